@@ -0,0 +1,32 @@
+/* BC1 (DXT1 / S3TC) block compression for display-ready wallpapers.
+ *
+ * Internal to the image module, split out (as exif.c and image_stream.c
+ * were) so the codec can be unit-tested without libpng, libjpeg or GL. A
+ * BC1 texture is 8 bytes per 4x4 block — 0.5 bytes per pixel against RGBA8's
+ * 4 — so a 4K slideshow image drops from 33 MB of VRAM to about 4 MB, and its
+ * upload shrinks by the same factor.
+ *
+ * Only opaque images are encoded: BC1's one-bit alpha would turn partially
+ * transparent wallpapers into cut-outs, and those stay RGBA8. The decoder is
+ * the reference the tests hold the encoder to; the GPU decodes for real.
+ */
+#ifndef NEOWALL_IMAGE_BC1_H
+#define NEOWALL_IMAGE_BC1_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Bytes of BC1 data for a width x height image (partial edge blocks count as
+ * whole blocks). 0 on overflow or a zero dimension. */
+size_t bc1_size(uint32_t width, uint32_t height);
+
+/* Encode RGBA8 pixels into `out` (bc1_size() bytes). Returns false, leaving
+ * `out` unspecified, if any pixel is not fully opaque. */
+bool bc1_encode_rgba(const uint8_t *rgba, uint32_t width, uint32_t height, uint8_t *out);
+
+/* Decode BC1 blocks back to RGBA8 (width * height * 4 bytes), per the S3TC
+ * spec including the three-colour + transparent-black block mode. */
+void bc1_decode_rgba(const uint8_t *blocks, uint32_t width, uint32_t height, uint8_t *rgba);
+
+#endif /* NEOWALL_IMAGE_BC1_H */
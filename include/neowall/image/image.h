@@ -1,6 +1,8 @@
 #ifndef IMAGE_H
 #define IMAGE_H
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /* Image format types */
@@ -10,13 +12,23 @@ enum image_format {
     FORMAT_UNKNOWN,
 };
 
+/* Layout of image_data.pixels. Zero (calloc) is plain RGBA/RGB. */
+enum image_pixel_format {
+    IMAGE_PIXELS_RAW,       /* width * height * channels bytes */
+    IMAGE_PIXELS_BC1,       /* BC1/DXT1 blocks, bc1_size(width, height) bytes */
+};
+
 /* Image data structure */
 struct image_data {
-    uint8_t *pixels;        /* RGBA pixel data */
+    uint8_t *pixels;        /* RGBA pixel data (or compressed blocks, see pixel_format) */
     uint32_t width;
     uint32_t height;
     uint32_t channels;      /* Number of channels (3 for RGB, 4 for RGBA) */
     enum image_format format;
+    enum image_pixel_format pixel_format;
+    size_t pixels_size;     /* Bytes in pixels when compressed; 0 for raw */
+    uint32_t full_width;    /* Preview only: size of the full image it stands in for */
+    uint32_t full_height;   /* (0 for a full-quality image) */
     char path[4096];        /* OUTPUT_MAX_PATH_LENGTH */
 };
 
@@ -26,6 +38,21 @@ void image_free(struct image_data *img);
 void image_free_pixels(struct image_data *img);  /* Free pixel data only (after GPU upload) */
 enum image_format image_detect_format(const char *path);
 
+/* Progressive display: a preview is decoded at 1/IMAGE_PREVIEW_REDUCE of the
+ * source (JPEG DCT scaling, or pass 1 of an Adam7 PNG) so something appears
+ * within a frame while the full decode runs in the background. Sources below
+ * IMAGE_PREVIEW_MIN_PIXELS (about a 4K frame) decode fast enough as they are,
+ * and non-interlaced PNGs have no cheap subsample; both return NULL. */
+#define IMAGE_PREVIEW_REDUCE 8
+#define IMAGE_PREVIEW_MIN_PIXELS ((size_t)3840 * 2160)
+struct image_data *image_load_preview(const char *path, int32_t display_width,
+                                      int32_t display_height, int mode);
+
+/* Replace an opaque RGBA image's pixels with BC1 blocks for a compressed
+ * texture upload. Returns false, leaving the image untouched, if it has any
+ * transparency or isn't RGBA. CPU-heavy: call from a worker thread. */
+bool image_compress_bc1(struct image_data *img);
+
 /* Image loaders for specific formats */
 struct image_data *image_load_png(const char *path);
 struct image_data *image_load_jpeg(const char *path);
@@ -0,0 +1,33 @@
+/* On-disk cache of display-ready, GPU-compressed wallpapers.
+ *
+ * Encoding a 4K image to BC1 costs far more than decoding it, so a slideshow
+ * pays it once: the block data is written under
+ * $XDG_CACHE_HOME/neowall/imagebin/ (or ~/.cache/...) and later cycles load
+ * it straight into a compressed texture, skipping the PNG/JPEG decode too.
+ *
+ * The key covers the file's identity (path, size, mtime, inode) and the
+ * decode target (display size and mode), so an edited image or a resized
+ * output simply misses. Best-effort throughout: any failure is a miss.
+ * No GL, no logging — callers report what they care about.
+ */
+#ifndef NEOWALL_IMAGE_CACHE_H
+#define NEOWALL_IMAGE_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct image_data;
+
+/* Key for `path` decoded for a width x height display in `mode`. False if
+ * the file cannot be stat'd. */
+bool image_cache_key(const char *path, int32_t width, int32_t height, int mode, uint64_t *key);
+
+/* Load a cached compressed image, or NULL on a miss. The result has
+ * pixel_format set and its path filled in; free with image_free(). */
+struct image_data *image_cache_load(uint64_t key);
+
+/* Store a compressed image under `key` (write to a temp file, then rename).
+ * Raw images are not cached. Returns true if the entry was written. */
+bool image_cache_store(uint64_t key, const struct image_data *img);
+
+#endif /* NEOWALL_IMAGE_CACHE_H */
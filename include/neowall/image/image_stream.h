@@ -0,0 +1,72 @@
+/* Row-streaming resample + centre crop for display-ready wallpapers.
+ *
+ * Internal to the image module. Split out from image.c (as exif.c was) so the
+ * resampler and the crop can be unit-tested without libpng,
+ * libjpeg, or the rest of neowall's I/O surface. (See tests/test_image_stream.c.)
+ *
+ * The decoders push source scanlines top to bottom; every output row is
+ * produced as soon as the two source rows it interpolates between have
+ * arrived, and is written straight to its final position in the output
+ * buffer. Only two RGBA source rows are ever resident, so a switch peaks at
+ * "output + 2 rows" instead of the old "full decode + scaled copy + cropped
+ * copy".
+ *
+ * There is no padding or tiling here: FIT, CENTER and TILE are composed on
+ * the GPU (see include/neowall/render/image_layout.h), so the output is never
+ * larger than the scaled image.
+ *
+ * The resampler is the same bilinear mapping image.c has always used
+ * (src = dst * (src_len - 1) / dst_len), so streamed output is bit-identical
+ * to the old whole-buffer passes.
+ */
+#ifndef NEOWALL_IMAGE_STREAM_H
+#define NEOWALL_IMAGE_STREAM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* How the scaled image maps onto the output buffer. */
+enum image_place {
+    IMAGE_PLACE_NONE, /* output == scaled image */
+    IMAGE_PLACE_CROP, /* output is a centred window of the scaled image */
+};
+
+/* Geometry of one decode. scaled_* equal to src_* means "no resample": rows
+ * are copied through untouched. For CROP the output is clamped to the scaled
+ * size per axis, exactly as the old image_center_crop() did. */
+struct image_stream_plan {
+    uint32_t src_width;
+    uint32_t src_height;
+    uint32_t scaled_width;
+    uint32_t scaled_height;
+    uint32_t out_width;
+    uint32_t out_height;
+    enum image_place place;
+};
+
+struct image_stream;
+
+/* Validate the plan and allocate the output buffer plus the two-row ring.
+ * Returns NULL on an invalid plan or allocation failure. */
+struct image_stream *image_stream_create(const struct image_stream_plan *plan);
+
+/* Slot for the next source row (src_width * 4 bytes, RGBA). Decoders write the
+ * scanline here directly, then call image_stream_commit_row(). Returns NULL
+ * once every source row has been committed. */
+uint8_t *image_stream_row_slot(struct image_stream *s);
+
+/* Consume the row last written to image_stream_row_slot() and emit every
+ * output row that has become computable. */
+void image_stream_commit_row(struct image_stream *s);
+
+/* Copy `rgba` into the next slot and commit it. For whole-buffer callers. */
+bool image_stream_push_row(struct image_stream *s, const uint8_t *rgba);
+
+/* Hand over the finished output buffer (caller frees) and its size. Fails,
+ * returning NULL, if fewer than src_height rows were committed. */
+uint8_t *image_stream_finish(struct image_stream *s, uint32_t *width, uint32_t *height);
+
+/* Release the stream and anything image_stream_finish() did not take. */
+void image_stream_destroy(struct image_stream *s);
+
+#endif /* NEOWALL_IMAGE_STREAM_H */
@@ -17,6 +17,7 @@
 /* Forward declarations for external types */
 struct neowall_state;
 struct compositor_surface;
+struct texture_upload;
 
 /* Thread-safe atomic types */
 typedef atomic_bool atomic_bool_t;
@@ -70,6 +71,8 @@ struct wallpaper_config {
     int shader_fps;                     /* Target FPS for shader rendering (default 60) */
     bool vsync;                         /* Enable vsync (sync to monitor refresh, ignores shader_fps) */
     bool show_fps;                      /* Show FPS watermark on screen (default false) */
+    bool compress_textures;             /* BC1-compress cycled images, cached on disk (default false) */
+    bool progressive;                   /* Preview huge images while they decode (default true) */
     bool pause_on_fullscreen;           /* Pause rendering when output is occluded by fullscreen window */
     float pause_coverage_threshold;     /* Fraction (0.0-1.0) of wallpaper region that must be covered by tiled windows to count as occluded. Default 0.8 */
     bool span;                          /* Explicitly span compatible sources across outputs (default false) */
@@ -105,6 +108,8 @@ struct wallpaper_config {
     float term_crt;                          /* nwTermFX CRT curve+vignette 0..1 (-1) */
     float term_chroma;                       /* nwTermFX chromatic aberration 0..1 (-1) */
     float term_fade;                         /* change-driven fade 0..1 (-1 = default) */
+    int  term_scrollback;                    /* history lines (-1 = default 10000) */
+    bool term_sdf;                           /* distance-field glyph atlas (default false) */
 };
 
 /* Output (monitor) state */
@@ -205,7 +210,9 @@ struct output_state {
     GLuint preload_texture;             /* Next texture to transition to */
     struct image_data *preload_image;   /* Image data for preloaded texture */
     char preload_path[OUTPUT_MAX_PATH_LENGTH];  /* Path of preloaded image */
-    atomic_bool_t preload_ready;        /* Is preload_texture ready for use? */
+    atomic_bool_t preload_ready;        /* Is preload_texture ready for use (upload fenced)? */
+    struct texture_upload *preload_upload; /* PBO ring the preload decodes into */
+    bool preload_refine;                /* preload_texture is the full image for a preview */
     
     /* Background thread for async image loading */
     pthread_t preload_thread;           /* Background preload thread */
@@ -222,6 +229,8 @@ struct output_state {
     enum wallpaper_mode preload_mode;
     pthread_mutex_t preload_mutex;      /* Protects preload_image during thread handoff */
     struct image_data *preload_decoded_image; /* Image decoded in background, ready for GPU upload */
+    bool preload_decoded_staged;        /* ...its pixels are already in the mapped upload PBO */
+    bool preload_decoded_refine;        /* ...it replaces the progressive preview on screen */
     atomic_bool_t preload_upload_pending; /* Background thread finished, main thread should upload */
     
     /* iChannel textures for shader inputs (dynamic count) */
@@ -409,7 +418,15 @@ bool output_terminal_mouse(struct output_state *output, int px, int py,
 /* Forward already-encoded key bytes to this output's terminal wallpaper child.
  * No-op unless the output runs a terminal. */
 bool output_terminal_key(struct output_state *output, const void *bytes, size_t len);
+
+/* Page this output's terminal wallpaper back (pages > 0) or forward through
+ * its scrollback. No-op unless the output runs a terminal. */
+bool output_terminal_scroll_page(struct output_state *output, int pages);
 GLuint output_upload_preload_texture(struct output_state *output);
+
+/* Publish the preload texture once its asynchronous upload has finished on
+ * the GPU. Cheap; call every frame with the context current. */
+void output_poll_preload_upload(struct output_state *output);
 void output_cleanup_transition(struct output_state *output);
 bool output_init_render(struct output_state *output);
 void output_destroy_texture(GLuint texture);
@@ -0,0 +1,47 @@
+/* Where a wallpaper texture lands on its output, for the GPU-side modes.
+ *
+ * FIT, CENTER and TILE used to be baked into the texture on the CPU: the
+ * decoder padded the scaled image out to the display with black, or copied it
+ * tile by tile, and uploaded a full display-sized texture however small the
+ * picture was. Now only the scaled picture is uploaded and the image shaders
+ * place it themselves — letterboxing outside the rect, GL_REPEAT for tiling.
+ *
+ * Split out of render.c (as span.c was out of output.c) so the placement math
+ * can be unit-tested without EGL or GL. Nothing here touches the GPU.
+ */
+#ifndef NEOWALL_RENDER_IMAGE_LAYOUT_H
+#define NEOWALL_RENDER_IMAGE_LAYOUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* How one image sits on its output. render.c maps each wallpaper_mode here. */
+enum image_layout_fit {
+    IMAGE_LAYOUT_FULL,   /* covers the whole output (FILL, STRETCH) */
+    IMAGE_LAYOUT_FIT,    /* centred, scaled down (never up) to fit, black bars */
+    IMAGE_LAYOUT_CENTER, /* centred at 1:1, overflow cropped, black bars */
+    IMAGE_LAYOUT_TILE,   /* 1:1 from the top-left corner, repeated */
+};
+
+/* The image's rectangle in the output quad's texcoord space: (0,0) is the
+ * top-left of the output, (1,1) the bottom-right, matching the texcoords of
+ * the image quad. A shader maps texcoord uv to image uv as (uv - xy) / wh.
+ * Outside [0,1] that is letterbox unless `tile` is set. */
+struct image_layout {
+    float x;
+    float y;
+    float w;
+    float h;
+    bool tile;
+};
+
+/* Place an image of img_w x img_h pixels on an out_w x out_h output.
+ *
+ * Centred placements start on a whole output pixel (the margin is floored),
+ * so a 1:1 image samples texel centres exactly and stays crisp. Degenerate
+ * sizes get the full-output layout, which is what a fullscreen quad with
+ * texcoords 0..1 always drew. */
+void image_layout_compute(enum image_layout_fit fit, uint32_t img_w, uint32_t img_h,
+                          int32_t out_w, int32_t out_h, struct image_layout *layout);
+
+#endif /* NEOWALL_RENDER_IMAGE_LAYOUT_H */
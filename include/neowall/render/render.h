@@ -1,10 +1,15 @@
 #ifndef RENDER_H
 #define RENDER_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <GL/gl.h>
 
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
 /* Forward declarations */
 struct output_state;
 struct wallpaper_config;
@@ -13,6 +18,9 @@ struct neowall_state;
 /* Texture creation from raw pixel data - render module doesn't need to know about image_data */
 GLuint render_create_texture_from_pixels(const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t channels);
 GLuint render_create_texture_from_pixels_flipped(const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t channels);
+GLuint render_create_compressed_texture(const uint8_t *blocks, size_t size,
+                                        uint32_t width, uint32_t height);
+bool render_texture_compression_supported(void);
 void render_destroy_texture(GLuint texture);
 
 /* Legacy API - deprecated, use render_create_texture_from_pixels() instead */
@@ -25,6 +33,11 @@ void render_cleanup_output(struct output_state *output);
 bool render_frame(struct output_state *output);
 bool render_frame_shader(struct output_state *output);
 bool render_frame_transition(struct output_state *output, float progress);
+
+/* Display-mode placement of an image on an output, for the image shaders */
+struct image_layout;
+void render_image_layout(const struct output_state *output, const struct image_data *image,
+                         struct image_layout *layout);
 GLuint render_create_texture(struct image_data *img);
 void render_destroy_texture(GLuint texture);
 bool render_load_channel_textures(struct output_state *output, struct wallpaper_config *config);
@@ -0,0 +1,64 @@
+/* Asynchronous wallpaper uploads through a ring of pixel buffer objects.
+ *
+ * glTexImage2D from client memory has to consume the whole image before it
+ * returns — for a 4K RGBA wallpaper that is tens of megabytes copied on the
+ * render thread, stalling every output's frame loop. With a PBO bound as
+ * GL_PIXEL_UNPACK_BUFFER the same call only queues a GPU-side copy.
+ *
+ * The flow for a preloaded wallpaper:
+ *   1. render thread: texture_upload_map() maps a free ring slot and hands
+ *      the pointer to the preload worker with the decode request;
+ *   2. worker: decodes and writes the pixels straight into the mapping;
+ *   3. render thread: texture_upload_submit() unmaps, queues the upload into
+ *      a new texture and drops a fence behind it;
+ *   4. render thread, every frame: texture_upload_poll() with a zero timeout;
+ *      the texture is only published (preload_ready) once the fence signals,
+ *      so the swap never waits on a half-finished DMA.
+ *
+ * GL 3.3 core has no persistent mapping (glBufferStorage is 4.4), so a slot
+ * is mapped once per upload instead; the ring's second slot lets the next
+ * preload be mapped while the previous upload's fence is still pending.
+ *
+ * Every call needs the shared EGL context current, except that the mapped
+ * pointer itself may be written from any thread until submit/cancel.
+ */
+#ifndef NEOWALL_RENDER_TEXTURE_UPLOAD_H
+#define NEOWALL_RENDER_TEXTURE_UPLOAD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <GL/gl.h>
+
+struct texture_upload;
+
+struct texture_upload *texture_upload_create(void);
+
+/* Release the PBOs and any outstanding fence. Safe with NULL. */
+void texture_upload_destroy(struct texture_upload *u);
+
+/* Map a free slot with room for `bytes` and return it for writing, or NULL
+ * if no slot is free or the map failed (callers fall back to a plain
+ * glTexImage2D). A slot still mapped from an abandoned request is unmapped
+ * first: the caller guarantees nobody is writing to it any more. */
+uint8_t *texture_upload_map(struct texture_upload *u, size_t bytes);
+
+/* Unmap the mapped slot and queue its first width * height RGBA pixels into
+ * a new texture, fenced. Returns the texture, or 0 on failure. The texture
+ * is usable right away as far as GL is concerned; texture_upload_poll() says
+ * when using it no longer costs a stall. */
+GLuint texture_upload_submit(struct texture_upload *u, uint32_t width, uint32_t height);
+
+/* As texture_upload_submit(), for `size` bytes of BC1 blocks (see
+ * include/neowall/image/bc1.h) uploaded with glCompressedTexImage2D. */
+GLuint texture_upload_submit_bc1(struct texture_upload *u, uint32_t width, uint32_t height,
+                                 size_t size);
+
+/* Unmap the mapped slot, if any, without uploading it. */
+void texture_upload_cancel(struct texture_upload *u);
+
+/* Has the last submitted upload finished on the GPU? Waits at most
+ * `timeout_ns` (0 = just look). True when nothing is in flight. */
+bool texture_upload_poll(struct texture_upload *u, uint64_t timeout_ns);
+
+#endif /* NEOWALL_RENDER_TEXTURE_UPLOAD_H */
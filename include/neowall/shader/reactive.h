@@ -8,11 +8,15 @@
  *
  * Everything here is best-effort and degrades gracefully: missing /proc files,
  * no battery, no audio source → the corresponding signal reads 0 (or a sane
- * default) and nothing breaks. All sampling is throttled and runs on the main
- * loop thread except audio capture, which owns a dedicated thread.
+ * default) and nothing breaks. Nothing here runs on the render path: system
+ * signals are sampled on their own thread on a fixed schedule, and audio and
+ * NVIDIA capture each own a dedicated thread.
  *
- * The values are published into a lock-free snapshot the render thread reads
- * once per frame. */
+ * The values are published through seqlocks (see src/shader/reactive_seqlock.h):
+ * the render thread copies them once per frame without taking a lock, and a
+ * writer in progress only makes it retry. The small scalar fields and the
+ * 4 KB of audio rows are published separately, so a frame that does not
+ * sample the audio texture never copies the rows. */
 
 #ifndef NEOWALL_REACTIVE_H
 #define NEOWALL_REACTIVE_H
@@ -23,8 +27,40 @@
 /* Number of FFT bins exposed to shaders (texture width). Power of two. */
 #define REACTIVE_AUDIO_BINS 512
 
-/* A frame-coherent snapshot of every reactive signal. Plain floats, copied by
- * value into the render path so the shader sees a consistent set each frame. */
+/* Recent per-frame spectrum rows kept for reactive_get_audio_row. Audio
+ * frames arrive at ~115 Hz; this covers a renderer running at >= 15 fps. */
+#define REACTIVE_AUDIO_BACKLOG 8
+
+/* Signal groups, one bit per collector. Live shaders declare which ones they
+ * read (reactive_demand_acquire) and only those are collected: a shader that
+ * uses none costs no sampling and spawns no parec or nvidia-smi. */
+enum {
+    REACTIVE_SIG_CPU      = 1u << 0,  /* cpu, cpu_per, cpu_cores, cpu_max, cpu_spread */
+    REACTIVE_SIG_RAM      = 1u << 1,  /* ram, ram_gb, ram_total_gb, swap */
+    REACTIVE_SIG_NET      = 1u << 2,  /* net_* */
+    REACTIVE_SIG_DISK     = 1u << 3,  /* disk_read, disk_write */
+    REACTIVE_SIG_LOAD     = 1u << 4,  /* load_avg, load_raw, procs, proc_count */
+    REACTIVE_SIG_BATTERY  = 1u << 5,  /* battery, charging */
+    REACTIVE_SIG_CPU_TEMP = 1u << 6,  /* cpu_temp, cpu_temp_c */
+    REACTIVE_SIG_GPU      = 1u << 7,  /* gpu, gpu_temp, gpu_temp_c (sysfs) */
+    REACTIVE_SIG_NVIDIA   = 1u << 8,  /* nv_* (NVML, or an nvidia-smi child) */
+    REACTIVE_SIG_UPTIME   = 1u << 9,  /* uptime_hours */
+    REACTIVE_SIG_TIME     = 1u << 10, /* time_of_day, sun, day_fraction */
+    REACTIVE_SIG_INPUT    = 1u << 11, /* key_energy, mouse_energy */
+    REACTIVE_SIG_AUDIO    = 1u << 12, /* audio_* and the audio rows (parec child) */
+};
+#define REACTIVE_SIG_COUNT 13
+#define REACTIVE_SIG_ALL ((1u << REACTIVE_SIG_COUNT) - 1u)
+
+/* What the fused signals are derived from. */
+#define REACTIVE_SIG_THERMAL (REACTIVE_SIG_CPU_TEMP | REACTIVE_SIG_GPU | REACTIVE_SIG_NVIDIA)
+#define REACTIVE_SIG_ACTIVITY (REACTIVE_SIG_CPU | REACTIVE_SIG_RAM | REACTIVE_SIG_NET |      \
+                               REACTIVE_SIG_DISK | REACTIVE_SIG_LOAD | REACTIVE_SIG_GPU |    \
+                               REACTIVE_SIG_NVIDIA)
+
+/* A frame-coherent snapshot of every scalar reactive signal. Plain floats,
+ * copied by value into the render path so the shader sees a consistent set
+ * each frame. The audio rows live in reactive_audio_t. */
 typedef struct {
     /* --- load (0..1, smoothed) --- */
     float cpu;          /* total CPU utilisation */
@@ -51,12 +87,12 @@ typedef struct {
     float gpu;          /* GPU utilisation 0..1 (amdgpu/nvidia/i915 best-effort) */
     float gpu_temp;     /* GPU temp normalised 0..1 over 30..95 C */
     float gpu_temp_c;   /* GPU temp in degrees C (0 if unknown) */
-    /* NVIDIA proprietary (via nvidia-smi worker; 0 if unavailable) */
+    /* NVIDIA proprietary (NVML or nvidia-smi worker; 0 if unavailable) */
     float nv_gpu;       /* NVIDIA GPU utilisation 0..1 */
     float nv_vram;      /* NVIDIA VRAM used / total 0..1 */
     float nv_temp_c;    /* NVIDIA GPU temp in degrees C */
     float nv_power;     /* NVIDIA board power draw / limit 0..1 */
-    bool  nv_active;    /* true if nvidia-smi is producing data */
+    bool  nv_active;    /* true if NVML / nvidia-smi is producing data */
 
     /* --- fused / derived shaping signals (0..1) --- */
     float thermal;      /* hottest of CPU/GPU normalised 0..1 (30..95 C) */
@@ -88,32 +124,70 @@ typedef struct {
     float audio_mid;               /* mid band energy 0..1 */
     float audio_treble;            /* high band energy 0..1 */
     float audio_beat;              /* 0..1 beat pulse, spikes on onset, decays */
+    uint32_t audio_frame;          /* reactive_audio_t.frame of the latest rows */
+} reactive_snapshot_t;
+
+/* The bulky audio rows, published separately from the scalars. */
+typedef struct {
+    uint32_t frame; /* bumps once per analysis frame; 0 = nothing yet */
     /* Spectrum + waveform, each REACTIVE_AUDIO_BINS samples in 0..1.
      * Uploaded as the two rows of the audio iChannel texture. */
-    float audio_spectrum[REACTIVE_AUDIO_BINS];
-    float audio_waveform[REACTIVE_AUDIO_BINS];
-} reactive_snapshot_t;
+    float spectrum[REACTIVE_AUDIO_BINS];
+    float waveform[REACTIVE_AUDIO_BINS];
+} reactive_audio_t;
 
-/* Initialise the subsystem. Safe to call once at startup. Starts the audio
- * capture thread if a source is available (best-effort). */
+/* Initialise the subsystem. Safe to call once at startup. Collectors start
+ * only once something demands them (see reactive_demand_acquire).
+ *
+ * Two environment variables make runs reproducible (see reactive_trace.h):
+ * NEOWALL_REACTIVE_RECORD=<file> writes every published snapshot and audio
+ * frame to a trace until reactive_shutdown; NEOWALL_REACTIVE_REPLAY=<file>
+ * serves a recorded trace from the getters below instead of live signals,
+ * and starts no collectors at all. */
 bool reactive_init(void);
 
-/* Stop the audio thread and release resources. */
+/* Stop the sampler and capture threads and release resources. */
 void reactive_shutdown(void);
 
-/* Sample the cheap system signals (CPU/RAM/net/battery/time). Self-throttled:
- * call every frame, it only does real work a few times per second. Call on the
- * main loop thread. */
-void reactive_sample(void);
+/* Reference-count demand for signal groups (REACTIVE_SIG_* bits). The
+ * system sampler runs while any system group is demanded and samples only
+ * those groups; the audio and NVIDIA capture threads (and their child
+ * processes) run only while their bit is demanded. Call from the render
+ * thread, e.g. when a shader is compiled and destroyed; safe before
+ * reactive_init (applied once initialised). Stopping a capture thread may
+ * block briefly while its child is reaped. */
+void reactive_demand_acquire(uint32_t signals);
+void reactive_demand_release(uint32_t signals);
 
 /* Feed input-activity energy (called from pointer/key handlers). dt_ms is the
  * time since the last call; speed is in pixels for mouse. */
 void reactive_note_key(void);
 void reactive_note_mouse(float dx, float dy);
 
-/* Copy the current frame-coherent snapshot. Cheap; call once per frame. */
+/* Copy the current frame-coherent scalar snapshot. Lock-free and cheap
+ * (a few hundred bytes); call once per frame. When replaying a trace, the
+ * snapshot is the one recorded at the time elapsed since reactive_init. */
 void reactive_get(reactive_snapshot_t *out);
 
+/* reactive_get for a renderer with its own clock: when replaying, returns the
+ * snapshot recorded `t` seconds into the trace (the caller's shader time), so
+ * the same trace and time give the same frame on every run. Live signals
+ * ignore `t`. */
+void reactive_get_at(reactive_snapshot_t *out, double t);
+
+/* Copy the latest audio rows (4 KB). Lock-free. Callers that keep the rows
+ * around can skip this when reactive_snapshot_t.audio_frame has not moved
+ * since their last copy. When replaying, these are the rows of the last
+ * snapshot this thread took. */
+void reactive_get_audio(reactive_audio_t *out);
+
+/* Copy the unsmoothed spectrum of audio frame `frame` (REACTIVE_AUDIO_BINS
+ * floats, 0..1) into `out`. Only the last REACTIVE_AUDIO_BACKLOG frames are
+ * held; returns false if `frame` is older than that or not produced yet.
+ * Lock-free. Lets a consumer that polls slower than the audio rate (the
+ * spectrogram history texture) still take one row per frame. */
+bool reactive_get_audio_row(uint32_t frame, float *out);
+
 /* True if audio capture is live (a monitor source was opened). */
 bool reactive_audio_available(void);
 
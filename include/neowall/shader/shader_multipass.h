@@ -25,6 +25,11 @@
 #define MULTIPASS_MAX_PASSES  5
 #define MULTIPASS_MAX_CHANNELS 4
 
+/* iAudioHistory rows (audio frames, ~115/s): default ~2.2 s, range. */
+#define MULTIPASS_AUDIO_HISTORY_ROWS 256
+#define MULTIPASS_AUDIO_HISTORY_MIN  16
+#define MULTIPASS_AUDIO_HISTORY_MAX  1024
+
 /* Pass types matching Shadertoy */
 typedef enum {
     PASS_TYPE_NONE = 0,
@@ -126,11 +131,14 @@ typedef struct {
     GLint iKeyEnergy, iMouseEnergy;
     GLint iAudioLevel, iAudioBass, iAudioMid, iAudioTreble, iAudioBeat, iAudioActive;
     GLint iAudio;               /* audio spectrum/waveform sampler */
+    GLint iAudioHistory;        /* spectrogram ring sampler (512 x N) */
+    GLint iAudioHistoryHead;    /* int: row of the newest spectrum in iAudioHistory */
     GLint iTermAtlas;           /* terminal glyph-atlas coverage sampler (R8) */
     GLint iTermColorAtlas;      /* terminal color-emoji atlas sampler (RGBA8) */
     GLint iTermCells;           /* terminal cell-record integer sampler (RGBA32UI) */
     GLint iTermChange;          /* terminal per-cell change-time sampler (R32UI) */
     GLint iTermInfo;            /* vec4: cols, rows, cellW, cellH */
+    GLint iTermRowBase;         /* int: texture row holding grid row 0 */
     GLint iTermAtlasSize;       /* vec2: atlas texel w,h */
     GLint iTermCursor;          /* vec3: cursorX, cursorY, visible */
     GLint iTermCursorPrev;      /* vec4: prevX, prevY, moveTime, unused */
@@ -185,17 +193,24 @@ typedef struct {
     GLuint noise_texture;                    /* Default noise texture */
     GLuint keyboard_texture;                 /* Keyboard state texture */
     GLuint audio_texture;                    /* Live audio (512x2) for iAudio / CHANNEL_SOURCE_AUDIO */
+    /* Spectrogram history for iAudioHistory: a 512 x audio_history_rows ring,
+     * one row per audio frame, newest at audio_history_head. Created on first
+     * use, so shaders that don't sample it pay nothing. */
+    GLuint audio_history_texture;
+    int    audio_history_rows;               /* N; 0 = MULTIPASS_AUDIO_HISTORY_ROWS */
+    int    audio_history_head;
+    uint32_t audio_history_frame;            /* last audio frame written to the ring */
     GLuint font_texture;                     /* Bitmap font atlas for CHANNEL_SOURCE_FONT */
     /* Live terminal source (CHANNEL_SOURCE_TERM). term is the CPU bridge that
      * owns the PTY + glyph atlas; cell_texture is an RGBA32UI per-cell record
-     * grid, atlas_texture is the R8 coverage bitmap. Uploaded per frame when
+     * grid, atlas_texture the R8 coverage page array. Uploaded per frame when
      * the terminal drew. NULL/0 when no terminal source is attached. */
     struct term_render *term;
     GLuint term_cell_texture;                /* RGBA32UI cols x rows */
     GLuint term_change_texture;              /* R32UI cols x rows: per-cell last-change ms */
-    GLuint term_atlas_texture;               /* R8 glyph coverage atlas */
-    GLuint term_color_atlas_texture;         /* RGBA8 color-emoji atlas (0 if none) */
-    int    term_atlas_uploaded_w, term_atlas_uploaded_h; /* last atlas dims uploaded */
+    GLuint term_atlas_texture;               /* R8 glyph coverage page array */
+    GLuint term_color_atlas_texture;         /* RGBA8 color-emoji page array (0 if none yet) */
+    int    term_atlas_layers, term_color_atlas_layers; /* pages each array holds */
     /* Optional terminal config (set before multipass_attach_terminal). Owned
      * strings freed in multipass_destroy; *_has_* gate the fg/bg overrides. */
     char  *term_cwd;
@@ -206,6 +221,8 @@ typedef struct {
     bool   term_has_fg, term_has_bg;
     float  term_fx[4];                       /* bloom, scanline, crt-curve, chromatic (0 = off) */
     float  term_fade;                        /* change-driven fade intensity (0 = off) */
+    int    term_scrollback;                  /* history lines to keep (0 = none) */
+    bool   term_sdf;                         /* distance-field glyphs (term_render_opts.sdf) */
     int    term_cursor_px, term_cursor_py;   /* last cursor cell, for slide interpolation */
     float  term_cursor_move_t;               /* iTime at which the cursor last moved */
     bool   term_cursor_seen;                 /* prev fields are valid */
@@ -244,6 +261,8 @@ typedef struct {
     float date_cached[4];                    /* iDate vec4, refreshed when the second ticks */
     long long date_cached_sec;               /* time() value date_cached was built for */
     reactive_snapshot_t frame_reactive;      /* one reactive snapshot per frame */
+    uint32_t audio_frame_uploaded;           /* reactive_audio_t.frame in audio_texture */
+    uint32_t reactive_demand;                /* REACTIVE_SIG_* held via reactive_demand_acquire */
 
     /* User uniforms declared by a .neowall manifest (Tier 2/3). Declared into
      * the wrapper at compile time and set each frame in multipass_set_uniforms. */
@@ -702,6 +721,16 @@ void multipass_set_channel(multipass_shader_t *shader,
 void multipass_add_user_uniform(multipass_shader_t *shader,
                                 const char *name, uniform_bind_t bind, float value);
 
+/**
+ * Set the number of rows (audio frames) in the iAudioHistory spectrogram
+ * ring. Clamped to MULTIPASS_AUDIO_HISTORY_MIN..MAX. Call before the first
+ * render; the texture is sized when it is created.
+ *
+ * @param shader Multipass shader
+ * @param rows   History length in audio frames (~115 per second)
+ */
+void multipass_set_audio_history(multipass_shader_t *shader, int rows);
+
 /**
  * Parse a uniform-binding keyword ("cpu", "audio_bass", "const", ...).
  * Returns UNIFORM_BIND_CONST for unknown / literal values.
@@ -761,4 +790,8 @@ void multipass_terminal_shutdown(multipass_shader_t *shader);
 /* Write raw (already-encoded) key bytes to the attached terminal's child. */
 bool multipass_terminal_write(multipass_shader_t *shader, const void *bytes, size_t len);
 
+/* Scroll the attached terminal's view `pages` screens back into its history
+ * (negative: forward). True if the view moved. */
+bool multipass_terminal_scroll_page(multipass_shader_t *shader, int pages);
+
 #endif /* SHADER_MULTIPASS_H */
\ No newline at end of file
@@ -70,6 +70,8 @@ static const char *neowall_reactive_uniforms =
     "uniform float iAudioBeat;      // beat pulse 0..1 (decays)\n"
     "uniform float iAudioActive;    // 1.0 if audio capture is live\n"
     "uniform sampler2D iAudio;      // row0 = spectrum, row1 = waveform (512 wide)\n"
+    "uniform sampler2D iAudioHistory; // spectrogram ring: 512 wide, one row per audio frame\n"
+    "uniform int   iAudioHistoryHead; // row of the newest spectrum in iAudioHistory\n"
     "\n"
     "// User uniforms (manifest-driven) live here; declared dynamically.\n";
 
@@ -166,6 +168,15 @@ static const char *neowall_glsl_stdlib =
 /* Continuation of the std-lib (split to satisfy the C99 4095-char string
  * literal limit; the two are concatenated at injection time). */
 static const char *neowall_glsl_stdlib2 =
+    "// ---- audio history (iAudioHistory spectrogram ring) ----\n"
+    "// Spectrum at x (0..1) as it was `age` audio frames ago (0 = newest,\n"
+    "// ~115 frames/s). Fractional ages blend neighbouring rows.\n"
+    "float spectrogram(float x, float age) {\n"
+    "    float n = float(textureSize(iAudioHistory, 0).y);\n"
+    "    float row = float(iAudioHistoryHead) - clamp(age, 0.0, n - 1.0);\n"
+    "    return texture(iAudioHistory, vec2(clamp(x,0.0,1.0), (row + 0.5) / n)).r;\n"
+    "}\n"
+    "\n"
     "// ---- 2D SDFs + ops ----\n"
     "float sdCircle(vec2 p,float r){ return length(p)-r; }\n"
     "float sdBox(vec2 p,vec2 b){ vec2 d=abs(p)-b; return length(max(d,0.0))+min(max(d.x,d.y),0.0); }\n"
@@ -233,18 +244,47 @@ static const char *neowall_glsl_stdlib3 =
     "float nwHexDigit(float v){ v = clamp(floor(v + 0.5), 0.0, 15.0); return v < 10.0 ? 48.0 + v : 55.0 + v; }\n"
     "// 0..9 -> ascii of that decimal digit.\n"
     "float nwDigit(float v){ return 48.0 + clamp(floor(v + 0.5), 0.0, 9.0); }\n"
+    "\n"
+    "// ---- live terminal: cell addressing --------------------------------\n"
+    "// nwTermTexel(cell) is where a cell lives in iTermCells/iTermChange: their\n"
+    "// rows form a ring starting at iTermRowBase, so scrolling uploads one row.\n"
+    "ivec2 nwTermTexel(ivec2 cell){\n"
+    "    int y = cell.y + iTermRowBase, rows = int(iTermInfo.y);\n"
+    "    return ivec2(cell.x, y >= rows ? y - rows : y);\n"
+    "}\n"
+    "// nwTermInk(b, pg, sdf): glyph ink 0..1 at atlas texel b of page pg.\n"
+    "// Coverage: 5 bilinear taps in a half-texel quincunx (centre + 4 corners);\n"
+    "// each tap is already box-filtered by the LINEAR 4x atlas, and averaging\n"
+    "// the quincunx removes the stair-step one tap leaves on diagonals/curves.\n"
+    "// Distance field: 128 on the outline, 128/6 per texel (6 = the spread,\n"
+    "// GLYPH_ATLAS_SDF_SPREAD), ramped over one screen pixel assuming the grid\n"
+    "// spans the viewport as it does for nwTerm.\n"
+    "float nwTermInk(vec2 b, float pg, bool sdf){\n"
+    "    vec2 uv = b / iTermAtlasSize;\n"
+    "    if (sdf) {\n"
+    "        vec2 tp = iTermInfo.xy * iTermInfo.zw / max(iResolution.xy, vec2(1.0));\n"
+    "        float d = (texture(iTermAtlas, vec3(uv, pg)).r * 255.0 - 128.0) * (6.0 / 128.0);\n"
+    "        return clamp(d / max(max(tp.x, tp.y), 0.001) + 0.5, 0.0, 1.0);\n"
+    "    }\n"
+    "    vec2 t = vec2(0.5) / iTermAtlasSize;\n"
+    "    return texture(iTermAtlas, vec3(uv, pg)).r * 0.5\n"
+    "         + (texture(iTermAtlas, vec3(uv + vec2( t.x,  t.y), pg)).r\n"
+    "          + texture(iTermAtlas, vec3(uv + vec2(-t.x,  t.y), pg)).r\n"
+    "          + texture(iTermAtlas, vec3(uv + vec2( t.x, -t.y), pg)).r\n"
+    "          + texture(iTermAtlas, vec3(uv + vec2(-t.x, -t.y), pg)).r) * 0.125;\n"
+    "}\n"
     "\n";
 
 /* Continuation (split for the C99 4095-char string-literal limit). */
 static const char *neowall_glsl_stdlib4 =
     "// ---- live terminal (bind a channel to \"terminal\") --------------------\n"
     "// nwTermCell(cell, frac, cw, ch) composites ONE terminal cell: it resolves\n"
-    "// the glyph rect + colours packed by term_render.c, samples the coverage\n"
+    "// the glyph rect + colours packed by term_render.c, samples the glyph\n"
     "// atlas iTermAtlas, and returns fg-over-bg (incl. underline/strike/cursor).\n"
     "// nwTerm(uv) tiles it across the unit square; nwTermFX(uv) adds bloom, a\n"
     "// phosphor scanline and a gentle CRT curve on top.\n"
     "vec3 nwTermCell(ivec2 cell, vec2 frac, float cw, float ch, bool drawCursor){\n"
-    "    uvec4 rec = texelFetch(iTermCells, cell, 0);\n"
+    "    uvec4 rec = texelFetch(iTermCells, nwTermTexel(cell), 0);\n"
     "    // decode fg (rec.b) and bg (rec.a low byte carries attrs)\n"
     "    vec3 fg = vec3(float((rec.b>>24)&0xFFu), float((rec.b>>16)&0xFFu), float((rec.b>>8)&0xFFu))/255.0;\n"
     "    vec3 bg = vec3(float((rec.a>>24)&0xFFu), float((rec.a>>16)&0xFFu), float((rec.a>>8)&0xFFu))/255.0;\n"
@@ -259,6 +299,7 @@ static const char *neowall_glsl_stdlib4 =
     "    if ((rec.r & 1u) != 0u) {\n"
     "        float ax = float((rec.r>>20)&0xFFFu);\n"
     "        float ay = float((rec.r>>8)&0xFFFu);\n"
+    "        float pg = float((rec.r>>2)&0x1Fu);    // atlas page (array layer)\n"
     "        float gw = float((rec.g>>24)&0xFFu);\n"
     "        float gh = float((rec.g>>16)&0xFFu);\n"
     "        float ox = float((rec.g>>8)&0xFFu) - 128.0;\n"
@@ -272,7 +313,7 @@ static const char *neowall_glsl_stdlib4 =
     "            if ((rec.r & 2u) != 0u) {\n"
     "                vec2 gpc2 = clamp(gp, vec2(0.5), vec2(gw, gh) - 0.5);\n"
     "                vec2 cuv = (vec2(ax, ay) + gpc2) / iTermAtlasSize;\n"
-    "                vec4 e = texture(iTermColorAtlas, cuv);\n"
+    "                vec4 e = texture(iTermColorAtlas, vec3(cuv, pg));\n"
     "                col = mix(bg, e.rgb, e.a);\n"
     "                if (drawCursor && iTermCursor.z > 0.5 && cell.x == int(iTermCursor.x) && cell.y == int(iTermCursor.y))\n"
     "                    col = vec3(1.0) - col;\n"
@@ -283,17 +324,8 @@ static const char *neowall_glsl_stdlib4 =
     "            // bleed is a thin dark seam per cell that breaks full-cell\n"
     "            // braille/block graph runs into a dotted trail.\n"
     "            vec2 gpc = clamp(gp, vec2(0.5), vec2(gw, gh) - 0.5);\n"
-    "            // SMOOTH AA: 5 bilinear taps in a half-texel quincunx (centre +\n"
-    "            // 4 corners). Each tap is already box-filtered by the LINEAR 4x\n"
-    "            // atlas; averaging the quincunx removes the residual stair-step\n"
-    "            // a single tap leaves on diagonals/curves.\n"
-    "            vec2 tpx = vec2(0.5) / iTermAtlasSize;\n"
-    "            vec2 b0 = (vec2(ax, ay) + gpc) / iTermAtlasSize;\n"
-    "            float cov = texture(iTermAtlas, b0).r * 0.5\n"
-    "                      + texture(iTermAtlas, b0 + vec2( tpx.x,  tpx.y)).r * 0.125\n"
-    "                      + texture(iTermAtlas, b0 + vec2(-tpx.x,  tpx.y)).r * 0.125\n"
-    "                      + texture(iTermAtlas, b0 + vec2( tpx.x, -tpx.y)).r * 0.125\n"
-    "                      + texture(iTermAtlas, b0 + vec2(-tpx.x, -tpx.y)).r * 0.125;\n"
+    "            // rec.r bit7: the glyph is a distance field, not coverage.\n"
+    "            float cov = nwTermInk(vec2(ax, ay) + gpc, pg, (rec.r & 128u) != 0u);\n"
     "            // Gamma-correct the coverage so the edge ramp is perceptually\n"
     "            // even (a raw sRGB mix makes dark-on-light too thin and mid-gray\n"
     "            // edges muddy). 0.714 ~= 1/1.4 lifts the mid coverage.\n"
@@ -397,13 +429,13 @@ static const char *neowall_glsl_stdlib6 =
     "    // Change-driven fade: cells whose record just changed briefly pulse\n"
     "    // brighter, then ease back — so graph bars and updating numbers glide\n"
     "    // into place instead of hard-snapping. A real terminal has no history\n"
-    "    // to do this; we do, via the R32UI per-cell last-change stamps.\n"
+    "    // to do this; we do, via the R32UI per-cell change stamps.\n"
     "    if (iTermFade.x > 0.001) {\n"
     "        float cols = iTermInfo.x, rows = iTermInfo.y;\n"
     "        ivec2 fc = ivec2(int(warped.x * cols), int((1.0 - warped.y) * rows));\n"
     "        fc = clamp(fc, ivec2(0), ivec2(int(cols)-1, int(rows)-1));\n"
-    "        uint chg = texelFetch(iTermChange, fc, 0).r;\n"
-    "        float age = (iTermFade.y - float(chg)) / 1000.0;   // seconds since change\n"
+    "        uint chg = texelFetch(iTermChange, nwTermTexel(fc), 0).r;\n"
+    "        float age = (iTermFade.y - float(chg)) / 1000.0;   // seconds\n"
     "        if (chg > 0u && age >= 0.0) {\n"
     "            // pulse: 0 at t=0, peak ~40ms, gone by ~260ms.\n"
     "            float p = age * 8.0 * exp(-age / 0.09);\n"
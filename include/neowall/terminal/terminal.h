@@ -130,13 +130,22 @@ nw_result term_write(terminal *t, const void *bytes, size_t len);
  * 2=right, 3=release (X10), 64=wheel-up, 65=wheel-down. `pressed` is false for
  * a button release, true for press/motion. Returns true if a sequence was sent
  * (i.e. the app wanted it), false if mouse reporting is off or the event is not
- * relevant to the active protocol (e.g. bare motion under click-only mode). */
+ * relevant to the active protocol (e.g. bare motion under click-only mode).
+ * With reporting off, the wheel scrolls the history instead (true if the view
+ * moved). */
 bool term_mouse(terminal *t, int cell_x, int cell_y, int button, bool pressed, bool motion);
 
 /* True when the child has any mouse reporting enabled — lets the host avoid the
  * work of tracking/encoding motion when nobody is listening. */
 bool term_wants_mouse(const terminal *t);
 
+/* Scroll the displayed view `delta` rows back into the scrollback (negative:
+ * toward the live screen) and return the new offset, 0 = live. With no
+ * history, or on the alternate screen, the view stays live. The wheel does
+ * this through term_mouse() when the app has not asked for the mouse, and
+ * any term_write() returns to the live screen. */
+int term_scroll_view(terminal *t, int delta);
+
 /* True once the child has exited (drives "restart the wallpaper command"). */
 bool term_child_exited(const terminal *t, int *exit_status_out);
 
@@ -144,17 +153,46 @@ bool term_child_exited(const terminal *t, int *exit_status_out);
 /* Snapshot (GL thread reads this)                                          */
 /* ------------------------------------------------------------------------ */
 
+/* Words in a per-row dirty bitmap: bit (y & 63) of word (y >> 6) is row y. */
+#define TERM_SCREEN_DIRTY_WORDS ((TERM_SCREEN_MAX_ROWS + 63) / 64)
+
 typedef struct term_frame {
     int              cols, rows;
-    const term_cell *cells;    /* rows*cols, row-major, borrowed (valid until next snapshot) */
+    /* rows*cols, borrowed (valid until next snapshot). A ring of rows: grid
+     * row y is at cells[((row_base + y) % rows) * cols]; see term_frame_row(). */
+    const term_cell *cells;
+    int              row_base;
+    /* Net lines the whole grid scrolled up (negative: down) since the previous
+     * snapshot; `row_base` moved by the same amount, and the rows it brought
+     * in are in `dirty_rows`. */
+    int              scrolled;
     int              cursor_x, cursor_y;
     bool             cursor_visible;
     uint64_t         epoch;    /* bumps whenever the grid changed; skip re-upload if unchanged */
+    /* Rows whose cells changed since the previous snapshot (TERM_SCREEN_DIRTY_WORDS
+     * words). Only these rows were copied into `cells`; the rest are unchanged
+     * from the previous frame. Authoritative where `epoch` is only a hint: the
+     * epoch is bumped after the reader drops the lock, so a snapshot can carry
+     * dirty rows under an epoch it has already seen. */
+    const uint64_t  *dirty_rows;
 } term_frame;
 
+static inline const term_cell *term_frame_row(const term_frame *f, int y) {
+    int i = f->row_base + y;
+    if (i >= f->rows) i -= f->rows;
+    return &f->cells[(size_t)i * f->cols];
+}
+
 /* Copy a frame-coherent view of the grid into the terminal's snapshot buffer
- * and return a borrowed pointer to it. Cheap; call once per rendered frame.
- * The returned cells pointer is valid until the next term_snapshot() call. */
+ * and return a borrowed pointer to it. Cheap; call once per rendered frame:
+ * only the rows the child touched since the last call are copied. The
+ * returned cells pointer is valid until the next term_snapshot() call.
+ *
+ * The previous frame is returned again, with no dirty rows and its old epoch,
+ * while the app is inside a synchronized repaint (DECSET 2026, up to a short
+ * timeout) and between the paced snapshots taken while the child floods the
+ * PTY. term_dirty_epoch() then stays ahead of the frame's, so an idle-gated
+ * caller keeps polling until the held output is shown. */
 const term_frame *term_snapshot(terminal *t);
 
 /* Lock-free monotonically-increasing counter, bumped by the reader thread each
@@ -189,6 +227,33 @@ int              term_screen_rows(const term_screen *s);
 const term_cell *term_screen_row(const term_screen *s, int y);   /* cols cells */
 void             term_screen_cursor(const term_screen *s, int *x, int *y);
 
+/* Store the rows changed since the last call in `rows_out` and clear the
+ * screen's own set. Returns true if any row changed. Every row starts dirty,
+ * and switching screens or resizing marks all of them again. `*scrolled`
+ * (optional) receives the net lines the whole grid scrolled up since the last
+ * call, negative for down. Such scrolls only dirty the rows they expose, and
+ * `rows_out` is indexed after them: rotate the previous copy by `*scrolled`
+ * rows, then refresh the rows in `rows_out`. */
+bool             term_screen_take_dirty(term_screen *s,
+                                        uint64_t rows_out[TERM_SCREEN_DIRTY_WORDS],
+                                        int *scrolled);
+
+/* Keep up to `lines` rows that scroll off the top of the primary screen, in
+ * compressed form (see src/terminal/scrollback.h). 0 turns history off.
+ * Replaces any existing history. False on allocation failure. */
+bool             term_screen_set_scrollback(term_screen *s, int lines);
+int              term_screen_history_lines(const term_screen *s);
+
+/* Move the view `delta` rows back into history (negative: toward the live
+ * screen), clamped to what is held; the alternate screen has none. Returns
+ * the new offset, 0 = live. Moving marks every row dirty. */
+int              term_screen_scroll_view(term_screen *s, int delta);
+int              term_screen_view_offset(const term_screen *s);
+
+/* Row y as displayed: history rows while scrolled back, otherwise the same
+ * as term_screen_row(). Decodes history on demand, hence non-const. */
+const term_cell *term_screen_view_row(term_screen *s, int y);
+
 /* Cursor visibility (DECTCEM). False when the app has hidden the cursor. */
 bool             term_screen_cursor_visible(const term_screen *s);
 
@@ -201,6 +266,12 @@ const char      *term_screen_title(const term_screen *s);
  * events into the PTY. */
 void             term_screen_mouse_mode(const term_screen *s, int *proto, bool *sgr);
 
+/* Synchronized output: true between the app's CSI ? 2026 h and CSI ? 2026 l,
+ * i.e. while the grid holds a half-drawn repaint that should not be shown.
+ * *begun (optional) receives the number of repaints started so far, so a
+ * caller polling once per frame can tell one long repaint from a new one. */
+bool             term_screen_sync_pending(const term_screen *s, uint32_t *begun);
+
 /* Drain queued reply bytes (responses to DSR / Device-Attributes / other query
  * control functions the app sent) into `out`, up to `cap` bytes; returns the
  * count copied and clears the buffer. The PTY layer writes these back to the
@@ -2,6 +2,7 @@
 #define TRANSITIONS_H
 
 #include "neowall/neowall.h"
+#include "neowall/render/image_layout.h"
 
 /* Transition rendering function signature */
 typedef bool (*transition_render_func)(struct output_state *output, float progress);
@@ -17,6 +18,33 @@ struct transition {
 void transitions_init(void);
 bool transition_render(struct output_state *output, enum transition_type type, float progress);
 
+/* GLSL helper shared by every image shader (fade doubles as the plain image
+ * program). Samples `tex` placed at `rect` (struct image_layout: xy origin,
+ * zw size, in quad texcoord space); outside the rect is opaque black unless
+ * `tile` is set, in which case GL_REPEAT on the texture does the rest.
+ * Splice it in after GLSL_VERSION_STRING. */
+#define TRANSITION_PLACE_IMAGE_GLSL                                                     \
+    "vec4 place_image(sampler2D tex, vec4 rect, float tile, vec2 uv) {\n"              \
+    "    vec2 t = (uv - rect.xy) / rect.zw;\n"                                         \
+    "    if (tile < 0.5 && (any(lessThan(t, vec2(0.0))) ||\n"                          \
+    "                       any(greaterThan(t, vec2(1.0))))) {\n"                      \
+    "        return vec4(0.0, 0.0, 0.0, 1.0);\n"                                       \
+    "    }\n"                                                                          \
+    "    return texture(tex, t);\n"                                                    \
+    "}\n"
+
+/* For two-texture transitions: declares image_rect0/1 and image_tile0/1 and
+ * wraps place_image() as sample_old(uv) (texture0) and sample_new(uv)
+ * (texture1). Needs texture0/texture1 declared before it. */
+#define TRANSITION_PLACE_IMAGE_PAIR_GLSL                                                \
+    "uniform vec4 image_rect0;\n"                                                      \
+    "uniform vec4 image_rect1;\n"                                                      \
+    "uniform float image_tile0;\n"                                                     \
+    "uniform float image_tile1;\n"                                                     \
+    TRANSITION_PLACE_IMAGE_GLSL                                                         \
+    "vec4 sample_old(vec2 uv) { return place_image(texture0, image_rect0, image_tile0, uv); }\n" \
+    "vec4 sample_new(vec2 uv) { return place_image(texture1, image_rect1, image_tile1, uv); }\n"
+
 /* Transition context for managing OpenGL state across draws */
 typedef struct {
     struct output_state *output;
@@ -24,13 +52,16 @@ typedef struct {
     GLint pos_attrib;
     GLint tex_attrib;
     float vertices[16];
+    struct image_layout old_layout; /* next_image / next_texture (outgoing) */
+    struct image_layout new_layout; /* current_image / texture (incoming) */
     bool blend_enabled;
     bool error_occurred;
 } transition_context_t;
 
 /* High-level transition API - abstracts OpenGL state management */
 bool transition_begin(transition_context_t *ctx, struct output_state *output, GLuint program);
-bool transition_draw_textured_quad(transition_context_t *ctx, GLuint texture, 
+bool transition_draw_textured_quad(transition_context_t *ctx, GLuint texture,
+                                    const struct image_layout *layout,
                                     float alpha, const float *custom_vertices);
 bool transition_draw_blended_textures(transition_context_t *ctx, 
                                        GLuint texture0, GLuint texture1,
@@ -38,6 +69,10 @@ bool transition_draw_blended_textures(transition_context_t *ctx,
                                        const float *resolution);
 void transition_end(transition_context_t *ctx);
 
+/* Set image_rect<unit>/image_tile<unit> on `program` and the bound texture's
+ * wrap mode to match. Also used by render_frame() for the plain image draw. */
+void transition_apply_image_layout(GLuint program, int unit, const struct image_layout *layout);
+
 /* Individual transition implementations */
 bool transition_fade_render(struct output_state *output, float progress);
 bool transition_slide_left_render(struct output_state *output, float progress);
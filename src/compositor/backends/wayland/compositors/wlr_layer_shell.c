@@ -617,6 +617,16 @@ static void kb_handle_key(void *data, struct wl_keyboard *kb, uint32_t serial,
                                              XKB_STATE_MODS_EFFECTIVE) > 0;
     bool alt  = xkb_state_mod_name_is_active(b->xkb_state, XKB_MOD_NAME_ALT,
                                              XKB_STATE_MODS_EFFECTIVE) > 0;
+    bool shift = xkb_state_mod_name_is_active(b->xkb_state, XKB_MOD_NAME_SHIFT,
+                                              XKB_STATE_MODS_EFFECTIVE) > 0;
+
+    /* Shift+PageUp/PageDown page through the scrollback, as in xterm; the
+     * child never sees them. */
+    if (shift && (sym == XKB_KEY_Page_Up || sym == XKB_KEY_Page_Down)) {
+        output_terminal_scroll_page(b->kbd_output, sym == XKB_KEY_Page_Up ? 1 : -1);
+        return;
+    }
+
     char seq[32];
     int n = keysym_to_vt(b->xkb_state, sym, keycode, ctrl, alt, seq, sizeof(seq));
     if (n <= 0) return;
@@ -1656,6 +1656,8 @@ static struct output_state *x11_make_output(struct neowall_state *state,
     out->config->shader_speed = 1.0f;
     out->config->shader_fps = 60;
     out->config->show_fps = false;
+    out->config->compress_textures = false;
+    out->config->progressive = true;
     out->config->channel_paths = NULL;
     out->config->channel_count = 0;
 
@@ -1663,6 +1665,7 @@ static struct output_state *x11_make_output(struct neowall_state *state,
     out->preload_image = NULL;
     out->preload_path[0] = '\0';
     atomic_init(&out->preload_ready, false);
+    out->preload_upload = NULL;
 
     pthread_mutex_init(&out->preload_mutex, NULL);
     out->preload_decoded_image = NULL;
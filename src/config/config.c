@@ -441,6 +441,8 @@ static void init_wallpaper_config_defaults(struct wallpaper_config *config) {
     config->shader_fps = 60;  /* Default 60 FPS for shaders */
     config->vsync = false;  /* Default: vsync off, use custom FPS with tearing control */
     config->show_fps = false;  /* Default: no FPS watermark */
+    config->compress_textures = false;  /* Default: uncompressed RGBA8 textures */
+    config->progressive = true;  /* Default: preview huge images while they decode */
     config->pause_on_fullscreen = true;  /* Default: pause rendering when occluded */
     config->pause_coverage_threshold = 0.8f;  /* Default: 80% tiled coverage = occluded */
     config->span = false;
@@ -468,6 +470,8 @@ static void init_wallpaper_config_defaults(struct wallpaper_config *config) {
     config->term_crt = -1.0f;
     config->term_chroma = -1.0f;
     config->term_fade = -1.0f;
+    config->term_scrollback = -1;
+    config->term_sdf = false;
 }
 
 static bool copy_config_string(char *dst, size_t dst_size, const VibeValue *value,
@@ -723,6 +727,7 @@ static bool parse_wallpaper_config(VibeValue *obj, struct wallpaper_config *conf
             { "term_cols", &config->term_cols, 1024 },
             { "term_rows", &config->term_rows, 512 },
             { "term_font_size", &config->term_font_size, 96 },
+            { "term_scrollback", &config->term_scrollback, 1000000 },
         };
         for (size_t i = 0; i < sizeof(integer_fields) / sizeof(integer_fields[0]); i++) {
             VibeValue *value = vibe_object_get(obj->as_object, integer_fields[i].key);
@@ -773,6 +778,15 @@ static bool parse_wallpaper_config(VibeValue *obj, struct wallpaper_config *conf
             *fxk[k].dst = (float)f;
             log_info("[%s] %s = %.2f", context_name, fxk[k].key, *fxk[k].dst);
         }
+
+        VibeValue *sdf_val = vibe_object_get(obj->as_object, "term_sdf");
+        if (sdf_val) {
+            if (sdf_val->type != VIBE_TYPE_BOOLEAN) {
+                log_error("[%s] 'term_sdf' must be a boolean (true or false)", context_name);
+                return false;
+            }
+            config->term_sdf = sdf_val->as_boolean;
+        }
     }
 
     /* ========================================================================
@@ -997,6 +1011,46 @@ static bool parse_wallpaper_config(VibeValue *obj, struct wallpaper_config *conf
         log_info("[%s] FPS watermark: %s", context_name, config->show_fps ? "enabled" : "disabled");
     }
 
+    /* Parse compress_textures (image cycling only) */
+    VibeValue *compress_val = vibe_object_get(obj->as_object, "compress_textures");
+    if (compress_val) {
+        if (compress_val->type != VIBE_TYPE_BOOLEAN) {
+            log_error("[%s] 'compress_textures' must be a boolean (true or false), got type: %d",
+                     context_name, compress_val->type);
+            return false;
+        }
+        config->compress_textures = compress_val->as_boolean;
+        log_info("[%s] Compressed textures: %s", context_name,
+                 config->compress_textures ? "enabled" : "disabled");
+
+        if (config->type != WALLPAPER_IMAGE) {
+            log_error("[%s] INVALID CONFIG: 'compress_textures' specified for a non-image wallpaper. "
+                     "Texture compression only applies to image wallpapers.",
+                     context_name);
+            return false;
+        }
+    }
+
+    /* Parse progressive (image wallpapers only) */
+    VibeValue *progressive_val = vibe_object_get(obj->as_object, "progressive");
+    if (progressive_val) {
+        if (progressive_val->type != VIBE_TYPE_BOOLEAN) {
+            log_error("[%s] 'progressive' must be a boolean (true or false), got type: %d",
+                     context_name, progressive_val->type);
+            return false;
+        }
+        config->progressive = progressive_val->as_boolean;
+        log_info("[%s] Progressive preview: %s", context_name,
+                 config->progressive ? "enabled" : "disabled");
+
+        if (config->type != WALLPAPER_IMAGE) {
+            log_error("[%s] INVALID CONFIG: 'progressive' specified for a non-image wallpaper. "
+                     "Progressive display only applies to image wallpapers.",
+                     context_name);
+            return false;
+        }
+    }
+
     /* Parse pause_on_fullscreen */
     VibeValue *pause_fs_val = vibe_object_get(obj->as_object, "pause_on_fullscreen");
     if (pause_fs_val) {
@@ -1121,9 +1175,11 @@ static bool parse_wallpaper_config(VibeValue *obj, struct wallpaper_config *conf
         "term_shader", "term_font_bold", "term_font_italic", "term_cwd",
         "term_env", "term_font_size", "term_fg", "term_bg",
         "term_bloom", "term_scanline", "term_crt", "term_chroma", "term_fade",
+        "term_scrollback", "term_sdf",
         "mode", "duration", "transition",
         "transition_duration", "shader_speed", "channels", "shader_fps", "vsync", "show_fps",
-        "pause_on_fullscreen", "pause_coverage_threshold", "shuffle"
+        "pause_on_fullscreen", "pause_coverage_threshold", "shuffle", "compress_textures",
+        "progressive"
     };
     size_t known_key_count = sizeof(known_keys) / sizeof(known_keys[0]);
 
@@ -367,6 +367,10 @@ static void render_outputs(struct neowall_state *state) {
             pthread_mutex_unlock(&output->preload_mutex);
         }
 
+        /* A queued PBO upload becomes the preload only once its fence has
+         * signalled; until then a cycle would stall on the copy. */
+        output_poll_preload_upload(output);
+
         /* Handle image transitions */
         if (output->transition_start_time > 0 &&
             output->config->transition != TRANSITION_NONE) {
@@ -860,9 +864,6 @@ void event_loop_run(struct neowall_state *state) {
 #endif
         }
 
-        /* Refresh live system/audio signals for reactive shaders (self-throttled). */
-        reactive_sample();
-
         /* Prepare for reading events via compositor backend */
         if (ops && ops->prepare_events) {
             if (!ops->prepare_events(backend_data)) {
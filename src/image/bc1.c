@@ -0,0 +1,224 @@
+/* BC1 encoder/decoder. See include/neowall/image/bc1.h.
+ *
+ * The encoder is a principal-axis range fit, the usual quality/speed point
+ * for offline-ish work: per block, the colours' dominant direction (power
+ * iteration on the covariance) picks the two endpoints, which are inset a
+ * little and rounded to RGB565, then each pixel takes the nearest of the four
+ * palette entries. Always four-colour mode (c0 > c1), since the input is
+ * opaque.
+ */
+#include <stdint.h>
+#include <string.h>
+
+#include "neowall/image/bc1.h"
+
+size_t bc1_size(uint32_t width, uint32_t height) {
+    if (width == 0 || height == 0) {
+        return 0;
+    }
+    size_t bw = ((size_t)width + 3) / 4;
+    size_t bh = ((size_t)height + 3) / 4;
+    if (bw > SIZE_MAX / 8 / bh) {
+        return 0;
+    }
+    return bw * bh * 8;
+}
+
+static uint16_t pack565(float r, float g, float b) {
+    int r5 = (int)(r * 31.0f / 255.0f + 0.5f);
+    int g6 = (int)(g * 63.0f / 255.0f + 0.5f);
+    int b5 = (int)(b * 31.0f / 255.0f + 0.5f);
+    r5 = r5 < 0 ? 0 : (r5 > 31 ? 31 : r5);
+    g6 = g6 < 0 ? 0 : (g6 > 63 ? 63 : g6);
+    b5 = b5 < 0 ? 0 : (b5 > 31 ? 31 : b5);
+    return (uint16_t)((r5 << 11) | (g6 << 5) | b5);
+}
+
+static void unpack565(uint16_t c, int out[3]) {
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+/* The four-colour palette both sides agree on. */
+static void palette4(uint16_t c0, uint16_t c1, int pal[4][3]) {
+    unpack565(c0, pal[0]);
+    unpack565(c1, pal[1]);
+    for (int k = 0; k < 3; k++) {
+        pal[2][k] = (2 * pal[0][k] + pal[1][k]) / 3;
+        pal[3][k] = (pal[0][k] + 2 * pal[1][k]) / 3;
+    }
+}
+
+static void encode_block(const uint8_t px[16][4], uint8_t out[8]) {
+    float mean[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 16; i++) {
+        for (int k = 0; k < 3; k++) {
+            mean[k] += px[i][k];
+        }
+    }
+    for (int k = 0; k < 3; k++) {
+        mean[k] /= 16.0f;
+    }
+
+    float cov[6] = {0}; /* rr rg rb gg gb bb */
+    for (int i = 0; i < 16; i++) {
+        float r = px[i][0] - mean[0], g = px[i][1] - mean[1], b = px[i][2] - mean[2];
+        cov[0] += r * r;
+        cov[1] += r * g;
+        cov[2] += r * b;
+        cov[3] += g * g;
+        cov[4] += g * b;
+        cov[5] += b * b;
+    }
+
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+    for (int it = 0; it < 8; it++) {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float m = x > 0 ? x : -x;
+        if ((y > 0 ? y : -y) > m) m = y > 0 ? y : -y;
+        if ((z > 0 ? z : -z) > m) m = z > 0 ? z : -z;
+        if (m < 1e-6f) {
+            break; /* flat block: any axis will do */
+        }
+        axis[0] = x / m;
+        axis[1] = y / m;
+        axis[2] = z / m;
+    }
+
+    int lo = 0, hi = 0;
+    float lo_d = 0.0f, hi_d = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        float d = px[i][0] * axis[0] + px[i][1] * axis[1] + px[i][2] * axis[2];
+        if (i == 0 || d < lo_d) {
+            lo_d = d;
+            lo = i;
+        }
+        if (i == 0 || d > hi_d) {
+            hi_d = d;
+            hi = i;
+        }
+    }
+
+    /* Inset the endpoints by 1/16 of the range: the extremes are usually
+     * outliers, and the interpolated entries then land nearer the bulk. */
+    float e0[3], e1[3];
+    for (int k = 0; k < 3; k++) {
+        float inset = (px[hi][k] - px[lo][k]) / 16.0f;
+        e0[k] = px[hi][k] - inset;
+        e1[k] = px[lo][k] + inset;
+    }
+    uint16_t c0 = pack565(e0[0], e0[1], e0[2]);
+    uint16_t c1 = pack565(e1[0], e1[1], e1[2]);
+    if (c0 < c1) {
+        uint16_t t = c0;
+        c0 = c1;
+        c1 = t;
+    }
+
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        int pal[4][3];
+        palette4(c0, c1, pal);
+        for (int i = 0; i < 16; i++) {
+            int best = 0, best_d = 0;
+            for (int p = 0; p < 4; p++) {
+                int dr = px[i][0] - pal[p][0];
+                int dg = px[i][1] - pal[p][1];
+                int db = px[i][2] - pal[p][2];
+                int d = dr * dr + dg * dg + db * db;
+                if (p == 0 || d < best_d) {
+                    best_d = d;
+                    best = p;
+                }
+            }
+            indices |= (uint32_t)best << (2 * i);
+        }
+    }
+    /* c0 == c1 reads as three-colour mode, where index 0 is still c0. */
+
+    out[0] = (uint8_t)(c0 & 0xff);
+    out[1] = (uint8_t)(c0 >> 8);
+    out[2] = (uint8_t)(c1 & 0xff);
+    out[3] = (uint8_t)(c1 >> 8);
+    out[4] = (uint8_t)(indices & 0xff);
+    out[5] = (uint8_t)((indices >> 8) & 0xff);
+    out[6] = (uint8_t)((indices >> 16) & 0xff);
+    out[7] = (uint8_t)(indices >> 24);
+}
+
+bool bc1_encode_rgba(const uint8_t *rgba, uint32_t width, uint32_t height, uint8_t *out) {
+    if (!rgba || !out || bc1_size(width, height) == 0) {
+        return false;
+    }
+    size_t n = (size_t)width * height;
+    for (size_t i = 0; i < n; i++) {
+        if (rgba[i * 4 + 3] != 255) {
+            return false;
+        }
+    }
+
+    uint8_t *dst = out;
+    for (uint32_t by = 0; by < height; by += 4) {
+        for (uint32_t bx = 0; bx < width; bx += 4) {
+            /* Edge blocks repeat the last row/column so the padding texels
+             * (never sampled) don't drag the endpoints around. */
+            uint8_t px[16][4];
+            for (uint32_t y = 0; y < 4; y++) {
+                uint32_t sy = by + y < height ? by + y : height - 1;
+                for (uint32_t x = 0; x < 4; x++) {
+                    uint32_t sx = bx + x < width ? bx + x : width - 1;
+                    memcpy(px[y * 4 + x], rgba + ((size_t)sy * width + sx) * 4, 4);
+                }
+            }
+            encode_block((const uint8_t(*)[4])px, dst);
+            dst += 8;
+        }
+    }
+    return true;
+}
+
+void bc1_decode_rgba(const uint8_t *blocks, uint32_t width, uint32_t height, uint8_t *rgba) {
+    if (!blocks || !rgba || bc1_size(width, height) == 0) {
+        return;
+    }
+    const uint8_t *src = blocks;
+    for (uint32_t by = 0; by < height; by += 4) {
+        for (uint32_t bx = 0; bx < width; bx += 4) {
+            uint16_t c0 = (uint16_t)(src[0] | (src[1] << 8));
+            uint16_t c1 = (uint16_t)(src[2] | (src[3] << 8));
+            uint32_t indices = (uint32_t)src[4] | ((uint32_t)src[5] << 8) |
+                               ((uint32_t)src[6] << 16) | ((uint32_t)src[7] << 24);
+            src += 8;
+
+            int pal[4][4];
+            int p3[4][3];
+            palette4(c0, c1, p3);
+            for (int p = 0; p < 4; p++) {
+                memcpy(pal[p], p3[p], sizeof(p3[p]));
+                pal[p][3] = 255;
+            }
+            if (c0 <= c1) {
+                /* Three-colour mode: midpoint, then transparent black. */
+                for (int k = 0; k < 3; k++) {
+                    pal[2][k] = (p3[0][k] + p3[1][k]) / 2;
+                    pal[3][k] = 0;
+                }
+                pal[3][3] = 0;
+            }
+
+            for (uint32_t y = 0; y < 4 && by + y < height; y++) {
+                for (uint32_t x = 0; x < 4 && bx + x < width; x++) {
+                    int idx = (indices >> (2 * (y * 4 + x))) & 3;
+                    uint8_t *d = rgba + ((size_t)(by + y) * width + bx + x) * 4;
+                    for (int k = 0; k < 4; k++) {
+                        d[k] = (uint8_t)pal[idx][k];
+                    }
+                }
+            }
+        }
+    }
+}
@@ -8,6 +8,8 @@
 #include <jpeglib.h>
 #include "neowall/image/image.h"
 #include "neowall/image/exif.h"
+#include "neowall/image/image_stream.h"
+#include "neowall/image/bc1.h"
 #include "neowall/neowall.h"
 #include "neowall/constants.h"
 
@@ -31,7 +33,9 @@ static bool image_buffer_size(uint32_t width, uint32_t height, size_t channels,
 /* Forward declarations */
 static struct image_data *image_scale_to_display(struct image_data *img, int32_t display_width, 
                                                    int32_t display_height, int mode);
-static struct image_data *image_scale_bilinear(struct image_data *img, uint32_t new_width, uint32_t new_height);
+static bool image_plan_for_display(uint32_t w, uint32_t h, int32_t display_width,
+                                   int32_t display_height, int mode,
+                                   struct image_stream_plan *plan);
 
 /* Expand path with tilde */
 static bool expand_path(const char *path, char *expanded, size_t size) {
@@ -96,8 +100,25 @@ enum image_format image_detect_format(const char *path) {
     return FORMAT_UNKNOWN;
 }
 
-/* Load PNG image */
-struct image_data *image_load_png(const char *path) {
+/* Display geometry a decode should be streamed into. A NULL target means
+ * "full resolution, no scaling" (iChannel textures, exif tests). A reduce
+ * factor above 1 asks for a progressive preview instead: the decoder reads a
+ * 1/reduce subsample of the source (JPEG DCT scaling, PNG Adam7 pass 1) and
+ * width/height are the display divided by the same factor. */
+struct image_target {
+    int32_t width;
+    int32_t height;
+    int mode;
+    uint32_t reduce;
+};
+
+/* A preview is only worth its extra pass when the full decode is slow. */
+static bool image_preview_worthwhile(uint32_t width, uint32_t height) {
+    return (size_t)width * (size_t)height >= IMAGE_PREVIEW_MIN_PIXELS;
+}
+
+/* Decode PNG, streaming rows into the display-sized output when possible */
+static struct image_data *image_decode_png(const char *path, const struct image_target *target) {
     if (!path) {
         log_error("Invalid path for PNG loading");
         return NULL;
@@ -146,9 +167,20 @@ struct image_data *image_load_png(const char *path) {
         return NULL;
     }
 
+    /* Everything allocated after setjmp is volatile so the error path below
+     * sees the current value after libpng longjmps out of a row read. */
+    struct image_data *volatile img = NULL;
+    png_bytep *volatile row_pointers = NULL;
+    png_bytep volatile scratch = NULL;
+    struct image_stream *volatile stream = NULL;
+
     /* Set up error handling */
     if (setjmp(png_jmpbuf(png_ptr))) {
         log_error("Error reading PNG file %s", expanded_path);
+        image_stream_destroy(stream);
+        free(scratch);
+        free(row_pointers);
+        image_free(img);
         png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
         fclose(fp);
         return NULL;
@@ -169,6 +201,16 @@ struct image_data *image_load_png(const char *path) {
     log_debug("Loading PNG: %s (%ux%u, color_type=%d, bit_depth=%d)",
               expanded_path, width, height, color_type, bit_depth);
 
+    /* Only an interlaced file has a cheap preview: Adam7 pass 1 (every 8th
+     * pixel each way) is the first 1/64 of the data. */
+    bool first_pass = target && target->reduce > 1;
+    if (first_pass && (png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_ADAM7 ||
+                       !image_preview_worthwhile(width, height))) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        fclose(fp);
+        return NULL;
+    }
+
     /* Transform to RGBA */
     if (bit_depth == 16) {
         png_set_strip_16(png_ptr);
@@ -197,10 +239,26 @@ struct image_data *image_load_png(const char *path) {
         png_set_gray_to_rgb(png_ptr);
     }
 
+    /* Let png_read_image() assemble Adam7 passes itself; a no-op otherwise.
+     * A preview leaves it off, so libpng hands pass 1 over as an image of its
+     * own (PNG_PASS_COLS x PNG_PASS_ROWS) and the rest is never inflated. */
+    if (!first_pass) {
+        png_set_interlace_handling(png_ptr);
+    }
+
     png_read_update_info(png_ptr, info_ptr);
 
+    const size_t png_row_bytes = png_get_rowbytes(png_ptr, info_ptr);
+    size_t row_bytes = png_row_bytes;
+    uint32_t full_width = width, full_height = height;
+    if (first_pass) {
+        width = PNG_PASS_COLS(full_width, 0);
+        height = PNG_PASS_ROWS(full_height, 0);
+        row_bytes = (size_t)width * 4;
+    }
+
     /* Allocate image data */
-    struct image_data *img = calloc(1, sizeof(struct image_data));
+    img = calloc(1, sizeof(struct image_data));
     if (!img) {
         log_error("Failed to allocate image data: %s", strerror(errno));
         png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
@@ -213,22 +271,64 @@ struct image_data *image_load_png(const char *path) {
     img->channels = 4; /* RGBA */
     img->format = FORMAT_PNG;
     snprintf(img->path, sizeof(img->path), "%s", path);
+    if (first_pass) {
+        img->full_width = full_width;
+        img->full_height = full_height;
+    }
 
-    /* Allocate pixel buffer */
-    size_t row_bytes = png_get_rowbytes(png_ptr, info_ptr);
     size_t pixel_bytes = 0;
     if (!image_buffer_size(width, height, 4, &pixel_bytes) ||
         row_bytes > SIZE_MAX / height || row_bytes * height > pixel_bytes) {
         log_error("PNG dimensions are invalid or too large: %ux%u", width, height);
-        free(img);
+        image_free(img);
         png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
         fclose(fp);
         return NULL;
     }
+
+    /* Interlaced (Adam7) files deliver each row in several passes, so they
+     * cannot feed a one-pass stream; they take the whole-buffer path. */
+    struct image_stream_plan plan;
+    if (target && row_bytes == (size_t)width * 4 &&
+        png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_NONE &&
+        image_plan_for_display(width, height, target->width, target->height,
+                               target->mode, &plan)) {
+        stream = image_stream_create(&plan);
+    }
+
+    if (stream) {
+        /* Streamed: decoder rows land directly in the resampler's ring and
+         * are placed into the display-sized output as they complete. */
+        for (uint32_t y = 0; y < height; y++) {
+            png_read_row(png_ptr, image_stream_row_slot(stream), NULL);
+            image_stream_commit_row(stream);
+        }
+
+        uint32_t out_width = 0, out_height = 0;
+        img->pixels = image_stream_finish(stream, &out_width, &out_height);
+        image_stream_destroy(stream);
+        stream = NULL;
+        if (!img->pixels) {
+            log_error("Streamed PNG decode of %s did not complete", expanded_path);
+            image_free(img);
+            png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+            fclose(fp);
+            return NULL;
+        }
+        log_debug("Streamed PNG %s: %ux%u -> %ux%u (mode=%d)", expanded_path,
+                  width, height, out_width, out_height, target->mode);
+        img->width = out_width;
+        img->height = out_height;
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        fclose(fp);
+        return img;
+    }
+
+    /* Allocate pixel buffer */
     img->pixels = malloc(row_bytes * (size_t)height);
     if (!img->pixels) {
         log_error("Failed to allocate pixel buffer: %s", strerror(errno));
-        free(img);
+        image_free(img);
         png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
         fclose(fp);
         return NULL;
@@ -236,11 +336,10 @@ struct image_data *image_load_png(const char *path) {
 
     /* Allocate row pointers */
     /* sizeof(png_bytep) is pointer size (8 bytes), height constrained by format */
-    png_bytep *row_pointers = malloc(sizeof(png_bytep) * height);
+    row_pointers = malloc(sizeof(png_bytep) * height);
     if (!row_pointers) {
         log_error("Failed to allocate row pointers: %s", strerror(errno));
-        free(img->pixels);
-        free(img);
+        image_free(img);
         png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
         fclose(fp);
         return NULL;
@@ -250,8 +349,28 @@ struct image_data *image_load_png(const char *path) {
         row_pointers[y] = img->pixels + y * row_bytes;
     }
 
-    /* Read image data */
-    png_read_image(png_ptr, row_pointers);
+    /* Read image data. png_read_image() would turn interlace handling back
+     * on, so pass 1 of a preview is read row by row, through a scratch row:
+     * libpng copies a full image width out even for a reduced pass. */
+    if (first_pass) {
+        scratch = malloc(png_row_bytes);
+        if (!scratch) {
+            log_error("Failed to allocate PNG row buffer: %s", strerror(errno));
+            free(row_pointers);
+            image_free(img);
+            png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+            fclose(fp);
+            return NULL;
+        }
+        for (uint32_t y = 0; y < height; y++) {
+            png_read_row(png_ptr, scratch, NULL);
+            memcpy(row_pointers[y], scratch, row_bytes);
+        }
+        free(scratch);
+        scratch = NULL;
+    } else {
+        png_read_image(png_ptr, row_pointers);
+    }
 
     /* Clean up */
     free(row_pointers);
@@ -260,7 +379,16 @@ struct image_data *image_load_png(const char *path) {
 
     log_debug("Loaded PNG image: %s (%ux%u)", expanded_path, width, height);
 
-    return img;
+    struct image_data *result = img;
+    if (target) {
+        result = image_scale_to_display(result, target->width, target->height, target->mode);
+    }
+    return result;
+}
+
+/* Load PNG image */
+struct image_data *image_load_png(const char *path) {
+    return image_decode_png(path, NULL);
 }
 
 /* JPEG error handler */
@@ -276,8 +404,8 @@ static void jpeg_error_exit(j_common_ptr cinfo) {
     longjmp(err->setjmp_buffer, 1);
 }
 
-/* Load JPEG image */
-struct image_data *image_load_jpeg(const char *path) {
+/* Decode JPEG, streaming rows into the display-sized output when possible */
+static struct image_data *image_decode_jpeg(const char *path, const struct image_target *target) {
     if (!path) {
         log_error("Invalid path for JPEG loading");
         return NULL;
@@ -298,12 +426,20 @@ struct image_data *image_load_jpeg(const char *path) {
     struct jpeg_decompress_struct cinfo;
     struct jpeg_error_mgr_ext jerr;
 
+    /* Allocated after setjmp; volatile so the error path sees them. */
+    struct image_data *volatile img = NULL;
+    unsigned char *volatile row_buffer = NULL;
+    struct image_stream *volatile stream = NULL;
+
     /* Set up error handling */
     cinfo.err = jpeg_std_error(&jerr.pub);
     jerr.pub.error_exit = jpeg_error_exit;
 
     if (setjmp(jerr.setjmp_buffer)) {
         log_error("JPEG error: %s (file: %s)", jerr.error_msg, expanded_path);
+        image_stream_destroy(stream);
+        free(row_buffer);
+        image_free(img);
         jpeg_destroy_decompress(&cinfo);
         fclose(fp);
         return NULL;
@@ -335,6 +471,21 @@ struct image_data *image_load_jpeg(const char *path) {
     /* Force RGB output */
     cinfo.out_color_space = JCS_RGB;
 
+    /* A preview lets libjpeg drop DCT coefficients instead (1/8 is little
+     * more than the DC terms) and skips the costlier quality options. */
+    bool preview = target && target->reduce > 1;
+    if (preview) {
+        if (!image_preview_worthwhile(cinfo.image_width, cinfo.image_height)) {
+            jpeg_destroy_decompress(&cinfo);
+            fclose(fp);
+            return NULL;
+        }
+        cinfo.scale_num = 1;
+        cinfo.scale_denom = target->reduce;
+        cinfo.dct_method = JDCT_IFAST;
+        cinfo.do_fancy_upsampling = FALSE;
+    }
+
     /* Start decompression */
     jpeg_start_decompress(&cinfo);
 
@@ -353,7 +504,7 @@ struct image_data *image_load_jpeg(const char *path) {
     }
 
     /* Allocate image data */
-    struct image_data *img = calloc(1, sizeof(struct image_data));
+    img = calloc(1, sizeof(struct image_data));
     if (!img) {
         log_error("Failed to allocate image data: %s", strerror(errno));
         jpeg_destroy_decompress(&cinfo);
@@ -366,50 +517,70 @@ struct image_data *image_load_jpeg(const char *path) {
     img->channels = 4; /* We'll convert RGB to RGBA */
     img->format = FORMAT_JPEG;
     snprintf(img->path, sizeof(img->path), "%s", path);
+    if (preview) {
+        /* Upright source size; image_load_preview() maps it to the display */
+        bool swap = exif_orientation >= EXIF_ORIENT_LEFT_TOP;
+        img->full_width = swap ? cinfo.image_height : cinfo.image_width;
+        img->full_height = swap ? cinfo.image_width : cinfo.image_height;
+    }
 
     size_t rgba_bytes = 0;
     if (!image_buffer_size(width, height, 4, &rgba_bytes)) {
         log_error("JPEG dimensions are invalid or too large: %ux%u", width, height);
-        free(img);
-        jpeg_destroy_decompress(&cinfo);
-        fclose(fp);
-        return NULL;
-    }
-    img->pixels = malloc(rgba_bytes);
-    if (!img->pixels) {
-        log_error("Failed to allocate pixel buffer: %s", strerror(errno));
-        free(img);
+        image_free(img);
         jpeg_destroy_decompress(&cinfo);
         fclose(fp);
         return NULL;
     }
 
     size_t row_stride = (size_t)width * 3;
-    unsigned char *row_buffer = malloc(row_stride);
+    row_buffer = malloc(row_stride);
     if (!row_buffer) {
         log_error("Failed to allocate row buffer: %s", strerror(errno));
-        free(img->pixels);
-        free(img);
+        image_free(img);
         jpeg_destroy_decompress(&cinfo);
         fclose(fp);
         return NULL;
     }
 
-    /* Read scanlines and convert RGB to RGBA */
+    /* An EXIF rotation needs the whole frame before the first output row is
+     * known, so only upright images stream. */
+    struct image_stream_plan plan;
+    if (target && exif_orientation == EXIF_ORIENT_TOP_LEFT &&
+        image_plan_for_display(width, height, target->width, target->height,
+                               target->mode, &plan)) {
+        stream = image_stream_create(&plan);
+    }
+
+    if (!stream) {
+        img->pixels = malloc(rgba_bytes);
+        if (!img->pixels) {
+            log_error("Failed to allocate pixel buffer: %s", strerror(errno));
+            free(row_buffer);
+            image_free(img);
+            jpeg_destroy_decompress(&cinfo);
+            fclose(fp);
+            return NULL;
+        }
+    }
+
+    /* Read scanlines and convert RGB to RGBA, either into the full buffer or
+     * into the resampler's next ring slot */
     uint32_t row = 0;
     while (cinfo.output_scanline < height) {
         unsigned char *row_ptr = row_buffer;
         jpeg_read_scanlines(&cinfo, &row_ptr, 1);
 
-        /* Convert RGB to RGBA */
+        uint8_t *dst = stream ? image_stream_row_slot(stream)
+                              : img->pixels + (size_t)row * (size_t)width * 4;
         for (size_t x = 0; x < (size_t)width; x++) {
-            size_t src_idx = x * 3;
-            size_t dst_idx = ((size_t)row * (size_t)width + x) * 4;
-
-            img->pixels[dst_idx + 0] = row_buffer[src_idx + 0]; /* R */
-            img->pixels[dst_idx + 1] = row_buffer[src_idx + 1]; /* G */
-            img->pixels[dst_idx + 2] = row_buffer[src_idx + 2]; /* B */
-            img->pixels[dst_idx + 3] = ALPHA_OPAQUE;                      /* A */
+            dst[x * 4 + 0] = row_buffer[x * 3 + 0]; /* R */
+            dst[x * 4 + 1] = row_buffer[x * 3 + 1]; /* G */
+            dst[x * 4 + 2] = row_buffer[x * 3 + 2]; /* B */
+            dst[x * 4 + 3] = ALPHA_OPAQUE;          /* A */
+        }
+        if (stream) {
+            image_stream_commit_row(stream);
         }
 
         row++;
@@ -417,21 +588,48 @@ struct image_data *image_load_jpeg(const char *path) {
 
     /* Clean up */
     free(row_buffer);
+    row_buffer = NULL;
     jpeg_finish_decompress(&cinfo);
     jpeg_destroy_decompress(&cinfo);
     fclose(fp);
 
+    if (stream) {
+        uint32_t out_width = 0, out_height = 0;
+        img->pixels = image_stream_finish(stream, &out_width, &out_height);
+        image_stream_destroy(stream);
+        if (!img->pixels) {
+            log_error("Streamed JPEG decode of %s did not complete", expanded_path);
+            image_free(img);
+            return NULL;
+        }
+        log_debug("Streamed JPEG %s: %ux%u -> %ux%u (mode=%d)", expanded_path,
+                  width, height, out_width, out_height, target->mode);
+        img->width = out_width;
+        img->height = out_height;
+        return img;
+    }
+
+    struct image_data *result = img;
+
     /* Honor EXIF Orientation tag BEFORE display-aware scaling so the scaler
      * sees the final visual dimensions (e.g. a portrait phone photo with
      * orientation=6 reports 4032x3024 in the file but is actually 3024x4032
      * once rotated). */
     if (exif_orientation != EXIF_ORIENT_TOP_LEFT) {
-        image_apply_exif_orientation(img, exif_orientation);
+        image_apply_exif_orientation(result, exif_orientation);
     }
 
-    log_debug("Loaded JPEG image: %s (%ux%u)", expanded_path, img->width, img->height);
+    log_debug("Loaded JPEG image: %s (%ux%u)", expanded_path, result->width, result->height);
 
-    return img;
+    if (target) {
+        result = image_scale_to_display(result, target->width, target->height, target->mode);
+    }
+    return result;
+}
+
+/* Load JPEG image */
+struct image_data *image_load_jpeg(const char *path) {
+    return image_decode_jpeg(path, NULL);
 }
 
 /* Load image from file (auto-detect format) with display-aware scaling */
@@ -442,30 +640,60 @@ struct image_data *image_load(const char *path, int32_t display_width,
         return NULL;
     }
 
+    /* Scale image intelligently based on display dimensions and mode. The
+     * decoders stream straight into the display-sized output when they can. */
+    struct image_target target = {display_width, display_height, mode, 1};
+    const struct image_target *tp =
+        (display_width > 0 && display_height > 0) ? &target : NULL;
+
     enum image_format format = image_detect_format(path);
-    struct image_data *img = NULL;
-    
     switch (format) {
         case FORMAT_PNG:
-            img = image_load_png(path);
-            break;
+            return image_decode_png(path, tp);
         case FORMAT_JPEG:
-            img = image_load_jpeg(path);
-            break;
+            return image_decode_jpeg(path, tp);
         default:
             log_error("Unsupported or unknown image format: %s", path);
             return NULL;
     }
+}
 
-    if (!img) {
+/* Fast, reduced-resolution stand-in for image_load() of a large file. The
+ * preview is decoded for a display 1/IMAGE_PREVIEW_REDUCE the size, and
+ * full_width/full_height are set to what image_load() would return, so the
+ * renderer can lay it out exactly where the full image will land. */
+struct image_data *image_load_preview(const char *path, int32_t display_width,
+                                      int32_t display_height, int mode) {
+    if (!path || display_width <= 0 || display_height <= 0) {
         return NULL;
     }
 
-    /* Scale image intelligently based on display dimensions and mode */
-    if (display_width > 0 && display_height > 0) {
-        img = image_scale_to_display(img, display_width, display_height, mode);
+    const int32_t r = IMAGE_PREVIEW_REDUCE;
+    struct image_target target = {(display_width + r - 1) / r, (display_height + r - 1) / r,
+                                   mode, IMAGE_PREVIEW_REDUCE};
+    struct image_data *img = NULL;
+    switch (image_detect_format(path)) {
+        case FORMAT_PNG:
+            img = image_decode_png(path, &target);
+            break;
+        case FORMAT_JPEG:
+            img = image_decode_jpeg(path, &target);
+            break;
+        default:
+            return NULL;
+    }
+    if (!img) {
+        return NULL; /* small, non-interlaced PNG or unreadable: load normally */
     }
 
+    struct image_stream_plan plan;
+    if (image_plan_for_display(img->full_width, img->full_height, display_width,
+                               display_height, mode, &plan)) {
+        img->full_width = plan.out_width;
+        img->full_height = plan.out_height;
+    }
+    log_debug("Preview of %s: %ux%u standing in for %ux%u", path, img->width, img->height,
+              img->full_width, img->full_height);
     return img;
 }
 
@@ -481,6 +709,30 @@ void image_free_pixels(struct image_data *img) {
     }
 }
 
+bool image_compress_bc1(struct image_data *img) {
+    if (!img || !img->pixels || img->pixel_format != IMAGE_PIXELS_RAW || img->channels != 4) {
+        return false;
+    }
+    size_t size = bc1_size(img->width, img->height);
+    if (size == 0) {
+        return false;
+    }
+    uint8_t *blocks = malloc(size);
+    if (!blocks) {
+        log_error("Failed to allocate %zu bytes for BC1 blocks", size);
+        return false;
+    }
+    if (!bc1_encode_rgba(img->pixels, img->width, img->height, blocks)) {
+        free(blocks);
+        return false; /* has transparency: stays RGBA */
+    }
+    free(img->pixels);
+    img->pixels = blocks;
+    img->pixel_format = IMAGE_PIXELS_BC1;
+    img->pixels_size = size;
+    return true;
+}
+
 /* Free image data */
 void image_free(struct image_data *img) {
     if (!img) {
@@ -571,306 +823,121 @@ static void calculate_optimal_dimensions(uint32_t img_width, uint32_t img_height
     }
 }
 
-/* Pad image to exact dimensions with transparent borders (center positioning) */
-static struct image_data *image_center_pad(struct image_data *img, uint32_t pad_width, uint32_t pad_height) {
-    if (!img || !img->pixels) {
-        return img;
-    }
-    
-    /* No padding needed if already exact size or larger */
-    if (img->width >= pad_width && img->height >= pad_height) {
-        return img;
-    }
-    
-    log_debug("Center-padding image from %ux%u to %ux%u",
-             img->width, img->height, pad_width, pad_height);
-    
-    /* Allocate new pixel buffer filled with opaque black (R=0, G=0, B=0, A=255) */
-    size_t new_size = (size_t)pad_width * pad_height * 4; /* RGBA */
-    uint8_t *new_pixels = malloc(new_size);
-    if (!new_pixels) {
-        log_error("Failed to allocate memory for padded image");
-        return img;
-    }
-    
-    /* Fill with opaque black (important: alpha = 255 for opaque) */
-    for (size_t i = 0; i < new_size; i += 4) {
-        new_pixels[i] = 0;       /* R */
-        new_pixels[i + 1] = 0;   /* G */
-        new_pixels[i + 2] = 0;   /* B */
-        new_pixels[i + 3] = 255; /* A - opaque */
-    }
-    
-    /* Calculate position to center the image */
-    uint32_t offset_x = (pad_width > img->width) ? (pad_width - img->width) / 2 : 0;
-    uint32_t offset_y = (pad_height > img->height) ? (pad_height - img->height) / 2 : 0;
-    
-    /* Copy original image to center of new buffer */
-    for (uint32_t y = 0; y < img->height; y++) {
-        uint32_t dst_y = offset_y + y;
-        uint32_t src_offset = y * img->width * 4;
-        uint32_t dst_offset = (dst_y * pad_width + offset_x) * 4;
-        memcpy(new_pixels + dst_offset, img->pixels + src_offset, img->width * 4);
-    }
-    
-    /* Replace old pixels with padded ones */
-    free(img->pixels);
-    img->pixels = new_pixels;
-    img->width = pad_width;
-    img->height = pad_height;
-    
-    return img;
-}
-
-/* Tile image to fill exact dimensions by repeating the source image */
-static struct image_data *image_tile_to_size(struct image_data *img, uint32_t target_width, uint32_t target_height) {
-    if (!img || !img->pixels || img->width == 0 || img->height == 0 ||
-        target_width == 0 || target_height == 0) {
-        return img;
-    }
-    /* No tiling needed if already exact size or larger */
-    if (img->width >= target_width && img->height >= target_height) {
-        return img;
-    }
-
-    log_debug("Tiling image from %ux%u to fill %ux%u",
-              img->width, img->height, target_width, target_height);
-    
-    /* Allocate new pixel buffer for tiled result */
-    size_t new_size = (size_t)target_width * target_height * 4; /* RGBA */
-    uint8_t *new_pixels = malloc(new_size);
-    if (!new_pixels) {
-        log_error("Failed to allocate memory for tiled image");
-        return img;
-    }
-    
-    /* Tile the image by copying it repeatedly */
-    for (uint32_t dst_y = 0; dst_y < target_height; dst_y++) {
-        uint32_t src_y = dst_y % img->height;  /* Wrap vertically */
-        
-        for (uint32_t dst_x = 0; dst_x < target_width; dst_x++) {
-            uint32_t src_x = dst_x % img->width;  /* Wrap horizontally */
-            
-            /* Copy pixel from source to destination */
-            uint32_t src_offset = (src_y * img->width + src_x) * 4;
-            uint32_t dst_offset = (dst_y * target_width + dst_x) * 4;
-            
-            new_pixels[dst_offset + 0] = img->pixels[src_offset + 0]; /* R */
-            new_pixels[dst_offset + 1] = img->pixels[src_offset + 1]; /* G */
-            new_pixels[dst_offset + 2] = img->pixels[src_offset + 2]; /* B */
-            new_pixels[dst_offset + 3] = img->pixels[src_offset + 3]; /* A */
-        }
-    }
-    
-    /* Replace old pixels with tiled ones */
-    free(img->pixels);
-    img->pixels = new_pixels;
-    img->width = target_width;
-    img->height = target_height;
-    
-    log_debug("Image tiled to %ux%u", target_width, target_height);
-    return img;
-}
-
-/* Center-crop image to exact dimensions */
-static struct image_data *image_center_crop(struct image_data *img, uint32_t crop_width, uint32_t crop_height) {
-    if (!img || !img->pixels) {
-        return img;
-    }
-    
-    /* No crop needed if already exact size */
-    if (img->width == crop_width && img->height == crop_height) {
-        return img;
-    }
-    
-    /* Calculate crop offsets (center crop) */
-    uint32_t offset_x = (img->width > crop_width) ? (img->width - crop_width) / 2 : 0;
-    uint32_t offset_y = (img->height > crop_height) ? (img->height - crop_height) / 2 : 0;
-    
-    /* Ensure we don't crop to larger than source */
-    uint32_t actual_crop_width = (crop_width < img->width) ? crop_width : img->width;
-    uint32_t actual_crop_height = (crop_height < img->height) ? crop_height : img->height;
-    
-    log_debug("Center-cropping image from %ux%u to %ux%u (offset: %u,%u)",
-             img->width, img->height, actual_crop_width, actual_crop_height, offset_x, offset_y);
-    
-    /* Allocate new pixel buffer */
-    size_t new_size = (size_t)actual_crop_width * actual_crop_height * 4; /* RGBA */
-    uint8_t *new_pixels = malloc(new_size);
-    if (!new_pixels) {
-        log_error("Failed to allocate memory for cropped image");
-        return img;
-    }
-    
-    /* Copy cropped region row by row */
-    for (uint32_t y = 0; y < actual_crop_height; y++) {
-        uint32_t src_y = offset_y + y;
-        uint32_t src_offset = (src_y * img->width + offset_x) * 4;
-        uint32_t dst_offset = y * actual_crop_width * 4;
-        memcpy(new_pixels + dst_offset, img->pixels + src_offset, actual_crop_width * 4);
-    }
-    
-    /* Replace old pixels with cropped ones */
-    free(img->pixels);
-    img->pixels = new_pixels;
-    img->width = actual_crop_width;
-    img->height = actual_crop_height;
-    
-    return img;
-}
-
-/* Scale image to optimal size for display mode */
-static struct image_data *image_scale_to_display(struct image_data *img, int32_t display_width, 
-                                                   int32_t display_height, int mode) {
-    if (!img || !img->pixels || img->width == 0 || img->height == 0 ||
-        display_width <= 0 || display_height <= 0) {
-        return img;
+/* Work out how an image of w x h becomes display-ready for `mode`. Returns
+ * false when the image is already usable as-is (no resample, no crop), which
+ * is also what every degenerate input gets.
+ *
+ * The CPU only ever shrinks here: it resamples and, for FILL and CENTER,
+ * crops away what can never be on screen. Letterboxing (FIT, CENTER) and
+ * repetition (TILE) are done by the image shaders from the texture's own
+ * size, so nothing is padded or tiled out to display size before upload. */
+static bool image_plan_for_display(uint32_t w, uint32_t h, int32_t display_width,
+                                   int32_t display_height, int mode,
+                                   struct image_stream_plan *plan) {
+    if (!plan || w == 0 || h == 0 || display_width <= 0 || display_height <= 0) {
+        return false;
     }
 
     /* Calculate optimal dimensions for this display mode. Initialised here so
      * the static analyzer can see both are always defined even if a future
      * mode is added to calculate_optimal_dimensions without setting them. */
-    uint32_t target_width = img->width, target_height = img->height;
-    calculate_optimal_dimensions(img->width, img->height, display_width, display_height,
+    uint32_t target_width = w, target_height = h;
+    calculate_optimal_dimensions(w, h, display_width, display_height,
                                  mode, &target_width, &target_height);
     if (target_width == 0 || target_height == 0) {
         log_error("Refusing to scale image to zero dimensions for %dx%d display", display_width,
                   display_height);
-        return img;
-    }
-    
-    /* Only scale if dimensions changed */
-    if (target_width == img->width && target_height == img->height) {
-        log_debug("Image %ux%u already optimal for display %dx%d (mode=%d)",
-                 img->width, img->height, display_width, display_height, mode);
-        return img;
+        return false;
     }
-    
+
     /* Only downscale for modes other than FILL/STRETCH (which need to fill display) */
     if (mode != MODE_FILL && mode != MODE_STRETCH) {
-        if (target_width > img->width || target_height > img->height) {
+        if (target_width > w || target_height > h) {
             log_debug("Keeping original size %ux%u (would upscale to %ux%u)",
-                     img->width, img->height, target_width, target_height);
-            return img;
+                     w, h, target_width, target_height);
+            target_width = w;
+            target_height = h;
         }
     }
-    
-    log_debug("Scaling image from %ux%u to %ux%u for %dx%d display (mode=%d)",
-             img->width, img->height, target_width, target_height, 
-             display_width, display_height, mode);
-    
-    img = image_scale_bilinear(img, target_width, target_height);
-    
-    if (!img || !img->pixels) {
-        return img;
+
+    /* FILL overflows the display on one axis by design, CENTER whenever the
+     * image is larger than the display; the overflow is cropped here so it
+     * is never uploaded. The GPU centres whatever is left. */
+    const uint32_t dw = (uint32_t)display_width, dh = (uint32_t)display_height;
+    uint32_t out_width = target_width, out_height = target_height;
+    if (mode == MODE_FILL || mode == MODE_CENTER) {
+        out_width = target_width < dw ? target_width : dw;
+        out_height = target_height < dh ? target_height : dh;
     }
-    
-    /* Adjust image to exact display size for seamless transitions
-     * All modes except TILE need to be exact display size for consistent rendering */
-    switch (mode) {
-        case MODE_FILL:
-            /* Already scaled to fill, now crop excess to exact display size */
-            img = image_center_crop(img, display_width, display_height);
-            break;
-            
-        case MODE_FIT:
-            /* Scaled to fit inside, now pad to exact display size with black borders */
-            if (img->width < (uint32_t)display_width || img->height < (uint32_t)display_height) {
-                img = image_center_pad(img, display_width, display_height);
-            }
-            break;
-            
-        case MODE_CENTER:
-            /* No scaling (1:1 pixels), crop if larger or pad if smaller to exact display size */
-            if (img->width > (uint32_t)display_width || img->height > (uint32_t)display_height) {
-                img = image_center_crop(img, display_width, display_height);
-            } else if (img->width < (uint32_t)display_width || img->height < (uint32_t)display_height) {
-                img = image_center_pad(img, display_width, display_height);
-            }
-            /* else: already exact size, perfect! */
-            break;
-            
-        case MODE_STRETCH:
-            /* Already scaled to exact display size, no adjustment needed */
-            break;
-            
-        case MODE_TILE:
-            /* Physically tile the image to exact display size for seamless transitions
-             * This makes transitions work perfectly while maintaining tile appearance */
-            img = image_tile_to_size(img, display_width, display_height);
-            break;
+
+    if (target_width == w && target_height == h && out_width == w && out_height == h) {
+        log_debug("Image %ux%u already optimal for display %dx%d (mode=%d)",
+                 w, h, display_width, display_height, mode);
+        return false;
     }
-    
-    return img;
+
+    size_t scaled_bytes = 0;
+    if (!image_buffer_size(target_width, target_height, 4, &scaled_bytes)) {
+        log_error("Refusing invalid or oversized scale target %ux%u", target_width, target_height);
+        return false;
+    }
+
+    log_debug("Scaling image from %ux%u to %ux%u (uploading %ux%u) for %dx%d display (mode=%d)",
+             w, h, target_width, target_height, out_width, out_height,
+             display_width, display_height, mode);
+
+    plan->src_width = w;
+    plan->src_height = h;
+    plan->scaled_width = target_width;
+    plan->scaled_height = target_height;
+    plan->out_width = out_width;
+    plan->out_height = out_height;
+    plan->place = (out_width != target_width || out_height != target_height)
+                      ? IMAGE_PLACE_CROP
+                      : IMAGE_PLACE_NONE;
+    return true;
 }
 
-/* High-quality bilinear image scaling */
-static struct image_data *image_scale_bilinear(struct image_data *img, uint32_t new_width, uint32_t new_height) {
+/* Scale an already-decoded image to optimal size for display mode. Used when
+ * the decoder could not stream (interlaced PNG, EXIF-rotated JPEG); the rows
+ * still go through the same resampler, so the only extra copy is the decode. */
+static struct image_data *image_scale_to_display(struct image_data *img, int32_t display_width, 
+                                                   int32_t display_height, int mode) {
     if (!img || !img->pixels || img->width == 0 || img->height == 0 ||
-        new_width == 0 || new_height == 0) {
+        display_width <= 0 || display_height <= 0) {
         return img;
     }
 
-    size_t new_size = 0;
-    if (!image_buffer_size(new_width, new_height, 4, &new_size)) {
-        log_error("Refusing invalid or oversized scale target %ux%u", new_width, new_height);
+    struct image_stream_plan plan;
+    if (!image_plan_for_display(img->width, img->height, display_width, display_height,
+                                mode, &plan)) {
         return img;
     }
 
-    /* Allocate new pixel buffer */
-    uint8_t *new_pixels = malloc(new_size);
-    if (!new_pixels) {
+    struct image_stream *stream = image_stream_create(&plan);
+    if (!stream) {
         log_error("Failed to allocate scaled image buffer");
         return img;
     }
-    
-    float x_ratio = (float)(img->width - 1) / (float)new_width;
-    float y_ratio = (float)(img->height - 1) / (float)new_height;
-    
-    /* Bilinear interpolation */
-    for (uint32_t y = 0; y < new_height; y++) {
-        for (uint32_t x = 0; x < new_width; x++) {
-            float src_x = x * x_ratio;
-            float src_y = y * y_ratio;
-            
-            uint32_t x1 = (uint32_t)src_x;
-            uint32_t y1 = (uint32_t)src_y;
-            uint32_t x2 = (x1 < img->width - 1) ? x1 + 1 : x1;
-            uint32_t y2 = (y1 < img->height - 1) ? y1 + 1 : y1;
-            
-            float x_diff = src_x - x1;
-            float y_diff = src_y - y1;
-            
-            /* Get the four surrounding pixels */
-            size_t idx_tl = (y1 * img->width + x1) * 4;  /* Top-left */
-            size_t idx_tr = (y1 * img->width + x2) * 4;  /* Top-right */
-            size_t idx_bl = (y2 * img->width + x1) * 4;  /* Bottom-left */
-            size_t idx_br = (y2 * img->width + x2) * 4;  /* Bottom-right */
-            
-            size_t dst_idx = (y * new_width + x) * 4;
-            
-            /* Interpolate each channel (RGBA) */
-            for (int c = 0; c < 4; c++) {
-                float tl = img->pixels[idx_tl + c];
-                float tr = img->pixels[idx_tr + c];
-                float bl = img->pixels[idx_bl + c];
-                float br = img->pixels[idx_br + c];
-                
-                /* Bilinear interpolation formula */
-                float top = tl * (1.0f - x_diff) + tr * x_diff;
-                float bottom = bl * (1.0f - x_diff) + br * x_diff;
-                float value = top * (1.0f - y_diff) + bottom * y_diff;
-                
-                new_pixels[dst_idx + c] = (uint8_t)(value + 0.5f);  /* Round */
-            }
-        }
+
+    size_t row_bytes = (size_t)img->width * 4;
+    for (uint32_t y = 0; y < img->height; y++) {
+        image_stream_push_row(stream, img->pixels + (size_t)y * row_bytes);
     }
-    
+
+    uint32_t out_width = 0, out_height = 0;
+    uint8_t *new_pixels = image_stream_finish(stream, &out_width, &out_height);
+    image_stream_destroy(stream);
+    if (!new_pixels) {
+        log_error("Failed to scale image to %ux%u", plan.out_width, plan.out_height);
+        return img;
+    }
+
     /* Free old pixels and update image */
     free(img->pixels);
     img->pixels = new_pixels;
-    img->width = new_width;
-    img->height = new_height;
-    
+    img->width = out_width;
+    img->height = out_height;
+
     return img;
-}
\ No newline at end of file
+}
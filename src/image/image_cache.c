@@ -0,0 +1,178 @@
+/* Compressed wallpaper cache. See include/neowall/image/image_cache.h.
+ *
+ * Layout: <cache>/neowall/imagebin/<key16>.img
+ *   header: u32 magic, u32 version, u32 pixel_format, u32 width, u32 height,
+ *           u32 reserved, u64 payload length
+ *   payload: the compressed blocks
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "neowall/image/bc1.h"
+#include "neowall/image/image.h"
+#include "neowall/image/image_cache.h"
+
+#define IMAGE_CACHE_MAGIC   0x4349574Eu /* "NWIC" */
+#define IMAGE_CACHE_VERSION 1u          /* bump when the encoder's output changes */
+
+struct image_cache_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t pixel_format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t reserved;
+    uint64_t length;
+};
+
+/* FNV-1a 64-bit, as program_cache.c keys its binaries */
+static uint64_t fnv1a(const void *data, size_t len, uint64_t h) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+/* Resolve (and create) the cache directory. Re-read every call so a changed
+ * XDG_CACHE_HOME — or a test's temporary one — is honoured. */
+static bool cache_dir(char *out, size_t out_len) {
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    int n;
+    if (xdg && xdg[0]) {
+        n = snprintf(out, out_len, "%s/neowall/imagebin", xdg);
+    } else {
+        const char *home = getenv("HOME");
+        if (!home || !home[0]) {
+            return false;
+        }
+        n = snprintf(out, out_len, "%s/.cache/neowall/imagebin", home);
+    }
+    if (n < 0 || (size_t)n >= out_len) {
+        return false;
+    }
+
+    /* mkdir -p */
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s", out);
+    for (char *p = tmp + 1; *p; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            mkdir(tmp, 0755);
+            *p = '/';
+        }
+    }
+    return mkdir(tmp, 0755) == 0 || errno == EEXIST;
+}
+
+static bool cache_path_for(uint64_t key, char *out, size_t out_len) {
+    char dir[512];
+    if (!cache_dir(dir, sizeof(dir))) {
+        return false;
+    }
+    int n = snprintf(out, out_len, "%s/%016llx.img", dir, (unsigned long long)key);
+    return n > 0 && (size_t)n < out_len;
+}
+
+/* Expected payload size for a header, or 0 if the format is unknown. */
+static size_t payload_size(uint32_t pixel_format, uint32_t width, uint32_t height) {
+    switch (pixel_format) {
+    case IMAGE_PIXELS_BC1:
+        return bc1_size(width, height);
+    default:
+        return 0;
+    }
+}
+
+bool image_cache_key(const char *path, int32_t width, int32_t height, int mode, uint64_t *key) {
+    struct stat st;
+    if (!path || !key || stat(path, &st) != 0) {
+        return false;
+    }
+    uint64_t h = fnv1a(path, strlen(path), 0xcbf29ce484222325ull);
+    int64_t fields[] = {
+        (int64_t)st.st_size, (int64_t)st.st_mtim.tv_sec, (int64_t)st.st_mtim.tv_nsec,
+        (int64_t)st.st_ino,  (int64_t)width,             (int64_t)height,
+        (int64_t)mode,       (int64_t)IMAGE_CACHE_VERSION,
+    };
+    *key = fnv1a(fields, sizeof(fields), h);
+    return true;
+}
+
+struct image_data *image_cache_load(uint64_t key) {
+    char path[600];
+    if (!cache_path_for(key, path, sizeof(path))) {
+        return NULL;
+    }
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+
+    struct image_data *img = NULL;
+    struct image_cache_header hdr;
+    if (fread(&hdr, sizeof(hdr), 1, f) == 1 && hdr.magic == IMAGE_CACHE_MAGIC &&
+        hdr.version == IMAGE_CACHE_VERSION && hdr.width > 0 && hdr.height > 0 &&
+        hdr.length == payload_size(hdr.pixel_format, hdr.width, hdr.height)) {
+        img = calloc(1, sizeof(*img));
+        uint8_t *blocks = img ? malloc((size_t)hdr.length) : NULL;
+        if (blocks && fread(blocks, (size_t)hdr.length, 1, f) == 1) {
+            img->pixels = blocks;
+            img->width = hdr.width;
+            img->height = hdr.height;
+            img->channels = 4;
+            img->pixel_format = (enum image_pixel_format)hdr.pixel_format;
+            img->pixels_size = (size_t)hdr.length;
+            snprintf(img->path, sizeof(img->path), "%s", path);
+        } else {
+            free(blocks);
+            free(img);
+            img = NULL;
+        }
+    }
+    fclose(f);
+
+    if (!img) {
+        unlink(path); /* stale/corrupt entry: drop so the next store replaces it */
+    }
+    return img;
+}
+
+bool image_cache_store(uint64_t key, const struct image_data *img) {
+    if (!img || !img->pixels || img->pixels_size == 0 ||
+        img->pixels_size != payload_size(img->pixel_format, img->width, img->height)) {
+        return false;
+    }
+    char path[600], tmp_path[640];
+    if (!cache_path_for(key, path, sizeof(path))) {
+        return false;
+    }
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp.%d", path, getpid());
+
+    FILE *f = fopen(tmp_path, "wb");
+    if (!f) {
+        return false;
+    }
+    struct image_cache_header hdr = {
+        .magic = IMAGE_CACHE_MAGIC,
+        .version = IMAGE_CACHE_VERSION,
+        .pixel_format = (uint32_t)img->pixel_format,
+        .width = img->width,
+        .height = img->height,
+        .reserved = 0,
+        .length = img->pixels_size,
+    };
+    bool wrote = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+                 fwrite(img->pixels, img->pixels_size, 1, f) == 1;
+    wrote = (fclose(f) == 0) && wrote;
+    if (!wrote || rename(tmp_path, path) != 0) { /* rename: atomic publish */
+        unlink(tmp_path);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,212 @@
+/* Row-streaming bilinear resample + centre crop.
+ * See include/neowall/image/image_stream.h. */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "neowall/image/image_stream.h"
+
+struct image_stream {
+    struct image_stream_plan plan;
+    bool resample;
+
+    uint8_t *out;     /* out_width * out_height * 4, owned until finish() */
+    uint8_t *ring[2]; /* source rows, indexed by row parity */
+    uint32_t rows_in; /* source rows committed so far */
+    uint32_t next_row; /* next scaled row to emit */
+
+    float y_ratio;
+
+    /* Horizontal taps for the scaled columns that reach the output
+     * ([win_x, win_x + win_w)), precomputed once instead of per pixel. */
+    uint32_t *x1;
+    uint32_t *x2;
+    float *x_diff;
+
+    uint32_t win_x;    /* first scaled column that reaches the output */
+    uint32_t win_w;    /* number of scaled columns that reach the output */
+    int64_t dst_y_off; /* output row = scaled row + dst_y_off */
+};
+
+static bool plan_valid(const struct image_stream_plan *p) {
+    if (p->src_width == 0 || p->src_height == 0 || p->scaled_width == 0 ||
+        p->scaled_height == 0 || p->out_width == 0 || p->out_height == 0) {
+        return false;
+    }
+    switch (p->place) {
+    case IMAGE_PLACE_NONE:
+        return p->out_width == p->scaled_width && p->out_height == p->scaled_height;
+    case IMAGE_PLACE_CROP:
+        return p->out_width <= p->scaled_width && p->out_height <= p->scaled_height;
+    }
+    return false;
+}
+
+struct image_stream *image_stream_create(const struct image_stream_plan *plan) {
+    if (!plan || !plan_valid(plan)) {
+        return NULL;
+    }
+    if ((size_t)plan->out_width > SIZE_MAX / 4 / plan->out_height) {
+        return NULL;
+    }
+
+    struct image_stream *s = calloc(1, sizeof(*s));
+    if (!s) {
+        return NULL;
+    }
+    s->plan = *plan;
+    s->resample = plan->scaled_width != plan->src_width ||
+                  plan->scaled_height != plan->src_height;
+
+    const uint32_t sw = plan->scaled_width, sh = plan->scaled_height;
+    const uint32_t ow = plan->out_width, oh = plan->out_height;
+    switch (plan->place) {
+    case IMAGE_PLACE_NONE:
+        s->win_w = sw;
+        break;
+    case IMAGE_PLACE_CROP:
+        s->win_x = (sw - ow) / 2;
+        s->win_w = ow;
+        s->dst_y_off = -(int64_t)((sh - oh) / 2);
+        break;
+    }
+
+    size_t out_bytes = (size_t)ow * oh * 4;
+    size_t row_bytes = (size_t)plan->src_width * 4;
+    s->out = malloc(out_bytes);
+    s->ring[0] = malloc(row_bytes);
+    s->ring[1] = malloc(row_bytes);
+    if (!s->out || !s->ring[0] || !s->ring[1]) {
+        image_stream_destroy(s);
+        return NULL;
+    }
+
+    if (s->resample) {
+        s->x1 = malloc(sizeof(*s->x1) * s->win_w);
+        s->x2 = malloc(sizeof(*s->x2) * s->win_w);
+        s->x_diff = malloc(sizeof(*s->x_diff) * s->win_w);
+        if (!s->x1 || !s->x2 || !s->x_diff) {
+            image_stream_destroy(s);
+            return NULL;
+        }
+        const uint32_t w = plan->src_width;
+        float x_ratio = (float)(w - 1) / (float)sw;
+        for (uint32_t i = 0; i < s->win_w; i++) {
+            uint32_t x = s->win_x + i;
+            float src_x = x * x_ratio;
+            s->x1[i] = (uint32_t)src_x;
+            s->x2[i] = (s->x1[i] < w - 1) ? s->x1[i] + 1 : s->x1[i];
+            s->x_diff[i] = src_x - s->x1[i];
+        }
+        s->y_ratio = (float)(plan->src_height - 1) / (float)sh;
+    }
+
+    return s;
+}
+
+/* Last source row scaled row `y` reads. Monotonic in y, which is what lets
+ * two resident rows suffice. */
+static uint32_t row_needs(const struct image_stream *s, uint32_t y, uint32_t *y1_out,
+                          float *y_diff_out) {
+    if (!s->resample) {
+        *y1_out = y;
+        *y_diff_out = 0.0f;
+        return y;
+    }
+    float src_y = y * s->y_ratio;
+    uint32_t y1 = (uint32_t)src_y;
+    uint32_t y2 = (y1 < s->plan.src_height - 1) ? y1 + 1 : y1;
+    *y1_out = y1;
+    *y_diff_out = src_y - y1;
+    return y2;
+}
+
+static void emit_row(struct image_stream *s, uint32_t y, uint32_t y1, uint32_t y2,
+                     float y_diff) {
+    const uint32_t ow = s->plan.out_width, oh = s->plan.out_height;
+    int64_t dy = (int64_t)y + s->dst_y_off;
+    if (dy < 0 || dy >= (int64_t)oh) {
+        return; /* cropped away: the row only had to be consumed */
+    }
+
+    uint8_t *dst = s->out + ((size_t)dy * ow) * 4;
+
+    if (!s->resample) {
+        memcpy(dst, s->ring[y1 & 1] + (size_t)s->win_x * 4, (size_t)s->win_w * 4);
+    } else {
+        const uint8_t *top_row = s->ring[y1 & 1];
+        const uint8_t *bot_row = s->ring[y2 & 1];
+        for (uint32_t i = 0; i < s->win_w; i++) {
+            const uint8_t *tl = top_row + (size_t)s->x1[i] * 4;
+            const uint8_t *tr = top_row + (size_t)s->x2[i] * 4;
+            const uint8_t *bl = bot_row + (size_t)s->x1[i] * 4;
+            const uint8_t *br = bot_row + (size_t)s->x2[i] * 4;
+            float x_diff = s->x_diff[i];
+            for (int c = 0; c < 4; c++) {
+                float top = tl[c] * (1.0f - x_diff) + tr[c] * x_diff;
+                float bottom = bl[c] * (1.0f - x_diff) + br[c] * x_diff;
+                float value = top * (1.0f - y_diff) + bottom * y_diff;
+                dst[(size_t)i * 4 + c] = (uint8_t)(value + 0.5f);
+            }
+        }
+    }
+}
+
+uint8_t *image_stream_row_slot(struct image_stream *s) {
+    if (!s || s->rows_in >= s->plan.src_height) {
+        return NULL;
+    }
+    return s->ring[s->rows_in & 1];
+}
+
+void image_stream_commit_row(struct image_stream *s) {
+    if (!s || s->rows_in >= s->plan.src_height) {
+        return;
+    }
+    s->rows_in++;
+
+    while (s->next_row < s->plan.scaled_height) {
+        uint32_t y1;
+        float y_diff;
+        uint32_t y2 = row_needs(s, s->next_row, &y1, &y_diff);
+        if (y2 >= s->rows_in) {
+            break;
+        }
+        emit_row(s, s->next_row, y1, y2, y_diff);
+        s->next_row++;
+    }
+}
+
+bool image_stream_push_row(struct image_stream *s, const uint8_t *rgba) {
+    uint8_t *slot = image_stream_row_slot(s);
+    if (!slot || !rgba) {
+        return false;
+    }
+    memcpy(slot, rgba, (size_t)s->plan.src_width * 4);
+    image_stream_commit_row(s);
+    return true;
+}
+
+uint8_t *image_stream_finish(struct image_stream *s, uint32_t *width, uint32_t *height) {
+    if (!s || s->rows_in != s->plan.src_height || s->next_row != s->plan.scaled_height) {
+        return NULL;
+    }
+    uint8_t *out = s->out;
+    s->out = NULL;
+    if (width) *width = s->plan.out_width;
+    if (height) *height = s->plan.out_height;
+    return out;
+}
+
+void image_stream_destroy(struct image_stream *s) {
+    if (!s) {
+        return;
+    }
+    free(s->out);
+    free(s->ring[0]);
+    free(s->ring[1]);
+    free(s->x1);
+    free(s->x2);
+    free(s->x_diff);
+    free(s);
+}
@@ -16,6 +16,8 @@
 #include "neowall/shader/shader_multipass.h"
 #include "neowall/shader/manifest.h"
 #include "neowall/render/render.h"  /* Only output.c includes render.h */
+#include "neowall/render/texture_upload.h"
+#include "neowall/image/image_cache.h"
 
 /* Helper function to get the preferred output identifier
  * Prefers connector_name (e.g., "HDMI-A-2", "DP-1") over model name
@@ -257,6 +259,7 @@ struct output_state *output_create(struct neowall_state *state,
     out->preload_image = NULL;
     out->preload_path[0] = '\0';
     atomic_init(&out->preload_ready, false);
+    out->preload_upload = NULL;
 
     /* Initialize background preload thread state */
     pthread_mutex_init(&out->preload_mutex, NULL);
@@ -297,6 +300,8 @@ struct output_state *output_create(struct neowall_state *state,
     out->config->shader_speed = 1.0f;
     out->config->shader_fps = 60;  /* Default 60 FPS */
     out->config->show_fps = false;  /* Default: no FPS watermark */
+    out->config->compress_textures = false;
+    out->config->progressive = true;
     out->config->channel_paths = NULL;
     out->config->channel_count = 0;
 
@@ -405,6 +410,10 @@ void output_destroy(struct output_state *output) {
         image_free(output->preload_decoded_image);
         output->preload_decoded_image = NULL;
     }
+
+    /* The preload thread was joined above, so nothing writes the mapping. */
+    texture_upload_destroy(output->preload_upload);
+    output->preload_upload = NULL;
     pthread_mutex_unlock(&output->preload_mutex);
     pthread_mutex_destroy(&output->preload_mutex);
 
@@ -507,6 +516,11 @@ bool output_create_egl_surface(struct output_state *output) {
 }
 
 /* Background thread function for async image decoding */
+/* How long output_set_wallpaper() will wait for a preload's asynchronous
+ * upload to land before switching to it anyway (GL orders the sampling after
+ * the copy, so the only cost of not waiting is a stall in the first frame). */
+#define PRELOAD_UPLOAD_WAIT_NS (50ULL * 1000000ULL)
+
 struct preload_thread_args {
     struct output_state *output;
     char path[MAX_PATH_LENGTH];
@@ -514,6 +528,10 @@ struct preload_thread_args {
     int32_t height;
     enum wallpaper_mode mode;
     uint64_t generation;
+    uint8_t *staging;       /* mapped upload PBO to write the pixels into, or NULL */
+    size_t staging_size;
+    bool compress;          /* BC1-encode the result (driver supports it) */
+    bool refine;            /* full decode behind a progressive preview */
 };
 
 static void *preload_thread_func(void *arg) {
@@ -534,8 +552,29 @@ static void *preload_thread_func(void *arg) {
         return NULL;
     }
 
+    /* Compressed slideshows keep their BC1 blocks on disk, keyed by file and
+     * display target, so a hit skips both the decode and the encode. */
+    struct image_data *decoded_image = NULL;
+    uint64_t cache_key = 0;
+    bool keyed = args->compress && image_cache_key(args->path, args->width, args->height,
+                                                   args->mode, &cache_key);
+    if (keyed) {
+        decoded_image = image_cache_load(cache_key);
+        if (decoded_image) {
+            snprintf(decoded_image->path, sizeof(decoded_image->path), "%s", args->path);
+            log_debug("Background thread: compressed cache hit for %s", args->path);
+        }
+    }
+
     /* Decode image in background (CPU-bound, no GL context needed) */
-    struct image_data *decoded_image = image_load(args->path, args->width, args->height, args->mode);
+    if (!decoded_image) {
+        decoded_image = image_load(args->path, args->width, args->height, args->mode);
+        if (decoded_image && args->compress && image_compress_bc1(decoded_image)) {
+            if (keyed && !image_cache_store(cache_key, decoded_image)) {
+                log_debug("Background thread: could not cache compressed %s", args->path);
+            }
+        }
+    }
 
     if (!decoded_image) {
         log_error("Background thread: failed to decode image: %s", args->path);
@@ -557,6 +596,21 @@ static void *preload_thread_func(void *arg) {
     log_debug("Background thread: decoded image %s (%ux%u) - ready for GPU upload",
              args->path, decoded_image->width, decoded_image->height);
 
+    /* Copy into the mapped PBO here rather than leave the render thread to
+     * push the whole image through glTexImage2D. Display-targeted decodes
+     * never exceed the display, which is what the mapping was sized for; the
+     * check is for the odd one that does (it takes the direct path). */
+    bool staged = false;
+    bool compressed = decoded_image->pixel_format == IMAGE_PIXELS_BC1;
+    size_t decoded_bytes = compressed ? decoded_image->pixels_size
+                                      : (size_t)decoded_image->width * decoded_image->height * 4;
+    if (args->staging && decoded_image->pixels && (compressed || decoded_image->channels == 4) &&
+        decoded_bytes <= args->staging_size) {
+        memcpy(args->staging, decoded_image->pixels, decoded_bytes);
+        image_free_pixels(decoded_image);
+        staged = true;
+    }
+
     /* Hand off decoded image to main thread for GPU upload */
     pthread_mutex_lock(&output->preload_mutex);
 
@@ -566,6 +620,8 @@ static void *preload_thread_func(void *arg) {
     }
 
     output->preload_decoded_image = decoded_image;
+    output->preload_decoded_staged = staged;
+    output->preload_decoded_refine = args->refine;
     output->preload_generation = args->generation;
     output->preload_width = args->width;
     output->preload_height = args->height;
@@ -582,6 +638,79 @@ static void *preload_thread_func(void *arg) {
     return NULL;
 }
 
+/* Decode `path` on the preload thread. The result is handed back through
+ * preload_decoded_image and uploaded by the event loop: as the next cycle
+ * wallpaper, or with `refine` as the full-quality replacement for the
+ * progressive preview currently on screen. */
+static void preload_launch(struct output_state *output, const char *path, bool refine) {
+    /* Prepare thread arguments */
+    struct preload_thread_args *args = malloc(sizeof(struct preload_thread_args));
+    if (!args) {
+        log_error("Failed to allocate preload thread args");
+        return;
+    }
+
+    args->output = output;
+    snprintf(args->path, sizeof(args->path), "%s", path);
+    args->width = output->width;
+    args->height = output->height;
+    args->mode = output->config->mode;
+    args->generation = atomic_load(&output->preprocessing_generation);
+    args->staging = NULL;
+    args->staging_size = 0;
+    args->compress = false;
+    args->refine = refine;
+
+    /* A decode still waiting for its upload is about to be superseded, and
+     * its pixels may live in the PBO slot the ring hands out next. */
+    pthread_mutex_lock(&output->preload_mutex);
+    if (output->preload_decoded_image) {
+        image_free(output->preload_decoded_image);
+        output->preload_decoded_image = NULL;
+    }
+    atomic_store(&output->preload_upload_pending, false);
+    pthread_mutex_unlock(&output->preload_mutex);
+
+    /* Map an upload PBO for the worker to decode into. Needs the GL context,
+     * which every caller has current; if not, or the ring is busy, the
+     * decoded image takes the direct glTexImage2D path as before. */
+    if (!output->preload_upload) {
+        output->preload_upload = texture_upload_create();
+    }
+    bool gl_current = eglGetCurrentContext() == output->state->egl_context;
+    args->compress = gl_current && output->config->compress_textures &&
+                     render_texture_compression_supported();
+    if (output->preload_upload && args->width > 0 && args->height > 0 && gl_current) {
+        size_t bytes = (size_t)args->width * (size_t)args->height * 4;
+        args->staging = texture_upload_map(output->preload_upload, bytes);
+        if (args->staging) {
+            args->staging_size = bytes;
+        }
+    }
+
+    char preload_path[MAX_PATH_LENGTH];
+    snprintf(preload_path, sizeof(preload_path), "%s", args->path);
+    log_debug("Starting background %s for output %s: %s", refine ? "full decode" : "preload",
+              output->model[0] ? output->model : "unknown", preload_path);
+
+    /* Launch background thread. We keep it joinable so output_destroy can wait
+     * for it deterministically (we never call pthread_cancel — image codecs
+     * aren't async-cancel-safe). */
+    atomic_store(&output->preload_should_stop, false);
+    atomic_store(&output->preload_thread_active, true);
+    atomic_store(&output->preload_thread_join_pending, true);
+    if (pthread_create(&output->preload_thread, NULL, preload_thread_func, args) != 0) {
+        log_error("Failed to create preload thread");
+        atomic_store(&output->preload_thread_active, false);
+        atomic_store(&output->preload_thread_join_pending, false);
+        texture_upload_cancel(output->preload_upload);
+        free(args);
+        return;
+    }
+
+    log_debug("Background preload thread started for: %s", preload_path);
+}
+
 /* Start background preload of next wallpaper (non-blocking) */
 void output_preload_next_wallpaper(struct output_state *output) {
     if (!output || !output->config) {
@@ -617,52 +746,17 @@ void output_preload_next_wallpaper(struct output_state *output) {
         return;
     }
 
-    const char *next_path = output->config->cycle_paths[next_index];
+    char next_path[MAX_PATH_LENGTH];
+    snprintf(next_path, sizeof(next_path), "%s", output->config->cycle_paths[next_index]);
+    pthread_mutex_unlock(&output->state->state_mutex);
 
     /* Check if already preloaded */
     if (atomic_load(&output->preload_ready) && strcmp(output->preload_path, next_path) == 0) {
-        pthread_mutex_unlock(&output->state->state_mutex);
         log_debug("Next wallpaper already preloaded: %s", next_path);
         return;
     }
 
-    /* Prepare thread arguments */
-    struct preload_thread_args *args = malloc(sizeof(struct preload_thread_args));
-    if (!args) {
-        pthread_mutex_unlock(&output->state->state_mutex);
-        log_error("Failed to allocate preload thread args");
-        return;
-    }
-
-    args->output = output;
-    snprintf(args->path, sizeof(args->path), "%s", next_path);
-    args->width = output->width;
-    args->height = output->height;
-    args->mode = output->config->mode;
-    args->generation = atomic_load(&output->preprocessing_generation);
-
-    pthread_mutex_unlock(&output->state->state_mutex);
-
-    char preload_path[MAX_PATH_LENGTH];
-    snprintf(preload_path, sizeof(preload_path), "%s", args->path);
-    log_debug("Starting background preload for output %s: %s",
-              output->model[0] ? output->model : "unknown", preload_path);
-
-    /* Launch background thread. We keep it joinable so output_destroy can wait
-     * for it deterministically (we never call pthread_cancel — image codecs
-     * aren't async-cancel-safe). */
-    atomic_store(&output->preload_should_stop, false);
-    atomic_store(&output->preload_thread_active, true);
-    atomic_store(&output->preload_thread_join_pending, true);
-    if (pthread_create(&output->preload_thread, NULL, preload_thread_func, args) != 0) {
-        log_error("Failed to create preload thread");
-        atomic_store(&output->preload_thread_active, false);
-        atomic_store(&output->preload_thread_join_pending, false);
-        free(args);
-        return;
-    }
-
-    log_debug("Background preload thread started for: %s", preload_path);
+    preload_launch(output, next_path, false);
 }
 
 /* Callback-safe half of geometry handling. Bumping the generation immediately
@@ -770,6 +864,16 @@ void output_set_wallpaper(struct output_state *output, const char *path) {
     GLuint new_texture = 0;
     bool used_preload = false;
 
+    if (output->preload_texture && !atomic_load(&output->preload_ready) &&
+        strcmp(output->preload_path, path) == 0) {
+        /* Its upload is still in flight: give it a moment to land rather
+         * than decoding the same image again. */
+        if (!texture_upload_poll(output->preload_upload, PRELOAD_UPLOAD_WAIT_NS)) {
+            log_debug("Preload upload for %s still in flight, switching anyway", path);
+        }
+        atomic_store(&output->preload_ready, true);
+    }
+
     if (atomic_load(&output->preload_ready) && strcmp(output->preload_path, path) == 0) {
         /* Use preloaded texture - no blocking I/O! */
         log_info("Using preloaded texture for %s (ZERO-STALL transition!)", path);
@@ -780,6 +884,7 @@ void output_set_wallpaper(struct output_state *output, const char *path) {
         /* Clear preload state (we're taking ownership) */
         output->preload_image = NULL;
         output->preload_texture = 0;
+        output->preload_refine = false;
         atomic_store(&output->preload_ready, false);
         output->preload_path[0] = '\0';
     } else {
@@ -808,8 +913,18 @@ void output_set_wallpaper(struct output_state *output, const char *path) {
         output->preload_path[0] = '\0';
         pthread_mutex_unlock(&output->preload_mutex);
 
+        /* A huge file puts a reduced preview up within the frame; the full
+         * decode follows on the preload thread and replaces it in place
+         * (see output_poll_preload_upload). */
+        if (output->config->progressive) {
+            new_image = image_load_preview(path, output->width, output->height,
+                                           output->config->mode);
+        }
+
         /* Load new image with display-aware scaling */
-        new_image = image_load(path, output->width, output->height, output->config->mode);
+        if (!new_image) {
+            new_image = image_load(path, output->width, output->height, output->config->mode);
+        }
         if (!new_image) {
             log_error("Failed to load wallpaper image: %s", path);
             return;
@@ -955,8 +1070,11 @@ void output_set_wallpaper(struct output_state *output, const char *path) {
     /* Mark for redraw */
     atomic_store_explicit(&output->needs_redraw, true, memory_order_release);
 
-    /* Preload next wallpaper if cycling is enabled */
-    if (output->config->cycle && output->config->cycle_count > 1) {
+    /* Finish a preview first; preloading the next wallpaper waits for it.
+     * Otherwise preload next wallpaper if cycling is enabled */
+    if (output->current_image && output->current_image->full_width) {
+        preload_launch(output, path, true);
+    } else if (output->config->cycle && output->config->cycle_count > 1) {
         output_preload_next_wallpaper(output);
     }
 }
@@ -1347,6 +1465,9 @@ nw_result output_set_terminal(struct output_state *output, const char *cmd,
      * updating numbers glide, which is the biggest "feels alive" win. */
     candidate->term_fade =
         output->config->term_fade     >= 0.0f ? output->config->term_fade     : 0.5f;
+    candidate->term_scrollback =
+        output->config->term_scrollback >= 0 ? output->config->term_scrollback : 10000;
+    candidate->term_sdf = output->config->term_sdf;
 
     /* Attach the terminal BEFORE init_gl (init creates the cell/atlas textures
      * sized to the grid) and before compile (nwTerm uniforms must resolve). */
@@ -2395,7 +2516,17 @@ bool output_terminal_key(struct output_state *output, const void *bytes, size_t
     return multipass_terminal_write(output->multipass_shader, bytes, len);
 }
 
-/* Upload preloaded image to GPU and return texture ID */
+bool output_terminal_scroll_page(struct output_state *output, int pages) {
+    if (!output || output->config->type != WALLPAPER_TERMINAL ||
+        !output->multipass_shader) {
+        return false;
+    }
+    return multipass_terminal_scroll_page(output->multipass_shader, pages);
+}
+
+/* Upload preloaded image to GPU and return texture ID. When the worker
+ * decoded into a mapped PBO this only queues the copy; preload_ready is then
+ * left to output_poll_preload_upload() once the upload's fence signals. */
 GLuint output_upload_preload_texture(struct output_state *output) {
     if (!output || !output->preload_decoded_image) {
         return 0;
@@ -2420,7 +2551,21 @@ GLuint output_upload_preload_texture(struct output_state *output) {
     }
 
     /* Upload decoded image to GPU */
-    GLuint new_texture = render_create_texture(output->preload_decoded_image);
+    struct image_data *img = output->preload_decoded_image;
+    GLuint new_texture;
+    bool fenced = false;
+    if (output->preload_decoded_staged && img->pixel_format == IMAGE_PIXELS_BC1) {
+        new_texture = texture_upload_submit_bc1(output->preload_upload, img->width,
+                                                img->height, img->pixels_size);
+        fenced = new_texture != 0;
+    } else if (output->preload_decoded_staged) {
+        new_texture = texture_upload_submit(output->preload_upload, img->width, img->height);
+        fenced = new_texture != 0;
+    } else {
+        texture_upload_cancel(output->preload_upload); /* mapping went unused */
+        new_texture = render_create_texture(img);
+    }
+
     if (new_texture != 0) {
         /* Invalidate GL state cache after texture creation */
         output->gl_state.bound_texture = 0;
@@ -2435,12 +2580,18 @@ GLuint output_upload_preload_texture(struct output_state *output) {
 
         /* Store uploaded texture */
         output->preload_texture = new_texture;
-        output->preload_image = output->preload_decoded_image;
+        output->preload_image = img;
+        output->preload_refine = output->preload_decoded_refine;
         output->preload_decoded_image = NULL;
-        atomic_store(&output->preload_ready, true);
 
-        log_info("GPU upload complete: %s (texture=%u) - ZERO-STALL ready!",
-                 output->preload_path, new_texture);
+        if (fenced) {
+            atomic_store(&output->preload_ready, false);
+            log_debug("GPU upload queued: %s (texture=%u)", output->preload_path, new_texture);
+        } else {
+            atomic_store(&output->preload_ready, true);
+            log_info("GPU upload complete: %s (texture=%u) - ZERO-STALL ready!",
+                     output->preload_path, new_texture);
+        }
     } else {
         log_error("Failed to create preload texture from decoded image");
         image_free(output->preload_decoded_image);
@@ -2450,6 +2601,53 @@ GLuint output_upload_preload_texture(struct output_state *output) {
     return new_texture;
 }
 
+/* Swap a finished full-quality decode in for the progressive preview it was
+ * started for. The layout already matches (render_image_layout sizes a
+ * preview as its full image), so this is a plain texture exchange, mid-
+ * transition or not. If the preview has been replaced since, the texture is
+ * left where it is as an ordinary preload of that path. */
+static void output_apply_refined_image(struct output_state *output) {
+    output->preload_refine = false;
+    struct image_data *preview = output->current_image;
+    if (!preview || !preview->full_width || strcmp(preview->path, output->preload_path) != 0) {
+        return;
+    }
+
+    render_destroy_texture(output->texture);
+    output->texture = output->preload_texture;
+    output->current_image = output->preload_image;
+    output->gl_state.bound_texture = 0;
+    image_free(preview);
+
+    output->preload_texture = 0;
+    output->preload_image = NULL;
+    atomic_store(&output->preload_ready, false);
+    output->preload_path[0] = '\0';
+
+    log_debug("Replaced preview of %s with the full image (%ux%u)", output->config->path,
+              output->current_image->width, output->current_image->height);
+    atomic_store_explicit(&output->needs_redraw, true, memory_order_release);
+
+    output_preload_next_wallpaper(output);
+}
+
+void output_poll_preload_upload(struct output_state *output) {
+    if (!output || !output->preload_texture) {
+        return;
+    }
+    if (!atomic_load(&output->preload_ready)) {
+        if (!texture_upload_poll(output->preload_upload, 0)) {
+            return;
+        }
+        atomic_store(&output->preload_ready, true);
+        log_info("GPU upload complete: %s (texture=%u) - ZERO-STALL ready!",
+                 output->preload_path, output->preload_texture);
+    }
+    if (output->preload_refine) {
+        output_apply_refined_image(output);
+    }
+}
+
 /* Clean up transition resources after transition completes */
 void output_cleanup_transition(struct output_state *output) {
     if (!output) {
@@ -0,0 +1,68 @@
+/* Pure wallpaper placement math. See include/neowall/render/image_layout.h. */
+#include "neowall/render/image_layout.h"
+
+static void layout_full(struct image_layout *layout) {
+    layout->x = 0.0f;
+    layout->y = 0.0f;
+    layout->w = 1.0f;
+    layout->h = 1.0f;
+    layout->tile = false;
+}
+
+/* Centre a draw_w x draw_h pixel box on the output. The margin is floored to
+ * a whole pixel; a negative margin (CENTER overflow) floors the same way the
+ * old CPU crop did, keeping the crop centred. */
+static void layout_centred(uint32_t draw_w, uint32_t draw_h, int32_t out_w, int32_t out_h,
+                           struct image_layout *layout) {
+    int64_t margin_x = ((int64_t)out_w - (int64_t)draw_w) / 2;
+    int64_t margin_y = ((int64_t)out_h - (int64_t)draw_h) / 2;
+    layout->x = (float)margin_x / (float)out_w;
+    layout->y = (float)margin_y / (float)out_h;
+    layout->w = (float)draw_w / (float)out_w;
+    layout->h = (float)draw_h / (float)out_h;
+    layout->tile = false;
+}
+
+void image_layout_compute(enum image_layout_fit fit, uint32_t img_w, uint32_t img_h,
+                          int32_t out_w, int32_t out_h, struct image_layout *layout) {
+    if (!layout) {
+        return;
+    }
+    layout_full(layout);
+    if (img_w == 0 || img_h == 0 || out_w <= 0 || out_h <= 0) {
+        return;
+    }
+
+    switch (fit) {
+    case IMAGE_LAYOUT_FULL:
+        break;
+
+    case IMAGE_LAYOUT_FIT: {
+        /* The decoder already scaled a large image down to fit, so this is
+         * normally 1:1. It still clamps in case the texture outlived a
+         * resize, rather than spilling off the smaller output. */
+        uint32_t draw_w = img_w, draw_h = img_h;
+        if (img_w > (uint32_t)out_w || img_h > (uint32_t)out_h) {
+            double sx = (double)out_w / (double)img_w;
+            double sy = (double)out_h / (double)img_h;
+            double s = sx < sy ? sx : sy;
+            draw_w = (uint32_t)(img_w * s);
+            draw_h = (uint32_t)(img_h * s);
+            if (draw_w == 0) draw_w = 1;
+            if (draw_h == 0) draw_h = 1;
+        }
+        layout_centred(draw_w, draw_h, out_w, out_h, layout);
+        break;
+    }
+
+    case IMAGE_LAYOUT_CENTER:
+        layout_centred(img_w, img_h, out_w, out_h, layout);
+        break;
+
+    case IMAGE_LAYOUT_TILE:
+        layout->w = (float)img_w / (float)out_w;
+        layout->h = (float)img_h / (float)out_h;
+        layout->tile = true;
+        break;
+    }
+}
@@ -537,6 +537,73 @@ GLuint render_create_texture_from_pixels(const uint8_t *pixels, uint32_t width,
     return texture;
 }
 
+/* Is BC1 (S3TC DXT1) texture upload available? GL 3.3 core exposes it only
+ * through GL_EXT_texture_compression_s3tc, which every desktop driver ships
+ * but some (software, GLES-backed) don't. Probed once; the context is shared. */
+bool render_texture_compression_supported(void) {
+    static int supported = -1;
+    if (supported >= 0) {
+        return supported == 1;
+    }
+
+    supported = 0;
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++) {
+        const char *ext = (const char *)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (ext && (strcmp(ext, "GL_EXT_texture_compression_s3tc") == 0 ||
+                    strcmp(ext, "GL_EXT_texture_compression_dxt1") == 0)) {
+            supported = 1;
+            break;
+        }
+    }
+    log_info("BC1 texture compression: %s", supported ? "available" : "not supported by driver");
+    return supported == 1;
+}
+
+/**
+ * Create OpenGL texture from BC1 (DXT1) blocks
+ *
+ * @param blocks BC1 data, bc1_size(width, height) bytes
+ * @param size Size of blocks in bytes
+ * @param width Image width in pixels
+ * @param height Image height in pixels
+ * @return OpenGL texture ID, or 0 on failure
+ */
+GLuint render_create_compressed_texture(const uint8_t *blocks, size_t size,
+                                        uint32_t width, uint32_t height) {
+    if (!blocks || size == 0 || width == 0 || height == 0 || size > INT32_MAX) {
+        log_error("Invalid parameters for compressed texture creation");
+        return 0;
+    }
+
+    /* Note: Caller MUST ensure EGL context is current before calling this function */
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glCompressedTexImage2D(GL_TEXTURE_2D, 0, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, width, height,
+                           0, (GLsizei)size, blocks);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        log_error("OpenGL error creating compressed texture: 0x%x", error);
+        glDeleteTextures(1, &texture);
+        return 0;
+    }
+
+    log_debug("Created BC1 texture %u (%ux%u, %zu bytes)", texture, width, height, size);
+    return texture;
+}
+
 /**
  * Create OpenGL texture from raw pixel data (vertically flipped)
  *
@@ -598,9 +665,15 @@ GLuint render_create_texture(struct image_data *img) {
     }
 
     /* Create texture using new pixel-based API */
-    GLuint texture = render_create_texture_from_pixels(
-        img->pixels, img->width, img->height, img->channels
-    );
+    GLuint texture;
+    if (img->pixel_format == IMAGE_PIXELS_BC1) {
+        texture = render_create_compressed_texture(img->pixels, img->pixels_size,
+                                                   img->width, img->height);
+    } else {
+        texture = render_create_texture_from_pixels(
+            img->pixels, img->width, img->height, img->channels
+        );
+    }
 
     if (texture) {
         /* Free pixel data after successful GPU upload - saves massive amounts of RAM!
@@ -857,39 +930,43 @@ bool render_update_channel_texture(struct output_state *output, size_t channel_i
 
 
 
-/* Calculate vertex coordinates based on display mode for a specific image
- * This function is used by transition modules to properly size images during transitions */
-void calculate_vertex_coords_for_image(struct output_state *output,
-                                        struct image_data *image,
-                                        float vertices[16]) {
-    /* Default: fullscreen quad */
-    memcpy(vertices, quad_vertices, sizeof(quad_vertices));
+/* Where `image` lands on `output` for the configured display mode. The
+ * decoder only scales (and crops FILL/CENTER overflow); letterboxing and
+ * tiling happen in the image shaders from this rect, so the texture is the
+ * picture itself rather than a display-sized copy of it. Used by
+ * render_frame() and by the transitions for both of their images. */
+void render_image_layout(const struct output_state *output, const struct image_data *image,
+                         struct image_layout *layout) {
+    enum image_layout_fit fit = IMAGE_LAYOUT_FULL;
+    if (output && output->config) {
+        switch (output->config->mode) {
+            case MODE_FIT:
+                fit = IMAGE_LAYOUT_FIT;
+                break;
+            case MODE_CENTER:
+                fit = IMAGE_LAYOUT_CENTER;
+                break;
+            case MODE_TILE:
+                fit = IMAGE_LAYOUT_TILE;
+                break;
+            case MODE_FILL:    /* cropped to the display at load time */
+            case MODE_STRETCH: /* scaled to the display at load time */
+            default:
+                break;
+        }
+    }
 
-    if (!image) {
+    if (!output || !image) {
+        image_layout_compute(IMAGE_LAYOUT_FULL, 0, 0, 0, 0, layout);
         return;
     }
-
-    /* All display modes now pre-process images to exact display size during load time:
-     * - MODE_FILL: scaled and center-cropped to exact size
-     * - MODE_FIT: scaled and padded with black borders to exact size
-     * - MODE_CENTER: kept at 1:1 pixels, cropped or padded to exact size
-     * - MODE_STRETCH: scaled to exact size
-     * - MODE_TILE: physically tiled to exact size
-     *
-     * This means we can use a simple fullscreen quad for all modes,
-     * ensuring consistent rendering during both transitions and normal display.
-     * No special vertex or texture coordinate calculations needed! */
-
-    (void)output; /* Unused but kept for API consistency */
+    /* A progressive preview is laid out at the size of the image it stands
+     * in for, so the full-quality swap does not move anything. */
+    uint32_t img_w = image->full_width ? image->full_width : image->width;
+    uint32_t img_h = image->full_width ? image->full_height : image->height;
+    image_layout_compute(fit, img_w, img_h, output->width, output->height, layout);
 }
 
-/* Calculate vertex coordinates based on display mode (uses current_image) */
-static void calculate_vertex_coords(struct output_state *output, float vertices[16]) {
-    calculate_vertex_coords_for_image(output, output->current_image, vertices);
-}
-
-
-
 /* Render shader wallpaper frame using multipass system
  * Matches gleditor's on_gl_render exactly for consistent behavior */
 
@@ -1167,16 +1244,11 @@ bool render_frame(struct output_state *output) {
     GLint pos_attrib = output->program_uniforms.position;
     GLint tex_attrib = output->program_uniforms.texcoord;
 
-    /* Calculate mode-aware vertex coordinates */
-    float mode_vertices[16];
-    calculate_vertex_coords(output, mode_vertices);
-
-    /* Bind VBO and update with mode-specific vertices
-     * NOTE: This still uses DYNAMIC_DRAW because vertices change per mode
-     * For most modes (stretch/fill), we could use the static quad, but
-     * CENTER/FIT/TILE need per-frame vertex adjustments */
+    /* Always the fullscreen quad: display modes are placed in the fragment
+     * shader (see render_image_layout). Re-uploaded because transitions
+     * share this VBO and leave their slid/offset vertices in it. */
     glBindBuffer(GL_ARRAY_BUFFER, output->vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(mode_vertices), mode_vertices, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad_vertices), quad_vertices, GL_DYNAMIC_DRAW);
 
     /* Set up vertex attributes */
     glVertexAttribPointer(pos_attrib, 2, GL_FLOAT, GL_FALSE,
@@ -1227,14 +1299,11 @@ bool render_frame(struct output_state *output) {
         glUniform1f(alpha_uniform, 1.0f);
     }
 
-    /* Handle tile mode texture wrapping - only change when needed */
-    if (output->config->mode == MODE_TILE) {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    } else {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    }
+    /* Place the image for its display mode: rect uniforms for the shader,
+     * and GL_REPEAT on the texture for tile mode */
+    struct image_layout layout;
+    render_image_layout(output, output->current_image, &layout);
+    transition_apply_image_layout(output->program, 0, &layout);
 
     /* Establish blending explicitly (needed for images with transparency). */
     set_blend_state(output, true);
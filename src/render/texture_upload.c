@@ -0,0 +1,210 @@
+/* PBO ring for asynchronous wallpaper uploads.
+ * See include/neowall/render/texture_upload.h. */
+#include <stdlib.h>
+#include <GL/gl.h>
+
+#include "neowall/neowall.h"
+#include "neowall/render/render.h"
+#include "neowall/render/texture_upload.h"
+
+/* One slot being filled by the preload worker, one still draining to the
+ * GPU. Preloads are one wallpaper ahead, so more would never be used. */
+#define TEXTURE_UPLOAD_RING_SIZE 2
+
+struct upload_slot {
+    GLuint pbo;
+    size_t capacity; /* bytes allocated for pbo */
+    GLsync fence;    /* set while an upload sourced from pbo is in flight */
+};
+
+struct texture_upload {
+    struct upload_slot slots[TEXTURE_UPLOAD_RING_SIZE];
+    int mapped;   /* slot handed out by texture_upload_map(), or -1 */
+    int inflight; /* slot of the last submit whose fence is pending, or -1 */
+};
+
+/* Drop a slot's fence if it has signalled (or the wait failed, which is
+ * treated as done rather than holding the slot forever). */
+static bool slot_settle(struct upload_slot *slot, uint64_t timeout_ns) {
+    if (!slot->fence) {
+        return true;
+    }
+    GLenum r = glClientWaitSync(slot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout_ns);
+    if (r == GL_TIMEOUT_EXPIRED) {
+        return false;
+    }
+    if (r == GL_WAIT_FAILED) {
+        log_error("Texture upload fence wait failed: 0x%x", glGetError());
+    }
+    glDeleteSync(slot->fence);
+    slot->fence = 0;
+    return true;
+}
+
+struct texture_upload *texture_upload_create(void) {
+    struct texture_upload *u = calloc(1, sizeof(*u));
+    if (!u) {
+        return NULL;
+    }
+    u->mapped = -1;
+    u->inflight = -1;
+    return u;
+}
+
+void texture_upload_destroy(struct texture_upload *u) {
+    if (!u) {
+        return;
+    }
+    texture_upload_cancel(u);
+    for (int i = 0; i < TEXTURE_UPLOAD_RING_SIZE; i++) {
+        if (u->slots[i].fence) {
+            glDeleteSync(u->slots[i].fence);
+        }
+        if (u->slots[i].pbo) {
+            glDeleteBuffers(1, &u->slots[i].pbo);
+        }
+    }
+    free(u);
+}
+
+uint8_t *texture_upload_map(struct texture_upload *u, size_t bytes) {
+    if (!u || bytes == 0 || bytes > (size_t)PTRDIFF_MAX) {
+        return NULL;
+    }
+    texture_upload_cancel(u);
+
+    /* Prefer a slot with no upload in flight; otherwise take one whose
+     * fence has already signalled. Never wait here. */
+    int pick = -1;
+    for (int i = 0; i < TEXTURE_UPLOAD_RING_SIZE && pick < 0; i++) {
+        if (!u->slots[i].fence) {
+            pick = i;
+        }
+    }
+    for (int i = 0; i < TEXTURE_UPLOAD_RING_SIZE && pick < 0; i++) {
+        if (slot_settle(&u->slots[i], 0)) {
+            if (u->inflight == i) {
+                u->inflight = -1;
+            }
+            pick = i;
+        }
+    }
+    if (pick < 0) {
+        log_debug("Texture upload ring full, falling back to a direct upload");
+        return NULL;
+    }
+
+    struct upload_slot *slot = &u->slots[pick];
+    if (!slot->pbo) {
+        glGenBuffers(1, &slot->pbo);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot->pbo);
+    if (slot->capacity < bytes) {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)bytes, NULL, GL_STREAM_DRAW);
+        slot->capacity = bytes;
+    }
+    /* INVALIDATE: the previous contents are dead, so the driver may hand back
+     * fresh storage instead of syncing with an older upload. */
+    void *ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)bytes,
+                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (!ptr) {
+        log_error("Failed to map texture upload buffer (%zu bytes): 0x%x", bytes, glGetError());
+        slot->capacity = 0; /* reallocate next time */
+        return NULL;
+    }
+
+    u->mapped = pick;
+    return ptr;
+}
+
+/* Shared tail of both submits: unmap, queue the upload, fence it. `size` is
+ * the compressed payload for BC1, 0 for RGBA8. */
+static GLuint submit_mapped(struct texture_upload *u, uint32_t width, uint32_t height,
+                            GLenum compressed_format, size_t size) {
+    if (!u || u->mapped < 0) {
+        return 0;
+    }
+    struct upload_slot *slot = &u->slots[u->mapped];
+    u->mapped = -1;
+
+    size_t needed = compressed_format ? size : (size_t)width * height * 4;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot->pbo);
+    GLboolean intact = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    if (!intact || width == 0 || height == 0 || needed == 0 || needed > slot->capacity) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (!intact) {
+            log_error("Texture upload buffer was lost while mapped");
+        }
+        return 0;
+    }
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    /* With a PBO bound the data argument is an offset into it: this only
+     * queues the copy. */
+    if (compressed_format) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, 0, compressed_format, width, height, 0,
+                               (GLsizei)size, (const void *)0);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                     (const void *)0);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        log_error("OpenGL error queueing texture upload: 0x%x", error);
+        glDeleteTextures(1, &texture);
+        return 0;
+    }
+
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    u->inflight = slot->fence ? (int)(slot - u->slots) : -1;
+
+    log_debug("Queued texture %u upload (%ux%u%s) from PBO %u", texture, width, height,
+              compressed_format ? ", BC1" : "", slot->pbo);
+    return texture;
+}
+
+GLuint texture_upload_submit(struct texture_upload *u, uint32_t width, uint32_t height) {
+    return submit_mapped(u, width, height, 0, 0);
+}
+
+GLuint texture_upload_submit_bc1(struct texture_upload *u, uint32_t width, uint32_t height,
+                                 size_t size) {
+    if (size == 0 || size > INT32_MAX) {
+        texture_upload_cancel(u);
+        return 0;
+    }
+    return submit_mapped(u, width, height, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, size);
+}
+
+void texture_upload_cancel(struct texture_upload *u) {
+    if (!u || u->mapped < 0) {
+        return;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, u->slots[u->mapped].pbo);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    u->mapped = -1;
+}
+
+bool texture_upload_poll(struct texture_upload *u, uint64_t timeout_ns) {
+    if (!u || u->inflight < 0) {
+        return true;
+    }
+    if (!slot_settle(&u->slots[u->inflight], timeout_ns)) {
+        return false;
+    }
+    u->inflight = -1;
+    return true;
+}
@@ -25,8 +25,8 @@
 #include <stdio.h>
 
 #ifdef __linux__
-#include <dirent.h>
-#include <unistd.h>
+#include <pthread.h>
+#include "thermal_sensors.h"
 #endif
 
 /* ============================================================================
@@ -398,29 +398,42 @@ void adaptive_end_frame(adaptive_state_t *state) {
  * Thermal Monitoring (Linux)
  * ============================================================================ */
 
+#ifdef __linux__
+/* One discovered sensor set for the process: every adaptive_state_t polls the
+ * same chips, and discovery walks all of /sys/class/hwmon. */
+static pthread_mutex_t g_thermal_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct thermal_sensors *g_thermal;
+static bool g_thermal_stale;
+#endif
+
 float adaptive_read_gpu_temperature(void) {
 #ifdef __linux__
-    /* Try NVIDIA first */
-    FILE *f = fopen("/sys/class/hwmon/hwmon0/temp1_input", "r");
-    if (!f) {
-        /* Try AMD */
-        f = fopen("/sys/class/drm/card0/device/hwmon/hwmon0/temp1_input", "r");
-    }
-    if (!f) {
-        /* Try generic thermal zone */
-        f = fopen("/sys/class/thermal/thermal_zone0/temp", "r");
+    /* The GPU's own sensor when there is one; otherwise the CPU package,
+     * which on integrated graphics is the die the GPU sits on. */
+    float temp = -1.0f;
+    pthread_mutex_lock(&g_thermal_lock);
+    if (!g_thermal) {
+        g_thermal = thermal_sensors_open(NULL);
+    } else if (g_thermal_stale) {
+        thermal_sensors_rescan(g_thermal);
     }
-    
-    if (f) {
-        int temp_milli = 0;
-        if (fscanf(f, "%d", &temp_milli) == 1) {
-            fclose(f);
-            return (float)temp_milli / 1000.0f;
-        }
-        fclose(f);
+    thermal_reading_t r;
+    thermal_sensors_read(g_thermal, THERMAL_CPU | THERMAL_GPU, &r);
+    /* rediscover next time if a chip stopped answering or nothing was found */
+    bool has_cpu = thermal_sensors_describe(g_thermal, THERMAL_CPU)[0] != '\0';
+    bool has_gpu = thermal_sensors_describe(g_thermal, THERMAL_GPU)[0] != '\0';
+    g_thermal_stale = (!has_cpu && !has_gpu) || (has_cpu && !r.cpu_ok) ||
+                      (has_gpu && !r.gpu_ok);
+    if (r.gpu_c > 0.0f) {
+        temp = r.gpu_c;
+    } else if (r.cpu_c > 0.0f) {
+        temp = r.cpu_c;
     }
-#endif
+    pthread_mutex_unlock(&g_thermal_lock);
+    return temp;
+#else
     return -1.0f;  /* Temperature unavailable */
+#endif
 }
 
 static void update_thermal_state(adaptive_state_t *state, double current_time) {
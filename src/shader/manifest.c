@@ -186,6 +186,12 @@ bool manifest_apply(multipass_shader_t *shader, const char *shader_path) {
         }
     }
 
+    /* --- audio_history: rows in the iAudioHistory spectrogram ring --- */
+    VibeValue *hist = vibe_object_get(root->as_object, "audio_history");
+    if (hist && hist->type == VIBE_TYPE_INTEGER) {
+        multipass_set_audio_history(shader, (int)hist->as_integer);
+    }
+
     /* --- uniforms block: name -> source-keyword | number --- */
     VibeValue *uni = vibe_object_get(root->as_object, "uniforms");
     if (uni && uni->type == VIBE_TYPE_OBJECT) {
@@ -1,10 +1,12 @@
 /* Reactive system data — implementation. See reactive.h.
  *
- * Zero new build dependencies. System metrics come from /proc and /sys. Audio
- * is captured by spawning `parec` (PulseAudio/PipeWire record) on a monitor
- * source and reading raw float32 mono PCM from its stdout on a worker thread;
- * if parec is absent the audio signals stay zero and everything else works.
- * The spectrum is computed with a small radix-2 FFT over a Hann window. */
+ * Zero new build dependencies. System metrics come from /proc and /sys, read
+ * on the sampler thread in reactive_sys.c and merged into the snapshot here. Audio
+ * comes from the output monitor through reactive_capture.c (in-process
+ * libpulse-simple when built with -Dpulse_capture, else a `parec` child) on a
+ * worker thread; if neither is available the audio signals stay zero and
+ * everything else works. The spectrum, bands and onsets come from the
+ * overlapped STFT in reactive_audio.c. */
 
 #define _DEFAULT_SOURCE
 #define _POSIX_C_SOURCE 200809L
@@ -19,6 +21,12 @@
 
 #include "neowall/shader/reactive.h"
 #include "neowall/neowall.h"
+#include "reactive_audio.h"
+#include "reactive_capture.h"
+#include "reactive_nvml.h"
+#include "reactive_seqlock.h"
+#include "reactive_sys.h"
+#include "reactive_trace.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -33,7 +41,6 @@
 #include <signal.h>
 #include <sys/wait.h>
 #include <spawn.h>
-#include <dirent.h>
 
 extern char **environ;
 
@@ -41,33 +48,65 @@ extern char **environ;
 #define M_PI 3.14159265358979323846
 #endif
 
-/* ---- FFT config ---- */
-#define FFT_SIZE 1024              /* must be power of two; bins = FFT_SIZE/2 */
+/* ---- audio capture config ---- */
 #define SAMPLE_RATE 44100
 
 /* ============================================================================
  * Shared state
  * ============================================================================ */
 
+/* Writers (sampler, audio, NVIDIA threads) update the master copy under
+ * g_lock and publish it to g_hot; readers only ever touch the seqlocks. The
+ * audio rows have a single writer (the audio thread) and their own seqlock. */
 static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
 static reactive_snapshot_t g_snap;          /* protected by g_lock */
+static REACTIVE_SEQLOCK(REACTIVE_SEQLOCK_WORDS(sizeof(reactive_snapshot_t))) g_hot;
+static REACTIVE_SEQLOCK(REACTIVE_SEQLOCK_WORDS(sizeof(reactive_audio_t))) g_cold;
+
+/* Per-frame spectrum rows, slot frame % REACTIVE_AUDIO_BACKLOG, each under
+ * its own seqlock so a publish costs one row rather than the whole backlog.
+ * Written by the audio thread only. */
+typedef struct {
+    uint32_t frame;
+    float spectrum[REACTIVE_AUDIO_BINS];
+} audio_row_t;
+static REACTIVE_SEQLOCK(REACTIVE_SEQLOCK_WORDS(sizeof(audio_row_t))) g_rows[REACTIVE_AUDIO_BACKLOG];
 static atomic_bool g_inited = false;
 
 /* audio thread */
 static pthread_t g_audio_thread;
 static atomic_bool g_audio_run = false;
 static atomic_bool g_audio_live = false;
-static pid_t g_parec_pid = -1;
 
-/* nvidia-smi worker thread — polls NVIDIA proprietary GPU stats that sysfs
- * doesn't expose (utilisation, VRAM, temp, power). Published into g_snap under
- * g_lock. Absent driver / no nvidia-smi → g_nv_live stays false, fields zero. */
+/* NVIDIA worker thread — polls NVIDIA proprietary GPU stats that sysfs
+ * doesn't expose (utilisation, VRAM, temp, power) through NVML, or through an
+ * nvidia-smi child if NVML can't be loaded. Published into g_snap under
+ * g_lock. Absent driver → g_nv_live stays false, fields zero. The NVML loop
+ * sleeps on g_nv_wake so a stop request doesn't wait out the poll period. */
 static pthread_t g_nv_thread;
 static atomic_bool g_nv_run = false;
 static atomic_bool g_nv_live = false;
 static pid_t g_nv_pid = -1;
-
-/* input energy accumulators (written from input handlers, decayed in sample) */
+static pthread_mutex_t g_nv_wake_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_nv_wake = PTHREAD_COND_INITIALIZER;
+
+/* /proc + /sys sampler thread; publishes through reactive_publish_sys() */
+static struct reactive_sys *g_sys = NULL;
+
+/* Trace recording (NEOWALL_REACTIVE_RECORD): every publish is appended
+ * under g_lock, timed from g_rec_t0. */
+static struct reactive_trace_writer *g_rec = NULL; /* protected by g_lock */
+static double g_rec_t0;
+
+/* Trace replay (NEOWALL_REACTIVE_REPLAY): loaded in reactive_init, read-only
+ * until reactive_shutdown. While set, no collector runs and the getters
+ * serve the trace. The audio rows follow the frame of the last snapshot
+ * each thread took. */
+static struct reactive_trace *g_replay = NULL;
+static double g_replay_t0;
+static _Thread_local uint32_t t_replay_frame;
+
+/* input energy accumulators (written from input handlers, decayed per sample) */
 static atomic_int g_key_hits = 0;
 static _Atomic float g_mouse_accum = 0.0f;
 
@@ -79,375 +118,49 @@ static float clampf(float v, float lo, float hi) {
     return v < lo ? lo : (v > hi ? hi : v);
 }
 
-/* read whole small file into buf; returns bytes read or -1 */
-static long read_file(const char *path, char *buf, size_t cap) {
-    int fd = open(path, O_RDONLY | O_CLOEXEC);
-    if (fd < 0) return -1;
-    long total = 0;
-    ssize_t n;
-    while ((size_t)total < cap - 1 && (n = read(fd, buf + total, cap - 1 - total)) > 0) {
-        total += n;
-    }
-    close(fd);
-    if (total < 0) return -1;
-    buf[total] = '\0';
-    return total;
-}
-
-/* ============================================================================
- * CPU / RAM / NET / BATTERY / TIME
- * ============================================================================ */
-
-typedef struct { unsigned long long idle, total; } cpu_times_t;
-
-static bool parse_cpu_line(const char *line, cpu_times_t *out) {
-    unsigned long long v[10] = {0};
-    int got = sscanf(line, "cpu%*[^ ] %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
-                     &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7], &v[8], &v[9]);
-    if (got < 4) {
-        /* try the aggregate "cpu " line (no suffix) */
-        got = sscanf(line, "cpu %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
-                     &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7], &v[8], &v[9]);
-        if (got < 4) return false;
-    }
-    unsigned long long total = 0;
-    for (int i = 0; i < 10; i++) total += v[i];
-    out->idle = v[3] + v[4];   /* idle + iowait */
-    out->total = total;
-    return true;
-}
-
-static void sample_cpu(reactive_snapshot_t *s) {
-    static cpu_times_t prev_total = {0};
-    static cpu_times_t prev_core[8] = {{0}};
-
-    char buf[4096];
-    if (read_file("/proc/stat", buf, sizeof(buf)) <= 0) return;
-
-    char *line = buf;
-    int core = 0;
-    bool first = true;
-    while (line && *line) {
-        char *nl = strchr(line, '\n');
-        if (nl) *nl = '\0';
-
-        if (strncmp(line, "cpu", 3) == 0) {
-            cpu_times_t cur;
-            bool is_agg = (line[3] == ' ');
-            if (parse_cpu_line(line, &cur)) {
-                if (is_agg && first) {
-                    unsigned long long dt = cur.total - prev_total.total;
-                    unsigned long long di = cur.idle - prev_total.idle;
-                    if (dt > 0) s->cpu = clampf(1.0f - (float)di / (float)dt, 0.0f, 1.0f);
-                    prev_total = cur;
-                    first = false;
-                } else if (!is_agg && core < 8) {
-                    unsigned long long dt = cur.total - prev_core[core].total;
-                    unsigned long long di = cur.idle - prev_core[core].idle;
-                    if (dt > 0) s->cpu_per[core] = clampf(1.0f - (float)di / (float)dt, 0.0f, 1.0f);
-                    prev_core[core] = cur;
-                    core++;
-                }
-            }
-        } else if (line != buf) {
-            break; /* cpu lines are contiguous at the top of /proc/stat */
-        }
-        line = nl ? nl + 1 : NULL;
-    }
-    s->cpu_cores = core;
-
-    /* derived: hottest core + load imbalance across cores */
-    if (core > 0) {
-        float mx = 0.0f, mean = 0.0f;
-        for (int i = 0; i < core; i++) { mx = fmaxf(mx, s->cpu_per[i]); mean += s->cpu_per[i]; }
-        mean /= (float)core;
-        float var = 0.0f;
-        for (int i = 0; i < core; i++) { float d = s->cpu_per[i] - mean; var += d * d; }
-        var /= (float)core;
-        s->cpu_max = mx;
-        /* spread: normalised std-dev, ~1.0 when a single core is pegged and
-         * the rest idle. sqrt(var) maxes near 0.5 in that case, so scale x2. */
-        s->cpu_spread = clampf(sqrtf(var) * 2.0f, 0.0f, 1.0f);
-    }
-}
-
-static void sample_ram(reactive_snapshot_t *s) {
-    char buf[4096];
-    if (read_file("/proc/meminfo", buf, sizeof(buf)) <= 0) return;
-    unsigned long long total = 0, avail = 0, swtotal = 0, swfree = 0;
-    char *p;
-    if ((p = strstr(buf, "MemTotal:"))) sscanf(p, "MemTotal: %llu", &total);
-    if ((p = strstr(buf, "MemAvailable:"))) sscanf(p, "MemAvailable: %llu", &avail);
-    if ((p = strstr(buf, "SwapTotal:"))) sscanf(p, "SwapTotal: %llu", &swtotal);
-    if ((p = strstr(buf, "SwapFree:"))) sscanf(p, "SwapFree: %llu", &swfree);
-    if (total > 0) {
-        s->ram = clampf(1.0f - (float)avail / (float)total, 0.0f, 1.0f);
-        /* meminfo values are in kiB */
-        s->ram_total_gb = (float)total / (1024.0f * 1024.0f);
-        s->ram_gb = (float)(total - avail) / (1024.0f * 1024.0f);
-    }
-    if (swtotal > 0) s->swap = clampf(1.0f - (float)swfree / (float)swtotal, 0.0f, 1.0f);
-    else s->swap = 0.0f;
-}
-
-static void sample_net(reactive_snapshot_t *s, double dt_sec) {
-    static unsigned long long prev_rx = 0, prev_tx = 0;
-    char buf[16384];
-    if (read_file("/proc/net/dev", buf, sizeof(buf)) <= 0) return;
-
-    unsigned long long rx = 0, tx = 0;
-    char *line = strchr(buf, '\n');       /* skip 2 header lines */
-    if (line) line = strchr(line + 1, '\n');
-    if (line) line++;
-    while (line && *line) {
-        char iface[64];
-        unsigned long long r = 0, t = 0;
-        if (sscanf(line, " %63[^:]: %llu %*u %*u %*u %*u %*u %*u %*u %llu",
-                   iface, &r, &t) == 3) {
-            if (strcmp(iface, "lo") != 0) { rx += r; tx += t; }
-        }
-        char *nl = strchr(line, '\n');
-        line = nl ? nl + 1 : NULL;
-    }
-
-    if (prev_rx != 0 && dt_sec > 0.0) {
-        double dn = (double)(rx - prev_rx) / dt_sec;   /* bytes/sec */
-        double up = (double)(tx - prev_tx) / dt_sec;
-        /* log-scale to 0..1: ~30 MB/s saturates */
-        s->net_down = clampf((float)(log10(1.0 + dn) / log10(3.0e7)), 0.0f, 1.0f);
-        s->net_up   = clampf((float)(log10(1.0 + up) / log10(3.0e7)), 0.0f, 1.0f);
-        /* raw MB/s for shaders that want honest absolute numbers */
-        s->net_down_mbs = (float)(dn / 1.0e6);
-        s->net_up_mbs   = (float)(up / 1.0e6);
-    }
-    prev_rx = rx; prev_tx = tx;
-}
-
-static void sample_battery(reactive_snapshot_t *s) {
-    char buf[256];
-    /* default: assume desktop (full, on AC) */
-    s->battery = 1.0f;
-    s->charging = true;
-    for (int i = 0; i < 4; i++) {
-        char path[128];
-        snprintf(path, sizeof(path), "/sys/class/power_supply/BAT%d/capacity", i);
-        if (read_file(path, buf, sizeof(buf)) > 0) {
-            s->battery = clampf((float)atoi(buf) / 100.0f, 0.0f, 1.0f);
-            snprintf(path, sizeof(path), "/sys/class/power_supply/BAT%d/status", i);
-            if (read_file(path, buf, sizeof(buf)) > 0) {
-                s->charging = (strncmp(buf, "Discharging", 11) != 0);
-            }
-            return;
-        }
-    }
-}
-
-/* --- disk I/O from /proc/diskstats (sums whole physical disks) --- */
-static void sample_disk(reactive_snapshot_t *s, double dt_sec) {
-    static unsigned long long prev_rd = 0, prev_wr = 0;
-    char buf[16384];
-    if (read_file("/proc/diskstats", buf, sizeof(buf)) <= 0) return;
-
-    unsigned long long rd = 0, wr = 0;
-    char *line = buf;
-    while (line && *line) {
-        /* fields: major minor name rd_ios rd_merges rd_sectors ... wr_sectors */
-        char name[64];
-        unsigned long long rsec = 0, wsec = 0;
-        if (sscanf(line, " %*u %*u %63s %*u %*u %llu %*u %*u %*u %llu",
-                   name, &rsec, &wsec) == 3) {
-            /* whole disks only: sd?, nvme?n?, vd?, mmcblk? — skip partitions
-             * (names ending in a digit for sd*, or 'p<digit>' for nvme). */
-            size_t L = strlen(name);
-            bool partition = false;
-            if (L > 0 && name[L-1] >= '0' && name[L-1] <= '9') {
-                if (strncmp(name, "sd", 2) == 0 || strncmp(name, "vd", 2) == 0 ||
-                    strncmp(name, "hd", 2) == 0) partition = true;
-                if (strstr(name, "p") && strncmp(name, "nvme", 4) == 0) partition = true;
-            }
-            if (strncmp(name, "loop", 4) == 0 || strncmp(name, "ram", 3) == 0 ||
-                strncmp(name, "zram", 4) == 0 || strncmp(name, "dm-", 3) == 0) partition = true;
-            if (!partition) { rd += rsec; wr += wsec; }
-        }
-        char *nl = strchr(line, '\n');
-        line = nl ? nl + 1 : NULL;
-    }
-
-    if (prev_rd != 0 && dt_sec > 0.0) {
-        /* sectors are 512 bytes */
-        double rbps = (double)(rd - prev_rd) * 512.0 / dt_sec;
-        double wbps = (double)(wr - prev_wr) * 512.0 / dt_sec;
-        /* log-scale to 0..1: ~500 MB/s saturates (NVMe-friendly) */
-        s->disk_read  = clampf((float)(log10(1.0 + rbps) / log10(5.0e8)), 0.0f, 1.0f);
-        s->disk_write = clampf((float)(log10(1.0 + wbps) / log10(5.0e8)), 0.0f, 1.0f);
-    }
-    prev_rd = rd; prev_wr = wr;
-}
-
-/* --- load average + nproc normalisation --- */
-static void sample_load(reactive_snapshot_t *s) {
-    char buf[256];
-    if (read_file("/proc/loadavg", buf, sizeof(buf)) <= 0) return;
-    double l1 = 0.0;
-    /* loadavg: "0.52 0.48 0.44 1/512 12345" -> last token before space is procs */
-    int total_proc = 0, run_proc = 0;
-    sscanf(buf, "%lf %*f %*f %d/%d", &l1, &run_proc, &total_proc);
-    s->load_raw = (float)l1;
-    long nproc = sysconf(_SC_NPROCESSORS_ONLN);
-    if (nproc < 1) nproc = 1;
-    s->load_avg = clampf((float)(l1 / (double)nproc), 0.0f, 1.0f);
-    if (total_proc > 0) {
-        s->proc_count = total_proc;
-        /* activity proxy: fraction of procs that are runnable */
-        s->procs = clampf((float)run_proc / (float)(nproc * 2), 0.0f, 1.0f);
-    }
-}
-
-/* --- uptime --- */
-static void sample_uptime(reactive_snapshot_t *s) {
-    char buf[128];
-    if (read_file("/proc/uptime", buf, sizeof(buf)) <= 0) return;
-    double up = atof(buf);
-    s->uptime_hours = (float)(up / 3600.0);
-}
-
-/* Read an integer from a sysfs file, or fallback. */
-static long read_long(const char *path, long fallback) {
-    char b[64];
-    if (read_file(path, b, sizeof(b)) > 0) return atol(b);
-    return fallback;
-}
-
-/* --- CPU temperature: scan /sys/class/hwmon for a coretemp/k10temp sensor --- */
-static void sample_cpu_temp(reactive_snapshot_t *s) {
-    DIR *d = opendir("/sys/class/hwmon");
-    if (!d) return;
-    struct dirent *e;
-    float best = 0.0f;
-    while ((e = readdir(d))) {
-        if (e->d_name[0] == '.') continue;
-        char namep[512], name[64] = {0};
-        snprintf(namep, sizeof(namep), "/sys/class/hwmon/%s/name", e->d_name);
-        if (read_file(namep, name, sizeof(name)) <= 0) continue;
-        bool is_cpu = strncmp(name, "coretemp", 8) == 0 ||
-                      strncmp(name, "k10temp", 7) == 0 ||
-                      strncmp(name, "zenpower", 8) == 0 ||
-                      strncmp(name, "cpu_thermal", 11) == 0;
-        if (!is_cpu) continue;
-        /* temp1_input is usually the package; take the max of temp1..temp4 */
-        for (int i = 1; i <= 4; i++) {
-            char tp[512];
-            snprintf(tp, sizeof(tp), "/sys/class/hwmon/%s/temp%d_input", e->d_name, i);
-            long milli = read_long(tp, -1);
-            if (milli > 0) {
-                float c = (float)milli / 1000.0f;
-                if (c > best) best = c;
-            }
-        }
-    }
-    closedir(d);
-    if (best > 0.0f) {
-        s->cpu_temp_c = best;
-        s->cpu_temp = clampf((best - 30.0f) / 65.0f, 0.0f, 1.0f); /* 30..95C */
-    }
+static double mono_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
 }
 
-/* --- GPU usage + temp: amdgpu (gpu_busy_percent), i915, or nvidia hwmon --- */
-static void sample_gpu(reactive_snapshot_t *s) {
-    /* 1) AMD: gpu_busy_percent under /sys/class/drm/cardN/device/ */
-    for (int c = 0; c < 4; c++) {
-        char p[256];
-        snprintf(p, sizeof(p), "/sys/class/drm/card%d/device/gpu_busy_percent", c);
-        long busy = read_long(p, -1);
-        if (busy >= 0) {
-            s->gpu = clampf((float)busy / 100.0f, 0.0f, 1.0f);
-            break;
-        }
-    }
-
-    /* GPU temp: scan hwmon for amdgpu / nouveau / nvidia / i915 */
-    DIR *d = opendir("/sys/class/hwmon");
-    if (d) {
-        struct dirent *e;
-        while ((e = readdir(d))) {
-            if (e->d_name[0] == '.') continue;
-            char namep[512], name[64] = {0};
-            snprintf(namep, sizeof(namep), "/sys/class/hwmon/%s/name", e->d_name);
-            if (read_file(namep, name, sizeof(name)) <= 0) continue;
-            bool is_gpu = strncmp(name, "amdgpu", 6) == 0 ||
-                          strncmp(name, "nouveau", 7) == 0 ||
-                          strncmp(name, "nvidia", 6) == 0 ||
-                          strncmp(name, "i915", 4) == 0;
-            if (!is_gpu) continue;
-            char tp[512];
-            snprintf(tp, sizeof(tp), "/sys/class/hwmon/%s/temp1_input", e->d_name);
-            long milli = read_long(tp, -1);
-            if (milli > 0) {
-                float cc = (float)milli / 1000.0f;
-                s->gpu_temp_c = cc;
-                s->gpu_temp = clampf((cc - 30.0f) / 65.0f, 0.0f, 1.0f);
-            }
-            break;
-        }
-        closedir(d);
-    }
+/* Per-frame keep of the smoothed spectrum row; replay recomputes the rows
+ * from raw frames with the same factor. */
+static float audio_spec_keep(void) {
+    return reactive_stft_rescale(0.5f);
 }
 
-static void sample_time(reactive_snapshot_t *s) {
-    time_t t = time(NULL);
-    struct tm tmv;
-    localtime_r(&t, &tmv);
-    float secs = tmv.tm_hour * 3600.0f + tmv.tm_min * 60.0f + tmv.tm_sec;
-    s->time_of_day = secs / 86400.0f;
-    /* sun elevation proxy: cosine peaking at solar noon (~13:00 local-ish) */
-    float h = secs / 3600.0f;
-    float sun = cosf((h - 13.0f) * (float)M_PI / 12.0f);
-    s->sun = clampf((sun + 0.15f) / 1.15f, 0.0f, 1.0f);
-    s->day_fraction = (float)tmv.tm_yday / 365.0f;
+/* Publish g_snap to readers (and to the trace, when recording). Caller holds
+ * g_lock. */
+static void publish_hot_locked(void) {
+    reactive_seqlock_write(&g_hot.seq, g_hot.words, &g_snap, sizeof(g_snap));
+    if (g_rec) reactive_trace_write_snapshot(g_rec, mono_now() - g_rec_t0, &g_snap);
 }
 
 /* ============================================================================
- * Audio capture + FFT
+ * Audio capture
  * ============================================================================ */
 
-/* FFT lives in reactive_fft.h (include-style) so it can be exposed as a
- * public symbol for unit tests via NEOWALL_TESTING without duplicating code. */
-#include "reactive_fft.h"
-
-#ifdef NEOWALL_TESTING
-    /* Internal call sites use the static name; alias it. */
-#define fft neowall_test_fft
-#endif
-
-/* Spawn `parec` capturing the default monitor as float32 mono @ SAMPLE_RATE.
- * Returns a read fd for the PCM stream, or -1 on failure. */
-static int spawn_parec(pid_t *out_pid) {
-    int pipefd[2];
-    if (pipe(pipefd) != 0) return -1;
-
-    char rate[16];
-    snprintf(rate, sizeof(rate), "%d", SAMPLE_RATE);
-    char *argv[] = {
-        "parec", "--format=float32le", "--channels=1", "--rate", rate,
-        "--latency-msec=30", NULL
-    };
-
-    posix_spawn_file_actions_t fa;
-    posix_spawn_file_actions_init(&fa);
-    posix_spawn_file_actions_adddup2(&fa, pipefd[1], STDOUT_FILENO);
-    posix_spawn_file_actions_addclose(&fa, pipefd[0]);
-    posix_spawn_file_actions_addclose(&fa, pipefd[1]);
-
-    pid_t pid;
-    int rc = posix_spawnp(&pid, "parec", &fa, NULL, argv, environ);
-    posix_spawn_file_actions_destroy(&fa);
-    close(pipefd[1]);
-    if (rc != 0) {
-        close(pipefd[0]);
-        return -1;
+/* Capture backend from the environment: NEOWALL_AUDIO_WAV=<file> plays a
+ * WAV file in a loop, paced in real time (no sound server needed);
+ * NEOWALL_AUDIO_BACKEND=pulse|parec forces one backend. Default: in-process
+ * pulse when built with it, else parec. */
+static void audio_capture_config(reactive_capture_config_t *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->kind = REACTIVE_CAPTURE_AUTO;
+    cfg->sample_rate = SAMPLE_RATE;
+    const char *wav = getenv("NEOWALL_AUDIO_WAV");
+    const char *backend = getenv("NEOWALL_AUDIO_BACKEND");
+    if (wav && wav[0]) {
+        cfg->kind = REACTIVE_CAPTURE_WAV;
+        cfg->wav_path = wav;
+        cfg->wav_realtime = true;
+        cfg->wav_loop = true;
+    } else if (backend && !strcmp(backend, "pulse")) {
+        cfg->kind = REACTIVE_CAPTURE_PULSE;
+    } else if (backend && !strcmp(backend, "parec")) {
+        cfg->kind = REACTIVE_CAPTURE_PAREC;
     }
-    *out_pid = pid;
-    return pipefd[0];
 }
 
 static void *audio_thread_fn(void *arg) {
@@ -455,122 +168,178 @@ static void *audio_thread_fn(void *arg) {
     /* Don't let SIGPIPE from a dying parec kill the process. */
     signal(SIGPIPE, SIG_IGN);
 
-    pid_t pid = -1;
-    int fd = spawn_parec(&pid);
-    if (fd < 0) {
-        log_info("Reactive: audio capture unavailable (parec not found) — "
-                 "audio uniforms will read zero");
+    reactive_capture_config_t cfg;
+    audio_capture_config(&cfg);
+    struct reactive_capture *cap = reactive_capture_open(&cfg);
+    if (!cap) {
+        log_info("Reactive: audio capture unavailable (no pulse/parec%s) — "
+                 "audio uniforms will read zero",
+                 cfg.kind == REACTIVE_CAPTURE_WAV ? ", or unreadable NEOWALL_AUDIO_WAV" : "");
         atomic_store(&g_audio_live, false);
         return NULL;
     }
-    g_parec_pid = pid;
     atomic_store(&g_audio_live, true);
-    log_info("Reactive: audio capture active (parec monitor, %d Hz)", SAMPLE_RATE);
+    log_info("Reactive: audio capture active (%s, %d Hz)", reactive_capture_name(cap),
+             SAMPLE_RATE);
 
-    float window[FFT_SIZE];
-    for (int i = 0; i < FFT_SIZE; i++) {
-        window[i] = 0.5f * (1.0f - cosf(2.0f * (float)M_PI * i / (FFT_SIZE - 1)));
+    struct reactive_stft *stft = reactive_stft_create(SAMPLE_RATE);
+    if (!stft) {
+        log_error("Reactive: out of memory for audio analysis");
+        reactive_capture_close(cap);
+        atomic_store(&g_audio_live, false);
+        return NULL;
     }
 
-    float pcm[FFT_SIZE];
-    int filled = 0;
-    float beat_avg = 0.0f;       /* running average bass energy for onset detect */
+    /* Smoothing constants were tuned at one frame per 1024 samples; scale
+     * them to the hop so the visual response time stays the same. */
+    const float sm = reactive_stft_rescale(0.6f);
+    const float spec_keep = audio_spec_keep();
+    const float beat_decay = reactive_stft_rescale(0.85f);
 
+    /* Rows are smoothed here, outside g_lock, and published on their own;
+     * this thread is their only writer. The frame is large: keep it static
+     * (there is only ever one audio thread). */
+    reactive_audio_t rows;
+    reactive_seqlock_read(&g_cold.seq, g_cold.words, &rows, sizeof(rows));
+    static reactive_stft_frame_t fr;
+    static audio_row_t row;
+
+    /* The capture ring already dropped anything stale, so everything read
+     * here is recent. The timeout bounds how long a stop request waits. */
     while (atomic_load(&g_audio_run)) {
         float chunk[256];
-        ssize_t got = read(fd, chunk, sizeof(chunk));
-        if (got <= 0) {
-            if (got < 0 && (errno == EINTR)) continue;
-            break; /* parec died / EOF */
-        }
-        int samples = (int)(got / sizeof(float));
-        for (int i = 0; i < samples; i++) {
-            pcm[filled++] = chunk[i];
-            if (filled < FFT_SIZE) continue;
-            filled = 0;
-
-            /* RMS loudness */
-            float sum2 = 0.0f;
-            for (int k = 0; k < FFT_SIZE; k++) sum2 += pcm[k] * pcm[k];
-            float rms = sqrtf(sum2 / FFT_SIZE);
-
-            float re[FFT_SIZE], im[FFT_SIZE];
-            for (int k = 0; k < FFT_SIZE; k++) { re[k] = pcm[k] * window[k]; im[k] = 0.0f; }
-            fft(re, im, FFT_SIZE);
-
-            float spec[REACTIVE_AUDIO_BINS];
-            float bass = 0, mid = 0, treble = 0;
-            int bins = FFT_SIZE / 2; /* == REACTIVE_AUDIO_BINS */
-            for (int k = 0; k < bins; k++) {
-                float mag = sqrtf(re[k] * re[k] + im[k] * im[k]) / (FFT_SIZE / 2.0f);
-                /* perceptual: log compress */
-                float v = clampf(log10f(1.0f + mag * 40.0f), 0.0f, 1.0f);
-                spec[k] = v;
-                if (k < bins / 8)        bass += v;
-                else if (k < bins / 2)   mid += v;
-                else                     treble += v;
-            }
-            bass /= (bins / 8); mid /= (bins * 3 / 8); treble /= (bins / 2);
+        int samples = reactive_capture_read(cap, chunk, 256, 100);
+        if (samples < 0) break; /* capture ended: parec died, server gone, EOF */
+        for (int used = 0; used < samples;) {
+            bool ready;
+            used += reactive_stft_push(stft, chunk + used, samples - used, &fr, &ready);
+            if (!ready) continue;
 
-            /* simple beat: bass energy jumping above its running average */
-            float beat = 0.0f;
-            if (bass > beat_avg * 1.4f && bass > 0.15f) beat = 1.0f;
-            beat_avg = beat_avg * 0.92f + bass * 0.08f;
+            for (int k = 0; k < REACTIVE_AUDIO_BINS; k++) {
+                rows.spectrum[k] = rows.spectrum[k] * spec_keep + fr.spectrum[k] * (1 - spec_keep);
+            }
+            memcpy(rows.waveform, fr.waveform, sizeof(rows.waveform));
+            if (++rows.frame == 0) rows.frame = 1;
+            /* the raw frame for the history texture, then the smoothed rows */
+            row.frame = rows.frame;
+            memcpy(row.spectrum, fr.spectrum, sizeof(row.spectrum));
+            {
+                int slot = (int)(row.frame % REACTIVE_AUDIO_BACKLOG);
+                reactive_seqlock_write(&g_rows[slot].seq, g_rows[slot].words, &row, sizeof(row));
+            }
+            /* rows before scalars: a reader that sees audio_frame N finds
+             * rows at least that new */
+            reactive_seqlock_write(&g_cold.seq, g_cold.words, &rows, sizeof(rows));
 
             pthread_mutex_lock(&g_lock);
-            float sm = 0.6f;
-            g_snap.audio_active = true;
-            g_snap.audio_level  = g_snap.audio_level  * sm + clampf(rms * 4.0f, 0, 1) * (1 - sm);
-            g_snap.audio_bass   = g_snap.audio_bass   * sm + clampf(bass, 0, 1)       * (1 - sm);
-            g_snap.audio_mid    = g_snap.audio_mid    * sm + clampf(mid, 0, 1)        * (1 - sm);
-            g_snap.audio_treble = g_snap.audio_treble * sm + clampf(treble, 0, 1)     * (1 - sm);
-            g_snap.audio_beat   = fmaxf(beat, g_snap.audio_beat * 0.85f);
-            for (int k = 0; k < REACTIVE_AUDIO_BINS; k++) {
-                g_snap.audio_spectrum[k] = g_snap.audio_spectrum[k] * 0.5f + spec[k] * 0.5f;
-                g_snap.audio_waveform[k] = clampf(pcm[k * (FFT_SIZE / REACTIVE_AUDIO_BINS)] * 0.5f + 0.5f, 0, 1);
+            if (g_rec) {
+                reactive_trace_write_audio(g_rec, mono_now() - g_rec_t0, fr.spectrum,
+                                           fr.waveform);
             }
+            g_snap.audio_active = true;
+            g_snap.audio_frame  = rows.frame;
+            g_snap.audio_level  = g_snap.audio_level  * sm + clampf(fr.rms * 4.0f, 0, 1) * (1 - sm);
+            g_snap.audio_bass   = g_snap.audio_bass   * sm + clampf(fr.bass, 0, 1)       * (1 - sm);
+            g_snap.audio_mid    = g_snap.audio_mid    * sm + clampf(fr.mid, 0, 1)        * (1 - sm);
+            g_snap.audio_treble = g_snap.audio_treble * sm + clampf(fr.treble, 0, 1)     * (1 - sm);
+            g_snap.audio_beat   = fr.onset ? 1.0f : g_snap.audio_beat * beat_decay;
+            publish_hot_locked();
             pthread_mutex_unlock(&g_lock);
         }
     }
 
-    close(fd);
-    /* Reap parec synchronously — we are the only spawner/owner of g_parec_pid,
-     * so we own the wait. No SIGCHLD handler is installed; we don't need one
-     * because every parec exit (graceful or crash) drops us into this block
-     * via the `break` above, where waitpid() collects the zombie. If parec
-     * already exited on its own, kill() returns ESRCH harmlessly and waitpid
-     * returns immediately. */
-    if (g_parec_pid > 0) {
-        kill(g_parec_pid, SIGTERM);
-        waitpid(g_parec_pid, NULL, 0);
-        g_parec_pid = -1;
+    reactive_stft_destroy(stft);
+    uint64_t dropped = reactive_capture_dropped(cap);
+    if (dropped) {
+        log_debug("Reactive: audio capture dropped %llu stale samples",
+                  (unsigned long long)dropped);
     }
+    reactive_capture_close(cap);
     atomic_store(&g_audio_live, false);
     return NULL;
 }
 
 /* ============================================================================
- * NVIDIA GPU capture (nvidia-smi worker)
+ * NVIDIA GPU capture (NVML, nvidia-smi fallback)
  * ============================================================================
  *
  * sysfs exposes gpu_busy_percent only for amdgpu/i915; the NVIDIA proprietary
- * driver does not. nvidia-smi is the only zero-dependency way to read util,
- * VRAM, temp and power on NVIDIA. We spawn it once in loop mode (`-lms 500`)
- * and parse its CSV stream, mirroring the parec pattern (spawn once, read a
- * stream, reap on exit). If nvidia-smi is absent the thread exits immediately
- * and every nv_* field stays zero. */
-static int spawn_nvsmi(pid_t *out_pid) {
+ * driver does not. The driver's own libnvidia-ml is dlopen'd at runtime
+ * (reactive_nvml.c) and queried directly every NEOWALL_NV_POLL_MS. Without it
+ * we spawn nvidia-smi once in loop mode (`-lms <period>`) and parse its CSV
+ * stream (spawn once, read a stream, reap on exit).
+ * NEOWALL_NV_BACKEND=smi skips NVML. If neither works the thread exits
+ * immediately and every nv_* field stays zero. */
+
+#define NV_POLL_MS_DEFAULT 500
+
+/* Poll period from NEOWALL_NV_POLL_MS, clamped to 50 ms .. 10 s. */
+static int nv_poll_ms(void) {
+    const char *env = getenv("NEOWALL_NV_POLL_MS");
+    int ms = env && env[0] ? atoi(env) : NV_POLL_MS_DEFAULT;
+    if (ms <= 0) ms = NV_POLL_MS_DEFAULT;
+    return ms < 50 ? 50 : (ms > 10000 ? 10000 : ms);
+}
+
+/* Fold one reading into g_snap and publish. */
+static void nv_publish(float util, float vram, float temp_c, float power) {
+    pthread_mutex_lock(&g_lock);
+    atomic_store(&g_nv_live, true);
+    /* light smoothing so beams don't jitter between polls */
+    float sm = 0.5f;
+    g_snap.nv_gpu    = g_snap.nv_gpu    * sm + util  * (1 - sm);
+    g_snap.nv_vram   = g_snap.nv_vram   * sm + vram  * (1 - sm);
+    g_snap.nv_temp_c = temp_c;
+    g_snap.nv_power  = g_snap.nv_power  * sm + power * (1 - sm);
+    g_snap.nv_active = true;
+    publish_hot_locked();
+    pthread_mutex_unlock(&g_lock);
+}
+
+/* Sleep up to `ms`, returning early once stop_nv clears g_nv_run. */
+static void nv_wait(int ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += ms / 1000;
+    deadline.tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    pthread_mutex_lock(&g_nv_wake_lock);
+    while (atomic_load(&g_nv_run) &&
+           pthread_cond_timedwait(&g_nv_wake, &g_nv_wake_lock, &deadline) != ETIMEDOUT) {
+    }
+    pthread_mutex_unlock(&g_nv_wake_lock);
+}
+
+static void nv_run_nvml(struct reactive_nvml *nvml, int period_ms) {
+    while (atomic_load(&g_nv_run)) {
+        reactive_nvml_sample_t s;
+        if (!reactive_nvml_sample(nvml, &s)) {
+            log_info("Reactive: NVIDIA GPU stopped answering NVML queries — "
+                     "nv_* uniforms will read zero");
+            break;
+        }
+        nv_publish(s.util, s.vram, s.temp_c, s.power);
+        nv_wait(period_ms);
+    }
+}
+
+static int spawn_nvsmi(pid_t *out_pid, int period_ms) {
     int pipefd[2];
     if (pipe(pipefd) != 0) return -1;
 
     /* query: util.gpu, mem.used, mem.total, temp, power.draw, power.limit
-     * -lms 500 = emit a fresh CSV row every 500 ms; nounits keeps it numeric. */
+     * -lms N = emit a fresh CSV row every N ms; nounits keeps it numeric. */
+    char period[16];
+    snprintf(period, sizeof(period), "%d", period_ms);
     char *argv[] = {
         "nvidia-smi",
         "--query-gpu=utilization.gpu,memory.used,memory.total,"
         "temperature.gpu,power.draw,power.limit",
         "--format=csv,noheader,nounits",
-        "-lms", "500", NULL
+        "-lms", period, NULL
     };
 
     posix_spawn_file_actions_t fa;
@@ -595,16 +364,29 @@ static void *nv_thread_fn(void *arg) {
     (void)arg;
     signal(SIGPIPE, SIG_IGN);
 
+    int period_ms = nv_poll_ms();
+    const char *backend = getenv("NEOWALL_NV_BACKEND");
+    if (!backend || strcmp(backend, "smi") != 0) {
+        struct reactive_nvml *nvml = reactive_nvml_open(NULL, 0);
+        if (nvml) {
+            log_info("Reactive: NVIDIA GPU capture active (NVML, every %d ms)", period_ms);
+            nv_run_nvml(nvml, period_ms);
+            reactive_nvml_close(nvml);
+            atomic_store(&g_nv_live, false);
+            return NULL;
+        }
+    }
+
     pid_t pid = -1;
-    int fd = spawn_nvsmi(&pid);
+    int fd = spawn_nvsmi(&pid, period_ms);
     if (fd < 0) {
-        log_info("Reactive: NVIDIA capture unavailable (nvidia-smi not found) — "
+        log_info("Reactive: NVIDIA capture unavailable (no NVML or nvidia-smi) — "
                  "nv_* uniforms will read zero");
         atomic_store(&g_nv_live, false);
         return NULL;
     }
     g_nv_pid = pid;
-    log_info("Reactive: NVIDIA GPU capture active (nvidia-smi)");
+    log_info("Reactive: NVIDIA GPU capture active (nvidia-smi, every %d ms)", period_ms);
 
     FILE *fp = fdopen(fd, "r");
     if (!fp) {
@@ -623,17 +405,7 @@ static void *nv_thread_fn(void *arg) {
         float u   = clampf(util / 100.0f, 0.0f, 1.0f);
         float vr  = mem_total > 0.0f ? clampf(mem_used / mem_total, 0.0f, 1.0f) : 0.0f;
         float pw  = plimit > 0.0f ? clampf(pdraw / plimit, 0.0f, 1.0f) : 0.0f;
-
-        pthread_mutex_lock(&g_lock);
-        atomic_store(&g_nv_live, true);
-        /* light smoothing so beams don't jitter between polls */
-        float sm = 0.5f;
-        g_snap.nv_gpu    = g_snap.nv_gpu    * sm + u  * (1 - sm);
-        g_snap.nv_vram   = g_snap.nv_vram   * sm + vr * (1 - sm);
-        g_snap.nv_temp_c = temp;
-        g_snap.nv_power  = g_snap.nv_power  * sm + pw * (1 - sm);
-        g_snap.nv_active = true;
-        pthread_mutex_unlock(&g_lock);
+        nv_publish(u, vr, temp, pw);
     }
 
     fclose(fp);  /* closes fd */
@@ -647,105 +419,19 @@ static void *nv_thread_fn(void *arg) {
 }
 
 /* ============================================================================
- * Public API
- * ============================================================================ */
-
-bool reactive_init(void) {
-    if (atomic_load(&g_inited)) return true;
-    memset(&g_snap, 0, sizeof(g_snap));
-    g_snap.battery = 1.0f;
-    g_snap.charging = true;
-
-    atomic_store(&g_audio_run, true);
-    if (pthread_create(&g_audio_thread, NULL, audio_thread_fn, NULL) != 0) {
-        log_info("Reactive: could not start audio thread");
-        atomic_store(&g_audio_run, false);
-    }
-
-    atomic_store(&g_nv_run, true);
-    if (pthread_create(&g_nv_thread, NULL, nv_thread_fn, NULL) != 0) {
-        log_info("Reactive: could not start NVIDIA thread");
-        atomic_store(&g_nv_run, false);
-    }
-
-    atomic_store(&g_inited, true);
-    log_info("Reactive subsystem initialised");
-    return true;
-}
-
-void reactive_shutdown(void) {
-    if (!atomic_load(&g_inited)) return;
-    /* Both capture threads block in a read()/fgets() on a pipe fed by a child
-     * (parec / nvidia-smi). Clearing the run flag alone does NOT unblock them —
-     * the read only re-checks the flag after it returns. To wake them we make
-     * the pipe hit EOF by killing the child. SIGTERM can be slow or ignored
-     * (observed: nvidia-smi still alive after SIGTERM), and there are startup /
-     * respawn / zombie races where g_*_pid is momentarily stale so the kill
-     * misses entirely — either way the plain pthread_join then hangs forever,
-     * and the daemon has to be SIGKILLed, which orphans the terminal-wallpaper
-     * child.
-     *
-     * So: SIGKILL the child to force EOF, then join with a BOUNDED timeout. If a
-     * thread is still wedged after the grace period we stop waiting and let the
-     * process exit take it down — a never-returning shutdown is far worse than
-     * a detached capture thread the kernel reaps on _exit. */
-    struct timespec deadline;
-
-    if (atomic_load(&g_audio_run)) {
-        atomic_store(&g_audio_run, false);
-        if (g_parec_pid > 0) kill(g_parec_pid, SIGKILL);
-        clock_gettime(CLOCK_REALTIME, &deadline);
-        deadline.tv_sec += 1;   /* 1s grace */
-        if (pthread_timedjoin_np(g_audio_thread, NULL, &deadline) != 0) {
-            /* still stuck — detach so no resource leak, then abandon it */
-            pthread_detach(g_audio_thread);
-            if (g_parec_pid > 0) kill(g_parec_pid, SIGKILL);
-            log_warn("reactive: audio capture thread did not stop in time; abandoning");
-        }
-    }
-    if (atomic_load(&g_nv_run)) {
-        atomic_store(&g_nv_run, false);
-        if (g_nv_pid > 0) kill(g_nv_pid, SIGKILL);
-        clock_gettime(CLOCK_REALTIME, &deadline);
-        deadline.tv_sec += 1;   /* 1s grace */
-        if (pthread_timedjoin_np(g_nv_thread, NULL, &deadline) != 0) {
-            pthread_detach(g_nv_thread);
-            if (g_nv_pid > 0) kill(g_nv_pid, SIGKILL);
-            log_warn("reactive: NVIDIA capture thread did not stop in time; abandoning");
-        }
-    }
-    atomic_store(&g_inited, false);
-}
-
-void reactive_sample(void) {
-    if (!atomic_load(&g_inited)) return;
-
-    static double last = 0.0;
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    double now = ts.tv_sec + ts.tv_nsec / 1e9;
-    double dt = now - last;
-    if (last != 0.0 && dt < 0.25) return;   /* 4 Hz is plenty for these */
-    double prev = last;
-    last = now;
+ * System sampler publish
+ * ============================================================================
+ *
+ * Runs on the sampler thread after every tick. Everything the main loop used
+ * to do at 4 Hz is folded in here: the system fields, input-energy decay,
+ * and the fused shaping signals. */
+static void reactive_publish_sys(const reactive_snapshot_t *sys, bool slow, double dt,
+                                 void *user) {
+    (void)slow;
+    (void)user;
 
     pthread_mutex_lock(&g_lock);
-    sample_cpu(&g_snap);
-    sample_ram(&g_snap);
-    sample_net(&g_snap, prev == 0.0 ? 0.0 : dt);
-    sample_disk(&g_snap, prev == 0.0 ? 0.0 : dt);
-    sample_load(&g_snap);
-    sample_battery(&g_snap);
-    sample_time(&g_snap);
-
-    /* Thermals, GPU, uptime are pricier (sysfs dir scans). Refresh ~1 Hz. */
-    static double last_slow = 0.0;
-    if (last_slow == 0.0 || now - last_slow >= 1.0) {
-        last_slow = now;
-        sample_uptime(&g_snap);
-        sample_cpu_temp(&g_snap);
-        sample_gpu(&g_snap);
-    }
+    reactive_sys_merge(&g_snap, sys);
 
     /* decay + fold in input energy */
     int keys = atomic_exchange(&g_key_hits, 0);
@@ -782,16 +468,235 @@ void reactive_sample(void) {
 
         /* pulse: a heartbeat whose rate rises with activity. Free-running phase
          * accumulator (independent of frame rate); output is a sharp 0..1 beat.
-         * Idle ~0.6 Hz, maxed-out ~2.6 Hz. */
+         * Idle ~0.6 Hz, maxed-out ~2.6 Hz. Only the sampler thread touches it. */
         static double phase = 0.0;
         double rate = 0.6 + 2.0 * (double)g_snap.activity;   /* Hz */
-        if (prev != 0.0) phase += rate * dt;
+        phase += rate * dt;
         phase = fmod(phase, 1.0);
         float b = (float)sin(phase * 2.0 * M_PI);
         b = powf(clampf(b, 0.0f, 1.0f), 3.0f);   /* sharpen into a systolic spike */
         g_snap.pulse = b;
     }
+    publish_hot_locked();
+    pthread_mutex_unlock(&g_lock);
+}
+
+/* ============================================================================
+ * Collectors on demand
+ * ============================================================================
+ *
+ * Each collector runs only while a live shader reads one of its signals.
+ * Demand is reference-counted per REACTIVE_SIG_* bit (one reference per
+ * compiled shader that reads it), so two outputs sharing a shader and then
+ * one switching away leaves the collector running for the other. */
+
+static pthread_mutex_t g_demand_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned g_demand_refs[REACTIVE_SIG_COUNT]; /* protected by g_demand_lock */
+static uint32_t g_demand;                          /* protected by g_demand_lock */
+
+/* The sampler also drives input-energy decay and the fused signals, so it
+ * runs for any demanded bit but the two that own their own threads. */
+#define REACTIVE_SIG_SYS (REACTIVE_SIG_ALL & ~(REACTIVE_SIG_AUDIO | REACTIVE_SIG_NVIDIA))
+
+static void start_audio(void) {
+    if (atomic_load(&g_audio_run)) return;
+    atomic_store(&g_audio_run, true);
+    if (pthread_create(&g_audio_thread, NULL, audio_thread_fn, NULL) != 0) {
+        log_info("Reactive: could not start audio thread");
+        atomic_store(&g_audio_run, false);
+    }
+}
+
+static void start_nv(void) {
+    if (atomic_load(&g_nv_run)) return;
+    atomic_store(&g_nv_run, true);
+    if (pthread_create(&g_nv_thread, NULL, nv_thread_fn, NULL) != 0) {
+        log_info("Reactive: could not start NVIDIA thread");
+        atomic_store(&g_nv_run, false);
+    }
+}
+
+/* With the nvidia-smi fallback, the NVIDIA thread blocks in fgets() on a
+ * pipe fed by the child. Clearing the run flag alone does NOT unblock it — the
+ * read only re-checks the flag after it returns. To wake it we make the pipe
+ * hit EOF by killing the child. (On NVML it sleeps on g_nv_wake, which
+ * stop_nv signals.) (The audio thread waits on its capture ring with a timeout, so it
+ * sees the flag within 100 ms; closing the capture then kills any parec
+ * child the same way.) SIGTERM can be slow or ignored
+ * (observed: nvidia-smi still alive after SIGTERM), and there are startup /
+ * respawn / zombie races where g_*_pid is momentarily stale so the kill
+ * misses entirely — either way the plain pthread_join then hangs forever,
+ * and the daemon has to be SIGKILLed, which orphans the terminal-wallpaper
+ * child.
+ *
+ * So: SIGKILL the child to force EOF, then join with a BOUNDED timeout. If a
+ * thread is still wedged after the grace period we stop waiting and let the
+ * process exit take it down — a never-returning shutdown is far worse than
+ * a detached capture thread the kernel reaps on _exit. */
+static void stop_audio(void) {
+    if (!atomic_load(&g_audio_run)) return;
+    struct timespec deadline;
+    atomic_store(&g_audio_run, false);
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 1;   /* 1s grace */
+    if (pthread_timedjoin_np(g_audio_thread, NULL, &deadline) != 0) {
+        /* still stuck (e.g. a sound server that stopped delivering blocks) —
+         * detach so no resource leak, then abandon it */
+        pthread_detach(g_audio_thread);
+        log_warn("reactive: audio capture thread did not stop in time; abandoning");
+    }
+}
+
+static void stop_nv(void) {
+    if (!atomic_load(&g_nv_run)) return;
+    struct timespec deadline;
+    pthread_mutex_lock(&g_nv_wake_lock);
+    atomic_store(&g_nv_run, false);
+    pthread_cond_broadcast(&g_nv_wake);
+    pthread_mutex_unlock(&g_nv_wake_lock);
+    if (g_nv_pid > 0) kill(g_nv_pid, SIGKILL);
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 1;   /* 1s grace */
+    if (pthread_timedjoin_np(g_nv_thread, NULL, &deadline) != 0) {
+        pthread_detach(g_nv_thread);
+        if (g_nv_pid > 0) kill(g_nv_pid, SIGKILL);
+        log_warn("reactive: NVIDIA capture thread did not stop in time; abandoning");
+    }
+}
+
+/* Bring the running collectors in line with g_demand. Caller holds
+ * g_demand_lock. */
+static void apply_demand_locked(void) {
+    if (!atomic_load(&g_inited) || g_replay) return;
+
+    uint32_t sys = g_demand & REACTIVE_SIG_SYS;
+    if (sys && !g_sys) {
+        struct reactive_sys_config sys_cfg = {
+            .root = NULL,
+            .signals = sys,
+            .publish = reactive_publish_sys,
+        };
+        g_sys = reactive_sys_start(&sys_cfg);
+        if (!g_sys) {
+            log_info("Reactive: could not start system sampler thread — "
+                     "system uniforms will hold their defaults");
+        }
+    } else if (sys) {
+        reactive_sys_set_signals(g_sys, sys);
+    } else if (g_sys) {
+        /* The sampler never blocks on a child, so a plain join is bounded
+         * by one tick's worth of sysfs reads. */
+        reactive_sys_stop(g_sys);
+        g_sys = NULL;
+    }
+
+    if (g_demand & REACTIVE_SIG_AUDIO) start_audio(); else stop_audio();
+    if (g_demand & REACTIVE_SIG_NVIDIA) start_nv(); else stop_nv();
+}
+
+void reactive_demand_acquire(uint32_t signals) {
+    signals &= REACTIVE_SIG_ALL;
+    if (!signals) return;
+    pthread_mutex_lock(&g_demand_lock);
+    uint32_t before = g_demand;
+    for (int i = 0; i < REACTIVE_SIG_COUNT; i++) {
+        if ((signals >> i) & 1u) {
+            g_demand_refs[i]++;
+            g_demand |= 1u << i;
+        }
+    }
+    if (g_demand != before) {
+        log_debug("Reactive: collecting signals 0x%04x", g_demand);
+        apply_demand_locked();
+    }
+    pthread_mutex_unlock(&g_demand_lock);
+}
+
+void reactive_demand_release(uint32_t signals) {
+    signals &= REACTIVE_SIG_ALL;
+    if (!signals) return;
+    pthread_mutex_lock(&g_demand_lock);
+    uint32_t before = g_demand;
+    for (int i = 0; i < REACTIVE_SIG_COUNT; i++) {
+        if (((signals >> i) & 1u) && g_demand_refs[i] > 0 && --g_demand_refs[i] == 0) {
+            g_demand &= ~(1u << i);
+        }
+    }
+    if (g_demand != before) {
+        log_debug("Reactive: collecting signals 0x%04x", g_demand);
+        apply_demand_locked();
+    }
+    pthread_mutex_unlock(&g_demand_lock);
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+/* NEOWALL_REACTIVE_REPLAY / NEOWALL_REACTIVE_RECORD; replay wins if both
+ * are set. A trace that can't be used falls back to live signals. */
+static void open_traces(void) {
+    const char *replay = getenv("NEOWALL_REACTIVE_REPLAY");
+    const char *record = getenv("NEOWALL_REACTIVE_RECORD");
+    if (replay && replay[0]) {
+        g_replay = reactive_trace_load(replay);
+        if (g_replay) {
+            g_replay_t0 = mono_now();
+            log_info("Reactive: replaying %s (%.1f s, %u audio frames) instead of live signals",
+                     replay, reactive_trace_duration(g_replay),
+                     reactive_trace_audio_frames(g_replay));
+            return;
+        }
+        log_error("Reactive: could not load trace %s — using live signals", replay);
+    }
+    if (record && record[0]) {
+        g_rec = reactive_trace_writer_open(record);
+        g_rec_t0 = mono_now();
+        if (g_rec) {
+            log_info("Reactive: recording signals to %s", record);
+        } else {
+            log_error("Reactive: could not create trace %s: %s", record, strerror(errno));
+        }
+    }
+}
+
+bool reactive_init(void) {
+    if (atomic_load(&g_inited)) return true;
+    pthread_mutex_lock(&g_lock);
+    open_traces();
+    memset(&g_snap, 0, sizeof(g_snap));
+    g_snap.battery = 1.0f;
+    g_snap.charging = true;
+    publish_hot_locked();
+    pthread_mutex_unlock(&g_lock);
+
+    pthread_mutex_lock(&g_demand_lock);
+    atomic_store(&g_inited, true);
+    apply_demand_locked();
+    pthread_mutex_unlock(&g_demand_lock);
+
+    log_info("Reactive subsystem initialised (collectors start on demand)");
+    return true;
+}
+
+void reactive_shutdown(void) {
+    if (!atomic_load(&g_inited)) return;
+    pthread_mutex_lock(&g_demand_lock);
+    reactive_sys_stop(g_sys);
+    g_sys = NULL;
+    stop_audio();
+    stop_nv();
+    atomic_store(&g_inited, false);
+    pthread_mutex_unlock(&g_demand_lock);
+
+    pthread_mutex_lock(&g_lock);
+    if (g_rec && !reactive_trace_writer_close(g_rec)) {
+        log_error("Reactive: writing the signal trace failed; it is incomplete");
+    }
+    g_rec = NULL;
     pthread_mutex_unlock(&g_lock);
+    reactive_trace_free(g_replay);
+    g_replay = NULL;
 }
 
 void reactive_note_key(void) {
@@ -806,13 +711,42 @@ void reactive_note_mouse(float dx, float dy) {
 }
 
 void reactive_get(reactive_snapshot_t *out) {
+    reactive_get_at(out, g_replay ? mono_now() - g_replay_t0 : 0.0);
+}
+
+void reactive_get_at(reactive_snapshot_t *out, double t) {
     if (!out) return;
     if (!atomic_load(&g_inited)) { memset(out, 0, sizeof(*out)); out->battery = 1.0f; return; }
-    pthread_mutex_lock(&g_lock);
-    *out = g_snap;
-    pthread_mutex_unlock(&g_lock);
+    if (g_replay) {
+        reactive_trace_snapshot_at(g_replay, t, out);
+        t_replay_frame = out->audio_frame;
+        return;
+    }
+    reactive_seqlock_read(&g_hot.seq, g_hot.words, out, sizeof(*out));
+}
+
+void reactive_get_audio(reactive_audio_t *out) {
+    if (!out) return;
+    if (!atomic_load(&g_inited)) { memset(out, 0, sizeof(*out)); return; }
+    if (g_replay) {
+        reactive_trace_audio(g_replay, t_replay_frame, audio_spec_keep(), out);
+        return;
+    }
+    reactive_seqlock_read(&g_cold.seq, g_cold.words, out, sizeof(*out));
+}
+
+bool reactive_get_audio_row(uint32_t frame, float *out) {
+    if (!out || frame == 0 || !atomic_load(&g_inited)) return false;
+    if (g_replay) return reactive_trace_audio_row(g_replay, frame, out);
+    int slot = (int)(frame % REACTIVE_AUDIO_BACKLOG);
+    static _Thread_local audio_row_t row; /* 2 KB: off the render stack */
+    reactive_seqlock_read(&g_rows[slot].seq, g_rows[slot].words, &row, sizeof(row));
+    if (row.frame != frame) return false;
+    memcpy(out, row.spectrum, sizeof(row.spectrum));
+    return true;
 }
 
 bool reactive_audio_available(void) {
+    if (g_replay) return reactive_trace_audio_frames(g_replay) > 0;
     return atomic_load(&g_audio_live);
 }
@@ -0,0 +1,252 @@
+/* Reactive audio analysis — implementation. See reactive_audio.h. */
+
+#include "reactive_audio.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define N REACTIVE_STFT_SIZE
+#define M (REACTIVE_STFT_SIZE / 2) /* complex FFT length */
+
+/* Onset detector tuning. The threshold tracks the recent flux level over
+ * about a second, so steady music does not fire on every frame and quiet
+ * passages still register their accents. */
+#define ONSET_SIGMAS 2.0f      /* threshold = mean + k * stddev */
+#define ONSET_FLOOR 0.01f      /* ...and never below this absolute flux */
+#define ONSET_TRACK_SEC 1.0f   /* time constant of the mean/variance EMAs */
+#define ONSET_REFRACTORY_SEC 0.1f
+
+struct reactive_stft {
+    int sample_rate;
+
+    float window[N];
+    float tw_re[M], tw_im[M]; /* e^{-2 pi i k / N}, k < N/2 */
+    uint16_t rev[M];          /* bit reversal over log2(M) bits */
+
+    /* mel filterbank: bin k contributes mel_w[k] to band mel_lo[k] and
+     * 1 - mel_w[k] to band mel_lo[k] + 1 (either may be out of range) */
+    int16_t mel_lo[REACTIVE_STFT_BINS];
+    float mel_w[REACTIVE_STFT_BINS];
+    float mel_norm[REACTIVE_MEL_BANDS];
+    float mel_hz[REACTIVE_MEL_BANDS]; /* band centres */
+
+    float ring[N];
+    int head;   /* next write index == oldest sample once full */
+    int filled; /* samples seen, saturating at N */
+    int since;  /* samples since the last frame */
+
+    float prev_mel[REACTIVE_MEL_BANDS];
+    bool have_prev;
+    float flux_mean, flux_var, flux_alpha;
+    int refractory, refractory_frames;
+};
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static float hz_to_mel(float hz) {
+    return 2595.0f * log10f(1.0f + hz / 700.0f);
+}
+
+static float mel_to_hz(float mel) {
+    return 700.0f * (powf(10.0f, mel / 2595.0f) - 1.0f);
+}
+
+static void build_mel(struct reactive_stft *st) {
+    /* REACTIVE_MEL_BANDS triangles between 30 Hz and 16 kHz (or Nyquist),
+     * each spanning its neighbours' centres. */
+    float lo_mel = hz_to_mel(30.0f);
+    float top = fminf(16000.0f, st->sample_rate * 0.5f);
+    float hi_mel = hz_to_mel(top);
+    float edge_hz[REACTIVE_MEL_BANDS + 2];
+    for (int i = 0; i < REACTIVE_MEL_BANDS + 2; i++) {
+        edge_hz[i] = mel_to_hz(lo_mel + (hi_mel - lo_mel) * i / (REACTIVE_MEL_BANDS + 1));
+    }
+    for (int b = 0; b < REACTIVE_MEL_BANDS; b++) {
+        st->mel_hz[b] = edge_hz[b + 1];
+        st->mel_norm[b] = 0.0f;
+    }
+
+    const float bin_hz = (float)st->sample_rate / N;
+    for (int k = 0; k < REACTIVE_STFT_BINS; k++) {
+        float f = k * bin_hz;
+        /* centres are edge_hz[1..B]; find the pair of centres around f */
+        int c = 0;
+        while (c < REACTIVE_MEL_BANDS + 2 && edge_hz[c] <= f) c++;
+        /* f lies in [edge_hz[c-1], edge_hz[c]): rising edge of band c-1,
+         * falling edge of band c-2 */
+        if (c == 0 || c >= REACTIVE_MEL_BANDS + 2) {
+            st->mel_lo[k] = -2; /* outside the filterbank */
+            st->mel_w[k] = 0.0f;
+            continue;
+        }
+        float t = (f - edge_hz[c - 1]) / (edge_hz[c] - edge_hz[c - 1]);
+        st->mel_lo[k] = (int16_t)(c - 2); /* band whose falling edge holds f */
+        st->mel_w[k] = 1.0f - t;          /* its weight; band c-1 gets t */
+        if (c - 2 >= 0) st->mel_norm[c - 2] += 1.0f - t;
+        if (c - 1 < REACTIVE_MEL_BANDS) st->mel_norm[c - 1] += t;
+    }
+}
+
+struct reactive_stft *reactive_stft_create(int sample_rate) {
+    struct reactive_stft *st = calloc(1, sizeof(*st));
+    if (!st) return NULL;
+    st->sample_rate = sample_rate > 0 ? sample_rate : 44100;
+
+    for (int i = 0; i < N; i++) {
+        st->window[i] = 0.5f * (1.0f - cosf(2.0f * (float)M_PI * i / (N - 1)));
+    }
+    for (int k = 0; k < M; k++) {
+        double a = -2.0 * M_PI * k / N;
+        st->tw_re[k] = (float)cos(a);
+        st->tw_im[k] = (float)sin(a);
+    }
+    int bits = 0;
+    while ((1 << bits) < M) bits++;
+    for (int i = 0; i < M; i++) {
+        unsigned r = 0;
+        for (int b = 0; b < bits; b++) {
+            if (i & (1 << b)) r |= 1u << (bits - 1 - b);
+        }
+        st->rev[i] = (uint16_t)r;
+    }
+    build_mel(st);
+
+    float frame_sec = (float)REACTIVE_STFT_HOP / st->sample_rate;
+    st->flux_alpha = 1.0f - expf(-frame_sec / ONSET_TRACK_SEC);
+    st->refractory_frames = (int)ceilf(ONSET_REFRACTORY_SEC / frame_sec);
+    return st;
+}
+
+void reactive_stft_destroy(struct reactive_stft *st) {
+    free(st);
+}
+
+void reactive_stft_real_fft(const struct reactive_stft *st, const float *in,
+                            float *re, float *im) {
+    /* Pack even/odd samples as one complex sequence, in bit-reversed order. */
+    float zr[M], zi[M];
+    for (int m = 0; m < M; m++) {
+        zr[st->rev[m]] = in[2 * m];
+        zi[st->rev[m]] = in[2 * m + 1];
+    }
+
+    /* Iterative radix-2 over M points; the stage-`len` twiddle
+     * e^{-2 pi i k / len} is table entry k * (N / len). */
+    for (int len = 2; len <= M; len <<= 1) {
+        int half = len >> 1;
+        int stride = N / len;
+        for (int i = 0; i < M; i += len) {
+            for (int k = 0; k < half; k++) {
+                float wr = st->tw_re[k * stride], wi = st->tw_im[k * stride];
+                int a = i + k, b = a + half;
+                float tr = wr * zr[b] - wi * zi[b];
+                float ti = wr * zi[b] + wi * zr[b];
+                zr[b] = zr[a] - tr; zi[b] = zi[a] - ti;
+                zr[a] += tr;        zi[a] += ti;
+            }
+        }
+    }
+
+    /* Split: X[k] = E[k] + W^k O[k] with E/O the spectra of the even/odd
+     * samples, recovered from Z[k] and conj(Z[M - k]). */
+    for (int k = 0; k <= M; k++) {
+        int k1 = k & (M - 1), k2 = (M - k) & (M - 1);
+        float a = zr[k1], b = zi[k1], c = zr[k2], d = zi[k2];
+        float er = 0.5f * (a + c), ei = 0.5f * (b - d);
+        float or_ = 0.5f * (b + d), oi = -0.5f * (a - c);
+        float wr = k < M ? st->tw_re[k] : -1.0f;
+        float wi = k < M ? st->tw_im[k] : 0.0f;
+        re[k] = er + wr * or_ - wi * oi;
+        im[k] = ei + wr * oi + wi * or_;
+    }
+}
+
+static void analyse(struct reactive_stft *st, reactive_stft_frame_t *out) {
+    float x[N];
+    float sum2 = 0.0f;
+    for (int i = 0; i < N; i++) {
+        float s = st->ring[(st->head + i) & (N - 1)];
+        sum2 += s * s;
+        x[i] = s * st->window[i];
+        if ((i & 1) == 0) {
+            out->waveform[i >> 1] = clampf(s * 0.5f + 0.5f, 0.0f, 1.0f);
+        }
+    }
+    out->rms = sqrtf(sum2 / N);
+
+    float re[M + 1], im[M + 1];
+    reactive_stft_real_fft(st, x, re, im);
+
+    float mel[REACTIVE_MEL_BANDS] = {0};
+    for (int k = 0; k < REACTIVE_STFT_BINS; k++) {
+        float mag = sqrtf(re[k] * re[k] + im[k] * im[k]) / (N / 2.0f);
+        /* perceptual: log compress */
+        float v = clampf(log10f(1.0f + mag * 40.0f), 0.0f, 1.0f);
+        out->spectrum[k] = v;
+        int b = st->mel_lo[k];
+        if (b >= 0) mel[b] += v * st->mel_w[k];
+        if (b + 1 >= 0 && b + 1 < REACTIVE_MEL_BANDS) mel[b + 1] += v * (1.0f - st->mel_w[k]);
+    }
+
+    float bass = 0.0f, mid = 0.0f, treble = 0.0f;
+    int nb = 0, nm = 0, nt = 0;
+    float flux = 0.0f;
+    for (int b = 0; b < REACTIVE_MEL_BANDS; b++) {
+        float v = st->mel_norm[b] > 0.0f ? mel[b] / st->mel_norm[b] : 0.0f;
+        out->mel[b] = v;
+        if (st->mel_hz[b] < REACTIVE_BASS_MAX_HZ)     { bass += v; nb++; }
+        else if (st->mel_hz[b] < REACTIVE_MID_MAX_HZ) { mid += v; nm++; }
+        else                                          { treble += v; nt++; }
+        if (st->have_prev) flux += fmaxf(0.0f, v - st->prev_mel[b]);
+        st->prev_mel[b] = v;
+    }
+    out->bass = nb ? bass / nb : 0.0f;
+    out->mid = nm ? mid / nm : 0.0f;
+    out->treble = nt ? treble / nt : 0.0f;
+    flux /= REACTIVE_MEL_BANDS;
+    out->flux = flux;
+
+    /* Onset: flux above the recent mean by ONSET_SIGMAS deviations. */
+    float thresh = fmaxf(st->flux_mean + ONSET_SIGMAS * sqrtf(st->flux_var), ONSET_FLOOR);
+    out->onset = st->have_prev && st->refractory == 0 && flux > thresh;
+    if (out->onset) {
+        st->refractory = st->refractory_frames;
+    } else if (st->refractory > 0) {
+        st->refractory--;
+    }
+    float d = flux - st->flux_mean;
+    st->flux_mean += st->flux_alpha * d;
+    st->flux_var = (1.0f - st->flux_alpha) * (st->flux_var + st->flux_alpha * d * d);
+    st->have_prev = true;
+}
+
+int reactive_stft_push(struct reactive_stft *st, const float *pcm, int n,
+                       reactive_stft_frame_t *out, bool *ready) {
+    *ready = false;
+    int used = 0;
+    while (used < n) {
+        st->ring[st->head] = pcm[used++];
+        st->head = (st->head + 1) & (N - 1);
+        if (st->filled < N) st->filled++;
+        st->since++;
+        if (st->filled == N && st->since >= REACTIVE_STFT_HOP) {
+            st->since = 0;
+            analyse(st, out);
+            *ready = true;
+            break;
+        }
+    }
+    return used;
+}
+
+float reactive_stft_rescale(float per_1024) {
+    return powf(per_1024, (float)REACTIVE_STFT_HOP / (float)REACTIVE_STFT_SIZE);
+}
@@ -0,0 +1,473 @@
+/* Reactive audio capture — implementation. See reactive_capture.h. */
+
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "reactive_capture.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef NEOWALL_HAVE_PULSE
+#include <pulse/simple.h>
+#endif
+
+extern char **environ;
+
+struct reactive_capture {
+    reactive_capture_kind_t kind;
+    int sample_rate;
+    int block;              /* samples per capture block */
+
+    /* ring: w - r samples buffered, at most cap; guarded by mu */
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+    float *buf;
+    int cap;
+    uint64_t w, r;
+    uint64_t dropped;
+    bool ended;
+
+    pthread_t thread;
+    bool running;           /* thread was started */
+    atomic_bool stop;
+
+    /* parec */
+    pid_t pid;
+    int fd;
+
+#ifdef NEOWALL_HAVE_PULSE
+    pa_simple *pa;
+#endif
+
+    /* wav */
+    FILE *wav;
+    long wav_data;          /* file offset of the first sample */
+    uint32_t wav_bytes;     /* length of the data chunk */
+    int wav_channels;
+    int wav_bits;           /* 16 (PCM) or 32 (float) */
+    bool wav_realtime, wav_loop;
+};
+
+/* ============================================================================
+ * Ring
+ * ============================================================================ */
+
+/* Producer side: append, overwriting the oldest samples when full. */
+static void ring_write(struct reactive_capture *c, const float *src, int n) {
+    pthread_mutex_lock(&c->mu);
+    for (int i = 0; i < n; i++) {
+        c->buf[c->w % (uint64_t)c->cap] = src[i];
+        c->w++;
+    }
+    if (c->w - c->r > (uint64_t)c->cap) {
+        c->dropped += c->w - c->r - (uint64_t)c->cap;
+        c->r = c->w - (uint64_t)c->cap;
+    }
+    pthread_cond_signal(&c->cv);
+    pthread_mutex_unlock(&c->mu);
+}
+
+static void ring_end(struct reactive_capture *c) {
+    pthread_mutex_lock(&c->mu);
+    c->ended = true;
+    pthread_cond_broadcast(&c->cv);
+    pthread_mutex_unlock(&c->mu);
+}
+
+int reactive_capture_read(struct reactive_capture *c, float *out, int max, int timeout_ms) {
+    if (!c || !out || max <= 0) return -1;
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&c->mu);
+    while (c->w == c->r && !c->ended) {
+        if (pthread_cond_timedwait(&c->cv, &c->mu, &deadline) == ETIMEDOUT) break;
+    }
+    int n = (int)(c->w - c->r < (uint64_t)max ? c->w - c->r : (uint64_t)max);
+    for (int i = 0; i < n; i++) {
+        out[i] = c->buf[(c->r + (uint64_t)i) % (uint64_t)c->cap];
+    }
+    c->r += (uint64_t)n;
+    bool ended = c->ended;
+    pthread_mutex_unlock(&c->mu);
+
+    if (n == 0 && ended) return -1;
+    return n;
+}
+
+uint64_t reactive_capture_dropped(struct reactive_capture *c) {
+    if (!c) return 0;
+    pthread_mutex_lock(&c->mu);
+    uint64_t d = c->dropped;
+    pthread_mutex_unlock(&c->mu);
+    return d;
+}
+
+const char *reactive_capture_name(const struct reactive_capture *c) {
+    if (!c) return "none";
+    switch (c->kind) {
+        case REACTIVE_CAPTURE_PULSE: return "pulse";
+        case REACTIVE_CAPTURE_PAREC: return "parec";
+        case REACTIVE_CAPTURE_WAV:   return "wav";
+        default:                     return "none";
+    }
+}
+
+/* ============================================================================
+ * pulse (libpulse-simple)
+ * ============================================================================ */
+
+#ifdef NEOWALL_HAVE_PULSE
+static bool pulse_open(struct reactive_capture *c) {
+    pa_sample_spec ss = {
+        .format = PA_SAMPLE_FLOAT32LE,
+        .rate = (uint32_t)c->sample_rate,
+        .channels = 1,
+    };
+    /* fragsize is what bounds latency on a record stream: the server hands
+     * us audio every block instead of batching up to its default ~2 s.
+     * maxlength caps the server-side queue at the same horizon as our ring. */
+    uint32_t block_bytes = (uint32_t)c->block * sizeof(float);
+    pa_buffer_attr ba = {
+        .maxlength = (uint32_t)c->cap * sizeof(float),
+        .tlength = (uint32_t)-1,
+        .prebuf = (uint32_t)-1,
+        .minreq = (uint32_t)-1,
+        .fragsize = block_bytes,
+    };
+    int err = 0;
+    c->pa = pa_simple_new(NULL, "neowall", PA_STREAM_RECORD, "@DEFAULT_MONITOR@",
+                          "reactive audio", &ss, NULL, &ba, &err);
+    return c->pa != NULL;
+}
+
+static void *pulse_thread(void *arg) {
+    struct reactive_capture *c = arg;
+    float *blk = malloc(sizeof(float) * (size_t)c->block);
+    if (blk) {
+        /* pa_simple_read returns once per fragment, so the stop flag is seen
+         * within one block. */
+        while (!atomic_load(&c->stop)) {
+            int err = 0;
+            if (pa_simple_read(c->pa, blk, sizeof(float) * (size_t)c->block, &err) < 0) break;
+            ring_write(c, blk, c->block);
+        }
+        free(blk);
+    }
+    ring_end(c);
+    return NULL;
+}
+#endif
+
+/* ============================================================================
+ * parec (child process)
+ * ============================================================================ */
+
+/* Spawn `parec` on the default monitor as float32 mono, stdout to a pipe. */
+static bool parec_open(struct reactive_capture *c, int latency_ms) {
+    int pipefd[2];
+    if (pipe(pipefd) != 0) return false;
+
+    char rate[16], latency[32];
+    snprintf(rate, sizeof(rate), "%d", c->sample_rate);
+    snprintf(latency, sizeof(latency), "--latency-msec=%d", latency_ms);
+    char *argv[] = {
+        "parec", "--device=@DEFAULT_MONITOR@", "--format=float32le", "--channels=1",
+        "--rate", rate, latency, NULL
+    };
+
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_adddup2(&fa, pipefd[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&fa, pipefd[0]);
+    posix_spawn_file_actions_addclose(&fa, pipefd[1]);
+
+    pid_t pid;
+    int rc = posix_spawnp(&pid, "parec", &fa, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&fa);
+    close(pipefd[1]);
+    if (rc != 0) {
+        close(pipefd[0]);
+        return false;
+    }
+    c->pid = pid;
+    c->fd = pipefd[0];
+    return true;
+}
+
+static void *parec_thread(void *arg) {
+    struct reactive_capture *c = arg;
+    /* Drain the pipe as fast as parec fills it so nothing queues there; the
+     * ring decides what is stale. A read may end mid-sample, so carry the
+     * partial bytes over. */
+    union {
+        float f[256];
+        unsigned char b[256 * sizeof(float)];
+    } u;
+    size_t have = 0;
+    while (!atomic_load(&c->stop)) {
+        ssize_t got = read(c->fd, u.b + have, sizeof(u.b) - have);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break; /* parec died / EOF / killed by close */
+        have += (size_t)got;
+        int samples = (int)(have / sizeof(float));
+        if (samples > 0) ring_write(c, u.f, samples);
+        size_t rest = have - (size_t)samples * sizeof(float);
+        memmove(u.b, u.b + (size_t)samples * sizeof(float), rest);
+        have = rest;
+    }
+    ring_end(c);
+    return NULL;
+}
+
+/* ============================================================================
+ * wav (file)
+ * ============================================================================ */
+
+static uint32_t le32(const unsigned char *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint16_t le16(const unsigned char *p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+/* Parse the RIFF header far enough to find the format and the data chunk. */
+static bool wav_open(struct reactive_capture *c, const char *path) {
+    if (!path) return false;
+    c->wav = fopen(path, "rb");
+    if (!c->wav) return false;
+
+    unsigned char hdr[12];
+    if (fread(hdr, 1, 12, c->wav) != 12 || memcmp(hdr, "RIFF", 4) != 0 ||
+        memcmp(hdr + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    bool have_fmt = false;
+    int format = 0;
+    for (;;) {
+        unsigned char ch[8];
+        if (fread(ch, 1, 8, c->wav) != 8) return false;
+        uint32_t size = le32(ch + 4);
+        if (memcmp(ch, "fmt ", 4) == 0) {
+            unsigned char fmt[40];
+            uint32_t take = size < sizeof(fmt) ? size : (uint32_t)sizeof(fmt);
+            if (size < 16 || fread(fmt, 1, take, c->wav) != take ||
+                fseek(c->wav, (long)(size - take) + (size & 1), SEEK_CUR) != 0) {
+                return false;
+            }
+            format = le16(fmt);
+            c->wav_channels = le16(fmt + 2);
+            if ((int)le32(fmt + 4) != c->sample_rate) return false;
+            c->wav_bits = le16(fmt + 14);
+            if (format == 0xFFFE && take >= 26) format = le16(fmt + 24); /* extensible */
+            have_fmt = true;
+        } else if (memcmp(ch, "data", 4) == 0) {
+            if (!have_fmt) return false;
+            c->wav_data = ftell(c->wav);
+            c->wav_bytes = size;
+            break;
+        } else if (fseek(c->wav, (long)size + (size & 1), SEEK_CUR) != 0) {
+            return false; /* chunks are word aligned, hence the pad byte */
+        }
+    }
+
+    bool pcm16 = format == 1 && c->wav_bits == 16;
+    bool f32 = format == 3 && c->wav_bits == 32;
+    return (pcm16 || f32) && c->wav_channels >= 1 && c->wav_channels <= 8;
+}
+
+/* Read up to `frames` frames from the data chunk as mono floats. Returns
+ * the number read; 0 at the end of the data. */
+static int wav_read(struct reactive_capture *c, float *out, int frames, uint32_t *pos) {
+    int bytes_per_frame = c->wav_channels * c->wav_bits / 8;
+    uint32_t left = (c->wav_bytes - *pos) / (uint32_t)bytes_per_frame;
+    if ((uint32_t)frames > left) frames = (int)left;
+    unsigned char raw[8 * 4 * 64];
+    int done = 0;
+    while (done < frames) {
+        int n = frames - done;
+        int fit = (int)sizeof(raw) / bytes_per_frame;
+        if (n > fit) n = fit;
+        if (fread(raw, (size_t)bytes_per_frame, (size_t)n, c->wav) != (size_t)n) break;
+        for (int i = 0; i < n; i++) {
+            const unsigned char *f = raw + i * bytes_per_frame;
+            float acc = 0.0f;
+            for (int ch = 0; ch < c->wav_channels; ch++) {
+                if (c->wav_bits == 16) {
+                    acc += (float)(int16_t)le16(f + ch * 2) / 32768.0f;
+                } else {
+                    uint32_t bits = le32(f + ch * 4);
+                    float v;
+                    memcpy(&v, &bits, sizeof(v));
+                    acc += v;
+                }
+            }
+            out[done + i] = acc / (float)c->wav_channels;
+        }
+        done += n;
+        *pos += (uint32_t)(n * bytes_per_frame);
+    }
+    return done;
+}
+
+static void *wav_thread(void *arg) {
+    struct reactive_capture *c = arg;
+    float *blk = malloc(sizeof(float) * (size_t)c->block);
+    uint32_t pos = 0;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    long block_ns = (long)((double)c->block * 1e9 / c->sample_rate);
+
+    while (blk && !atomic_load(&c->stop)) {
+        int n = wav_read(c, blk, c->block, &pos);
+        if (n == 0) {
+            if (!c->wav_loop || pos == 0) break;
+            pos = 0;
+            if (fseek(c->wav, c->wav_data, SEEK_SET) != 0) break;
+            continue;
+        }
+        if (c->wav_realtime) {
+            /* absolute schedule: a block is released when it would have been
+             * captured, with no drift from wakeup latency */
+            next.tv_nsec += block_ns;
+            while (next.tv_nsec >= 1000000000L) {
+                next.tv_sec++;
+                next.tv_nsec -= 1000000000L;
+            }
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR) { }
+            if (atomic_load(&c->stop)) break;
+        }
+        ring_write(c, blk, n);
+    }
+    free(blk);
+    ring_end(c);
+    return NULL;
+}
+
+/* ============================================================================
+ * Open / close
+ * ============================================================================ */
+
+/* Release backend resources; the producer thread must not be running. */
+static void capture_free(struct reactive_capture *c) {
+    if (c->fd >= 0) close(c->fd);
+    if (c->pid > 0) {
+        kill(c->pid, SIGKILL);
+        waitpid(c->pid, NULL, 0);
+    }
+#ifdef NEOWALL_HAVE_PULSE
+    if (c->pa) pa_simple_free(c->pa);
+#endif
+    if (c->wav) fclose(c->wav);
+    pthread_cond_destroy(&c->cv);
+    pthread_mutex_destroy(&c->mu);
+    free(c->buf);
+    free(c);
+}
+
+static struct reactive_capture *capture_new(const reactive_capture_config_t *cfg,
+                                            reactive_capture_kind_t kind) {
+    struct reactive_capture *c = calloc(1, sizeof(*c));
+    if (!c) return NULL;
+    c->kind = kind;
+    c->sample_rate = cfg->sample_rate > 0 ? cfg->sample_rate : 44100;
+    int latency_ms = cfg->latency_ms > 0 ? cfg->latency_ms : REACTIVE_CAPTURE_LATENCY_MS;
+    c->block = c->sample_rate * latency_ms / 1000;
+    if (c->block < 64) c->block = 64;
+    int ring_ms = cfg->ring_ms > 0 ? cfg->ring_ms : latency_ms * REACTIVE_CAPTURE_RING_BLOCKS;
+    c->cap = c->sample_rate * ring_ms / 1000;
+    if (c->cap < 64) c->cap = 64;
+    c->pid = -1;
+    c->fd = -1;
+    c->wav_realtime = cfg->wav_realtime;
+    c->wav_loop = cfg->wav_loop;
+
+    c->buf = malloc(sizeof(float) * (size_t)c->cap);
+    pthread_condattr_t ca;
+    pthread_condattr_init(&ca);
+    pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+    pthread_cond_init(&c->cv, &ca);
+    pthread_condattr_destroy(&ca);
+    pthread_mutex_init(&c->mu, NULL);
+    if (!c->buf) {
+        capture_free(c);
+        return NULL;
+    }
+    return c;
+}
+
+static struct reactive_capture *capture_try(const reactive_capture_config_t *cfg,
+                                            reactive_capture_kind_t kind) {
+    struct reactive_capture *c = capture_new(cfg, kind);
+    if (!c) return NULL;
+    int latency_ms = cfg->latency_ms > 0 ? cfg->latency_ms : REACTIVE_CAPTURE_LATENCY_MS;
+
+    void *(*fn)(void *) = NULL;
+    bool ok = false;
+    switch (kind) {
+#ifdef NEOWALL_HAVE_PULSE
+        case REACTIVE_CAPTURE_PULSE:
+            ok = pulse_open(c);
+            fn = pulse_thread;
+            break;
+#endif
+        case REACTIVE_CAPTURE_PAREC:
+            ok = parec_open(c, latency_ms);
+            fn = parec_thread;
+            break;
+        case REACTIVE_CAPTURE_WAV:
+            ok = wav_open(c, cfg->wav_path);
+            fn = wav_thread;
+            break;
+        default:
+            break;
+    }
+    if (!ok || pthread_create(&c->thread, NULL, fn, c) != 0) {
+        capture_free(c);
+        return NULL;
+    }
+    c->running = true;
+    return c;
+}
+
+struct reactive_capture *reactive_capture_open(const reactive_capture_config_t *cfg) {
+    if (!cfg) return NULL;
+    if (cfg->kind != REACTIVE_CAPTURE_AUTO) return capture_try(cfg, cfg->kind);
+
+    struct reactive_capture *c = NULL;
+#ifdef NEOWALL_HAVE_PULSE
+    c = capture_try(cfg, REACTIVE_CAPTURE_PULSE);
+#endif
+    if (!c) c = capture_try(cfg, REACTIVE_CAPTURE_PAREC);
+    return c;
+}
+
+void reactive_capture_close(struct reactive_capture *c) {
+    if (!c) return;
+    if (c->running) {
+        atomic_store(&c->stop, true);
+        /* The parec producer sits in read() on the pipe; force EOF. SIGKILL,
+         * not SIGTERM, for the reasons given at stop_audio in reactive.c. */
+        if (c->pid > 0) kill(c->pid, SIGKILL);
+        pthread_join(c->thread, NULL);
+    }
+    capture_free(c);
+}
@@ -0,0 +1,71 @@
+/* Audio capture for the reactive subsystem: mono float32 PCM from the
+ * default output monitor, delivered through a small ring that drops stale
+ * audio instead of queuing it.
+ *
+ * The audio thread used to spawn `parec` and read() its stdout directly. That
+ * added process-start latency, and because the pipe buffers ~64 KB (~370 ms
+ * of float audio), any stall on our side came back as lag that never drained.
+ * Now a producer thread per capture fills a ring sized to a few capture
+ * blocks; when the consumer falls behind, the oldest samples are overwritten,
+ * so the analysis always sees the most recent audio.
+ *
+ * Backends:
+ *   - pulse: in-process libpulse-simple record stream on @DEFAULT_MONITOR@
+ *     with a fixed fragment size (built with -Dpulse_capture, works on
+ *     PipeWire through pipewire-pulse);
+ *   - parec: the old child-process capture, kept as the fallback;
+ *   - wav:   a RIFF/WAVE file, optionally paced in real time and looped. Used
+ *     by the tests and for running audio shaders without a sound server.
+ *
+ * Log-free and independent of the rest of reactive.c so
+ * tests/test_reactive_capture.c can drive it with WAV files.
+ */
+
+#ifndef NEOWALL_REACTIVE_CAPTURE_H
+#define NEOWALL_REACTIVE_CAPTURE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define REACTIVE_CAPTURE_LATENCY_MS 20 /* default capture block */
+#define REACTIVE_CAPTURE_RING_BLOCKS 4 /* default ring: this many blocks */
+
+typedef enum {
+    REACTIVE_CAPTURE_AUTO = 0, /* pulse when built in and reachable, else parec */
+    REACTIVE_CAPTURE_PULSE,
+    REACTIVE_CAPTURE_PAREC,
+    REACTIVE_CAPTURE_WAV,
+} reactive_capture_kind_t;
+
+typedef struct {
+    reactive_capture_kind_t kind;
+    int sample_rate;      /* Hz; the stream is always mono float32 */
+    int latency_ms;       /* capture block length; 0 = REACTIVE_CAPTURE_LATENCY_MS */
+    int ring_ms;          /* stale-drop horizon; 0 = REACTIVE_CAPTURE_RING_BLOCKS blocks */
+    const char *wav_path; /* REACTIVE_CAPTURE_WAV: file to play */
+    bool wav_realtime;    /* pace the file at its sample rate (else as fast as read) */
+    bool wav_loop;        /* restart at end of data instead of ending the stream */
+} reactive_capture_config_t;
+
+struct reactive_capture;
+
+/* Open a capture and start its producer thread. For AUTO, falls back from
+ * pulse to parec. A WAV file must match cfg->sample_rate and be 16-bit PCM
+ * or 32-bit float (any channel count; downmixed to mono). NULL on failure. */
+struct reactive_capture *reactive_capture_open(const reactive_capture_config_t *cfg);
+
+/* Take up to `max` of the oldest buffered samples, waiting up to timeout_ms
+ * for some to arrive. Returns the count, 0 on timeout, or -1 once the stream
+ * has ended (EOF, capture error or child exit) and the ring is drained. */
+int reactive_capture_read(struct reactive_capture *c, float *out, int max, int timeout_ms);
+
+/* Stop the producer (killing a parec child), join it and free everything. */
+void reactive_capture_close(struct reactive_capture *c);
+
+/* "pulse", "parec" or "wav". */
+const char *reactive_capture_name(const struct reactive_capture *c);
+
+/* Samples overwritten before they were read, since open. */
+uint64_t reactive_capture_dropped(struct reactive_capture *c);
+
+#endif /* NEOWALL_REACTIVE_CAPTURE_H */
@@ -1,8 +1,9 @@
-/* Radix-2 Cooley-Tukey FFT used by the reactive audio path.
+/* Radix-2 Cooley-Tukey complex FFT, the reference transform for the reactive
+ * audio path.
  *
- * Extracted from reactive.c so it can be unit-tested without spinning up the
- * audio capture thread or parec subprocess. The implementation is identical
- * to what was inlined; reactive.c now includes this header-style file.
+ * Originally inlined in reactive.c's audio thread; the thread now runs the
+ * table-driven real-input STFT in reactive_audio.c, and this straightforward
+ * version is kept as the oracle tests/test_reactive_audio.c checks it against.
  *
  * `re` and `im` are length `n` (must be a power of two), modified in place.
  *
@@ -0,0 +1,116 @@
+/* NVML telemetry — implementation. See reactive_nvml.h. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "reactive_nvml.h"
+
+#include <dlfcn.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ---- the subset of nvml.h used here ---- */
+typedef int nvmlReturn_t;
+typedef struct nvmlDevice_st *nvmlDevice_t;
+typedef struct {
+    unsigned int gpu;    /* percent of time a kernel ran over the last period */
+    unsigned int memory; /* percent of time device memory was read or written */
+} nvmlUtilization_t;
+typedef struct {
+    unsigned long long total, free, used; /* bytes */
+} nvmlMemory_t;
+
+#define NVML_SUCCESS 0
+#define NVML_TEMPERATURE_GPU 0
+
+struct reactive_nvml {
+    void *lib;
+    nvmlDevice_t dev;
+    nvmlReturn_t (*shutdown)(void);
+    nvmlReturn_t (*utilization)(nvmlDevice_t, nvmlUtilization_t *);
+    nvmlReturn_t (*memory)(nvmlDevice_t, nvmlMemory_t *);
+    nvmlReturn_t (*temperature)(nvmlDevice_t, int, unsigned int *);
+    nvmlReturn_t (*power_usage)(nvmlDevice_t, unsigned int *);       /* mW; optional */
+    nvmlReturn_t (*power_limit)(nvmlDevice_t, unsigned int *);       /* mW; optional */
+};
+
+/* dlsym into a function pointer without the object/function pointer cast
+ * that ISO C leaves undefined (and -Wpedantic rejects). */
+static bool sym(void *lib, const char *name, void *fn_ptr) {
+    void *p = dlsym(lib, name);
+    if (!p) return false;
+    memcpy(fn_ptr, &p, sizeof(p));
+    return true;
+}
+
+static float clamp01(float v) {
+    return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+}
+
+struct reactive_nvml *reactive_nvml_open(const char *library, unsigned index) {
+    void *lib = dlopen(library ? library : REACTIVE_NVML_LIBRARY, RTLD_NOW | RTLD_LOCAL);
+    if (!lib) return NULL;
+
+    struct reactive_nvml *nv = calloc(1, sizeof(*nv));
+    nvmlReturn_t (*init)(void) = NULL;
+    nvmlReturn_t (*by_index)(unsigned int, nvmlDevice_t *) = NULL;
+    if (!nv || !sym(lib, "nvmlInit_v2", &init) ||
+        !sym(lib, "nvmlShutdown", &nv->shutdown) ||
+        !sym(lib, "nvmlDeviceGetHandleByIndex_v2", &by_index) ||
+        !sym(lib, "nvmlDeviceGetUtilizationRates", &nv->utilization) ||
+        !sym(lib, "nvmlDeviceGetMemoryInfo", &nv->memory) ||
+        !sym(lib, "nvmlDeviceGetTemperature", &nv->temperature)) {
+        free(nv);
+        dlclose(lib);
+        return NULL;
+    }
+    sym(lib, "nvmlDeviceGetPowerUsage", &nv->power_usage);
+    sym(lib, "nvmlDeviceGetEnforcedPowerLimit", &nv->power_limit);
+
+    if (init() != NVML_SUCCESS) {
+        free(nv);
+        dlclose(lib);
+        return NULL;
+    }
+    if (by_index(index, &nv->dev) != NVML_SUCCESS) {
+        nv->shutdown();
+        free(nv);
+        dlclose(lib);
+        return NULL;
+    }
+    nv->lib = lib;
+    return nv;
+}
+
+bool reactive_nvml_sample(struct reactive_nvml *nv, reactive_nvml_sample_t *out) {
+    if (!nv || !out) return false;
+    memset(out, 0, sizeof(*out));
+
+    nvmlUtilization_t util;
+    if (nv->utilization(nv->dev, &util) != NVML_SUCCESS) return false;
+    out->util = clamp01((float)util.gpu / 100.0f);
+
+    nvmlMemory_t mem;
+    if (nv->memory(nv->dev, &mem) == NVML_SUCCESS && mem.total > 0) {
+        out->vram = clamp01((float)((double)mem.used / (double)mem.total));
+    }
+
+    unsigned int temp;
+    if (nv->temperature(nv->dev, NVML_TEMPERATURE_GPU, &temp) == NVML_SUCCESS) {
+        out->temp_c = (float)temp;
+    }
+
+    unsigned int draw, limit;
+    if (nv->power_usage && nv->power_limit &&
+        nv->power_usage(nv->dev, &draw) == NVML_SUCCESS &&
+        nv->power_limit(nv->dev, &limit) == NVML_SUCCESS && limit > 0) {
+        out->power = clamp01((float)draw / (float)limit);
+    }
+    return true;
+}
+
+void reactive_nvml_close(struct reactive_nvml *nv) {
+    if (!nv) return;
+    nv->shutdown();
+    dlclose(nv->lib);
+    free(nv);
+}
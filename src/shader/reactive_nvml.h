@@ -0,0 +1,49 @@
+/* NVIDIA GPU telemetry for the reactive subsystem through NVML
+ * (libnvidia-ml), loaded at runtime with dlopen.
+ *
+ * The NVIDIA thread used to keep an `nvidia-smi -lms 500` child alive and
+ * parse its CSV output: a second process that costs CPU of its own, starts
+ * slowly, and has to be killed to stop the thread. NVML is the library
+ * nvidia-smi itself is built on. Here each sample is five direct calls
+ * (utilisation, memory, temperature, power draw and limit) made at whatever
+ * rate the caller picks. Nothing is linked at build time: if the driver's
+ * library isn't installed, reactive_nvml_open fails and reactive.c falls back
+ * to nvidia-smi.
+ *
+ * Only the handful of NVML entry points used here are declared, with the
+ * types from nvml.h they need, so no CUDA/NVML headers are required.
+ *
+ * Log-free, so tests/test_reactive_nvml.c can drive it against a stub
+ * library (tests/stub_nvml.c) without NVIDIA hardware.
+ */
+
+#ifndef NEOWALL_REACTIVE_NVML_H
+#define NEOWALL_REACTIVE_NVML_H
+
+#include <stdbool.h>
+
+#define REACTIVE_NVML_LIBRARY "libnvidia-ml.so.1"
+
+typedef struct {
+    float util;   /* GPU utilisation 0..1 */
+    float vram;   /* memory used / total 0..1 */
+    float temp_c; /* GPU core temperature, degrees C */
+    float power;  /* board power draw / enforced limit 0..1 (0 if unsupported) */
+} reactive_nvml_sample_t;
+
+struct reactive_nvml;
+
+/* dlopen `library` (NULL = REACTIVE_NVML_LIBRARY), initialise NVML and pick
+ * GPU `index`. NULL if the library, a required symbol, the driver or the
+ * device is missing. */
+struct reactive_nvml *reactive_nvml_open(const char *library, unsigned index);
+
+/* Query the device once. Readings the GPU does not support (power on many
+ * laptop parts) read 0. Returns false if utilisation could not be read:
+ * the GPU fell off the bus or the driver was unloaded. */
+bool reactive_nvml_sample(struct reactive_nvml *nv, reactive_nvml_sample_t *out);
+
+/* Shut NVML down and dlclose. NULL is a no-op. */
+void reactive_nvml_close(struct reactive_nvml *nv);
+
+#endif /* NEOWALL_REACTIVE_NVML_H */
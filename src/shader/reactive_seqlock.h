@@ -0,0 +1,83 @@
+/* Seqlock for publishing reactive snapshots to lock-free readers.
+ *
+ * The render path reads the reactive snapshot once per frame per output; the
+ * sampler, audio and NVIDIA threads write it. With a mutex, a reader could
+ * stall behind the audio thread. Here readers never block and never write
+ * shared memory: they copy the payload and retry if a writer was active.
+ *
+ * The payload is stored as atomic 32-bit words so the concurrent copy is not
+ * a data race in the C11 model. The writer bumps the sequence to odd, stores
+ * the words with release and publishes the even sequence with release. The
+ * reader loads the sequence, copies the words with acquire and re-checks the
+ * sequence: a reader that saw any word of a newer publish is then guaranteed
+ * to see the odd (or newer) sequence and retry. This is the fence-free form
+ * from Boehm's "Can seqlocks get along with programming language memory
+ * models?" (MSPC 2012); on x86 the per-word orderings are plain moves, and
+ * unlike standalone fences ThreadSanitizer models them.
+ *
+ * Writers must be serialised by the caller. A single writer thread needs
+ * nothing; several writers share a mutex that readers never touch.
+ *
+ * Header-only and dependency-free so tests/test_reactive_seqlock.c can
+ * stress it under ThreadSanitizer. */
+
+#ifndef NEOWALL_REACTIVE_SEQLOCK_H
+#define NEOWALL_REACTIVE_SEQLOCK_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Words needed to hold an object of `bytes` bytes. */
+#define REACTIVE_SEQLOCK_WORDS(bytes) (((bytes) + 3) / 4)
+
+/* Declare a seqlock holding `nwords` words:
+ *   struct { atomic_uint seq; _Atomic uint32_t words[nwords]; } */
+#define REACTIVE_SEQLOCK(nwords)                                               \
+    struct {                                                                   \
+        atomic_uint seq;                                                       \
+        _Atomic uint32_t words[nwords];                                        \
+    }
+
+/* Publish `bytes` bytes from `src`. Caller serialises writers. */
+static inline void reactive_seqlock_write(atomic_uint *seq, _Atomic uint32_t *words,
+                                          const void *src, size_t bytes) {
+    unsigned s = atomic_load_explicit(seq, memory_order_relaxed);
+    atomic_store_explicit(seq, s + 1, memory_order_relaxed);
+
+    const unsigned char *p = src;
+    size_t n = REACTIVE_SEQLOCK_WORDS(bytes);
+    for (size_t i = 0; i < n; i++) {
+        uint32_t w = 0;
+        size_t take = bytes - i * 4 < 4 ? bytes - i * 4 : 4;
+        memcpy(&w, p + i * 4, take);
+        atomic_store_explicit(&words[i], w, memory_order_release);
+    }
+
+    atomic_store_explicit(seq, s + 2, memory_order_release);
+}
+
+/* Copy a consistent `bytes`-byte payload into `dst`. Returns the sequence it
+ * read at (even; bumps by 2 per publish). */
+static inline unsigned reactive_seqlock_read(atomic_uint *seq, _Atomic uint32_t *words,
+                                             void *dst, size_t bytes) {
+    unsigned char *p = dst;
+    size_t n = REACTIVE_SEQLOCK_WORDS(bytes);
+    for (;;) {
+        unsigned s1 = atomic_load_explicit(seq, memory_order_acquire);
+        if (s1 & 1u) {
+            continue; /* writer mid-publish: at most a 4 KB copy away */
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint32_t w = atomic_load_explicit(&words[i], memory_order_acquire);
+            size_t take = bytes - i * 4 < 4 ? bytes - i * 4 : 4;
+            memcpy(p + i * 4, &w, take);
+        }
+        if (atomic_load_explicit(seq, memory_order_relaxed) == s1) {
+            return s1;
+        }
+    }
+}
+
+#endif /* NEOWALL_REACTIVE_SEQLOCK_H */
@@ -0,0 +1,642 @@
+/* Reactive system sampler — implementation. See reactive_sys.h.
+ *
+ * The parsers are the ones reactive.c ran on the main loop, unchanged in
+ * what they read and how they scale it; the previous-sample counters they
+ * kept in function statics now live in struct reactive_sys.
+ *
+ * Files are opened once and re-read with pread(fd, ..., 0): procfs and sysfs
+ * regenerate their contents on every read from offset 0, so a steady-state
+ * fast tick is one syscall per file instead of open + read + read + close
+ * plus a path walk. The table remembers misses too (BAT1..3, card1..3 on a
+ * typical desktop), and both misses and sysfs hits are rechecked on slow
+ * ticks so a hot-plugged battery or GPU is picked up within one slow
+ * period. Temperature sensors are found and cached by thermal_sensors.c,
+ * which rediscovers them the same way. */
+
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "reactive_sys.h"
+#include "thermal_sensors.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define REACTIVE_SYS_FAST_PERIOD 0.25 /* 4 Hz is plenty for these */
+#define REACTIVE_SYS_SLOW_PERIOD 1.0  /* thermals, GPU, uptime: dir scans */
+
+#define REACTIVE_SYS_MAX_FDS    48 /* 6 procfs + battery + GPU busy */
+
+typedef struct { unsigned long long idle, total; } cpu_times_t;
+
+/* One remembered file. fd == -1 is a remembered miss. */
+struct sys_fd {
+    char path[160]; /* root-relative, as passed to read_file() */
+    int fd;
+    dev_t dev;      /* identity at open time, for sysfs revalidation */
+    ino_t ino;
+};
+
+struct reactive_sys {
+    struct reactive_sys_config cfg;
+    char root[256];
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool stop;         /* protected by lock */
+    bool force;        /* protected by lock: tick now, slow (signals added) */
+    uint32_t signals;  /* protected by lock */
+    uint32_t sampled;  /* sampler thread: signals of the previous tick */
+
+    reactive_snapshot_t snap; /* sampler-thread private */
+
+    cpu_times_t prev_total;
+    cpu_times_t prev_core[8];
+    unsigned long long prev_rx, prev_tx;
+    unsigned long long prev_rd, prev_wr;
+
+    struct sys_fd fds[REACTIVE_SYS_MAX_FDS];
+    int nfds;
+
+    /* CPU/GPU temperature inputs; opened on the first slow tick that wants
+     * them, rediscovered while stale */
+    struct thermal_sensors *thermal;
+    bool thermal_stale;
+};
+
+/* ============================================================================
+ * Small helpers
+ * ============================================================================ */
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static void sys_path(const struct reactive_sys *rs, const char *path, char *out, size_t cap) {
+    snprintf(out, cap, "%s%s", rs->root, path);
+}
+
+/* Read a whole small file with pread from offset 0; stops on a short read,
+ * which is EOF for procfs/sysfs. Returns bytes read or -1. */
+static long pread_all(int fd, char *buf, size_t cap) {
+    size_t total = 0;
+    while (total < cap - 1) {
+        ssize_t n = pread(fd, buf + total, cap - 1 - total, (off_t)total);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        total += (size_t)n;
+        if (n == 0 || total < cap - 1) break;
+    }
+    buf[total] = '\0';
+    return (long)total;
+}
+
+/* Uncached read, for directory scans that look at many files once. */
+static long read_path(const struct reactive_sys *rs, const char *path, char *buf, size_t cap) {
+    char full[512];
+    sys_path(rs, path, full, sizeof(full));
+    int fd = open(full, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    long n = pread_all(fd, buf, cap);
+    close(fd);
+    return n;
+}
+
+static void fd_open(struct reactive_sys *rs, struct sys_fd *e) {
+    char full[512];
+    sys_path(rs, e->path, full, sizeof(full));
+    e->fd = open(full, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (e->fd >= 0 && fstat(e->fd, &st) == 0) {
+        e->dev = st.st_dev;
+        e->ino = st.st_ino;
+    }
+}
+
+static void fd_close(struct sys_fd *e) {
+    if (e->fd >= 0) close(e->fd);
+    e->fd = -1;
+}
+
+/* Slow-tick housekeeping: retry remembered misses, and reopen sysfs files
+ * whose path now names a different inode (device unplugged, re-probed or
+ * renumbered). procfs files never move, so they are left alone. */
+static void fd_revalidate(struct reactive_sys *rs) {
+    for (int i = 0; i < rs->nfds; i++) {
+        struct sys_fd *e = &rs->fds[i];
+        if (e->fd >= 0) {
+            if (strncmp(e->path, "/sys/", 5) != 0) continue;
+            char full[512];
+            struct stat st;
+            sys_path(rs, e->path, full, sizeof(full));
+            if (stat(full, &st) == 0 && st.st_dev == e->dev && st.st_ino == e->ino) continue;
+            fd_close(e);
+        }
+        fd_open(rs, e);
+    }
+}
+
+/* Find the table entry for `path`, opening it on first use. NULL when the
+ * table is full (the caller falls back to an uncached read). */
+static struct sys_fd *fd_lookup(struct reactive_sys *rs, const char *path) {
+    for (int i = 0; i < rs->nfds; i++) {
+        if (strcmp(rs->fds[i].path, path) == 0) return &rs->fds[i];
+    }
+    if (rs->nfds >= REACTIVE_SYS_MAX_FDS || strlen(path) >= sizeof(rs->fds[0].path)) {
+        return NULL;
+    }
+    struct sys_fd *e = &rs->fds[rs->nfds++];
+    snprintf(e->path, sizeof(e->path), "%s", path);
+    fd_open(rs, e);
+    return e;
+}
+
+/* read whole small file into buf through the descriptor table; returns
+ * bytes read or -1 */
+static long read_file(struct reactive_sys *rs, const char *path, char *buf, size_t cap) {
+    struct sys_fd *e = fd_lookup(rs, path);
+    if (!e) return read_path(rs, path, buf, cap);
+    if (e->fd < 0) return -1;
+    long n = pread_all(e->fd, buf, cap);
+    if (n < 0) {
+        /* sysfs answers ENODEV once the device is gone; the path may
+         * already name its replacement */
+        fd_close(e);
+        fd_open(rs, e);
+        if (e->fd >= 0) n = pread_all(e->fd, buf, cap);
+    }
+    return n;
+}
+
+/* Read an integer from a sysfs file, or fallback. */
+static long read_long(struct reactive_sys *rs, const char *path, long fallback) {
+    char b[64];
+    if (read_file(rs, path, b, sizeof(b)) > 0) return atol(b);
+    return fallback;
+}
+
+/* ============================================================================
+ * CPU / RAM / NET / DISK / LOAD / BATTERY / TIME
+ * ============================================================================ */
+
+static bool parse_cpu_line(const char *line, cpu_times_t *out) {
+    unsigned long long v[10] = {0};
+    int got = sscanf(line, "cpu%*[^ ] %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
+                     &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7], &v[8], &v[9]);
+    if (got < 4) {
+        /* try the aggregate "cpu " line (no suffix) */
+        got = sscanf(line, "cpu %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
+                     &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7], &v[8], &v[9]);
+        if (got < 4) return false;
+    }
+    unsigned long long total = 0;
+    for (int i = 0; i < 10; i++) total += v[i];
+    out->idle = v[3] + v[4];   /* idle + iowait */
+    out->total = total;
+    return true;
+}
+
+static void sample_cpu(struct reactive_sys *rs, reactive_snapshot_t *s) {
+    char buf[4096];
+    if (read_file(rs, "/proc/stat", buf, sizeof(buf)) <= 0) return;
+
+    char *line = buf;
+    int core = 0;
+    bool first = true;
+    while (line && *line) {
+        char *nl = strchr(line, '\n');
+        if (nl) *nl = '\0';
+
+        if (strncmp(line, "cpu", 3) == 0) {
+            cpu_times_t cur;
+            bool is_agg = (line[3] == ' ');
+            if (parse_cpu_line(line, &cur)) {
+                if (is_agg && first) {
+                    unsigned long long dt = cur.total - rs->prev_total.total;
+                    unsigned long long di = cur.idle - rs->prev_total.idle;
+                    if (dt > 0) s->cpu = clampf(1.0f - (float)di / (float)dt, 0.0f, 1.0f);
+                    rs->prev_total = cur;
+                    first = false;
+                } else if (!is_agg && core < 8) {
+                    unsigned long long dt = cur.total - rs->prev_core[core].total;
+                    unsigned long long di = cur.idle - rs->prev_core[core].idle;
+                    if (dt > 0) s->cpu_per[core] = clampf(1.0f - (float)di / (float)dt, 0.0f, 1.0f);
+                    rs->prev_core[core] = cur;
+                    core++;
+                }
+            }
+        } else if (line != buf) {
+            break; /* cpu lines are contiguous at the top of /proc/stat */
+        }
+        line = nl ? nl + 1 : NULL;
+    }
+    s->cpu_cores = core;
+
+    /* derived: hottest core + load imbalance across cores */
+    if (core > 0) {
+        float mx = 0.0f, mean = 0.0f;
+        for (int i = 0; i < core; i++) { mx = fmaxf(mx, s->cpu_per[i]); mean += s->cpu_per[i]; }
+        mean /= (float)core;
+        float var = 0.0f;
+        for (int i = 0; i < core; i++) { float d = s->cpu_per[i] - mean; var += d * d; }
+        var /= (float)core;
+        s->cpu_max = mx;
+        /* spread: normalised std-dev, ~1.0 when a single core is pegged and
+         * the rest idle. sqrt(var) maxes near 0.5 in that case, so scale x2. */
+        s->cpu_spread = clampf(sqrtf(var) * 2.0f, 0.0f, 1.0f);
+    }
+}
+
+static void sample_ram(struct reactive_sys *rs, reactive_snapshot_t *s) {
+    char buf[4096];
+    if (read_file(rs, "/proc/meminfo", buf, sizeof(buf)) <= 0) return;
+    unsigned long long total = 0, avail = 0, swtotal = 0, swfree = 0;
+    char *p;
+    if ((p = strstr(buf, "MemTotal:"))) sscanf(p, "MemTotal: %llu", &total);
+    if ((p = strstr(buf, "MemAvailable:"))) sscanf(p, "MemAvailable: %llu", &avail);
+    if ((p = strstr(buf, "SwapTotal:"))) sscanf(p, "SwapTotal: %llu", &swtotal);
+    if ((p = strstr(buf, "SwapFree:"))) sscanf(p, "SwapFree: %llu", &swfree);
+    if (total > 0) {
+        s->ram = clampf(1.0f - (float)avail / (float)total, 0.0f, 1.0f);
+        /* meminfo values are in kiB */
+        s->ram_total_gb = (float)total / (1024.0f * 1024.0f);
+        s->ram_gb = (float)(total - avail) / (1024.0f * 1024.0f);
+    }
+    if (swtotal > 0) s->swap = clampf(1.0f - (float)swfree / (float)swtotal, 0.0f, 1.0f);
+    else s->swap = 0.0f;
+}
+
+static void sample_net(struct reactive_sys *rs, reactive_snapshot_t *s, double dt_sec) {
+    char buf[16384];
+    if (read_file(rs, "/proc/net/dev", buf, sizeof(buf)) <= 0) return;
+
+    unsigned long long rx = 0, tx = 0;
+    char *line = strchr(buf, '\n');       /* skip 2 header lines */
+    if (line) line = strchr(line + 1, '\n');
+    if (line) line++;
+    while (line && *line) {
+        char iface[64];
+        unsigned long long r = 0, t = 0;
+        if (sscanf(line, " %63[^:]: %llu %*u %*u %*u %*u %*u %*u %*u %llu",
+                   iface, &r, &t) == 3) {
+            if (strcmp(iface, "lo") != 0) { rx += r; tx += t; }
+        }
+        char *nl = strchr(line, '\n');
+        line = nl ? nl + 1 : NULL;
+    }
+
+    if (rs->prev_rx != 0 && dt_sec > 0.0) {
+        double dn = (double)(rx - rs->prev_rx) / dt_sec;   /* bytes/sec */
+        double up = (double)(tx - rs->prev_tx) / dt_sec;
+        /* log-scale to 0..1: ~30 MB/s saturates */
+        s->net_down = clampf((float)(log10(1.0 + dn) / log10(3.0e7)), 0.0f, 1.0f);
+        s->net_up   = clampf((float)(log10(1.0 + up) / log10(3.0e7)), 0.0f, 1.0f);
+        /* raw MB/s for shaders that want honest absolute numbers */
+        s->net_down_mbs = (float)(dn / 1.0e6);
+        s->net_up_mbs   = (float)(up / 1.0e6);
+    }
+    rs->prev_rx = rx; rs->prev_tx = tx;
+}
+
+static void sample_battery(struct reactive_sys *rs, reactive_snapshot_t *s) {
+    char buf[256];
+    /* default: assume desktop (full, on AC) */
+    s->battery = 1.0f;
+    s->charging = true;
+    for (int i = 0; i < 4; i++) {
+        char path[128];
+        snprintf(path, sizeof(path), "/sys/class/power_supply/BAT%d/capacity", i);
+        if (read_file(rs, path, buf, sizeof(buf)) > 0) {
+            s->battery = clampf((float)atoi(buf) / 100.0f, 0.0f, 1.0f);
+            snprintf(path, sizeof(path), "/sys/class/power_supply/BAT%d/status", i);
+            if (read_file(rs, path, buf, sizeof(buf)) > 0) {
+                s->charging = (strncmp(buf, "Discharging", 11) != 0);
+            }
+            return;
+        }
+    }
+}
+
+/* --- disk I/O from /proc/diskstats (sums whole physical disks) --- */
+static void sample_disk(struct reactive_sys *rs, reactive_snapshot_t *s, double dt_sec) {
+    char buf[16384];
+    if (read_file(rs, "/proc/diskstats", buf, sizeof(buf)) <= 0) return;
+
+    unsigned long long rd = 0, wr = 0;
+    char *line = buf;
+    while (line && *line) {
+        /* fields: major minor name rd_ios rd_merges rd_sectors ... wr_sectors */
+        char name[64];
+        unsigned long long rsec = 0, wsec = 0;
+        if (sscanf(line, " %*u %*u %63s %*u %*u %llu %*u %*u %*u %llu",
+                   name, &rsec, &wsec) == 3) {
+            /* whole disks only: sd?, nvme?n?, vd?, mmcblk? — skip partitions
+             * (names ending in a digit for sd*, or 'p<digit>' for nvme). */
+            size_t L = strlen(name);
+            bool partition = false;
+            if (L > 0 && name[L-1] >= '0' && name[L-1] <= '9') {
+                if (strncmp(name, "sd", 2) == 0 || strncmp(name, "vd", 2) == 0 ||
+                    strncmp(name, "hd", 2) == 0) partition = true;
+                if (strstr(name, "p") && strncmp(name, "nvme", 4) == 0) partition = true;
+            }
+            if (strncmp(name, "loop", 4) == 0 || strncmp(name, "ram", 3) == 0 ||
+                strncmp(name, "zram", 4) == 0 || strncmp(name, "dm-", 3) == 0) partition = true;
+            if (!partition) { rd += rsec; wr += wsec; }
+        }
+        char *nl = strchr(line, '\n');
+        line = nl ? nl + 1 : NULL;
+    }
+
+    if (rs->prev_rd != 0 && dt_sec > 0.0) {
+        /* sectors are 512 bytes */
+        double rbps = (double)(rd - rs->prev_rd) * 512.0 / dt_sec;
+        double wbps = (double)(wr - rs->prev_wr) * 512.0 / dt_sec;
+        /* log-scale to 0..1: ~500 MB/s saturates (NVMe-friendly) */
+        s->disk_read  = clampf((float)(log10(1.0 + rbps) / log10(5.0e8)), 0.0f, 1.0f);
+        s->disk_write = clampf((float)(log10(1.0 + wbps) / log10(5.0e8)), 0.0f, 1.0f);
+    }
+    rs->prev_rd = rd; rs->prev_wr = wr;
+}
+
+/* --- load average + nproc normalisation --- */
+static void sample_load(struct reactive_sys *rs, reactive_snapshot_t *s) {
+    char buf[256];
+    if (read_file(rs, "/proc/loadavg", buf, sizeof(buf)) <= 0) return;
+    double l1 = 0.0;
+    /* loadavg: "0.52 0.48 0.44 1/512 12345" -> last token before space is procs */
+    int total_proc = 0, run_proc = 0;
+    sscanf(buf, "%lf %*f %*f %d/%d", &l1, &run_proc, &total_proc);
+    s->load_raw = (float)l1;
+    long nproc = sysconf(_SC_NPROCESSORS_ONLN);
+    if (nproc < 1) nproc = 1;
+    s->load_avg = clampf((float)(l1 / (double)nproc), 0.0f, 1.0f);
+    if (total_proc > 0) {
+        s->proc_count = total_proc;
+        /* activity proxy: fraction of procs that are runnable */
+        s->procs = clampf((float)run_proc / (float)(nproc * 2), 0.0f, 1.0f);
+    }
+}
+
+/* --- uptime --- */
+static void sample_uptime(struct reactive_sys *rs, reactive_snapshot_t *s) {
+    char buf[128];
+    if (read_file(rs, "/proc/uptime", buf, sizeof(buf)) <= 0) return;
+    double up = atof(buf);
+    s->uptime_hours = (float)(up / 3600.0);
+}
+
+/* --- CPU / GPU temperature from the discovered sensors --- */
+
+/* Sample the thermal classes in `which`. False if any of them has no sensor
+ * or one stopped answering, so the caller rescans on the next slow tick. */
+static bool sample_temps(struct reactive_sys *rs, reactive_snapshot_t *s, unsigned which) {
+    thermal_reading_t r;
+    thermal_sensors_read(rs->thermal, which, &r);
+    if (r.cpu_c > 0.0f) {
+        s->cpu_temp_c = r.cpu_c;
+        s->cpu_temp = clampf((r.cpu_c - 30.0f) / 65.0f, 0.0f, 1.0f); /* 30..95C */
+    }
+    if (r.gpu_c > 0.0f) {
+        s->gpu_temp_c = r.gpu_c;
+        s->gpu_temp = clampf((r.gpu_c - 30.0f) / 65.0f, 0.0f, 1.0f);
+    }
+    return (!(which & THERMAL_CPU) || r.cpu_ok) && (!(which & THERMAL_GPU) || r.gpu_ok);
+}
+
+/* --- GPU usage: amdgpu gpu_busy_percent (temperature: sample_temps) --- */
+static void sample_gpu(struct reactive_sys *rs, reactive_snapshot_t *s) {
+    for (int c = 0; c < 4; c++) {
+        char p[256];
+        snprintf(p, sizeof(p), "/sys/class/drm/card%d/device/gpu_busy_percent", c);
+        long busy = read_long(rs, p, -1);
+        if (busy >= 0) {
+            s->gpu = clampf((float)busy / 100.0f, 0.0f, 1.0f);
+            break;
+        }
+    }
+}
+
+static void sample_time(reactive_snapshot_t *s) {
+    time_t t = time(NULL);
+    struct tm tmv;
+    localtime_r(&t, &tmv);
+    float secs = tmv.tm_hour * 3600.0f + tmv.tm_min * 60.0f + tmv.tm_sec;
+    s->time_of_day = secs / 86400.0f;
+    /* sun elevation proxy: cosine peaking at solar noon (~13:00 local-ish) */
+    float h = secs / 3600.0f;
+    float sun = cosf((h - 13.0f) * (float)M_PI / 12.0f);
+    s->sun = clampf((sun + 0.15f) / 1.15f, 0.0f, 1.0f);
+    s->day_fraction = (float)tmv.tm_yday / 365.0f;
+}
+
+/* ============================================================================
+ * Sampler thread
+ * ============================================================================ */
+
+static double mono_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void tick(struct reactive_sys *rs, uint32_t sig, bool slow, double dt) {
+    reactive_snapshot_t *s = &rs->snap;
+
+    /* groups switched back on restart their deltas rather than averaging
+     * over the time they were off */
+    uint32_t added = sig & ~rs->sampled;
+    if (added & REACTIVE_SIG_NET) {
+        rs->prev_rx = rs->prev_tx = 0;
+    }
+    if (added & REACTIVE_SIG_DISK) {
+        rs->prev_rd = rs->prev_wr = 0;
+    }
+    rs->sampled = sig;
+
+    if (slow) {
+        fd_revalidate(rs);
+    }
+    if (sig & REACTIVE_SIG_CPU) sample_cpu(rs, s);
+    if (sig & REACTIVE_SIG_RAM) sample_ram(rs, s);
+    if (sig & REACTIVE_SIG_NET) sample_net(rs, s, dt);
+    if (sig & REACTIVE_SIG_DISK) sample_disk(rs, s, dt);
+    if (sig & REACTIVE_SIG_LOAD) sample_load(rs, s);
+    if (sig & REACTIVE_SIG_BATTERY) sample_battery(rs, s);
+    if (sig & REACTIVE_SIG_TIME) sample_time(s);
+    if (slow) {
+        if (sig & REACTIVE_SIG_UPTIME) sample_uptime(rs, s);
+        if (sig & REACTIVE_SIG_GPU) sample_gpu(rs, s);
+        /* Rediscover the thermal sensors while one is missing or a cached
+         * one has stopped answering; otherwise the slow tick is just its
+         * preads. */
+        unsigned which = ((sig & REACTIVE_SIG_CPU_TEMP) ? THERMAL_CPU : 0u) |
+                         ((sig & REACTIVE_SIG_GPU) ? THERMAL_GPU : 0u);
+        if (which) {
+            if (!rs->thermal) {
+                rs->thermal = thermal_sensors_open(rs->root);
+            } else if (rs->thermal_stale) {
+                thermal_sensors_rescan(rs->thermal);
+            }
+            rs->thermal_stale = !sample_temps(rs, s, which);
+        }
+    }
+    if (rs->cfg.publish) {
+        rs->cfg.publish(s, slow, dt, rs->cfg.user);
+    }
+}
+
+static void *sampler_thread_fn(void *arg) {
+    struct reactive_sys *rs = arg;
+    const double fast = rs->cfg.fast_period;
+    const double slow = rs->cfg.slow_period;
+
+    double last = 0.0, last_slow = 0.0;
+    double next = mono_now();
+    pthread_mutex_lock(&rs->lock);
+    while (!rs->stop) {
+        /* Deadlines advance by whole periods, so a slow tick shifts nothing
+         * after it; a stall longer than a period skips the missed ticks. */
+        double now = mono_now();
+        if (now < next && !rs->force) {
+            struct timespec ts;
+            ts.tv_sec = (time_t)next;
+            ts.tv_nsec = (long)((next - (double)ts.tv_sec) * 1e9);
+            int rc = pthread_cond_timedwait(&rs->wake, &rs->lock, &ts);
+            if (rc != 0 && rc != ETIMEDOUT && rc != EINTR) {
+                break;
+            }
+            continue;
+        }
+        bool forced = rs->force;
+        uint32_t sig = rs->signals;
+        rs->force = false;
+        pthread_mutex_unlock(&rs->lock);
+
+        bool is_slow = forced || last_slow == 0.0 || now - last_slow >= slow - 1e-3;
+        if (is_slow) last_slow = now;
+        tick(rs, sig, is_slow, last == 0.0 ? 0.0 : now - last);
+        last = now;
+
+        if (forced) {
+            next = now; /* the regular schedule restarts from here */
+        }
+        next += fast;
+        now = mono_now();
+        if (next <= now) {
+            next = now + fast;
+        }
+        pthread_mutex_lock(&rs->lock);
+    }
+    pthread_mutex_unlock(&rs->lock);
+    return NULL;
+}
+
+struct reactive_sys *reactive_sys_start(const struct reactive_sys_config *cfg) {
+    struct reactive_sys *rs = calloc(1, sizeof(*rs));
+    if (!rs) return NULL;
+    if (cfg) rs->cfg = *cfg;
+    if (rs->cfg.fast_period <= 0.0) rs->cfg.fast_period = REACTIVE_SYS_FAST_PERIOD;
+    if (rs->cfg.slow_period <= 0.0) rs->cfg.slow_period = REACTIVE_SYS_SLOW_PERIOD;
+    snprintf(rs->root, sizeof(rs->root), "%s", rs->cfg.root ? rs->cfg.root : "");
+    rs->cfg.root = rs->root;
+    rs->signals = rs->cfg.signals ? rs->cfg.signals : REACTIVE_SIG_ALL;
+
+    /* default: assume desktop (full, on AC) until the first sample */
+    rs->snap.battery = 1.0f;
+    rs->snap.charging = true;
+
+    pthread_condattr_t ca;
+    pthread_condattr_init(&ca);
+    pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+    pthread_cond_init(&rs->wake, &ca);
+    pthread_condattr_destroy(&ca);
+    pthread_mutex_init(&rs->lock, NULL);
+
+    if (pthread_create(&rs->thread, NULL, sampler_thread_fn, rs) != 0) {
+        pthread_cond_destroy(&rs->wake);
+        pthread_mutex_destroy(&rs->lock);
+        free(rs);
+        return NULL;
+    }
+    return rs;
+}
+
+void reactive_sys_stop(struct reactive_sys *rs) {
+    if (!rs) return;
+    pthread_mutex_lock(&rs->lock);
+    rs->stop = true;
+    pthread_cond_signal(&rs->wake);
+    pthread_mutex_unlock(&rs->lock);
+    pthread_join(rs->thread, NULL);
+    for (int i = 0; i < rs->nfds; i++) {
+        fd_close(&rs->fds[i]);
+    }
+    thermal_sensors_close(rs->thermal);
+    pthread_cond_destroy(&rs->wake);
+    pthread_mutex_destroy(&rs->lock);
+    free(rs);
+}
+
+void reactive_sys_set_signals(struct reactive_sys *rs, uint32_t signals) {
+    if (!rs) return;
+    if (!signals) signals = REACTIVE_SIG_ALL;
+    pthread_mutex_lock(&rs->lock);
+    if (signals & ~rs->signals) {
+        rs->force = true;
+        pthread_cond_signal(&rs->wake);
+    }
+    rs->signals = signals;
+    pthread_mutex_unlock(&rs->lock);
+}
+
+void reactive_sys_merge(reactive_snapshot_t *dst, const reactive_snapshot_t *src) {
+    dst->cpu = src->cpu;
+    memcpy(dst->cpu_per, src->cpu_per, sizeof(dst->cpu_per));
+    dst->cpu_cores = src->cpu_cores;
+    dst->cpu_max = src->cpu_max;
+    dst->cpu_spread = src->cpu_spread;
+    dst->ram = src->ram;
+    dst->ram_gb = src->ram_gb;
+    dst->ram_total_gb = src->ram_total_gb;
+    dst->swap = src->swap;
+    dst->net_down = src->net_down;
+    dst->net_up = src->net_up;
+    dst->net_down_mbs = src->net_down_mbs;
+    dst->net_up_mbs = src->net_up_mbs;
+    dst->disk_read = src->disk_read;
+    dst->disk_write = src->disk_write;
+    dst->load_avg = src->load_avg;
+    dst->load_raw = src->load_raw;
+
+    dst->cpu_temp = src->cpu_temp;
+    dst->cpu_temp_c = src->cpu_temp_c;
+    dst->gpu = src->gpu;
+    dst->gpu_temp = src->gpu_temp;
+    dst->gpu_temp_c = src->gpu_temp_c;
+
+    dst->uptime_hours = src->uptime_hours;
+    dst->procs = src->procs;
+    dst->proc_count = src->proc_count;
+
+    dst->battery = src->battery;
+    dst->charging = src->charging;
+
+    dst->time_of_day = src->time_of_day;
+    dst->sun = src->sun;
+    dst->day_fraction = src->day_fraction;
+}
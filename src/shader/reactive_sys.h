@@ -0,0 +1,66 @@
+/* System-signal sampler for the reactive subsystem.
+ *
+ * Everything reactive.c used to read from /proc and /sys on the main loop
+ * (CPU, RAM, swap, network, disk, load, battery, uptime, thermals, GPU) runs
+ * here on a dedicated thread with its own schedule: a fast tick (4 Hz by
+ * default) for the cheap counters and a slow tick (1 Hz) that adds the
+ * sysfs directory scans. A battery read that takes 10+ ms on some ACPI
+ * firmware now delays the next sample instead of a frame; the render path
+ * only ever copies the published snapshot.
+ *
+ * Each tick hands the sampled fields to a publish callback (on the sampler
+ * thread), which reactive.c uses to merge them into the shared snapshot
+ * under its own lock.
+ *
+ * Split out (as reactive_fft.h was) so it can be tested against a fake /proc
+ * and /sys tree: every path is resolved under a configurable root, and
+ * nothing here logs or reaches into the rest of neowall.
+ * (See tests/test_reactive_sys.c.)
+ */
+
+#ifndef NEOWALL_REACTIVE_SYS_H
+#define NEOWALL_REACTIVE_SYS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "neowall/shader/reactive.h"
+
+/* Called after every tick with the sampler's current view of the system
+ * fields (see reactive_sys_merge). `slow` is true on ticks that also
+ * refreshed the slow signals; `dt` is seconds since the previous tick (0 on
+ * the first). */
+typedef void (*reactive_sys_publish_fn)(const reactive_snapshot_t *sys, bool slow, double dt,
+                                        void *user);
+
+struct reactive_sys_config {
+    const char *root;    /* prefix for /proc and /sys; NULL or "" = the real ones */
+    double fast_period;  /* seconds between ticks; <= 0 means 0.25 */
+    double slow_period;  /* seconds between slow refreshes; <= 0 means 1.0 */
+    uint32_t signals;    /* REACTIVE_SIG_* groups to sample; 0 means all */
+    reactive_sys_publish_fn publish;
+    void *user;
+};
+
+struct reactive_sys;
+
+/* Start the sampler thread. The first tick (fast + slow) runs immediately.
+ * Returns NULL if the thread could not be started. */
+struct reactive_sys *reactive_sys_start(const struct reactive_sys_config *cfg);
+
+/* Wake the thread, join it and free the sampler. No publish runs after this
+ * returns. NULL is a no-op. */
+void reactive_sys_stop(struct reactive_sys *sys);
+
+/* Change the sampled groups (0 means all). Newly added groups are sampled
+ * at once, on an immediate slow tick, rather than at the next deadline; rate
+ * signals (net, disk) restart their deltas instead of averaging over the
+ * time they were off. The audio and NVIDIA bits are ignored here; those
+ * collectors live in reactive.c. */
+void reactive_sys_set_signals(struct reactive_sys *sys, uint32_t signals);
+
+/* Copy the fields the sampler owns from `src` into `dst`, leaving audio,
+ * NVIDIA, input and fused fields alone. */
+void reactive_sys_merge(reactive_snapshot_t *dst, const reactive_snapshot_t *src);
+
+#endif /* NEOWALL_REACTIVE_SYS_H */
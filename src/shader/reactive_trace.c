@@ -0,0 +1,341 @@
+/* Reactive traces — implementation. See reactive_trace.h. */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "reactive_trace.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_MAGIC "NWRT"
+#define TRACE_HEADER_SIZE 12
+
+#define REC_SNAPSHOT 1
+#define REC_AUDIO 2
+
+#define SNAP_WORDS (sizeof(reactive_snapshot_t) / 4)
+#define SNAP_BITMAP ((SNAP_WORDS + 7) / 8)
+
+_Static_assert(sizeof(reactive_snapshot_t) % 4 == 0,
+               "reactive_snapshot_t is diffed as 32-bit words");
+
+/* ============================================================================
+ * Recording
+ * ============================================================================ */
+
+struct reactive_trace_writer {
+    FILE *f;
+    char buf[1 << 16];          /* stdio buffer: records land in memory first */
+    uint64_t last_us;           /* time of the previous record */
+    uint32_t prev[SNAP_WORDS];  /* previous snapshot */
+    bool have_prev;
+    bool failed;
+};
+
+static void put_u16(FILE *f, unsigned v) {
+    fputc((int)(v & 0xff), f);
+    fputc((int)(v >> 8 & 0xff), f);
+}
+
+static void put_u32(FILE *f, uint32_t v) {
+    put_u16(f, v & 0xffff);
+    put_u16(f, v >> 16);
+}
+
+static void put_varint(FILE *f, uint64_t v) {
+    while (v >= 0x80) {
+        fputc((int)(v & 0x7f) | 0x80, f);
+        v >>= 7;
+    }
+    fputc((int)v, f);
+}
+
+/* Record type and the delta to `t`, which is clamped to be monotonic. */
+static void put_record(struct reactive_trace_writer *w, int type, double t) {
+    uint64_t us = t > 0.0 ? (uint64_t)llround(t * 1e6) : 0;
+    if (us < w->last_us) us = w->last_us;
+    fputc(type, w->f);
+    put_varint(w->f, us - w->last_us);
+    w->last_us = us;
+}
+
+static uint8_t quantize(float v) {
+    if (!(v > 0.0f)) return 0; /* also NaN */
+    if (v >= 1.0f) return 255;
+    return (uint8_t)lrintf(v * 255.0f);
+}
+
+struct reactive_trace_writer *reactive_trace_writer_open(const char *path) {
+    struct reactive_trace_writer *w = calloc(1, sizeof(*w));
+    if (!w) return NULL;
+    w->f = fopen(path, "wb");
+    if (!w->f) {
+        free(w);
+        return NULL;
+    }
+    setvbuf(w->f, w->buf, _IOFBF, sizeof(w->buf));
+    fwrite(TRACE_MAGIC, 1, 4, w->f);
+    put_u16(w->f, REACTIVE_TRACE_VERSION);
+    put_u16(w->f, (unsigned)sizeof(reactive_snapshot_t));
+    put_u16(w->f, REACTIVE_AUDIO_BINS);
+    put_u16(w->f, 0);
+    return w;
+}
+
+void reactive_trace_write_snapshot(struct reactive_trace_writer *w, double t,
+                                   const reactive_snapshot_t *snap) {
+    if (!w || !snap) return;
+    uint32_t words[SNAP_WORDS];
+    memcpy(words, snap, sizeof(words));
+
+    uint8_t bitmap[SNAP_BITMAP] = {0};
+    bool changed = false;
+    for (size_t i = 0; i < SNAP_WORDS; i++) {
+        if (words[i] != w->prev[i]) {
+            bitmap[i / 8] |= (uint8_t)(1u << (i % 8));
+            changed = true;
+        }
+    }
+    /* the first snapshot is always written, even if it is all zero */
+    if (!changed && w->have_prev) return;
+
+    put_record(w, REC_SNAPSHOT, t);
+    fwrite(bitmap, 1, sizeof(bitmap), w->f);
+    for (size_t i = 0; i < SNAP_WORDS; i++) {
+        if (bitmap[i / 8] & (1u << (i % 8))) put_u32(w->f, words[i]);
+    }
+    memcpy(w->prev, words, sizeof(words));
+    w->have_prev = true;
+    if (ferror(w->f)) w->failed = true;
+}
+
+void reactive_trace_write_audio(struct reactive_trace_writer *w, double t,
+                                const float *spectrum, const float *waveform) {
+    if (!w || !spectrum || !waveform) return;
+    uint8_t q[REACTIVE_AUDIO_BINS];
+    put_record(w, REC_AUDIO, t);
+    for (int k = 0; k < REACTIVE_AUDIO_BINS; k++) q[k] = quantize(spectrum[k]);
+    fwrite(q, 1, sizeof(q), w->f);
+    for (int k = 0; k < REACTIVE_AUDIO_BINS; k++) q[k] = quantize(waveform[k]);
+    fwrite(q, 1, sizeof(q), w->f);
+    if (ferror(w->f)) w->failed = true;
+}
+
+bool reactive_trace_writer_close(struct reactive_trace_writer *w) {
+    if (!w) return true;
+    bool ok = !w->failed && !ferror(w->f);
+    if (fclose(w->f) != 0) ok = false;
+    free(w);
+    return ok;
+}
+
+/* ============================================================================
+ * Replay
+ * ============================================================================ */
+
+typedef struct {
+    double t;
+    reactive_snapshot_t snap; /* audio_frame = audio records before it */
+} trace_snap_t;
+
+typedef struct {
+    uint8_t spectrum[REACTIVE_AUDIO_BINS];
+    uint8_t waveform[REACTIVE_AUDIO_BINS];
+} trace_audio_t;
+
+struct reactive_trace {
+    trace_snap_t *snaps;
+    size_t nsnaps;
+    trace_audio_t *audio; /* frame f at audio[f - 1] */
+    uint32_t naudio;
+    double duration;
+};
+
+typedef struct {
+    const uint8_t *p, *end;
+} cursor_t;
+
+static bool get_varint(cursor_t *c, uint64_t *out) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (c->p >= c->end) return false;
+        uint8_t b = *c->p++;
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            *out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static unsigned get_u16(const uint8_t *p) {
+    return (unsigned)p[0] | (unsigned)p[1] << 8;
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)get_u16(p) | (uint32_t)get_u16(p + 2) << 16;
+}
+
+static uint8_t *read_file(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    size_t cap = 1 << 16, n = 0;
+    uint8_t *buf = malloc(cap);
+    while (buf) {
+        n += fread(buf + n, 1, cap - n, f);
+        if (n < cap) break;
+        uint8_t *grown = realloc(buf, cap * 2);
+        if (!grown) {
+            free(buf);
+            buf = NULL;
+            break;
+        }
+        buf = grown;
+        cap *= 2;
+    }
+    if (buf && ferror(f)) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *len = n;
+    return buf;
+}
+
+/* Append room for one more element to a growing array. */
+static bool grow(void **arr, size_t *cap, size_t n, size_t elem) {
+    if (n < *cap) return true;
+    size_t want = *cap ? *cap * 2 : 256;
+    void *p = realloc(*arr, want * elem);
+    if (!p) return false;
+    *arr = p;
+    *cap = want;
+    return true;
+}
+
+/* Decode every record. A record cut short at the end of the file (a
+ * recording that was killed) ends the trace; anything else malformed fails
+ * the load. */
+static bool decode(struct reactive_trace *tr, cursor_t c) {
+    size_t snap_cap = 0, audio_cap = 0;
+    uint32_t words[SNAP_WORDS] = {0};
+    uint64_t us = 0;
+
+    while (c.p < c.end) {
+        int type = *c.p++;
+        uint64_t dt;
+        if (!get_varint(&c, &dt)) break;
+        us += dt;
+
+        if (type == REC_SNAPSHOT) {
+            if ((size_t)(c.end - c.p) < SNAP_BITMAP) break;
+            const uint8_t *bitmap = c.p;
+            c.p += SNAP_BITMAP;
+            size_t need = 0;
+            for (size_t i = 0; i < SNAP_WORDS; i++) need += (bitmap[i / 8] >> (i % 8)) & 1u;
+            if ((size_t)(c.end - c.p) < need * 4) break;
+            for (size_t i = 0; i < SNAP_WORDS; i++) {
+                if (!(bitmap[i / 8] & (1u << (i % 8)))) continue;
+                words[i] = get_u32(c.p);
+                c.p += 4;
+            }
+            if (!grow((void **)&tr->snaps, &snap_cap, tr->nsnaps, sizeof(*tr->snaps))) {
+                return false;
+            }
+            trace_snap_t *s = &tr->snaps[tr->nsnaps++];
+            s->t = (double)us / 1e6;
+            memcpy(&s->snap, words, sizeof(words));
+            s->snap.audio_frame = tr->naudio;
+        } else if (type == REC_AUDIO) {
+            if ((size_t)(c.end - c.p) < sizeof(trace_audio_t)) break;
+            if (!grow((void **)&tr->audio, &audio_cap, tr->naudio, sizeof(*tr->audio))) {
+                return false;
+            }
+            memcpy(&tr->audio[tr->naudio++], c.p, sizeof(trace_audio_t));
+            c.p += sizeof(trace_audio_t);
+        } else {
+            return false;
+        }
+        tr->duration = (double)us / 1e6;
+    }
+    return tr->nsnaps > 0;
+}
+
+struct reactive_trace *reactive_trace_load(const char *path) {
+    size_t len = 0;
+    uint8_t *buf = read_file(path, &len);
+    if (!buf) return NULL;
+
+    struct reactive_trace *tr = NULL;
+    if (len >= TRACE_HEADER_SIZE && memcmp(buf, TRACE_MAGIC, 4) == 0 &&
+        get_u16(buf + 4) == REACTIVE_TRACE_VERSION &&
+        get_u16(buf + 6) == sizeof(reactive_snapshot_t) &&
+        get_u16(buf + 8) == REACTIVE_AUDIO_BINS) {
+        tr = calloc(1, sizeof(*tr));
+        cursor_t c = {buf + TRACE_HEADER_SIZE, buf + len};
+        if (tr && !decode(tr, c)) {
+            reactive_trace_free(tr);
+            tr = NULL;
+        }
+    }
+    free(buf);
+    return tr;
+}
+
+void reactive_trace_free(struct reactive_trace *tr) {
+    if (!tr) return;
+    free(tr->snaps);
+    free(tr->audio);
+    free(tr);
+}
+
+double reactive_trace_duration(const struct reactive_trace *tr) {
+    return tr ? tr->duration : 0.0;
+}
+
+uint32_t reactive_trace_audio_frames(const struct reactive_trace *tr) {
+    return tr ? tr->naudio : 0;
+}
+
+void reactive_trace_snapshot_at(const struct reactive_trace *tr, double t,
+                                reactive_snapshot_t *out) {
+    if (!tr || !out) return;
+    /* last snapshot with time <= t; the first one if t precedes them all */
+    size_t lo = 0, hi = tr->nsnaps;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (tr->snaps[mid].t <= t) lo = mid; else hi = mid;
+    }
+    *out = tr->snaps[lo].snap;
+}
+
+bool reactive_trace_audio_row(const struct reactive_trace *tr, uint32_t frame, float *out) {
+    if (!tr || !out || frame == 0 || frame > tr->naudio) return false;
+    const uint8_t *q = tr->audio[frame - 1].spectrum;
+    for (int k = 0; k < REACTIVE_AUDIO_BINS; k++) out[k] = q[k] / 255.0f;
+    return true;
+}
+
+void reactive_trace_audio(const struct reactive_trace *tr, uint32_t frame, float keep,
+                          reactive_audio_t *out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!tr || frame == 0 || frame > tr->naudio) return;
+
+    /* Restart the smoothing a fixed distance back, so the result depends
+     * only on `frame` and not on which frames were looked up before. */
+    uint32_t first = frame > REACTIVE_TRACE_SMOOTH_FRAMES
+                         ? frame - REACTIVE_TRACE_SMOOTH_FRAMES + 1 : 1;
+    for (uint32_t f = first; f <= frame; f++) {
+        const uint8_t *q = tr->audio[f - 1].spectrum;
+        for (int k = 0; k < REACTIVE_AUDIO_BINS; k++) {
+            out->spectrum[k] = out->spectrum[k] * keep + q[k] / 255.0f * (1.0f - keep);
+        }
+    }
+    const uint8_t *w = tr->audio[frame - 1].waveform;
+    for (int k = 0; k < REACTIVE_AUDIO_BINS; k++) out->waveform[k] = w[k] / 255.0f;
+    out->frame = frame;
+}
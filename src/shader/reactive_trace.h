@@ -0,0 +1,98 @@
+/* Reactive traces: record the reactive snapshot stream to a compact binary
+ * file and look it up again by time, so a benchmark or regression run sees
+ * the same CPU, network, thermal and audio signals every time.
+ *
+ * Live reactive_get depends on whatever the machine is doing, so two runs of
+ * an audio- or load-driven shader never draw the same frames or cost the
+ * same. A trace recorded once (NEOWALL_REACTIVE_RECORD) and replayed later
+ * (NEOWALL_REACTIVE_REPLAY) makes the reactive inputs a pure function of
+ * shader time, on a machine with no audio device as well as a dev box.
+ *
+ * File layout, little-endian:
+ *   header  "NWRT", u16 version, u16 sizeof(reactive_snapshot_t),
+ *           u16 REACTIVE_AUDIO_BINS, u16 reserved
+ *   records u8 type, varint microseconds since the previous record, body:
+ *     SNAPSHOT  bitmap of the 32-bit words that changed since the previous
+ *               snapshot, then those words;
+ *     AUDIO     one analysis frame: raw spectrum and waveform, 8 bits a bin.
+ * A snapshot that moved only the audio fields costs ~40 bytes; an audio frame
+ * 1 KB. The smoothed spectrum rows are not stored: they are recomputed from
+ * the raw frames on lookup.
+ *
+ * The snapshot layout is stored as its size only, so a trace is tied to the
+ * build that recorded it; one from a different layout is rejected on load.
+ *
+ * Pure and log-free, like reactive_audio.c, so tests/test_reactive_trace.c
+ * can round-trip traces without the rest of neowall.
+ */
+
+#ifndef NEOWALL_REACTIVE_TRACE_H
+#define NEOWALL_REACTIVE_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "neowall/shader/reactive.h"
+
+#define REACTIVE_TRACE_VERSION 1
+
+/* Audio frames blended into a smoothed spectrum row on lookup. The live
+ * smoothing keeps ~0.77 per frame, so older frames weigh < 1e-5. */
+#define REACTIVE_TRACE_SMOOTH_FRAMES 48
+
+/* ---- recording ---- */
+
+struct reactive_trace_writer;
+
+/* Create (truncate) `path` and write the header. NULL on failure. */
+struct reactive_trace_writer *reactive_trace_writer_open(const char *path);
+
+/* Append a snapshot taken `t` seconds into the recording. Times must not go
+ * backwards (earlier ones are clamped to the previous record). A snapshot
+ * identical to the previous one is not written. */
+void reactive_trace_write_snapshot(struct reactive_trace_writer *w, double t,
+                                   const reactive_snapshot_t *snap);
+
+/* Append one audio analysis frame: the unsmoothed spectrum and the waveform,
+ * REACTIVE_AUDIO_BINS values each in 0..1. */
+void reactive_trace_write_audio(struct reactive_trace_writer *w, double t,
+                                const float *spectrum, const float *waveform);
+
+/* Flush and close. Returns false if any write failed (disk full, ...).
+ * NULL is a no-op returning true. */
+bool reactive_trace_writer_close(struct reactive_trace_writer *w);
+
+/* ---- replay ---- */
+
+struct reactive_trace;
+
+/* Read and decode a whole trace into memory. NULL if the file is missing,
+ * not a trace, from another snapshot layout, corrupt or holds no snapshot.
+ * A record cut short at the end (a recording that was killed) is dropped.
+ * The result is read-only, so lookups are safe from any number of threads. */
+struct reactive_trace *reactive_trace_load(const char *path);
+void reactive_trace_free(struct reactive_trace *tr);
+
+/* Time of the last record, seconds. */
+double reactive_trace_duration(const struct reactive_trace *tr);
+
+/* Number of audio frames; they are numbered 1..n. */
+uint32_t reactive_trace_audio_frames(const struct reactive_trace *tr);
+
+/* The snapshot in effect `t` seconds into the trace: the last one recorded
+ * at or before t (the first one before it starts, the last one after it
+ * ends). audio_frame is set to the number of audio frames recorded by t. */
+void reactive_trace_snapshot_at(const struct reactive_trace *tr, double t,
+                                reactive_snapshot_t *out);
+
+/* The unsmoothed spectrum of audio frame `frame`. False if out of range. */
+bool reactive_trace_audio_row(const struct reactive_trace *tr, uint32_t frame, float *out);
+
+/* The audio rows as reactive_get_audio would have published them at
+ * `frame`: the spectrum smoothed with `keep` per frame over the previous
+ * REACTIVE_TRACE_SMOOTH_FRAMES frames, and that frame's waveform. Frame 0
+ * (nothing recorded yet) gives zero rows. */
+void reactive_trace_audio(const struct reactive_trace *tr, uint32_t frame, float keep,
+                          reactive_audio_t *out);
+
+#endif /* NEOWALL_REACTIVE_TRACE_H */
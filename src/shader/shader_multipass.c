@@ -326,6 +326,14 @@ void multipass_set_channel(multipass_shader_t *shader,
     }
 }
 
+void multipass_set_audio_history(multipass_shader_t *shader, int rows) {
+    if (!shader) return;
+    if (rows < MULTIPASS_AUDIO_HISTORY_MIN) rows = MULTIPASS_AUDIO_HISTORY_MIN;
+    if (rows > MULTIPASS_AUDIO_HISTORY_MAX) rows = MULTIPASS_AUDIO_HISTORY_MAX;
+    shader->audio_history_rows = rows;
+    log_info("Manifest: audio history %d rows", rows);
+}
+
 void multipass_add_user_uniform(multipass_shader_t *shader,
                                 const char *name, uniform_bind_t bind, float value) {
     if (!shader || !name || shader->user_uniform_count >= MULTIPASS_MAX_USER_UNIFORMS) return;
@@ -363,6 +371,8 @@ nw_result multipass_attach_terminal(multipass_shader_t *shader,
     if (shader->term_font_italic) o.font_italic_path = shader->term_font_italic;
     if (shader->term_has_fg) o.default_fg = shader->term_fg;
     if (shader->term_has_bg) o.default_bg = shader->term_bg;
+    o.scrollback = shader->term_scrollback;
+    o.sdf = shader->term_sdf;
     nw_result err = nw_ok();
     shader->term = term_render_create(&o, &err);
     if (!shader->term) {
@@ -451,6 +461,16 @@ bool multipass_terminal_write(multipass_shader_t *shader, const void *bytes, siz
 #endif
 }
 
+bool multipass_terminal_scroll_page(multipass_shader_t *shader, int pages) {
+#ifdef NEOWALL_HAVE_TERMINAL
+    if (!shader || !shader->term) return false;
+    return term_render_scroll_page(shader->term, pages);
+#else
+    (void)shader; (void)pages;
+    return false;
+#endif
+}
+
 
 multipass_channel_t multipass_default_channel(channel_source_t source) {
     multipass_channel_t channel = {
@@ -713,10 +733,11 @@ static const char *multipass_wrapper_prefix =
     "// simple we expose a dedicated integer sampler + the metadata uniforms.\n"
     "uniform highp usampler2D iTermCells;\n"
     "uniform highp usampler2D iTermChange; // R32UI: per-cell last-change ms\n"
-    "uniform sampler2D iTermAtlas;\n"
-    "uniform sampler2D iTermColorAtlas;\n"
+    "uniform sampler2DArray iTermAtlas;      // layer = page, rec.r bits 2-6\n"
+    "uniform sampler2DArray iTermColorAtlas;\n"
     "uniform vec4 iTermInfo;       // cols, rows, cellW, cellH\n"
-    "uniform vec2 iTermAtlasSize;  // atlas texel w, h\n"
+    "uniform int iTermRowBase;     // texture row holding grid row 0\n"
+    "uniform vec2 iTermAtlasSize;  // atlas page texel w, h\n"
     "uniform vec3 iTermCursor;     // cursorX, cursorY, visible\n"
     "uniform vec4 iTermCursorPrev; // prevX, prevY, moveTime, (unused)\n"
     "uniform vec4 iTermFX;         // bloom, scanline, crt-curve, chromatic\n"
@@ -1295,37 +1316,27 @@ bool multipass_init_gl(multipass_shader_t *shader, int width, int height) {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
+        /* Glyph atlas: an R8 coverage texture array, one layer per atlas
+         * page. Created here with a single layer so the sampler is valid
+         * before the first glyph; multipass_render reallocates it as pages
+         * are added. The color-emoji array (RGBA8) is created there on the
+         * first colour glyph; until then no cell sets TERM_FLAG_COLOR. */
         int aw = term_render_atlas_w(shader->term);
         int ah = term_render_atlas_h(shader->term);
         glGenTextures(1, &shader->term_atlas_texture);
-        glBindTexture(GL_TEXTURE_2D, shader->term_atlas_texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, shader->term_atlas_texture);
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, aw, ah, 0,
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R8, aw, ah, 1, 0,
                      GL_RED, GL_UNSIGNED_BYTE, NULL);
         /* LINEAR gives sub-pixel AA on the coverage bitmap (kitty-style). */
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        shader->term_atlas_uploaded_w = 0;
-        shader->term_atlas_uploaded_h = 0;
-
-        /* Color-emoji atlas (RGBA8). Only created when the terminal actually
-         * loaded a color-emoji font; otherwise the shader's color branch never
-         * fires (no cell sets TERM_FLAG_COLOR) and we keep the texture unbound. */
-        if (term_render_color_atlas(shader->term)) {
-            glGenTextures(1, &shader->term_color_atlas_texture);
-            glBindTexture(GL_TEXTURE_2D, shader->term_color_atlas_texture);
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, aw, ah, 0,
-                         GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        }
-        log_info("Created terminal textures: cells %dx%d, atlas %dx%d%s", cols, rows, aw, ah,
-                 shader->term_color_atlas_texture ? " (+color emoji)" : "");
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        shader->term_atlas_layers = 1;
+        shader->term_color_atlas_layers = 0;
+
+        log_info("Created terminal textures: cells %dx%d, atlas pages %dx%d", cols, rows, aw, ah);
     }
 #endif
 
@@ -1474,11 +1485,14 @@ static void cache_uniform_locations(multipass_pass_t *pass) {
     u->iAudioBeat    = glGetUniformLocation(prog, "iAudioBeat");
     u->iAudioActive  = glGetUniformLocation(prog, "iAudioActive");
     u->iAudio        = glGetUniformLocation(prog, "iAudio");
+    u->iAudioHistory = glGetUniformLocation(prog, "iAudioHistory");
+    u->iAudioHistoryHead = glGetUniformLocation(prog, "iAudioHistoryHead");
     u->iTermAtlas    = glGetUniformLocation(prog, "iTermAtlas");
     u->iTermColorAtlas = glGetUniformLocation(prog, "iTermColorAtlas");
     u->iTermCells    = glGetUniformLocation(prog, "iTermCells");
     u->iTermChange   = glGetUniformLocation(prog, "iTermChange");
     u->iTermInfo     = glGetUniformLocation(prog, "iTermInfo");
+    u->iTermRowBase  = glGetUniformLocation(prog, "iTermRowBase");
     u->iTermAtlasSize = glGetUniformLocation(prog, "iTermAtlasSize");
     u->iTermCursor   = glGetUniformLocation(prog, "iTermCursor");
     u->iTermCursorPrev = glGetUniformLocation(prog, "iTermCursorPrev");
@@ -1520,6 +1534,127 @@ static void cache_channel_buffer_indices(multipass_shader_t *shader) {
 }
 
 /* Check if shader source uses textureLod (needs mipmaps) */
+/* True if any pass samples the live audio texture, through iAudio or an
+ * iChannel bound to CHANNEL_SOURCE_AUDIO. */
+static bool multipass_samples_audio(const multipass_shader_t *shader) {
+    for (int p = 0; p < shader->pass_count; p++) {
+        const multipass_pass_t *pass = &shader->passes[p];
+        if (!pass->program || !pass->uniforms.cached) continue;
+        if (pass->uniforms.iAudio >= 0) return true;
+        for (int c = 0; c < MULTIPASS_MAX_CHANNELS; c++) {
+            if (pass->uniforms.iChannel[c] >= 0 &&
+                pass->channels[c].source == CHANNEL_SOURCE_AUDIO) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* True if any pass samples the spectrogram history texture. */
+static bool multipass_samples_audio_history(const multipass_shader_t *shader) {
+    for (int p = 0; p < shader->pass_count; p++) {
+        const multipass_pass_t *pass = &shader->passes[p];
+        if (pass->program && pass->uniforms.cached && pass->uniforms.iAudioHistory >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* The reactive signal groups this shader reads: every reactive uniform that
+ * resolved to a location in some compiled pass, every live-bound manifest
+ * uniform, and the audio textures. */
+static uint32_t multipass_reactive_signals(const multipass_shader_t *shader) {
+    uint32_t m = 0;
+    for (int p = 0; p < shader->pass_count; p++) {
+        const multipass_pass_t *pass = &shader->passes[p];
+        const uniform_locations_t *u = &pass->uniforms;
+        if (!pass->program || !u->cached) continue;
+#define NEED(loc, sig) do { if (u->loc >= 0) m |= (sig); } while (0)
+        NEED(iCpu, REACTIVE_SIG_CPU);
+        NEED(iCpuCores, REACTIVE_SIG_CPU);
+        NEED(iCpuCoreCount, REACTIVE_SIG_CPU);
+        NEED(iCpuMax, REACTIVE_SIG_CPU);
+        NEED(iCpuSpread, REACTIVE_SIG_CPU);
+        NEED(iRam, REACTIVE_SIG_RAM);
+        NEED(iRamGB, REACTIVE_SIG_RAM);
+        NEED(iRamTotalGB, REACTIVE_SIG_RAM);
+        NEED(iSwap, REACTIVE_SIG_RAM);
+        NEED(iNetDown, REACTIVE_SIG_NET);
+        NEED(iNetUp, REACTIVE_SIG_NET);
+        NEED(iNetDownRaw, REACTIVE_SIG_NET);
+        NEED(iNetUpRaw, REACTIVE_SIG_NET);
+        NEED(iDiskRead, REACTIVE_SIG_DISK);
+        NEED(iDiskWrite, REACTIVE_SIG_DISK);
+        NEED(iLoad, REACTIVE_SIG_LOAD);
+        NEED(iLoadRaw, REACTIVE_SIG_LOAD);
+        NEED(iProcs, REACTIVE_SIG_LOAD);
+        NEED(iProcCount, REACTIVE_SIG_LOAD);
+        NEED(iCpuTemp, REACTIVE_SIG_CPU_TEMP);
+        NEED(iCpuTempC, REACTIVE_SIG_CPU_TEMP);
+        NEED(iGpu, REACTIVE_SIG_GPU);
+        NEED(iGpuTemp, REACTIVE_SIG_GPU);
+        NEED(iGpuTempC, REACTIVE_SIG_GPU);
+        NEED(iNvGpu, REACTIVE_SIG_NVIDIA);
+        NEED(iNvVram, REACTIVE_SIG_NVIDIA);
+        NEED(iNvGpuTempC, REACTIVE_SIG_NVIDIA);
+        NEED(iNvPower, REACTIVE_SIG_NVIDIA);
+        NEED(iNvActive, REACTIVE_SIG_NVIDIA);
+        NEED(iThermal, REACTIVE_SIG_THERMAL);
+        NEED(iActivity, REACTIVE_SIG_ACTIVITY);
+        NEED(iPulse, REACTIVE_SIG_ACTIVITY);
+        NEED(iUptimeHours, REACTIVE_SIG_UPTIME);
+        NEED(iBattery, REACTIVE_SIG_BATTERY);
+        NEED(iCharging, REACTIVE_SIG_BATTERY);
+        NEED(iTimeOfDay, REACTIVE_SIG_TIME);
+        NEED(iSun, REACTIVE_SIG_TIME);
+        NEED(iDayFraction, REACTIVE_SIG_TIME);
+        NEED(iKeyEnergy, REACTIVE_SIG_INPUT);
+        NEED(iMouseEnergy, REACTIVE_SIG_INPUT);
+        NEED(iAudioLevel, REACTIVE_SIG_AUDIO);
+        NEED(iAudioBass, REACTIVE_SIG_AUDIO);
+        NEED(iAudioMid, REACTIVE_SIG_AUDIO);
+        NEED(iAudioTreble, REACTIVE_SIG_AUDIO);
+        NEED(iAudioBeat, REACTIVE_SIG_AUDIO);
+        NEED(iAudioActive, REACTIVE_SIG_AUDIO);
+#undef NEED
+    }
+    if (multipass_samples_audio(shader) || multipass_samples_audio_history(shader)) {
+        m |= REACTIVE_SIG_AUDIO;
+    }
+
+    for (int ui = 0; ui < shader->user_uniform_count; ui++) {
+        switch (shader->user_uniforms[ui].bind) {
+            case UNIFORM_BIND_CONST:        break;
+            case UNIFORM_BIND_CPU:          m |= REACTIVE_SIG_CPU; break;
+            case UNIFORM_BIND_RAM:          m |= REACTIVE_SIG_RAM; break;
+            case UNIFORM_BIND_SWAP:         m |= REACTIVE_SIG_RAM; break;
+            case UNIFORM_BIND_NET_DOWN:     m |= REACTIVE_SIG_NET; break;
+            case UNIFORM_BIND_NET_UP:       m |= REACTIVE_SIG_NET; break;
+            case UNIFORM_BIND_DISK_READ:    m |= REACTIVE_SIG_DISK; break;
+            case UNIFORM_BIND_DISK_WRITE:   m |= REACTIVE_SIG_DISK; break;
+            case UNIFORM_BIND_LOAD:         m |= REACTIVE_SIG_LOAD; break;
+            case UNIFORM_BIND_PROCS:        m |= REACTIVE_SIG_LOAD; break;
+            case UNIFORM_BIND_BATTERY:      m |= REACTIVE_SIG_BATTERY; break;
+            case UNIFORM_BIND_CPU_TEMP:     m |= REACTIVE_SIG_CPU_TEMP; break;
+            case UNIFORM_BIND_GPU:          m |= REACTIVE_SIG_GPU; break;
+            case UNIFORM_BIND_GPU_TEMP:     m |= REACTIVE_SIG_GPU; break;
+            case UNIFORM_BIND_UPTIME:       m |= REACTIVE_SIG_UPTIME; break;
+            case UNIFORM_BIND_TIME_OF_DAY:  m |= REACTIVE_SIG_TIME; break;
+            case UNIFORM_BIND_SUN:          m |= REACTIVE_SIG_TIME; break;
+            case UNIFORM_BIND_KEY_ENERGY:   m |= REACTIVE_SIG_INPUT; break;
+            case UNIFORM_BIND_MOUSE_ENERGY: m |= REACTIVE_SIG_INPUT; break;
+            case UNIFORM_BIND_AUDIO_LEVEL:
+            case UNIFORM_BIND_AUDIO_BASS:
+            case UNIFORM_BIND_AUDIO_MID:
+            case UNIFORM_BIND_AUDIO_TREBLE:
+            case UNIFORM_BIND_AUDIO_BEAT:   m |= REACTIVE_SIG_AUDIO; break;
+        }
+    }
+    return m;
+}
+
 static bool shader_uses_textureLod(const char *source) {
     return source && strstr(source, "textureLod") != NULL;
 }
@@ -1660,6 +1795,16 @@ bool multipass_compile_all(multipass_shader_t *shader) {
         }
     }
 
+    /* Start the reactive collectors this shader reads (and only those);
+     * acquire before release so a recompile never bounces a shared one. */
+    uint32_t demand = multipass_reactive_signals(shader);
+    reactive_demand_acquire(demand);
+    reactive_demand_release(shader->reactive_demand);
+    shader->reactive_demand = demand;
+    if (demand) {
+        log_info("Shader reads reactive signals 0x%04x", demand);
+    }
+
     return all_success;
 }
 
@@ -1784,6 +1929,9 @@ void multipass_resize(multipass_shader_t *shader, int width, int height) {
 void multipass_destroy(multipass_shader_t *shader) {
     if (!shader) return;
 
+    reactive_demand_release(shader->reactive_demand);
+    shader->reactive_demand = 0;
+
     /* Delete passes */
     for (int i = 0; i < shader->pass_count; i++) {
         multipass_pass_t *pass = &shader->passes[i];
@@ -1803,6 +1951,7 @@ void multipass_destroy(multipass_shader_t *shader) {
     if (shader->noise_texture) glDeleteTextures(1, &shader->noise_texture);
     if (shader->keyboard_texture) glDeleteTextures(1, &shader->keyboard_texture);
     if (shader->audio_texture) glDeleteTextures(1, &shader->audio_texture);
+    if (shader->audio_history_texture) glDeleteTextures(1, &shader->audio_history_texture);
     if (shader->font_texture) glDeleteTextures(1, &shader->font_texture);
 #ifdef NEOWALL_HAVE_TERMINAL
     if (shader->term_cell_texture) glDeleteTextures(1, &shader->term_cell_texture);
@@ -1920,7 +2069,7 @@ void multipass_set_uniforms(multipass_shader_t *shader,
     }
 
     /* --- neowall reactive uniforms (live system + audio) ---
-     * Snapshot taken ONCE per frame in multipass_render (mutex-guarded copy);
+     * Snapshot taken ONCE per frame in multipass_render (lock-free copy);
      * all passes read the same coherent values. Each glUniform is skipped
      * if the shader didn't reference that uniform (location < 0). */
     const reactive_snapshot_t *rp = &shader->frame_reactive;
@@ -2105,13 +2254,24 @@ void multipass_bind_textures(multipass_shader_t *shader, int pass_index) {
         glUniform1i(u->iAudio, MULTIPASS_MAX_CHANNELS);
     }
 
+    /* Spectrogram history on unit 9, after the terminal units. The head is
+     * the ring row of the newest spectrum; spectrogram() counts back from it. */
+    if (u->iAudioHistory >= 0 && shader->audio_history_texture) {
+        glActiveTexture(GL_TEXTURE0 + MULTIPASS_MAX_CHANNELS + 5);
+        glBindTexture(GL_TEXTURE_2D, shader->audio_history_texture);
+        glUniform1i(u->iAudioHistory, MULTIPASS_MAX_CHANNELS + 5);
+    }
+    if (u->iAudioHistoryHead >= 0) {
+        glUniform1i(u->iAudioHistoryHead, shader->audio_history_head);
+    }
+
 #ifdef NEOWALL_HAVE_TERMINAL
     /* Terminal glyph-atlas sampler on unit 5, plus grid/atlas/cursor metadata.
      * The cell texture itself is bound to whichever iChannelN the shader set to
      * the "terminal" source above. */
     if (u->iTermAtlas >= 0 && shader->term_atlas_texture) {
         glActiveTexture(GL_TEXTURE0 + MULTIPASS_MAX_CHANNELS + 1);
-        glBindTexture(GL_TEXTURE_2D, shader->term_atlas_texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, shader->term_atlas_texture);
         glUniform1i(u->iTermAtlas, MULTIPASS_MAX_CHANNELS + 1);
     }
     if (u->iTermCells >= 0 && shader->term_cell_texture) {
@@ -2131,15 +2291,15 @@ void multipass_bind_textures(multipass_shader_t *shader, int pass_index) {
             glUniform1i(u->iTermChange, MULTIPASS_MAX_CHANNELS + 4);
         }
     }
-    /* Color-emoji atlas on unit 7. When absent, bind the coverage atlas as a
+    /* Color-emoji atlas on unit 7. When absent, bind the coverage array as a
      * harmless stand-in so the sampler is always valid; the shader never reads
-     * it unless a cell carries the color flag (which requires the font). */
+     * it unless a cell carries the color flag (which requires a colour page). */
     if (u->iTermColorAtlas >= 0) {
         GLuint ctex = shader->term_color_atlas_texture ? shader->term_color_atlas_texture
                                                        : shader->term_atlas_texture;
         if (ctex) {
             glActiveTexture(GL_TEXTURE0 + MULTIPASS_MAX_CHANNELS + 3);
-            glBindTexture(GL_TEXTURE_2D, ctex);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, ctex);
             glUniform1i(u->iTermColorAtlas, MULTIPASS_MAX_CHANNELS + 3);
         }
     }
@@ -2151,6 +2311,9 @@ void multipass_bind_textures(multipass_shader_t *shader, int pass_index) {
                         (float)term_render_cell_w(shader->term),
                         (float)term_render_cell_h(shader->term));
         }
+        if (u->iTermRowBase >= 0) {
+            glUniform1i(u->iTermRowBase, term_render_row_base(shader->term));
+        }
         if (u->iTermAtlasSize >= 0) {
             glUniform2f(u->iTermAtlasSize,
                         (float)term_render_atlas_w(shader->term),
@@ -2291,6 +2454,106 @@ void multipass_render_pass(multipass_shader_t *shader,
     }
 }
 
+/* Create the spectrogram ring on first use: REACTIVE_AUDIO_BINS wide,
+ * audio_history_rows tall, zeroed. REPEAT on T so spectrogram() can blend
+ * across the wrap point. */
+static bool create_audio_history(multipass_shader_t *shader) {
+    int rows = shader->audio_history_rows > 0 ? shader->audio_history_rows
+                                              : MULTIPASS_AUDIO_HISTORY_ROWS;
+    float *zero = calloc((size_t)REACTIVE_AUDIO_BINS * rows, sizeof(float));
+    if (!zero) return false;
+    glGenTextures(1, &shader->audio_history_texture);
+    glBindTexture(GL_TEXTURE_2D, shader->audio_history_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, REACTIVE_AUDIO_BINS, rows, 0,
+                 GL_RED, GL_FLOAT, zero);
+    free(zero);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    shader->audio_history_rows = rows;
+    shader->audio_history_head = rows - 1;
+    log_info("Created audio history texture (512x%d, id=%u)", rows,
+             shader->audio_history_texture);
+    return true;
+}
+
+/* Append every audio frame produced since the last render to the spectrogram
+ * ring, one glTexSubImage2D row each (2 KB), advancing the head. The audio
+ * thread runs faster than most displays, so this is usually one or two rows;
+ * frames older than the reactive backlog are skipped rather than invented. */
+static void update_audio_history(multipass_shader_t *shader) {
+    if (!shader->audio_history_texture && !create_audio_history(shader)) return;
+
+    const reactive_snapshot_t *ra = &shader->frame_reactive;
+    uint32_t newest = ra->audio_frame;
+    if (!ra->audio_active || newest == shader->audio_history_frame) return;
+
+    uint32_t pending = newest - shader->audio_history_frame;
+    if (shader->audio_history_frame == 0 || pending > REACTIVE_AUDIO_BACKLOG) {
+        pending = REACTIVE_AUDIO_BACKLOG;
+    }
+
+    float row[REACTIVE_AUDIO_BINS];
+    glBindTexture(GL_TEXTURE_2D, shader->audio_history_texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (uint32_t f = newest - pending + 1; f != newest + 1; f++) {
+        if (!reactive_get_audio_row(f, row)) continue;
+        shader->audio_history_head = (shader->audio_history_head + 1) % shader->audio_history_rows;
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, shader->audio_history_head,
+                        REACTIVE_AUDIO_BINS, 1, GL_RED, GL_FLOAT, row);
+    }
+    shader->audio_history_frame = newest;
+}
+
+#ifdef NEOWALL_HAVE_TERMINAL
+/* Push a terminal glyph page array (coverage or colour) to its texture. A
+ * texture array can't gain layers in place, so when the atlas has grown a page
+ * the array is reallocated at the new depth and every page is pushed; on other
+ * frames only the dirty rows of dirty pages go up. */
+static void upload_term_atlas(GLuint *tex, int *layers, term_render *tr, bool color) {
+    int pages = color ? term_render_color_atlas_pages(tr) : term_render_atlas_pages(tr);
+    if (pages <= 0) return;
+    int aw = term_render_atlas_w(tr);
+    int ah = term_render_atlas_h(tr);
+    GLenum fmt = color ? GL_RGBA : GL_RED;
+    size_t bpp = color ? 4 : 1;
+
+    if (!*tex) {
+        glGenTextures(1, tex);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, *tex);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, *tex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    bool all = pages != *layers;
+    if (all) {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, color ? GL_RGBA8 : GL_R8, aw, ah, pages, 0,
+                     fmt, GL_UNSIGNED_BYTE, NULL);
+        *layers = pages;
+    }
+    for (int p = 0; p < pages; p++) {
+        const uint8_t *bits = color ? term_render_color_atlas_page(tr, p)
+                                    : term_render_atlas_page(tr, p);
+        int y0 = 0, y1 = ah;
+        bool dirty = color ? term_render_color_atlas_page_dirty_rows(tr, p, &y0, &y1)
+                           : term_render_atlas_page_dirty_rows(tr, p, &y0, &y1);
+        if (all) { y0 = 0; y1 = ah; }
+        else if (!dirty) continue;
+        if (y0 < 0) y0 = 0;
+        if (y1 > ah) y1 = ah;
+        if (!bits || y1 <= y0) continue;
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, y0, p, aw, y1 - y0, 1,
+                        fmt, GL_UNSIGNED_BYTE, bits + (size_t)y0 * aw * bpp);
+    }
+    if (color) term_render_clear_color_atlas_dirty(tr);
+    else       term_render_clear_atlas_dirty(tr);
+}
+#endif
+
 void multipass_render(multipass_shader_t *shader,
                       float time,
                       float mouse_x, float mouse_y,
@@ -2330,9 +2593,10 @@ void multipass_render(multipass_shader_t *shader,
     }
     shader->last_frame_wall = wall_time;
 
-    /* One reactive snapshot per FRAME (mutex-guarded ~2.2KB copy), shared by
-     * all passes and the audio texture upload below. */
-    reactive_get(&shader->frame_reactive);
+    /* One reactive snapshot per FRAME (lock-free copy of the scalars),
+     * shared by all passes and the audio texture upload below. Keyed to
+     * iTime so a replayed signal trace lines up with the shader's clock. */
+    reactive_get_at(&shader->frame_reactive, time);
 
     /* Start GPU timing for this frame (if enabled) */
     adaptive_begin_frame(&shader->adaptive);
@@ -2412,22 +2676,29 @@ void multipass_render(multipass_shader_t *shader,
 
     log_debug_frame(shader->frame_count, "=== Frame %d ===", shader->frame_count);
 
-    /* Refresh the live audio texture once per frame from this frame's
-     * reactive snapshot. Skipped cheaply if no audio is live (the texture
-     * just stays zero). */
-    if (shader->audio_texture) {
+    /* Refresh the live audio texture from the reactive audio rows. Skipped
+     * cheaply if no pass samples it, no audio is live (the texture just stays
+     * zero) or the audio thread has not produced a new frame since the last
+     * upload; only then are the 4 KB of rows copied and pushed. */
+    if (shader->audio_texture && multipass_samples_audio(shader)) {
         const reactive_snapshot_t *ra = &shader->frame_reactive;
-        if (ra->audio_active) {
-            float rows[REACTIVE_AUDIO_BINS * 2];
-            memcpy(&rows[0], ra->audio_spectrum, sizeof(ra->audio_spectrum));
-            memcpy(&rows[REACTIVE_AUDIO_BINS], ra->audio_waveform, sizeof(ra->audio_waveform));
+        if (ra->audio_active && ra->audio_frame != shader->audio_frame_uploaded) {
+            reactive_audio_t rows;
+            reactive_get_audio(&rows);
             glBindTexture(GL_TEXTURE_2D, shader->audio_texture);
             glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, REACTIVE_AUDIO_BINS, 2,
-                            GL_RED, GL_FLOAT, rows);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, REACTIVE_AUDIO_BINS, 1,
+                            GL_RED, GL_FLOAT, rows.spectrum);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 1, REACTIVE_AUDIO_BINS, 1,
+                            GL_RED, GL_FLOAT, rows.waveform);
+            shader->audio_frame_uploaded = rows.frame;
         }
     }
 
+    if (multipass_samples_audio_history(shader)) {
+        update_audio_history(shader);
+    }
+
 #ifdef NEOWALL_HAVE_TERMINAL
     /* Refresh the terminal textures once per frame. term_render_update pulls a
      * frame-coherent snapshot and returns true only when the grid changed, so
@@ -2436,83 +2707,54 @@ void multipass_render(multipass_shader_t *shader,
     if (shader->term && shader->term_cell_texture) {
         bool cells_changed = term_render_update(shader->term);
 
-        if (term_render_atlas_dirty(shader->term)) {
-            int aw = term_render_atlas_w(shader->term);
-            int ah = term_render_atlas_h(shader->term);
-            const uint8_t *bits = term_render_atlas(shader->term);
-            int y0 = 0, y1 = ah;
-            term_render_atlas_dirty_rows(shader->term, &y0, &y1);
-            if (y0 < 0) y0 = 0;
-            if (y1 > ah) y1 = ah;
-            if (y1 > y0) {
-                glBindTexture(GL_TEXTURE_2D, shader->term_atlas_texture);
-                glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-                /* Push only the rows that changed since the last upload. The
-                 * atlas is a fixed-size R8 texture, so a sub-rect covering
-                 * [y0,y1) avoids re-sending the whole 2048x2048 (4 MB) on every
-                 * new glyph. */
-                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y0, aw, y1 - y0,
-                                GL_RED, GL_UNSIGNED_BYTE,
-                                bits + (size_t)y0 * aw);
-            }
-            term_render_clear_atlas_dirty(shader->term);
-        }
-
-        /* Color-emoji atlas: same dirty-row sub-rect upload, RGBA8. */
-        if (shader->term_color_atlas_texture && term_render_color_atlas_dirty(shader->term)) {
-            int aw = term_render_atlas_w(shader->term);
-            int ah = term_render_atlas_h(shader->term);
-            const uint8_t *bits = term_render_color_atlas(shader->term);
-            int y0 = 0, y1 = ah;
-            term_render_color_atlas_dirty_rows(shader->term, &y0, &y1);
-            if (y0 < 0) y0 = 0;
-            if (y1 > ah) y1 = ah;
-            if (bits && y1 > y0) {
-                glBindTexture(GL_TEXTURE_2D, shader->term_color_atlas_texture);
-                glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y0, aw, y1 - y0,
-                                GL_RGBA, GL_UNSIGNED_BYTE,
-                                bits + (size_t)y0 * aw * 4);
-            }
-            term_render_clear_color_atlas_dirty(shader->term);
-        }
+        /* Glyph pages: only the rows new glyphs landed on, or the whole
+         * array when the atlas grew a page. */
+        if (term_render_atlas_dirty(shader->term))
+            upload_term_atlas(&shader->term_atlas_texture, &shader->term_atlas_layers,
+                              shader->term, false);
+        if (term_render_color_atlas_dirty(shader->term))
+            upload_term_atlas(&shader->term_color_atlas_texture,
+                              &shader->term_color_atlas_layers, shader->term, true);
 
         if (cells_changed) {
             int cols = term_render_cols(shader->term);
             int rows = term_render_rows(shader->term);
             const uint32_t *cells = term_render_cells(shader->term);
-            /* Push only the band of rows that changed since the last frame
-             * (computed by term_render_update's row diff). For a terminal where
-             * a few lines move per frame this is a fraction of the full
-             * cols*rows*16-byte grid. UNPACK_ROW_LENGTH keeps the source
-             * stride at the full row width while we upload a sub-rect. */
-            int y0 = 0, y1 = rows;
-            term_render_cells_dirty_rows(shader->term, &y0, &y1);
-            if (y0 < 0) y0 = 0;
-            if (y1 > rows) y1 = rows;
-            if (y1 > y0) {
+            /* Push only the rows that changed since the last frame (the
+             * screen's dirty rows that term_render_update found to differ),
+             * one sub-rect per run of consecutive rows. For htop's clock tick
+             * that is a single row, not the band from it down to the last
+             * process line. The texture rows are a ring (iTermRowBase), so a
+             * log scrolling by a line uploads that line, not the grid.
+             * UNPACK_ROW_LENGTH keeps the source stride at the full row width
+             * while we upload a sub-rect. */
+            const uint32_t *chg = term_render_change_ms(shader->term);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, cols);
+            for (int y = 0; y < rows;) {
+                if (!term_render_cells_row_dirty(shader->term, y)) {
+                    y++;
+                    continue;
+                }
+                int run = y;
+                while (y < rows && term_render_cells_row_dirty(shader->term, y)) y++;
+
                 glBindTexture(GL_TEXTURE_2D, shader->term_cell_texture);
-                glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-                glPixelStorei(GL_UNPACK_ROW_LENGTH, cols);
-                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y0, cols, y1 - y0,
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, run, cols, y - run,
                                 GL_RGBA_INTEGER, GL_UNSIGNED_INT,
-                                cells + (size_t)y0 * cols * 4);
-                glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+                                cells + (size_t)run * cols * 4);
 
-                /* Push the matching band of per-cell change timestamps (R32UI,
-                 * one uint per cell) so the shader's change-driven fade sees the
-                 * fresh stamps. Same [y0,y1) band as the cell upload. */
-                const uint32_t *chg = term_render_change_ms(shader->term);
+                /* The matching rows of per-cell change timestamps (R32UI, one
+                 * uint per cell), so the shader's change-driven fade sees the
+                 * fresh stamps. */
                 if (chg && shader->term_change_texture) {
                     glBindTexture(GL_TEXTURE_2D, shader->term_change_texture);
-                    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-                    glPixelStorei(GL_UNPACK_ROW_LENGTH, cols);
-                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y0, cols, y1 - y0,
+                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, run, cols, y - run,
                                     GL_RED_INTEGER, GL_UNSIGNED_INT,
-                                    chg + (size_t)y0 * cols);
-                    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+                                    chg + (size_t)run * cols);
                 }
             }
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
         }
     }
 #endif
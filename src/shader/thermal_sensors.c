@@ -0,0 +1,360 @@
+/* Thermal sensor discovery — implementation. See thermal_sensors.h. */
+
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "thermal_sensors.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MAX_ENTRIES 64   /* hwmon chips / thermal zones looked at per class */
+#define MAX_INPUTS 16    /* tempN_input indices tried per hwmon chip */
+
+/* One open sensor input. */
+struct sensor {
+    char path[160];      /* root-relative */
+    int fd;
+    dev_t dev;           /* identity at open time */
+    ino_t ino;
+    thermal_class_t cls;
+};
+
+struct thermal_sensors {
+    char root[256];
+    struct sensor in[THERMAL_SENSORS_MAX];
+    int n;
+    char cpu_desc[96];
+    char gpu_desc[96];
+};
+
+/* Name prefixes by preference; rank 0 = not this class. */
+typedef struct {
+    const char *prefix;
+    int rank;
+} match_t;
+
+static const match_t k_hwmon_cpu[] = {
+    {"coretemp", 1}, {"k10temp", 1}, {"zenpower", 1}, {"cpu_thermal", 2}, {"soc_thermal", 3},
+};
+static const match_t k_hwmon_gpu[] = {
+    {"amdgpu", 1}, {"radeon", 1}, {"nouveau", 1}, {"nvidia", 1}, {"i915", 2}, {"xe", 2},
+};
+static const match_t k_zone_cpu[] = {
+    {"x86_pkg_temp", 1}, {"cpu", 2}, {"soc", 3},
+};
+static const match_t k_zone_gpu[] = {
+    {"gpu", 1},
+};
+
+/* Labels of the package/die input of a CPU chip. */
+static const char *const k_package_labels[] = {"Package id", "Physical id", "Tctl", "Tdie"};
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static int rank_of(const match_t *table, size_t n, const char *name) {
+    for (size_t i = 0; i < n; i++) {
+        if (strncmp(name, table[i].prefix, strlen(table[i].prefix)) == 0) return table[i].rank;
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * File helpers
+ * ============================================================================ */
+
+static void full_path(const struct thermal_sensors *ts, const char *rel, char *out, size_t cap) {
+    snprintf(out, cap, "%s%s", ts->root, rel);
+}
+
+/* Read a small sysfs file with pread from offset 0; trailing newline
+ * stripped. Returns the length or -1. */
+static long pread_str(int fd, char *buf, size_t cap) {
+    ssize_t n;
+    do {
+        n = pread(fd, buf, cap - 1, 0);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) return -1;
+    buf[n] = '\0';
+    while (n > 0 && (buf[n - 1] == '\n' || buf[n - 1] == ' ')) buf[--n] = '\0';
+    return (long)n;
+}
+
+static long read_str(const struct thermal_sensors *ts, const char *rel, char *buf, size_t cap) {
+    char full[512];
+    full_path(ts, rel, full, sizeof(full));
+    int fd = open(full, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    long n = pread_str(fd, buf, cap);
+    close(fd);
+    return n;
+}
+
+static bool exists(const struct thermal_sensors *ts, const char *rel) {
+    char full[512];
+    full_path(ts, rel, full, sizeof(full));
+    return access(full, R_OK) == 0;
+}
+
+/* Directory entries starting with `prefix`, in natural order (hwmon2 before
+ * hwmon10) so discovery does not depend on readdir order. */
+static int list_dir(const struct thermal_sensors *ts, const char *rel, const char *prefix,
+                    char names[][32], int cap) {
+    char full[512];
+    full_path(ts, rel, full, sizeof(full));
+    DIR *d = opendir(full);
+    if (!d) return 0;
+    int n = 0;
+    struct dirent *e;
+    while ((e = readdir(d)) && n < cap) {
+        if (strncmp(e->d_name, prefix, strlen(prefix)) != 0) continue;
+        if (strlen(e->d_name) >= 32) continue;
+        snprintf(names[n++], 32, "%s", e->d_name);
+    }
+    closedir(d);
+    for (int i = 1; i < n; i++) {
+        for (int j = i; j > 0; j--) {
+            size_t la = strlen(names[j - 1]), lb = strlen(names[j]);
+            if (la < lb || (la == lb && strcmp(names[j - 1], names[j]) <= 0)) break;
+            char tmp[32];
+            memcpy(tmp, names[j - 1], 32);
+            memcpy(names[j - 1], names[j], 32);
+            memcpy(names[j], tmp, 32);
+        }
+    }
+    return n;
+}
+
+/* Open `rel` as a sensor of class `cls`. False if the set is full or the
+ * file can't be opened. */
+static bool add_input(struct thermal_sensors *ts, const char *rel, thermal_class_t cls) {
+    if (ts->n >= THERMAL_SENSORS_MAX || strlen(rel) >= sizeof(ts->in[0].path)) return false;
+    struct sensor *s = &ts->in[ts->n];
+    char full[512];
+    full_path(ts, rel, full, sizeof(full));
+    s->fd = open(full, O_RDONLY | O_CLOEXEC);
+    if (s->fd < 0) return false;
+    struct stat st;
+    if (fstat(s->fd, &st) == 0) {
+        s->dev = st.st_dev;
+        s->ino = st.st_ino;
+    }
+    snprintf(s->path, sizeof(s->path), "%s", rel);
+    s->cls = cls;
+    ts->n++;
+    return true;
+}
+
+/* ============================================================================
+ * Discovery
+ * ============================================================================ */
+
+static bool is_package_label(const char *label) {
+    for (size_t i = 0; i < COUNT(k_package_labels); i++) {
+        const char *p = k_package_labels[i];
+        if (strncmp(label, p, strlen(p)) == 0) return true;
+    }
+    return false;
+}
+
+/* Add the inputs of one hwmon chip. CPU: its package inputs, else its first
+ * THERMAL_SENSORS_CPU_INPUTS. GPU: its "edge" input, else its first. The
+ * label of the first input added ("" if unlabelled) goes to `label`; false if
+ * nothing was added. */
+static bool add_hwmon_chip(struct thermal_sensors *ts, const char *chip, thermal_class_t cls,
+                           char label[32]) {
+    int present[MAX_INPUTS], npresent = 0;
+    char labels[MAX_INPUTS][32];
+    int preferred[MAX_INPUTS], npreferred = 0;
+
+    for (int i = 1; i <= MAX_INPUTS; i++) {
+        char rel[160];
+        snprintf(rel, sizeof(rel), "/sys/class/hwmon/%s/temp%d_input", chip, i);
+        if (!exists(ts, rel)) continue;
+        int k = npresent++;
+        present[k] = i;
+        snprintf(rel, sizeof(rel), "/sys/class/hwmon/%s/temp%d_label", chip, i);
+        if (read_str(ts, rel, labels[k], sizeof(labels[k])) < 0) labels[k][0] = '\0';
+        bool want = cls == THERMAL_CPU ? is_package_label(labels[k])
+                                       : strcmp(labels[k], "edge") == 0;
+        if (want) preferred[npreferred++] = k;
+    }
+    if (npresent == 0) return false;
+
+    int pick[MAX_INPUTS], npick = 0;
+    if (npreferred > 0) {
+        memcpy(pick, preferred, sizeof(int) * (size_t)npreferred);
+        npick = npreferred;
+    } else {
+        int limit = cls == THERMAL_CPU ? THERMAL_SENSORS_CPU_INPUTS : 1;
+        for (int k = 0; k < npresent && k < limit; k++) pick[npick++] = k;
+    }
+
+    bool added = false;
+    for (int j = 0; j < npick; j++) {
+        char rel[160];
+        snprintf(rel, sizeof(rel), "/sys/class/hwmon/%s/temp%d_input", chip, present[pick[j]]);
+        if (add_input(ts, rel, cls) && !added) {
+            memcpy(label, labels[pick[j]], 32);
+            added = true;
+        }
+    }
+    return added;
+}
+
+/* Pick the best-ranked hwmon chips of a class. CPU takes every chip of the
+ * best rank (one coretemp per socket), GPU only the first. */
+static bool scan_hwmon(struct thermal_sensors *ts, thermal_class_t cls, char *desc,
+                       size_t desc_cap) {
+    const match_t *table = cls == THERMAL_CPU ? k_hwmon_cpu : k_hwmon_gpu;
+    size_t ntable = cls == THERMAL_CPU ? COUNT(k_hwmon_cpu) : COUNT(k_hwmon_gpu);
+
+    char chips[MAX_ENTRIES][32];
+    char names[MAX_ENTRIES][32];
+    int ranks[MAX_ENTRIES];
+    int n = list_dir(ts, "/sys/class/hwmon", "hwmon", chips, MAX_ENTRIES);
+    int best = 0;
+    for (int i = 0; i < n; i++) {
+        char rel[160];
+        snprintf(rel, sizeof(rel), "/sys/class/hwmon/%s/name", chips[i]);
+        if (read_str(ts, rel, names[i], sizeof(names[i])) <= 0) names[i][0] = '\0';
+        ranks[i] = names[i][0] ? rank_of(table, ntable, names[i]) : 0;
+        if (ranks[i] && (!best || ranks[i] < best)) best = ranks[i];
+    }
+    if (!best) return false;
+
+    bool found = false;
+    for (int i = 0; i < n; i++) {
+        if (ranks[i] != best) continue;
+        char label[32];
+        if (!add_hwmon_chip(ts, chips[i], cls, label)) continue;
+        if (!found) {
+            snprintf(desc, desc_cap, "%s%s%s (%s)", names[i], label[0] ? " " : "", label,
+                     chips[i]);
+        }
+        found = true;
+        if (cls == THERMAL_GPU) break;
+    }
+    return found;
+}
+
+/* Thermal zones of the best rank for a class: up to
+ * THERMAL_SENSORS_CPU_INPUTS for the CPU (per-cluster zones on ARM), one for
+ * the GPU. */
+static bool scan_zones(struct thermal_sensors *ts, thermal_class_t cls, char *desc,
+                       size_t desc_cap) {
+    const match_t *table = cls == THERMAL_CPU ? k_zone_cpu : k_zone_gpu;
+    size_t ntable = cls == THERMAL_CPU ? COUNT(k_zone_cpu) : COUNT(k_zone_gpu);
+    int limit = cls == THERMAL_CPU ? THERMAL_SENSORS_CPU_INPUTS : 1;
+
+    char zones[MAX_ENTRIES][32];
+    char types[MAX_ENTRIES][32];
+    int ranks[MAX_ENTRIES];
+    int n = list_dir(ts, "/sys/class/thermal", "thermal_zone", zones, MAX_ENTRIES);
+    int best = 0;
+    for (int i = 0; i < n; i++) {
+        char rel[160];
+        snprintf(rel, sizeof(rel), "/sys/class/thermal/%s/type", zones[i]);
+        if (read_str(ts, rel, types[i], sizeof(types[i])) <= 0) types[i][0] = '\0';
+        ranks[i] = types[i][0] ? rank_of(table, ntable, types[i]) : 0;
+        if (ranks[i] && (!best || ranks[i] < best)) best = ranks[i];
+    }
+    if (!best) return false;
+
+    int added = 0;
+    for (int i = 0; i < n && added < limit; i++) {
+        if (ranks[i] != best) continue;
+        char rel[160];
+        snprintf(rel, sizeof(rel), "/sys/class/thermal/%s/temp", zones[i]);
+        if (!add_input(ts, rel, cls)) continue;
+        if (!added) snprintf(desc, desc_cap, "%s (%s)", types[i], zones[i]);
+        added++;
+    }
+    return added > 0;
+}
+
+static void close_inputs(struct thermal_sensors *ts) {
+    for (int i = 0; i < ts->n; i++) {
+        if (ts->in[i].fd >= 0) close(ts->in[i].fd);
+    }
+    ts->n = 0;
+    ts->cpu_desc[0] = '\0';
+    ts->gpu_desc[0] = '\0';
+}
+
+void thermal_sensors_rescan(struct thermal_sensors *ts) {
+    if (!ts) return;
+    close_inputs(ts);
+    if (!scan_hwmon(ts, THERMAL_CPU, ts->cpu_desc, sizeof(ts->cpu_desc))) {
+        scan_zones(ts, THERMAL_CPU, ts->cpu_desc, sizeof(ts->cpu_desc));
+    }
+    if (!scan_hwmon(ts, THERMAL_GPU, ts->gpu_desc, sizeof(ts->gpu_desc))) {
+        scan_zones(ts, THERMAL_GPU, ts->gpu_desc, sizeof(ts->gpu_desc));
+    }
+}
+
+struct thermal_sensors *thermal_sensors_open(const char *root) {
+    struct thermal_sensors *ts = calloc(1, sizeof(*ts));
+    if (!ts) return NULL;
+    snprintf(ts->root, sizeof(ts->root), "%s", root ? root : "");
+    thermal_sensors_rescan(ts);
+    return ts;
+}
+
+/* ============================================================================
+ * Reading
+ * ============================================================================ */
+
+/* Milli-degrees from a still-valid input; -1 if the path now names another
+ * file (or none) or the read fails. */
+static long read_input(const struct thermal_sensors *ts, const struct sensor *s) {
+    char full[512];
+    struct stat st;
+    full_path(ts, s->path, full, sizeof(full));
+    if (stat(full, &st) != 0 || st.st_dev != s->dev || st.st_ino != s->ino) return -1;
+    char buf[32];
+    if (pread_str(s->fd, buf, sizeof(buf)) <= 0) return -1;
+    return atol(buf);
+}
+
+void thermal_sensors_read(struct thermal_sensors *ts, unsigned which, thermal_reading_t *out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!ts) return;
+
+    bool cpu_found = false, gpu_found = false, cpu_failed = false, gpu_failed = false;
+    for (int i = 0; i < ts->n; i++) {
+        const struct sensor *s = &ts->in[i];
+        if (!(s->cls & which)) continue;
+        bool cpu = s->cls == THERMAL_CPU;
+        if (cpu) cpu_found = true; else gpu_found = true;
+
+        long milli = read_input(ts, s);
+        if (milli <= 0) {
+            if (cpu) cpu_failed = true; else gpu_failed = true;
+            continue;
+        }
+        float c = (float)milli / 1000.0f;
+        float *dst = cpu ? &out->cpu_c : &out->gpu_c;
+        if (c > *dst) *dst = c;
+    }
+    out->cpu_ok = cpu_found && !cpu_failed;
+    out->gpu_ok = gpu_found && !gpu_failed;
+}
+
+const char *thermal_sensors_describe(const struct thermal_sensors *ts, thermal_class_t cls) {
+    if (!ts) return "";
+    return cls == THERMAL_CPU ? ts->cpu_desc : ts->gpu_desc;
+}
+
+void thermal_sensors_close(struct thermal_sensors *ts) {
+    if (!ts) return;
+    close_inputs(ts);
+    free(ts);
+}
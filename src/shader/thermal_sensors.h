@@ -0,0 +1,65 @@
+/* Thermal sensor discovery: find the CPU package and GPU temperature sensors
+ * among everything under /sys/class/hwmon and /sys/class/thermal, keep their
+ * files open and re-read them with pread.
+ *
+ * hwmon0 and thermal_zone0 are whatever the kernel probed first. On many
+ * machines that is an NVMe drive, a Wi-Fi card or the ACPI zone (acpitz),
+ * not the CPU or GPU. So adaptive_scale.c throttled on a disk temperature,
+ * and the reactive sampler only knew hwmon. Here every hwmon chip is
+ * classified by its `name`:
+ *   CPU: coretemp, k10temp, zenpower, cpu_thermal, ...
+ *   GPU: amdgpu, radeon, nouveau, nvidia (discrete first), then i915, xe
+ * Thermal zones are classified by `type` (x86_pkg_temp, cpu*, soc*, gpu*) and
+ * are used only for a class that no hwmon chip covers, as on many ARM boards.
+ * Drives, NICs, batteries and ACPI zones are never picked.
+ *
+ * Within a CPU chip, inputs labelled as the package (Package id, Tctl, Tdie)
+ * are preferred; an unlabelled chip contributes its first four inputs and the
+ * hottest wins. A GPU chip contributes its "edge" input, or its first one.
+ *
+ * Every path is resolved under a configurable root and nothing here logs, so
+ * tests/test_thermal_sensors.c can run it against a fabricated sysfs tree.
+ */
+
+#ifndef NEOWALL_THERMAL_SENSORS_H
+#define NEOWALL_THERMAL_SENSORS_H
+
+#include <stdbool.h>
+
+#define THERMAL_SENSORS_MAX 8     /* inputs kept open across both classes */
+#define THERMAL_SENSORS_CPU_INPUTS 4
+
+typedef enum {
+    THERMAL_CPU = 1u << 0,
+    THERMAL_GPU = 1u << 1,
+} thermal_class_t;
+
+typedef struct {
+    float cpu_c;  /* hottest chosen CPU input, degrees C; 0 if none answered */
+    float gpu_c;  /* chosen GPU input, degrees C; 0 if none answered */
+    bool cpu_ok;  /* a CPU sensor was found and all of its inputs answered */
+    bool gpu_ok;  /* likewise for the GPU */
+} thermal_reading_t;
+
+struct thermal_sensors;
+
+/* Discover sensors under `root` (NULL or "" = the real /sys). NULL only on
+ * allocation failure; a machine with no usable sensor gets an empty set. */
+struct thermal_sensors *thermal_sensors_open(const char *root);
+
+/* Close the cached files and walk the sysfs classes again. */
+void thermal_sensors_rescan(struct thermal_sensors *ts);
+
+/* Read the sensors of the classes in `which` (THERMAL_* bits). Each input is
+ * checked against its path first, so a chip that was re-probed or unplugged
+ * reads as not ok (the caller then rescans) rather than returning the value
+ * of a deleted file. */
+void thermal_sensors_read(struct thermal_sensors *ts, unsigned which, thermal_reading_t *out);
+
+/* What was picked for a class, e.g. "k10temp Tctl (hwmon2)"; "" if nothing. */
+const char *thermal_sensors_describe(const struct thermal_sensors *ts, thermal_class_t cls);
+
+/* Close every cached file. NULL is a no-op. */
+void thermal_sensors_close(struct thermal_sensors *ts);
+
+#endif /* NEOWALL_THERMAL_SENSORS_H */
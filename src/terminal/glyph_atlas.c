@@ -2,14 +2,24 @@
  * glyph_atlas.c — dynamic font rasterization into a coverage atlas.
  *
  * Uses stb_truetype (vendored, public domain) to rasterize glyphs on demand.
- * Packs them into one bitmap with a simple shelf/skyline row packer, which is
- * more than enough for a terminal's small glyph working set. A hash map caches
- * codepoint -> slot so each glyph is rasterized at most once.
+ * Packs them onto 1024x1024 pages with a simple shelf row packer; pages are
+ * allocated as the working set grows and, at the page limit, the least
+ * recently used page is emptied and refilled. A hash map caches
+ * codepoint -> slot so each glyph is rasterized once while it stays resident,
+ * and glyph_cache keeps every rasterized glyph on disk so the next run (or
+ * the next atlas at the same size) copies it in instead.
+ *
+ * Rendering a glyph (outline raster or distance field, synthesis or emoji
+ * decode) produces a bitmap of its own; placing it reserves page space and
+ * copies it in. With workers started the first half runs on a small thread
+ * pool and the render thread only places finished glyphs, once per frame.
  */
 #include "glyph_atlas.h"
 #include "glyph_synth.h"
+#include "glyph_cache.h"
 #include "cbdt.h"
 
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -139,23 +149,68 @@ static char *fontconfig_match(const char *family, bool monospace, bool color) {
 }
 #endif
 
-/* ---- atlas geometry ---- */
-#define ATLAS_W 2048
-#define ATLAS_H 2048
+/* ---- atlas geometry ----
+ * Glyphs live on fixed-size pages that are allocated on first use and become
+ * the layers of a GL texture array. When the last page is full the coldest
+ * page (the one whose most recently used glyph is oldest) is emptied and
+ * packed again from the top. The page index rides in 5 bits of the cell
+ * record, so neither limit may exceed 32. */
+#define PAGE_W 1024
+#define PAGE_H 1024
+#define MAX_PAGES       32   /* coverage, 1 MB each */
+#define MAX_COLOR_PAGES 8    /* RGBA, 4 MB each */
 
 /* ---- hash map: (codepoint, style) -> slot index ---- */
-#define MAP_CAP 8192   /* power of two; load kept < 0.7 (styled keys triple the set) */
+#define MAP_INIT 1024   /* power of two; doubled to keep load < 0.7 */
 
 /* Style bits folded into the map key so bold/italic variants of the same cp
  * cache separately. Bit 30 = bold, bit 31 = italic (cp is a 21-bit scalar). */
 #define STYLE_BOLD   (1u << 30)
 #define STYLE_ITALIC (1u << 31)
 
+/* Folded into the disk cache key: bump whenever rasterization, synthesis or
+ * emoji scaling would produce different pixels or metrics for the same font. */
+#define RASTER_VERSION 1u
+
+#define MAX_WORKERS 8
+
 typedef struct {
     uint32_t key;      /* 0 = empty; else cp | style bits */
     uint32_t slot;     /* index into slots[] */
 } map_entry;
 
+/* Bookkeeping kept beside each glyph_slot (the public struct stays small). */
+typedef struct {
+    uint32_t key;      /* map key of the glyph in this slot; 0 = free slot */
+    uint32_t last_use; /* frame of the last lookup, for eviction */
+} slot_meta;
+
+/* One page: its bitmap, a shelf packer cursor and the rows touched since the
+ * last upload. */
+typedef struct {
+    uint8_t *bits;     /* PAGE_W * PAGE_H * bpp, zeroed */
+    int      shelf_x, shelf_y, shelf_h;
+    bool     dirty;
+    int      dirty_y0, dirty_y1;   /* half-open */
+} atlas_page;
+
+/* A glyph handed to the workers: the key in, the rendered entry and bitmap
+ * out, then placed into its pending slot by glyph_atlas_collect. */
+typedef struct raster_job {
+    struct raster_job *next;
+    int                slot;
+    glyph_cache_entry  e;
+    uint8_t           *pixels;
+} raster_job;
+
+typedef struct {
+    atlas_page page[MAX_PAGES];
+    int        count;  /* pages allocated */
+    int        limit;  /* pages allowed */
+    int        bpp;    /* 1 = coverage, 4 = RGBA */
+    bool       dirty;  /* any page dirty */
+} page_set;
+
 struct glyph_atlas {
     face regular;
     face bold;
@@ -168,73 +223,252 @@ struct glyph_atlas {
     uint8_t   *emoji_data;   /* owned font buffer backing `emoji` */
 
     int    cell_w, cell_h;
+    bool   sdf;          /* outline glyphs as distance fields */
 
-    uint8_t *bitmap;     /* ATLAS_W * ATLAS_H, 8-bit coverage */
-    bool     dirty;
-    int      dirty_y0, dirty_y1;  /* row range touched since last clear (half-open) */
-
-    /* Color emoji atlas: RGBA8, straight alpha, own shelf packer + dirty rows. */
-    uint8_t *color_bitmap;               /* ATLAS_W * ATLAS_H * 4 */
-    bool     color_dirty;
-    int      color_dirty_y0, color_dirty_y1;
-    int      cshelf_x, cshelf_y, cshelf_h;
+    page_set cov;        /* 8-bit coverage pages */
+    page_set rgba;       /* colour-emoji pages, straight alpha */
 
-    /* shelf packer cursor */
-    int shelf_x, shelf_y, shelf_h;
+    uint32_t frame;      /* advanced by glyph_atlas_begin_frame */
+    uint32_t generation; /* bumped whenever a page is emptied */
+    bool     out_of_room;/* the last reserve failed for want of space */
 
     glyph_slot *slots;
-    int         slot_count, slot_cap;
-
-    map_entry map[MAP_CAP];
+    slot_meta  *meta;
+    int        *free_slots;   /* stack of released slot indices */
+    int         slot_count, slot_cap, free_count;
+
+    map_entry *map;
+    uint32_t   map_cap, map_used;
+
+    uint64_t     font_key;   /* the loaded fonts, for the disk cache key */
+    glyph_cache *disk;       /* NULL without a cache directory */
+    unsigned     disk_hits;
+
+    /* Worker pool. Workers touch only the faces and the emoji font, which
+     * never change after create, and the job lists under `lock`. */
+    pthread_t       workers[MAX_WORKERS];
+    int             nworkers;
+    bool            pool;       /* lock and wake initialized */
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;
+    bool            stop;
+    raster_job     *todo, *todo_tail;  /* queued, oldest first */
+    raster_job     *done;              /* rendered, not yet collected */
+    raster_job     *stalled;           /* collected but found no room (render thread) */
+    int             in_flight;         /* queued and not yet placed (render thread) */
 };
 
 /* ---- hash ---- */
-static inline uint32_t hash_cp(uint32_t key) {
+static inline uint32_t hash_cp(uint32_t key, uint32_t cap) {
     key *= 2654435761u;   /* Knuth multiplicative */
-    return key & (MAP_CAP - 1);
+    return key & (cap - 1);
 }
 
 static int map_find(glyph_atlas *a, uint32_t key) {
-    uint32_t h = hash_cp(key);
-    for (int probe = 0; probe < MAP_CAP; probe++) {
+    uint32_t h = hash_cp(key, a->map_cap);
+    for (uint32_t probe = 0; probe < a->map_cap; probe++) {
         map_entry *e = &a->map[h];
         if (e->key == 0) return -1;        /* empty slot -> not present */
         if (e->key == key) return (int)e->slot;
-        h = (h + 1) & (MAP_CAP - 1);
+        h = (h + 1) & (a->map_cap - 1);
     }
     return -1;
 }
 
+static void map_put(map_entry *map, uint32_t cap, uint32_t *used, uint32_t key, uint32_t slot) {
+    uint32_t h = hash_cp(key, cap);
+    for (uint32_t probe = 0; probe < cap; probe++) {
+        map_entry *e = &map[h];
+        if (e->key == key) { e->slot = slot; return; }
+        if (e->key == 0) { e->key = key; e->slot = slot; (*used)++; return; }
+        h = (h + 1) & (cap - 1);
+    }
+}
+
+/* Rebuild the map at `cap` entries from the live slots. Used to grow it and to
+ * drop the keys of an emptied page in one go (linear probing has no cheap
+ * delete). On OOM the old map is kept. */
+static void map_rebuild(glyph_atlas *a, uint32_t cap) {
+    map_entry *m = calloc(cap, sizeof(*m));
+    if (!m) return;
+    uint32_t used = 0;
+    for (int i = 0; i < a->slot_count; i++)
+        if (a->meta[i].key) map_put(m, cap, &used, a->meta[i].key, (uint32_t)i);
+    free(a->map);
+    a->map = m;
+    a->map_cap = cap;
+    a->map_used = used;
+}
+
 static void map_insert(glyph_atlas *a, uint32_t key, uint32_t slot) {
-    uint32_t h = hash_cp(key);
-    for (int probe = 0; probe < MAP_CAP; probe++) {
-        map_entry *e = &a->map[h];
-        if (e->key == 0 || e->key == key) { e->key = key; e->slot = slot; return; }
-        h = (h + 1) & (MAP_CAP - 1);
+    if ((a->map_used + 1) * 10 > a->map_cap * 7) map_rebuild(a, a->map_cap * 2);
+    /* still full after a failed grow: drop the key. Lookup then re-rasterizes
+     * each time — correctness holds. */
+    if ((a->map_used + 1) * 10 > a->map_cap * 9) return;
+    map_put(a->map, a->map_cap, &a->map_used, key, slot);
+}
+
+/* Take a slot, reusing a released one first. -1 on OOM. The slot holds no
+ * key (so eviction and map rebuilds pass it over) until slot_keep. */
+static int slot_alloc(glyph_atlas *a) {
+    int i;
+    if (a->free_count > 0) {
+        i = a->free_slots[--a->free_count];
+    } else {
+        if (a->slot_count >= a->slot_cap) {
+            int ncap = a->slot_cap * 2;
+            glyph_slot *ns = realloc(a->slots, (size_t)ncap * sizeof(*ns));
+            if (!ns) return -1;
+            a->slots = ns;
+            slot_meta *nm = realloc(a->meta, (size_t)ncap * sizeof(*nm));
+            if (!nm) return -1;
+            a->meta = nm;
+            int *nf = realloc(a->free_slots, (size_t)ncap * sizeof(*nf));
+            if (!nf) return -1;
+            a->free_slots = nf;
+            a->slot_cap = ncap;
+        }
+        i = a->slot_count++;
+    }
+    memset(&a->slots[i], 0, sizeof(a->slots[i]));
+    a->meta[i].key = 0;
+    a->meta[i].last_use = 0;
+    return i;
+}
+
+static void slot_release(glyph_atlas *a, int i) {
+    a->meta[i].key = 0;
+    a->free_slots[a->free_count++] = i;
+}
+
+/* Publish a filled slot under `key`. */
+static int slot_keep(glyph_atlas *a, uint32_t key, int i) {
+    a->meta[i].key = key;
+    a->meta[i].last_use = a->frame;
+    map_insert(a, key, (uint32_t)i);
+    return i;
+}
+
+/* ---- pages ---- */
+
+/* Extend a page's dirty row range to cover [y0, y1). The GL uploader then
+ * re-pushes only these rows of that layer. */
+static void mark_dirty_rows(page_set *ps, int page, int y0, int y1) {
+    atlas_page *pg = &ps->page[page];
+    if (y0 < 0) y0 = 0;
+    if (y1 > PAGE_H) y1 = PAGE_H;
+    if (y0 >= y1) return;
+    if (!pg->dirty) { pg->dirty_y0 = y0; pg->dirty_y1 = y1; }
+    else {
+        if (y0 < pg->dirty_y0) pg->dirty_y0 = y0;
+        if (y1 > pg->dirty_y1) pg->dirty_y1 = y1;
     }
-    /* map full: silently drop (working set exceeded MAP_CAP, absurd for a
-     * terminal). Lookup will just re-rasterize each time — correctness holds. */
-}
-
-/* ---- shelf packer: reserve a w x h rectangle in the atlas ---- */
-static bool atlas_reserve(glyph_atlas *a, int w, int h, uint16_t *ox, uint16_t *oy) {
-    if (w > ATLAS_W) return false;
-    if (a->shelf_x + w > ATLAS_W) {
-        /* new shelf */
-        a->shelf_y += a->shelf_h;
-        a->shelf_x = 0;
-        a->shelf_h = 0;
+    pg->dirty = true;
+    ps->dirty = true;
+}
+
+/* Shelf packer: place w x h on the page, or leave it untouched and fail. */
+static bool shelf_fit(atlas_page *pg, int w, int h, uint16_t *ox, uint16_t *oy) {
+    int x = pg->shelf_x, y = pg->shelf_y, sh = pg->shelf_h;
+    if (x + w > PAGE_W) {   /* new shelf */
+        y += sh;
+        x = 0;
+        sh = 0;
     }
-    if (a->shelf_y + h > ATLAS_H) return false;   /* atlas full */
-    *ox = (uint16_t)a->shelf_x;
-    *oy = (uint16_t)a->shelf_y;
-    a->shelf_x += w;
-    if (h > a->shelf_h) a->shelf_h = h;
+    if (y + h > PAGE_H) return false;
+    *ox = (uint16_t)x;
+    *oy = (uint16_t)y;
+    pg->shelf_x = x + w;
+    pg->shelf_y = y;
+    pg->shelf_h = h > sh ? h : sh;
+    return true;
+}
+
+/* Empty the least recently used page of a set: release its glyphs, clear its
+ * bitmap and restart its packer. Pages holding a glyph looked up this frame
+ * are never chosen — cells resolved earlier in the frame still point at
+ * them. Returns the page, or -1 when every page is in use this frame. */
+static int evict_coldest(glyph_atlas *a, page_set *ps) {
+    bool color = ps == &a->rgba;
+    uint32_t newest[MAX_PAGES] = {0};
+    for (int i = 0; i < a->slot_count; i++) {
+        const glyph_slot *s = &a->slots[i];
+        if (!a->meta[i].key || !s->valid || s->w == 0 || s->color != color) continue;
+        if (a->meta[i].last_use > newest[s->page]) newest[s->page] = a->meta[i].last_use;
+    }
+    int victim = -1;
+    for (int p = 0; p < ps->count; p++) {
+        if (newest[p] >= a->frame) continue;
+        if (victim < 0 || newest[p] < newest[victim]) victim = p;
+    }
+    if (victim < 0) return -1;
+
+    for (int i = 0; i < a->slot_count; i++) {
+        glyph_slot *s = &a->slots[i];
+        if (!a->meta[i].key || !s->valid || s->w == 0 || s->color != color ||
+            s->page != victim)
+            continue;
+        s->valid = false;
+        slot_release(a, i);
+    }
+    map_rebuild(a, a->map_cap);
+
+    atlas_page *pg = &ps->page[victim];
+    memset(pg->bits, 0, (size_t)PAGE_W * PAGE_H * (size_t)ps->bpp);
+    pg->shelf_x = pg->shelf_y = pg->shelf_h = 0;
+    mark_dirty_rows(ps, victim, 0, PAGE_H);
+    a->generation++;
+    return victim;
+}
+
+/* Reserve a w x h rectangle: first fit on an existing page, then a new page,
+ * then the coldest page emptied. Sets out_of_room when none of that worked. */
+static bool atlas_reserve(glyph_atlas *a, page_set *ps, int w, int h,
+                          uint16_t *ox, uint16_t *oy, uint8_t *opage) {
+    if (w > PAGE_W || h > PAGE_H) return false;
+    for (int p = 0; p < ps->count; p++) {
+        if (shelf_fit(&ps->page[p], w, h, ox, oy)) { *opage = (uint8_t)p; return true; }
+    }
+    int p = -1;
+    if (ps->count < ps->limit) {
+        uint8_t *bits = calloc((size_t)PAGE_W * PAGE_H, (size_t)ps->bpp);
+        if (bits) {
+            p = ps->count++;
+            ps->page[p] = (atlas_page){.bits = bits};
+            mark_dirty_rows(ps, p, 0, PAGE_H);   /* a new layer uploads whole */
+        }
+    }
+    if (p < 0) p = evict_coldest(a, ps);
+    if (p < 0 || !shelf_fit(&ps->page[p], w, h, ox, oy)) {
+        a->out_of_room = true;
+        return false;
+    }
+    *opage = (uint8_t)p;
     return true;
 }
 
 /* ---- construction ---- */
 
+static void stop_workers(glyph_atlas *a);   /* worker pool, below */
+
+/* Fold a font the atlas loaded into its disk cache key, tagged with its role
+ * so the same file as bold or as a fallback keys differently. */
+static void key_font(glyph_atlas *a, char role, const char *path) {
+    a->font_key = glyph_cache_hash(&role, 1, a->font_key);
+    a->font_key = glyph_cache_hash_file(path, a->font_key);
+}
+
+/* (Re)open the disk cache for the loaded fonts at this cell size and mode. The
+ * cell size is the supersampled one, so it covers font size, output scale and
+ * supersample factor alike. */
+static void open_disk(glyph_atlas *a) {
+    glyph_cache_close(a->disk);
+    int32_t geometry[] = {a->cell_w, a->cell_h, (int32_t)RASTER_VERSION,
+                          a->sdf ? GLYPH_ATLAS_SDF_SPREAD : 0};
+    a->disk = glyph_cache_open(glyph_cache_hash(geometry, sizeof(geometry), a->font_key),
+                               a->cell_w, a->cell_h);
+}
+
 /* Init a single face from an owned/borrowed font buffer at the cell height.
  * Returns false (face.ready stays 0) if the buffer isn't a usable font. */
 static bool face_init(face *fc, const uint8_t *data, size_t len, bool owns, int cell_h) {
@@ -282,48 +516,6 @@ static void face_free(face *fc) {
     if (fc && fc->ready && fc->owns && fc->data) free((void *)fc->data);
 }
 
-/* Extend the dirty row range to cover [y0, y1). The GL uploader then re-pushes
- * only these rows instead of the whole 2048-row atlas. */
-static void mark_dirty_rows(glyph_atlas *a, int y0, int y1) {
-    if (y0 < 0) y0 = 0;
-    if (y1 > ATLAS_H) y1 = ATLAS_H;
-    if (y0 >= y1) return;
-    if (!a->dirty) { a->dirty_y0 = y0; a->dirty_y1 = y1; }
-    else {
-        if (y0 < a->dirty_y0) a->dirty_y0 = y0;
-        if (y1 > a->dirty_y1) a->dirty_y1 = y1;
-    }
-    a->dirty = true;
-}
-
-/* Color-atlas equivalents of the coverage shelf packer / dirty tracker. */
-static bool color_reserve(glyph_atlas *a, int w, int h, uint16_t *ox, uint16_t *oy) {
-    if (w > ATLAS_W) return false;
-    if (a->cshelf_x + w > ATLAS_W) {
-        a->cshelf_y += a->cshelf_h;
-        a->cshelf_x = 0;
-        a->cshelf_h = 0;
-    }
-    if (a->cshelf_y + h > ATLAS_H) return false;
-    *ox = (uint16_t)a->cshelf_x;
-    *oy = (uint16_t)a->cshelf_y;
-    a->cshelf_x += w;
-    if (h > a->cshelf_h) a->cshelf_h = h;
-    return true;
-}
-
-static void mark_color_dirty_rows(glyph_atlas *a, int y0, int y1) {
-    if (y0 < 0) y0 = 0;
-    if (y1 > ATLAS_H) y1 = ATLAS_H;
-    if (y0 >= y1) return;
-    if (!a->color_dirty) { a->color_dirty_y0 = y0; a->color_dirty_y1 = y1; }
-    else {
-        if (y0 < a->color_dirty_y0) a->color_dirty_y0 = y0;
-        if (y1 > a->color_dirty_y1) a->color_dirty_y1 = y1;
-    }
-    a->color_dirty = true;
-}
-
 /* Box-filter downscale of a straight-alpha RGBA source into a dst rect. Alpha
  * is premultiplied during averaging so translucent edges don't bleed the
  * (undefined) colour of fully-transparent source texels, then un-premultiplied
@@ -361,16 +553,17 @@ static void rgba_downscale(const uint8_t *src, int sw, int sh,
     }
 }
 
-/* Rasterize a color emoji for `cp` into the RGBA color atlas. Returns the new
- * slot index (with .color = true), or -1 if the emoji font lacks it / atlas
- * full. Emoji are square strikes drawn across the glyph's TWO cells at the
- * supersampled cell height; term_render draws head+tail halves from w = 2*cw. */
-static int raster_emoji(glyph_atlas *a, uint32_t cp) {
-    if (!a->emoji || !a->color_bitmap) return -1;
-    if (!cbdt_has(a->emoji, cp)) return -1;
+/* Render a color emoji for `cp`: the strike decoded and box-filtered down to
+ * fit its cells. False if the emoji font lacks it. Emoji are square strikes
+ * drawn across the glyph's TWO cells at the supersampled cell height;
+ * term_render draws head+tail halves from w = 2*cw. */
+static bool render_emoji(const glyph_atlas *a, uint32_t cp, glyph_cache_entry *e,
+                         uint8_t **px) {
+    if (!a->emoji) return false;
+    if (!cbdt_has(a->emoji, cp)) return false;
     int sw = 0, sh = 0;
     uint8_t *rgba = cbdt_render(a->emoji, cp, &sw, &sh);
-    if (!rgba || sw <= 0 || sh <= 0) { free(rgba); return -1; }
+    if (!rgba || sw <= 0 || sh <= 0) { free(rgba); return false; }
 
     /* Cell span must match the screen model's char_width: SMP pictographs and
      * the wide-emoji blocks occupy TWO cells; BMP dingbats/symbols occupy one.
@@ -388,35 +581,20 @@ static int raster_emoji(glyph_atlas *a, uint32_t cp) {
     if (dw < 1) dw = 1;
     if (dh < 1) dh = 1;
 
-    uint16_t ox, oy;
-    if (!color_reserve(a, dw + 1, dh + 1, &ox, &oy)) { free(rgba); return -1; }
-
-    /* downscale into a temp, then blit into the atlas at (ox,oy) */
-    uint8_t *tmp = malloc((size_t)dw * dh * 4);
-    if (!tmp) { free(rgba); return -1; }
-    rgba_downscale(rgba, sw, sh, tmp, dw, dh);
+    uint8_t *out = malloc((size_t)dw * dh * 4);
+    if (!out) { free(rgba); return false; }
+    rgba_downscale(rgba, sw, sh, out, dw, dh);
     free(rgba);
-    for (int y = 0; y < dh; y++)
-        memcpy(a->color_bitmap + ((size_t)(oy + y) * ATLAS_W + ox) * 4,
-               tmp + (size_t)y * dw * 4, (size_t)dw * 4);
-    free(tmp);
-    mark_color_dirty_rows(a, oy, oy + dh);
-
-    if (a->slot_count >= a->slot_cap) {
-        int ncap = a->slot_cap * 2;
-        glyph_slot *ns = realloc(a->slots, (size_t)ncap * sizeof(glyph_slot));
-        if (!ns) return -1;
-        a->slots = ns;
-        a->slot_cap = ncap;
-    }
-    glyph_slot *s = &a->slots[a->slot_count];
-    s->x = ox; s->y = oy; s->w = (uint16_t)dw; s->h = (uint16_t)dh;
+
+    e->w = (uint16_t)dw;
+    e->h = (uint16_t)dh;
     /* centre the (possibly aspect-shrunk) strike inside the 2-cell box */
-    s->off_x = (int16_t)((box_w - dw) / 2);
-    s->off_y = (int16_t)((box_h - dh) / 2);
-    s->valid = true;
-    s->color = true;
-    return a->slot_count++;
+    e->off_x = (int16_t)((box_w - dw) / 2);
+    e->off_y = (int16_t)((box_h - dh) / 2);
+    e->valid = true;
+    e->color = true;
+    *px = out;
+    return true;
 }
 
 glyph_atlas *glyph_atlas_create_ex(const uint8_t *font_data, size_t font_len,
@@ -428,6 +606,7 @@ glyph_atlas *glyph_atlas_create_ex(const uint8_t *font_data, size_t font_len,
     if (!a) return NULL;
     a->cell_w = cell_w;
     a->cell_h = cell_h;
+    a->font_key = GLYPH_CACHE_HASH_INIT;
 
     /* --- primary (regular) face ---
      * NOTE: face_init() takes ownership of an owns=true buffer on BOTH paths —
@@ -438,6 +617,7 @@ glyph_atlas *glyph_atlas_create_ex(const uint8_t *font_data, size_t font_len,
         if (!copy) { free(a); return NULL; }
         memcpy(copy, font_data, font_len);
         if (!face_init(&a->regular, copy, font_len, true, cell_h)) { free(a); return NULL; }
+        a->font_key = glyph_cache_hash(copy, font_len, a->font_key);
     } else {
         size_t len = 0; uint8_t *loaded = NULL;
 #ifdef NEOWALL_HAVE_FONTCONFIG
@@ -453,25 +633,30 @@ glyph_atlas *glyph_atlas_create_ex(const uint8_t *font_data, size_t font_len,
         if (!loaded) { free(a); return NULL; }
         /* face_init already freed `loaded` if it rejected the font. */
         if (!face_init(&a->regular, loaded, len, true, cell_h)) { free(a); return NULL; }
+        a->font_key = glyph_cache_hash(loaded, len, a->font_key);
     }
 
     /* --- optional bold / italic faces (fall back to regular if absent) --- */
-    face_init_path(&a->bold, bold_path, cell_h);
-    face_init_path(&a->italic, italic_path, cell_h);
+    if (face_init_path(&a->bold, bold_path, cell_h)) key_font(a, 'b', bold_path);
+    if (face_init_path(&a->italic, italic_path, cell_h)) key_font(a, 'i', italic_path);
 
     /* --- fallback chain for glyphs the primary lacks (CJK/symbols) --- */
 #ifdef NEOWALL_HAVE_FONTCONFIG
     const char *fallback_families[] = {"Noto Sans Mono CJK", "Noto Sans Symbols 2", "sans-serif", NULL};
     for (int i = 0; fallback_families[i] && a->fallback_count < MAX_FALLBACK; i++) {
         char *path = fontconfig_match(fallback_families[i], false, false);
-        if (path && face_init_path(&a->fallback[a->fallback_count], path, cell_h))
+        if (path && face_init_path(&a->fallback[a->fallback_count], path, cell_h)) {
+            key_font(a, 'f', path);
             a->fallback_count++;
+        }
         free(path);
     }
 #endif
     for (int i = 0; kFallbackFontPaths[i] && a->fallback_count < MAX_FALLBACK; i++) {
-        if (face_init_path(&a->fallback[a->fallback_count], kFallbackFontPaths[i], cell_h))
+        if (face_init_path(&a->fallback[a->fallback_count], kFallbackFontPaths[i], cell_h)) {
+            key_font(a, 'f', kFallbackFontPaths[i]);
             a->fallback_count++;
+        }
     }
 
     /* --- color emoji font (CBDT/CBLC or sbix), via the self-contained reader
@@ -483,7 +668,7 @@ glyph_atlas *glyph_atlas_create_ex(const uint8_t *font_data, size_t font_len,
         uint8_t *edata = read_file(emoji_path, &elen);
         if (edata) {
             cbdt_font *cf = cbdt_open(edata, elen);
-            if (cf) { a->emoji = cf; a->emoji_data = edata; }
+            if (cf) { a->emoji = cf; a->emoji_data = edata; key_font(a, 'e', emoji_path); }
             else free(edata);
         }
         free(emoji_path);
@@ -494,30 +679,33 @@ glyph_atlas *glyph_atlas_create_ex(const uint8_t *font_data, size_t font_len,
         uint8_t *edata = read_file(kColorEmojiFontPaths[i], &elen);
         if (!edata) continue;
         cbdt_font *cf = cbdt_open(edata, elen);
-        if (cf) { a->emoji = cf; a->emoji_data = edata; break; }
+        if (cf) {
+            a->emoji = cf;
+            a->emoji_data = edata;
+            key_font(a, 'e', kColorEmojiFontPaths[i]);
+            break;
+        }
         free(edata);
     }
 
-    a->bitmap = calloc((size_t)ATLAS_W * ATLAS_H, 1);
-    if (!a->bitmap) goto fail;
-    /* Color atlas is only allocated when an emoji font is actually present. */
-    if (a->emoji) {
-        a->color_bitmap = calloc((size_t)ATLAS_W * ATLAS_H * 4, 1);
-        if (!a->color_bitmap) {   /* degrade gracefully: no color emoji, text still works */
-            cbdt_close(a->emoji); a->emoji = NULL;
-            free(a->emoji_data);  a->emoji_data = NULL;
-        }
-    }
+    /* Pages are allocated as glyphs arrive; colour pages only ever with an
+     * emoji font present. */
+    a->cov.bpp = 1;
+    a->cov.limit = MAX_PAGES;
+    a->rgba.bpp = 4;
+    a->rgba.limit = a->emoji ? MAX_COLOR_PAGES : 0;
+    a->frame = 1;
+
     a->slot_cap = 512;
     a->slots = calloc((size_t)a->slot_cap, sizeof(glyph_slot));
-    if (!a->slots) goto fail;
-
-    a->shelf_x = a->shelf_y = a->shelf_h = 0;
-    a->cshelf_x = a->cshelf_y = a->cshelf_h = 0;
-    a->dirty = true;
-    a->dirty_y0 = 0; a->dirty_y1 = ATLAS_H;   /* first upload covers all */
-    a->color_dirty = a->emoji ? true : false;
-    a->color_dirty_y0 = 0; a->color_dirty_y1 = ATLAS_H;
+    a->meta = calloc((size_t)a->slot_cap, sizeof(slot_meta));
+    a->free_slots = calloc((size_t)a->slot_cap, sizeof(int));
+    if (!a->slots || !a->meta || !a->free_slots) goto fail;
+    a->map_cap = MAP_INIT;
+    a->map = calloc(a->map_cap, sizeof(map_entry));
+    if (!a->map) goto fail;
+
+    open_disk(a);
     return a;
 
     /* One teardown path so the constructor can never drift out of sync with
@@ -535,11 +723,16 @@ glyph_atlas *glyph_atlas_create(const uint8_t *font_data, size_t font_len,
 
 void glyph_atlas_destroy(glyph_atlas *a) {
     if (!a) return;
-    free(a->bitmap);
-    free(a->color_bitmap);
+    stop_workers(a);
+    glyph_cache_close(a->disk);
+    for (int p = 0; p < a->cov.count; p++) free(a->cov.page[p].bits);
+    for (int p = 0; p < a->rgba.count; p++) free(a->rgba.page[p].bits);
     if (a->emoji) cbdt_close(a->emoji);
     free(a->emoji_data);
     free(a->slots);
+    free(a->meta);
+    free(a->free_slots);
+    free(a->map);
     face_free(&a->regular);
     face_free(&a->bold);
     face_free(&a->italic);
@@ -550,7 +743,7 @@ void glyph_atlas_destroy(glyph_atlas *a) {
 /* Choose the face for a style, falling back to regular when a variant is
  * absent. Bold-without-a-bold-face still uses regular (synthetic emboldening
  * would need a second raster pass; acceptable degrade). */
-static face *pick_face(glyph_atlas *a, uint32_t style) {
+static const face *pick_face(const glyph_atlas *a, uint32_t style) {
     if ((style & STYLE_ITALIC) && a->italic.ready) return &a->italic;
     if ((style & STYLE_BOLD)   && a->bold.ready)   return &a->bold;
     return &a->regular;
@@ -570,53 +763,63 @@ static bool prefers_color_emoji(uint32_t cp) {
            (cp >= 0x1F1E6 && cp <= 0x1F1FF);     /* regional indicators (flags) */
 }
 
-/* Rasterize a font glyph from a specific face into the atlas; returns the new
- * slot index, or -1 if the face lacks the glyph / atlas is full. Does NOT touch
- * the map (caller keys it). */
-static int raster_face(glyph_atlas *a, face *fc, uint32_t cp) {
-    if (!fc || !fc->ready) return -1;
+/* Rasterize a font glyph from a specific face into a new bitmap, coverage or
+ * (sdf) a distance field padded by the spread. False if the face lacks the
+ * glyph; whitespace comes back valid with no pixels. */
+static bool render_face(const face *fc, uint32_t cp, bool sdf, glyph_cache_entry *e,
+                        uint8_t **px) {
+    if (!fc || !fc->ready) return false;
     int gi = stbtt_FindGlyphIndex(&fc->font, (int)cp);
-    if (gi == 0) return -1;   /* not in this face */
+    if (gi == 0) return false;   /* not in this face */
 
     int x0, y0, x1, y1;
     stbtt_GetGlyphBitmapBox(&fc->font, gi, fc->scale, fc->scale, &x0, &y0, &x1, &y1);
     int gw = x1 - x0, gh = y1 - y0;
-
     if (gw <= 0 || gh <= 0) {
         /* whitespace (space, etc.) — valid but no ink */
-        if (a->slot_count >= a->slot_cap) return -1;
-        glyph_slot *s = &a->slots[a->slot_count];
-        memset(s, 0, sizeof(*s));
-        s->valid = true;
-        return a->slot_count++;
+        e->valid = true;
+        return true;
     }
 
-    uint16_t ox, oy;
-    if (!atlas_reserve(a, gw + 1, gh + 1, &ox, &oy)) return -1;
-
-    stbtt_MakeGlyphBitmap(&fc->font,
-                          a->bitmap + (size_t)oy * ATLAS_W + ox,
-                          gw, gh, ATLAS_W, fc->scale, fc->scale, gi);
-    mark_dirty_rows(a, oy, oy + gh);
-
-    if (a->slot_count >= a->slot_cap) {
-        int ncap = a->slot_cap * 2;
-        glyph_slot *ns = realloc(a->slots, (size_t)ncap * sizeof(glyph_slot));
-        if (!ns) return -1;
-        a->slots = ns;
-        a->slot_cap = ncap;
+    if (sdf) {
+        /* The field comes from STBTT_malloc, i.e. malloc, so it is freed like
+         * any other glyph bitmap. */
+        uint8_t *field = stbtt_GetGlyphSDF(&fc->font, fc->scale, gi, GLYPH_ATLAS_SDF_SPREAD,
+                                           128, 128.0f / GLYPH_ATLAS_SDF_SPREAD,
+                                           &gw, &gh, &x0, &y0);
+        if (!field) return false;
+        e->w = (uint16_t)gw;
+        e->h = (uint16_t)gh;
+        e->off_x = (int16_t)x0;
+        e->off_y = (int16_t)(fc->ascent_px + y0);
+        e->valid = true;
+        e->sdf = true;
+        *px = field;
+        return true;
     }
-    glyph_slot *s = &a->slots[a->slot_count];
-    s->x = ox; s->y = oy; s->w = (uint16_t)gw; s->h = (uint16_t)gh;
-    s->off_x = (int16_t)x0;                        /* glyph left bearing */
-    s->off_y = (int16_t)(fc->ascent_px + y0);      /* top of ink from cell top */
-    s->valid = true;
-    return a->slot_count++;
+
+    uint8_t *out = malloc((size_t)gw * gh);
+    if (!out) return false;
+    stbtt_MakeGlyphBitmap(&fc->font, out, gw, gh, gw, fc->scale, fc->scale, gi);
+    e->w = (uint16_t)gw;
+    e->h = (uint16_t)gh;
+    e->off_x = (int16_t)x0;                        /* glyph left bearing */
+    e->off_y = (int16_t)(fc->ascent_px + y0);      /* top of ink from cell top */
+    e->valid = true;
+    *px = out;
+    return true;
 }
 
-/* Rasterize + insert a (codepoint, style) key; returns its slot index. */
-static int rasterize(glyph_atlas *a, uint32_t cp, uint32_t style) {
-    uint32_t key = cp | style;
+/* Render a (codepoint, style) key into *e and a new bitmap *px (NULL when it
+ * has no ink). A key no face can draw comes back blank (valid=false). Reads
+ * only the faces, which never change after create, so workers may call it
+ * concurrently. */
+static void render_glyph(const glyph_atlas *a, uint32_t key, glyph_cache_entry *e,
+                         uint8_t **px) {
+    uint32_t style = key & (STYLE_BOLD | STYLE_ITALIC);
+    uint32_t cp = key & ~style;
+    *e = (glyph_cache_entry){.key = key};
+    *px = NULL;
 
     /* TUI drawing ranges (box/block/braille) are synthesized to fill the whole
      * cell edge-to-edge, so meters and sparklines tile with no seams. This runs
@@ -626,26 +829,11 @@ static int rasterize(glyph_atlas *a, uint32_t cp, uint32_t style) {
         int cw = a->cell_w, ch = a->cell_h;
         uint8_t *tmp = malloc((size_t)cw * ch);
         if (tmp && glyph_synth_render(cp, tmp, cw, ch)) {
-            uint16_t ox, oy;
-            if (!atlas_reserve(a, cw + 1, ch + 1, &ox, &oy)) { free(tmp); goto blank; }
-            for (int y = 0; y < ch; y++)
-                memcpy(a->bitmap + (size_t)(oy + y) * ATLAS_W + ox,
-                       tmp + (size_t)y * cw, (size_t)cw);
-            mark_dirty_rows(a, oy, oy + ch);
-            free(tmp);
-            if (a->slot_count >= a->slot_cap) {
-                int ncap = a->slot_cap * 2;
-                glyph_slot *ns = realloc(a->slots, (size_t)ncap * sizeof(glyph_slot));
-                if (!ns) goto blank;
-                a->slots = ns;
-                a->slot_cap = ncap;
-            }
-            glyph_slot *s = &a->slots[a->slot_count];
-            s->x = ox; s->y = oy; s->w = (uint16_t)cw; s->h = (uint16_t)ch;
-            s->off_x = 0; s->off_y = 0;   /* fills the cell exactly */
-            s->valid = true;
-            map_insert(a, key, (uint32_t)a->slot_count);
-            return a->slot_count++;
+            e->w = (uint16_t)cw;
+            e->h = (uint16_t)ch;   /* fills the cell exactly, no offset */
+            e->valid = true;
+            *px = tmp;
+            return;
         }
         free(tmp);
         /* synth declined: fall through to the font. */
@@ -654,36 +842,205 @@ static int rasterize(glyph_atlas *a, uint32_t cp, uint32_t style) {
     /* Emoji-presentation codepoints render as COLOR whenever the emoji font
      * has them — tried BEFORE the text faces so ❤ ⭐ ✈ don't come out as dull
      * monochrome outlines that a text/symbol face happens to carry. */
-    if (prefers_color_emoji(cp)) {
-        int cidx = raster_emoji(a, cp);
-        if (cidx >= 0) { map_insert(a, key, (uint32_t)cidx); return cidx; }
-    }
+    if (prefers_color_emoji(cp) && render_emoji(a, cp, e, px)) return;
 
     /* 1) the styled face, 2) regular (if we started styled), 3) fallback chain. */
-    int idx = raster_face(a, pick_face(a, style), cp);
-    if (idx < 0 && style) idx = raster_face(a, &a->regular, cp);
+    if (render_face(pick_face(a, style), cp, a->sdf, e, px)) return;
+    if (style && render_face(&a->regular, cp, a->sdf, e, px)) return;
 
     /* For non-presentation codepoints, still try a COLOR emoji strike before
      * the monochrome fallback fonts (catches emoji the text face lacks). */
-    if (idx < 0) {
-        int cidx = raster_emoji(a, cp);
-        if (cidx >= 0) { map_insert(a, key, (uint32_t)cidx); return cidx; }
+    if (render_emoji(a, cp, e, px)) return;
+
+    for (int i = 0; i < a->fallback_count; i++)
+        if (render_face(&a->fallback[i], cp, a->sdf, e, px)) return;
+}
+
+/* Put a rendered (or disk-cached) glyph into slot `idx`: a rectangle reserved
+ * on its page set and the pixels copied in. False, with the slot untouched,
+ * when every page holds a glyph used this frame; a glyph too large for any
+ * page is kept blank. */
+static bool fill_slot(glyph_atlas *a, int idx, const glyph_cache_entry *e, const uint8_t *px) {
+    uint16_t ox = 0, oy = 0;
+    uint8_t page = 0;
+    bool valid = e->valid;
+    if (px) {
+        page_set *ps = e->color ? &a->rgba : &a->cov;
+        a->out_of_room = false;
+        if (atlas_reserve(a, ps, e->w + 1, e->h + 1, &ox, &oy, &page)) {
+            size_t row = (size_t)e->w * ps->bpp;
+            uint8_t *bits = ps->page[page].bits;
+            for (int y = 0; y < e->h; y++)
+                memcpy(bits + ((size_t)(oy + y) * PAGE_W + ox) * ps->bpp, px + y * row, row);
+            mark_dirty_rows(ps, page, oy, oy + e->h);
+        } else if (a->out_of_room) {
+            return false;
+        } else {
+            valid = false;
+        }
+    }
+    a->slots[idx] = (glyph_slot){
+        .x = ox, .y = oy,
+        .w = valid ? e->w : 0, .h = valid ? e->h : 0,
+        .off_x = e->off_x, .off_y = e->off_y,
+        .page = page,
+        .valid = valid,
+        .color = valid && e->color,
+        .sdf = valid && e->sdf,
+    };
+    return true;
+}
+
+/* A new slot holding `e`, published under its key. -1 if there is no room
+ * this frame (not cached, so a later frame retries). */
+static int place_glyph(glyph_atlas *a, const glyph_cache_entry *e, const uint8_t *px) {
+    int idx = slot_alloc(a);
+    if (idx < 0) return -1;
+    if (!fill_slot(a, idx, e, px)) {
+        slot_release(a, idx);
+        return -1;
+    }
+    return slot_keep(a, e->key, idx);
+}
+
+static void remember(glyph_atlas *a, const glyph_cache_entry *e, const uint8_t *px) {
+    glyph_cache_add(a->disk, e, px, (size_t)e->w * (e->color ? 4u : 1u));
+}
+
+/* ---- worker pool ---- */
+
+static void *worker_main(void *arg) {
+    glyph_atlas *a = arg;
+    pthread_mutex_lock(&a->lock);
+    for (;;) {
+        while (!a->todo && !a->stop) pthread_cond_wait(&a->wake, &a->lock);
+        if (a->stop) break;
+        raster_job *j = a->todo;
+        a->todo = j->next;
+        if (!a->todo) a->todo_tail = NULL;
+        pthread_mutex_unlock(&a->lock);
+
+        render_glyph(a, j->e.key, &j->e, &j->pixels);
+
+        pthread_mutex_lock(&a->lock);
+        j->next = a->done;
+        a->done = j;
     }
+    pthread_mutex_unlock(&a->lock);
+    return NULL;
+}
+
+static void free_jobs(raster_job *j) {
+    while (j) {
+        raster_job *next = j->next;
+        free(j->pixels);
+        free(j);
+        j = next;
+    }
+}
 
-    for (int i = 0; idx < 0 && i < a->fallback_count; i++)
-        idx = raster_face(a, &a->fallback[i], cp);
+/* Publish `key` as a pending slot and queue it for the workers. */
+static int enqueue(glyph_atlas *a, uint32_t key) {
+    raster_job *j = calloc(1, sizeof(*j));
+    int idx = j ? slot_alloc(a) : -1;
+    if (idx < 0) { free(j); return -1; }
+    a->slots[idx].pending = true;
+    j->slot = idx;
+    j->e.key = key;
+    pthread_mutex_lock(&a->lock);
+    if (a->todo_tail) a->todo_tail->next = j;
+    else              a->todo = j;
+    a->todo_tail = j;
+    pthread_cond_signal(&a->wake);
+    pthread_mutex_unlock(&a->lock);
+    a->in_flight++;
+    return slot_keep(a, key, idx);
+}
+
+int glyph_atlas_start_workers(glyph_atlas *a, int n) {
+    if (!a || a->nworkers || n <= 0) return 0;
+    if (n > MAX_WORKERS) n = MAX_WORKERS;
+    if (pthread_mutex_init(&a->lock, NULL) != 0) return 0;
+    if (pthread_cond_init(&a->wake, NULL) != 0) {
+        pthread_mutex_destroy(&a->lock);
+        return 0;
+    }
+    a->pool = true;
+    while (a->nworkers < n &&
+           pthread_create(&a->workers[a->nworkers], NULL, worker_main, a) == 0)
+        a->nworkers++;
+    return a->nworkers;
+}
+
+static void stop_workers(glyph_atlas *a) {
+    if (!a->pool) return;
+    pthread_mutex_lock(&a->lock);
+    a->stop = true;
+    pthread_cond_broadcast(&a->wake);
+    pthread_mutex_unlock(&a->lock);
+    for (int i = 0; i < a->nworkers; i++) pthread_join(a->workers[i], NULL);
+    free_jobs(a->todo);
+    free_jobs(a->done);
+    free_jobs(a->stalled);
+    pthread_cond_destroy(&a->wake);
+    pthread_mutex_destroy(&a->lock);
+}
+
+int glyph_atlas_collect(glyph_atlas *a) {
+    if (!a || !a->nworkers) return 0;
+    pthread_mutex_lock(&a->lock);
+    raster_job *done = a->done;
+    a->done = NULL;
+    pthread_mutex_unlock(&a->lock);
+
+    /* Last frame's stalled glyphs first; they have waited longest. */
+    raster_job **tail = &a->stalled;
+    while (*tail) tail = &(*tail)->next;
+    *tail = done;
+    raster_job *j = a->stalled, *keep = NULL;
+    int placed = 0;
+    while (j) {
+        raster_job *next = j->next;
+        if (!fill_slot(a, j->slot, &j->e, j->pixels)) {
+            j->next = keep;
+            keep = j;
+        } else {
+            /* Pinned for the rest of the frame like any other lookup, so
+             * the next placement cannot evict it straight away. */
+            a->meta[j->slot].last_use = a->frame;
+            remember(a, &j->e, j->pixels);
+            free(j->pixels);
+            free(j);
+            a->in_flight--;
+            placed++;
+        }
+        j = next;
+    }
+    a->stalled = keep;
+    return placed;
+}
 
-    if (idx >= 0) { map_insert(a, key, (uint32_t)idx); return idx; }
+int glyph_atlas_pending(const glyph_atlas *a) { return a ? a->in_flight : 0; }
 
-blank:
-    if (a->slot_count >= a->slot_cap) return -1;
-    {
-        glyph_slot *b = &a->slots[a->slot_count];
-        memset(b, 0, sizeof(*b));
-        b->valid = false;
-        map_insert(a, key, (uint32_t)a->slot_count);
-        return a->slot_count++;
+/* Place a key missing from the map: copied from the disk cache when it has
+ * it, else rendered here (synchronous atlas) or queued for the workers. */
+static int rasterize(glyph_atlas *a, uint32_t cp, uint32_t style) {
+    uint32_t key = cp | style;
+    glyph_cache_entry e;
+    const uint8_t *cached;
+    if (glyph_cache_find(a->disk, key, &e, &cached) && (!e.color || a->emoji)) {
+        int idx = place_glyph(a, &e, cached);
+        if (idx >= 0) a->disk_hits++;
+        return idx;
     }
+    if (a->nworkers) return enqueue(a, key);
+
+    uint8_t *px;
+    render_glyph(a, key, &e, &px);
+    int idx = place_glyph(a, &e, px);
+    if (idx >= 0) remember(a, &e, px);
+    free(px);
+    return idx;
 }
 
 const glyph_slot *glyph_atlas_get_styled(glyph_atlas *a, uint32_t cp,
@@ -694,6 +1051,7 @@ const glyph_slot *glyph_atlas_get_styled(glyph_atlas *a, uint32_t cp,
     int idx = map_find(a, cp | style);
     if (idx < 0) idx = rasterize(a, cp, style);
     if (idx < 0 || idx >= a->slot_count) return &blank;
+    a->meta[idx].last_use = a->frame;
     return &a->slots[idx];
 }
 
@@ -701,25 +1059,64 @@ const glyph_slot *glyph_atlas_get(glyph_atlas *a, uint32_t cp) {
     return glyph_atlas_get_styled(a, cp, false, false);
 }
 
-const uint8_t *glyph_atlas_bitmap(const glyph_atlas *a) { return a ? a->bitmap : NULL; }
-int  glyph_atlas_width(const glyph_atlas *a)  { (void)a; return ATLAS_W; }
-int  glyph_atlas_height(const glyph_atlas *a) { (void)a; return ATLAS_H; }
+void glyph_atlas_begin_frame(glyph_atlas *a) { if (a) a->frame++; }
+uint32_t glyph_atlas_generation(const glyph_atlas *a) { return a ? a->generation : 0; }
+unsigned glyph_atlas_disk_hits(const glyph_atlas *a) { return a ? a->disk_hits : 0; }
+
+void glyph_atlas_set_sdf(glyph_atlas *a, bool sdf) {
+    if (!a || a->nworkers || a->sdf == sdf) return;
+    a->sdf = sdf;
+    open_disk(a);
+}
+
+void glyph_atlas_set_max_pages(glyph_atlas *a, int pages) {
+    if (!a || pages < 1) return;
+    int cov = pages < MAX_PAGES ? pages : MAX_PAGES;
+    a->cov.limit = cov > a->cov.count ? cov : a->cov.count;
+    if (a->emoji) {
+        int col = pages < MAX_COLOR_PAGES ? pages : MAX_COLOR_PAGES;
+        a->rgba.limit = col > a->rgba.count ? col : a->rgba.count;
+    }
+}
+
+static void page_set_clear_dirty(page_set *ps) {
+    for (int p = 0; p < ps->count; p++) {
+        ps->page[p].dirty = false;
+        ps->page[p].dirty_y0 = ps->page[p].dirty_y1 = 0;
+    }
+    ps->dirty = false;
+}
+
+static bool page_set_dirty_rows(const page_set *ps, int page, int *y0, int *y1) {
+    bool dirty = page >= 0 && page < ps->count && ps->page[page].dirty;
+    if (y0) *y0 = dirty ? ps->page[page].dirty_y0 : 0;
+    if (y1) *y1 = dirty ? ps->page[page].dirty_y1 : 0;
+    return dirty;
+}
+
+int  glyph_atlas_width(const glyph_atlas *a)  { (void)a; return PAGE_W; }
+int  glyph_atlas_height(const glyph_atlas *a) { (void)a; return PAGE_H; }
 int  glyph_atlas_cell_w(const glyph_atlas *a) { return a ? a->cell_w : 0; }
 int  glyph_atlas_cell_h(const glyph_atlas *a) { return a ? a->cell_h : 0; }
-bool glyph_atlas_dirty(const glyph_atlas *a)  { return a ? a->dirty : false; }
-void glyph_atlas_clear_dirty(glyph_atlas *a)  { if (a) { a->dirty = false; a->dirty_y0 = a->dirty_y1 = 0; } }
 
-void glyph_atlas_dirty_rows(const glyph_atlas *a, int *y0, int *y1) {
-    if (y0) *y0 = a ? a->dirty_y0 : 0;
-    if (y1) *y1 = a ? a->dirty_y1 : 0;
+int glyph_atlas_pages(const glyph_atlas *a) { return a ? a->cov.count : 0; }
+const uint8_t *glyph_atlas_page(const glyph_atlas *a, int page) {
+    return a && page >= 0 && page < a->cov.count ? a->cov.page[page].bits : NULL;
+}
+bool glyph_atlas_dirty(const glyph_atlas *a)  { return a ? a->cov.dirty : false; }
+void glyph_atlas_clear_dirty(glyph_atlas *a)  { if (a) page_set_clear_dirty(&a->cov); }
+bool glyph_atlas_page_dirty_rows(const glyph_atlas *a, int page, int *y0, int *y1) {
+    static const page_set none;
+    return page_set_dirty_rows(a ? &a->cov : &none, page, y0, y1);
 }
 
-const uint8_t *glyph_atlas_color_bitmap(const glyph_atlas *a) { return a ? a->color_bitmap : NULL; }
-bool glyph_atlas_color_dirty(const glyph_atlas *a) { return a ? a->color_dirty : false; }
-void glyph_atlas_clear_color_dirty(glyph_atlas *a) {
-    if (a) { a->color_dirty = false; a->color_dirty_y0 = a->color_dirty_y1 = 0; }
+int glyph_atlas_color_pages(const glyph_atlas *a) { return a ? a->rgba.count : 0; }
+const uint8_t *glyph_atlas_color_page(const glyph_atlas *a, int page) {
+    return a && page >= 0 && page < a->rgba.count ? a->rgba.page[page].bits : NULL;
 }
-void glyph_atlas_color_dirty_rows(const glyph_atlas *a, int *y0, int *y1) {
-    if (y0) *y0 = a ? a->color_dirty_y0 : 0;
-    if (y1) *y1 = a ? a->color_dirty_y1 : 0;
+bool glyph_atlas_color_dirty(const glyph_atlas *a) { return a ? a->rgba.dirty : false; }
+void glyph_atlas_clear_color_dirty(glyph_atlas *a) { if (a) page_set_clear_dirty(&a->rgba); }
+bool glyph_atlas_color_page_dirty_rows(const glyph_atlas *a, int page, int *y0, int *y1) {
+    static const page_set none;
+    return page_set_dirty_rows(a ? &a->rgba : &none, page, y0, y1);
 }
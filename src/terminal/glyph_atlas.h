@@ -2,10 +2,14 @@
  * glyph_atlas.h — a dynamic, font-rasterized glyph atlas for the terminal.
  *
  * Loads a REAL TrueType/OpenType font (bundled default, or a user-configured
- * path) and rasterizes glyphs on demand into a single GPU-ready coverage
- * texture, caching codepoint -> atlas cell. This is how kitty/alacritty work:
- * a TUI touches a small working set of glyphs (a few hundred), so the atlas
- * fills once and then every frame is pure lookups.
+ * path) and rasterizes glyphs on demand into GPU-ready coverage pages, caching
+ * codepoint -> atlas cell. This is how kitty/alacritty work: a TUI touches a
+ * small working set of glyphs (a few hundred), so the first page fills once
+ * and then every frame is pure lookups. CJK or emoji-heavy output grows more
+ * pages (the layers of a texture array), up to a limit past which the least
+ * recently used page is emptied and reused. Every glyph rasterized is also
+ * written to an on-disk cache (glyph_cache.h) keyed by the fonts and cell
+ * size, so the next start copies it back instead of rasterizing it again.
  *
  * Rasterization is done by stb_truetype (a single vendored public-domain
  * header — src/terminal/vendor/stb_truetype.h — NOT an external dependency;
@@ -18,8 +22,13 @@
  * user explicitly configured) — never network- or attacker-supplied data. The
  * wallpaper never loads a font from an untrusted source, so this is safe.
  *
- * This module is CPU-side only: it produces an 8-bit coverage bitmap for the
- * whole atlas plus a per-codepoint UV cache. The GL upload lives in the shader
+ * In SDF mode (glyph_atlas_set_sdf) outline glyphs are stored as signed
+ * distance fields instead: rasterized once at a reference cell size, they are
+ * reconstructed by the shader at whatever size the cell lands on screen, so
+ * every output shares one modest atlas and one disk cache.
+ *
+ * This module is CPU-side only: it produces 8-bit coverage pages plus a
+ * per-codepoint UV cache. The GL upload lives in the shader
  * engine (it owns the GL context), keeping this unit headlessly testable.
  */
 #ifndef NEOWALL_TERMINAL_GLYPH_ATLAS_H
@@ -35,14 +44,25 @@ typedef struct glyph_atlas glyph_atlas;
  * draw it at within a terminal cell (fonts aren't cell-aligned; we center the
  * advance box and record where the ink sits). */
 typedef struct glyph_slot {
-    uint16_t x, y;        /* top-left in the atlas bitmap */
+    uint16_t x, y;        /* top-left within its page */
     uint16_t w, h;        /* glyph bitmap size */
     int16_t  off_x, off_y;/* pixel offset from cell top-left to glyph top-left */
+    uint8_t  page;        /* page (texture array layer) holding the glyph */
     bool     valid;
     bool     color;       /* true = RGBA emoji in the COLOR atlas (x,y index it),
                              sampled directly; false = R8 coverage, tinted by fg */
+    bool     pending;     /* a worker is still rasterizing it (valid=false until
+                             glyph_atlas_collect places it) */
+    bool     sdf;         /* R8 texels hold a distance field, not coverage */
 } glyph_slot;
 
+/* Distance-field encoding: 128 on the outline, changing by
+ * 128 / GLYPH_ATLAS_SDF_SPREAD per texel (up inside, down outside), so the
+ * field saturates that many texels from the edge. Each bitmap is padded by
+ * the spread on every side. nwTermCell in shader_stdlib.h decodes with the
+ * same constant. */
+#define GLYPH_ATLAS_SDF_SPREAD 6
+
 /* Create an atlas that rasterizes `font` at a cell size of cell_w x cell_h
  * pixels. `font_data`/`font_len` is the in-memory font file (owned by caller,
  * must outlive the atlas). If font_data is NULL the bundled default font is
@@ -59,10 +79,13 @@ glyph_atlas *glyph_atlas_create_ex(const uint8_t *font_data, size_t font_len,
 
 void glyph_atlas_destroy(glyph_atlas *a);
 
-/* Look up (rasterizing + inserting on first touch) the slot for a codepoint.
- * Returns a borrowed pointer into the atlas's cache (stable for the atlas's
- * lifetime). On atlas-full or un-rasterizable glyph, returns a blank slot
- * (valid=false) — the renderer draws nothing, never garbage. */
+/* Look up (rasterizing + inserting on first touch) the slot for a codepoint,
+ * and mark it used in the current frame. Returns a borrowed pointer into the
+ * atlas's cache, valid until the next lookup. For an un-rasterizable glyph, or
+ * when every page holds a glyph used this frame, returns a blank slot
+ * (valid=false) — the renderer draws nothing, never garbage. Only the former
+ * is cached; the latter is retried on the next lookup. With workers started a
+ * glyph that must be rasterized comes back pending instead. */
 const glyph_slot *glyph_atlas_get(glyph_atlas *a, uint32_t cp);
 
 /* As above, but selects the bold/italic face for the glyph (falling back to
@@ -70,28 +93,64 @@ const glyph_slot *glyph_atlas_get(glyph_atlas *a, uint32_t cp);
 const glyph_slot *glyph_atlas_get_styled(glyph_atlas *a, uint32_t cp,
                                          bool bold, bool italic);
 
-/* Atlas bitmap accessors (single-channel, 8-bit coverage, row-major). The
- * shader engine uploads this to a GL_R8 texture. `dirty` is set whenever new
- * glyphs were rasterized since the last clear, so the uploader can re-push only
- * when needed. */
-const uint8_t *glyph_atlas_bitmap(const glyph_atlas *a);
+/* Eviction clock. The renderer calls begin_frame once per resolve pass; glyphs
+ * looked up since then are in use and their pages are never emptied. The
+ * generation changes whenever a page is emptied: any placement obtained
+ * before that may now point at another glyph and must be looked up again. */
+void           glyph_atlas_begin_frame(glyph_atlas *a);
+uint32_t       glyph_atlas_generation(const glyph_atlas *a);
+
+/* Cap the pages of each kind (at most 32 coverage and 8 colour, the default;
+ * never below the pages already allocated). For tests and small devices. */
+void           glyph_atlas_set_max_pages(glyph_atlas *a, int pages);
+
+/* Store outline glyphs as distance fields (slot.sdf) instead of coverage.
+ * Synthesized box/braille glyphs stay coverage so they still tile edge to
+ * edge, and emoji stay RGBA. Call once, before starting workers and before
+ * the first lookup; the mode keys its own disk cache. */
+void           glyph_atlas_set_sdf(glyph_atlas *a, bool sdf);
+
+/* Rasterize on `n` worker threads (at most 8) instead of inside lookups: a
+ * glyph neither resident nor in the disk cache is queued and its slot stays
+ * pending until a later glyph_atlas_collect. Call once, before the first
+ * lookup; returns the workers started (0 leaves the atlas synchronous). */
+int            glyph_atlas_start_workers(glyph_atlas *a, int n);
+
+/* Place the glyphs the workers have finished into their pending slots, on
+ * the thread doing lookups; a copy per glyph. Returns how many became ready.
+ * Placing may empty a page, which shows in glyph_atlas_generation. */
+int            glyph_atlas_collect(glyph_atlas *a);
+
+/* Glyphs queued or rendered but not yet placed. */
+int            glyph_atlas_pending(const glyph_atlas *a);
+
+/* Glyphs placed from the on-disk cache instead of rasterized. */
+unsigned       glyph_atlas_disk_hits(const glyph_atlas *a);
+
+/* Coverage pages (single-channel, 8-bit, row-major, width x height each). The
+ * shader engine uploads them as the layers of a GL_R8 texture array; a glyph's
+ * `page` is its layer. `dirty` is set whenever glyphs were rasterized (or a
+ * page emptied) since the last clear, and page_dirty_rows gives the row range
+ * [*y0, *y1) of one page to re-push, returning false if it is clean. A new
+ * page starts wholly dirty. */
 int            glyph_atlas_width(const glyph_atlas *a);
 int            glyph_atlas_height(const glyph_atlas *a);
 int            glyph_atlas_cell_w(const glyph_atlas *a);
 int            glyph_atlas_cell_h(const glyph_atlas *a);
+int            glyph_atlas_pages(const glyph_atlas *a);
+const uint8_t *glyph_atlas_page(const glyph_atlas *a, int page);
 bool           glyph_atlas_dirty(const glyph_atlas *a);
+bool           glyph_atlas_page_dirty_rows(const glyph_atlas *a, int page, int *y0, int *y1);
 void           glyph_atlas_clear_dirty(glyph_atlas *a);
 
-/* Color-emoji atlas (RGBA8, straight alpha, row-major). Same fixed dimensions
- * as the coverage atlas. Color glyph_slots index into THIS bitmap. Uploaded to
- * a GL_RGBA8 texture by the shader engine and sampled directly (no fg tint). */
-const uint8_t *glyph_atlas_color_bitmap(const glyph_atlas *a);
+/* Color-emoji pages (RGBA8, straight alpha, row-major), same dimensions as the
+ * coverage pages. Color glyph_slots index into THESE. Uploaded to a GL_RGBA8
+ * texture array by the shader engine and sampled directly (no fg tint). No
+ * page is ever allocated without an emoji font. */
+int            glyph_atlas_color_pages(const glyph_atlas *a);
+const uint8_t *glyph_atlas_color_page(const glyph_atlas *a, int page);
 bool           glyph_atlas_color_dirty(const glyph_atlas *a);
-void           glyph_atlas_color_dirty_rows(const glyph_atlas *a, int *y0, int *y1);
+bool           glyph_atlas_color_page_dirty_rows(const glyph_atlas *a, int page, int *y0, int *y1);
 void           glyph_atlas_clear_color_dirty(glyph_atlas *a);
 
-/* Row range [*y0, *y1) of the atlas that changed since the last clear_dirty.
- * The GL uploader pushes only these rows instead of the whole atlas. */
-void           glyph_atlas_dirty_rows(const glyph_atlas *a, int *y0, int *y1);
-
 #endif /* NEOWALL_TERMINAL_GLYPH_ATLAS_H */
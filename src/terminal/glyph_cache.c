@@ -0,0 +1,364 @@
+/*
+ * glyph_cache.c — on-disk glyph cache. See glyph_cache.h.
+ *
+ * Layout: <cache>/neowall/glyphs/<key16>.glyph
+ *   header:  u32 magic, u32 version, u32 cell_w, u32 cell_h, u32 count,
+ *            u32 reserved, u64 data length
+ *   index:   count records sorted by key (see disk_record)
+ *   data:    the pixels, packed rows, at each record's offset
+ * Everything is validated once on open, so lookups trust the mapping.
+ */
+#include "glyph_cache.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define GLYPH_CACHE_MAGIC   0x4347574Eu /* "NWGC" */
+#define GLYPH_CACHE_VERSION 1u          /* bump when the layout changes */
+#define MAX_ENTRIES         (1u << 16)
+
+#define FLAG_VALID 1u
+#define FLAG_COLOR 2u
+#define FLAG_SDF   4u
+
+struct glyph_cache_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t cell_w;
+    uint32_t cell_h;
+    uint32_t count;
+    uint32_t reserved;
+    uint64_t length;
+};
+
+typedef struct {
+    uint32_t key;
+    uint16_t w, h;
+    int16_t  off_x, off_y;
+    uint8_t  flags;
+    uint8_t  pad[3];
+    uint32_t offset;     /* into the data section (the blob, for added ones) */
+} disk_record;
+
+_Static_assert(sizeof(struct glyph_cache_header) == 32, "header layout");
+_Static_assert(sizeof(disk_record) == 20, "record layout");
+
+struct glyph_cache {
+    char     path[600];
+    int      cell_w, cell_h;
+
+    /* the mapped file; index == NULL when there was none */
+    void              *map;
+    size_t             map_len;
+    const disk_record *index;
+    uint32_t           count;
+    const uint8_t     *data;
+    uint64_t           data_len;
+
+    /* glyphs added this run, with their pixels in one growable blob and an
+     * open-addressed table (record index + 1) to find them by key */
+    disk_record *fresh;
+    uint32_t     fresh_count, fresh_cap;
+    uint8_t     *blob;
+    size_t       blob_len, blob_cap;
+    uint32_t    *table;
+    uint32_t     table_cap;
+    bool         unsaved;
+};
+
+uint64_t glyph_cache_hash(const void *data, size_t len, uint64_t h) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+uint64_t glyph_cache_hash_file(const char *path, uint64_t h) {
+    if (!path) return h;
+    h = glyph_cache_hash(path, strlen(path) + 1, h);
+    struct stat st;
+    if (stat(path, &st) != 0) return h;
+    int64_t fields[] = {
+        (int64_t)st.st_size, (int64_t)st.st_mtim.tv_sec, (int64_t)st.st_mtim.tv_nsec,
+        (int64_t)st.st_ino,
+    };
+    return glyph_cache_hash(fields, sizeof(fields), h);
+}
+
+/* Resolve (and create) the cache directory. Re-read every call so a changed
+ * XDG_CACHE_HOME — or a test's temporary one — is honoured. */
+static bool cache_dir(char *out, size_t out_len) {
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    int n;
+    if (xdg && xdg[0]) {
+        n = snprintf(out, out_len, "%s/neowall/glyphs", xdg);
+    } else {
+        const char *home = getenv("HOME");
+        if (!home || !home[0]) return false;
+        n = snprintf(out, out_len, "%s/.cache/neowall/glyphs", home);
+    }
+    if (n < 0 || (size_t)n >= out_len) return false;
+
+    /* mkdir -p */
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s", out);
+    for (char *p = tmp + 1; *p; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            mkdir(tmp, 0755);
+            *p = '/';
+        }
+    }
+    return mkdir(tmp, 0755) == 0 || errno == EEXIST;
+}
+
+static size_t pixel_bytes(const disk_record *r) {
+    if (!(r->flags & FLAG_VALID)) return 0;
+    return (size_t)r->w * r->h * ((r->flags & FLAG_COLOR) ? 4u : 1u);
+}
+
+/* Check a mapped file against the expected cell size; on success point the
+ * cache at its index and data. */
+static bool adopt_mapping(glyph_cache *c, const uint8_t *m, size_t len) {
+    struct glyph_cache_header hdr;
+    if (len < sizeof(hdr)) return false;
+    memcpy(&hdr, m, sizeof(hdr));
+    if (hdr.magic != GLYPH_CACHE_MAGIC || hdr.version != GLYPH_CACHE_VERSION ||
+        hdr.cell_w != (uint32_t)c->cell_w || hdr.cell_h != (uint32_t)c->cell_h ||
+        hdr.count > MAX_ENTRIES || hdr.length > GLYPH_CACHE_MAX_BYTES)
+        return false;
+    size_t index_len = (size_t)hdr.count * sizeof(disk_record);
+    if (sizeof(hdr) + index_len + hdr.length != len) return false;
+
+    const disk_record *index = (const disk_record *)(m + sizeof(hdr));
+    for (uint32_t i = 0; i < hdr.count; i++) {
+        const disk_record *r = &index[i];
+        if (i > 0 && r->key <= index[i - 1].key) return false;
+        if ((uint64_t)r->offset + pixel_bytes(r) > hdr.length) return false;
+    }
+    c->index = index;
+    c->count = hdr.count;
+    c->data = m + sizeof(hdr) + index_len;
+    c->data_len = hdr.length;
+    return true;
+}
+
+glyph_cache *glyph_cache_open(uint64_t key, int cell_w, int cell_h) {
+    if (cell_w <= 0 || cell_h <= 0) return NULL;
+    char dir[512];
+    if (!cache_dir(dir, sizeof(dir))) return NULL;
+    glyph_cache *c = calloc(1, sizeof(*c));
+    if (!c) return NULL;
+    c->cell_w = cell_w;
+    c->cell_h = cell_h;
+    int n = snprintf(c->path, sizeof(c->path), "%s/%016llx.glyph", dir,
+                     (unsigned long long)key);
+    if (n < 0 || (size_t)n >= sizeof(c->path)) { free(c); return NULL; }
+
+    int fd = open(c->path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return c;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void *m = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m != MAP_FAILED) {
+            if (adopt_mapping(c, m, (size_t)st.st_size)) {
+                c->map = m;
+                c->map_len = (size_t)st.st_size;
+            } else {
+                munmap(m, (size_t)st.st_size);
+                unlink(c->path); /* stale/corrupt: drop so the next save replaces it */
+            }
+        }
+    }
+    close(fd);
+    return c;
+}
+
+static const disk_record *find_mapped(const glyph_cache *c, uint32_t key) {
+    uint32_t lo = 0, hi = c->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        uint32_t k = c->index[mid].key;
+        if (k == key) return &c->index[mid];
+        if (k < key) lo = mid + 1;
+        else         hi = mid;
+    }
+    return NULL;
+}
+
+static inline uint32_t table_hash(uint32_t key, uint32_t cap) {
+    return (key * 2654435761u) & (cap - 1);
+}
+
+static const disk_record *find_fresh(const glyph_cache *c, uint32_t key) {
+    if (!c->table_cap) return NULL;
+    for (uint32_t h = table_hash(key, c->table_cap);; h = (h + 1) & (c->table_cap - 1)) {
+        uint32_t i = c->table[h];
+        if (i == 0) return NULL;
+        if (c->fresh[i - 1].key == key) return &c->fresh[i - 1];
+    }
+}
+
+bool glyph_cache_find(const glyph_cache *c, uint32_t key,
+                      glyph_cache_entry *e, const uint8_t **pixels) {
+    if (!c) return false;
+    const uint8_t *base = c->data;
+    const disk_record *r = find_mapped(c, key);
+    if (!r) {
+        r = find_fresh(c, key);
+        base = c->blob;
+    }
+    if (!r) return false;
+    if (e) {
+        *e = (glyph_cache_entry){
+            .key = r->key, .w = r->w, .h = r->h, .off_x = r->off_x, .off_y = r->off_y,
+            .valid = (r->flags & FLAG_VALID) != 0, .color = (r->flags & FLAG_COLOR) != 0,
+            .sdf = (r->flags & FLAG_SDF) != 0,
+        };
+    }
+    if (pixels) *pixels = pixel_bytes(r) ? base + r->offset : NULL;
+    return true;
+}
+
+static bool table_grow(glyph_cache *c) {
+    uint32_t cap = c->table_cap ? c->table_cap * 2 : 256;
+    uint32_t *t = calloc(cap, sizeof(*t));
+    if (!t) return false;
+    for (uint32_t i = 0; i < c->fresh_count; i++) {
+        uint32_t h = table_hash(c->fresh[i].key, cap);
+        while (t[h]) h = (h + 1) & (cap - 1);
+        t[h] = i + 1;
+    }
+    free(c->table);
+    c->table = t;
+    c->table_cap = cap;
+    return true;
+}
+
+void glyph_cache_add(glyph_cache *c, const glyph_cache_entry *e,
+                     const uint8_t *pixels, size_t stride) {
+    if (!c || !e || glyph_cache_find(c, e->key, NULL, NULL)) return;
+    if (c->count + c->fresh_count >= MAX_ENTRIES) return;
+    disk_record r = {
+        .key = e->key, .w = e->w, .h = e->h, .off_x = e->off_x, .off_y = e->off_y,
+        .flags = (uint8_t)((e->valid ? FLAG_VALID : 0u) | (e->color ? FLAG_COLOR : 0u) |
+                           (e->sdf ? FLAG_SDF : 0u)),
+    };
+    size_t bytes = pixel_bytes(&r);
+    if (bytes && !pixels) return;
+    if (c->data_len + c->blob_len + bytes > GLYPH_CACHE_MAX_BYTES) return;
+
+    if ((c->fresh_count + 1) * 2 > c->table_cap && !table_grow(c)) return;
+    if (c->fresh_count == c->fresh_cap) {
+        uint32_t cap = c->fresh_cap ? c->fresh_cap * 2 : 256;
+        disk_record *f = realloc(c->fresh, cap * sizeof(*f));
+        if (!f) return;
+        c->fresh = f;
+        c->fresh_cap = cap;
+    }
+    if (c->blob_len + bytes > c->blob_cap) {
+        size_t cap = c->blob_cap ? c->blob_cap : 64 * 1024;
+        while (cap < c->blob_len + bytes) cap *= 2;
+        uint8_t *b = realloc(c->blob, cap);
+        if (!b) return;
+        c->blob = b;
+        c->blob_cap = cap;
+    }
+
+    r.offset = (uint32_t)c->blob_len;
+    size_t row = bytes ? bytes / r.h : 0;
+    for (int y = 0; bytes && y < r.h; y++)
+        memcpy(c->blob + c->blob_len + (size_t)y * row, pixels + (size_t)y * stride, row);
+    c->blob_len += bytes;
+
+    uint32_t h = table_hash(r.key, c->table_cap);
+    while (c->table[h]) h = (h + 1) & (c->table_cap - 1);
+    c->fresh[c->fresh_count++] = r;
+    c->table[h] = c->fresh_count;
+    c->unsaved = true;
+}
+
+static int cmp_record(const void *pa, const void *pb) {
+    uint32_t a = ((const disk_record *)pa)->key, b = ((const disk_record *)pb)->key;
+    return a < b ? -1 : a > b;
+}
+
+bool glyph_cache_save(glyph_cache *c) {
+    if (!c || !c->unsaved) return true;
+
+    /* Merge the two sorted runs; keys are unique across them (add skips keys
+     * already present), so this is a plain merge. */
+    uint32_t total = c->count + c->fresh_count;
+    disk_record *fresh = malloc((size_t)c->fresh_count * sizeof(*fresh));
+    disk_record *out = malloc((size_t)total * sizeof(*out));
+    const uint8_t **src = malloc((size_t)total * sizeof(*src));
+    if (!fresh || !out || !src) {
+        free(fresh); free(out); free(src);
+        return false;
+    }
+    memcpy(fresh, c->fresh, (size_t)c->fresh_count * sizeof(*fresh));
+    qsort(fresh, c->fresh_count, sizeof(*fresh), cmp_record);
+    uint64_t offset = 0;
+    for (uint32_t i = 0, j = 0, k = 0; k < total; k++) {
+        bool mapped = j >= c->fresh_count || (i < c->count && c->index[i].key < fresh[j].key);
+        out[k] = mapped ? c->index[i++] : fresh[j++];
+        src[k] = (mapped ? c->data : c->blob) + out[k].offset;
+        out[k].offset = (uint32_t)offset;
+        offset += pixel_bytes(&out[k]);
+    }
+
+    char tmp_path[640];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp.%d.%lx", c->path, (int)getpid(),
+             (unsigned long)(uintptr_t)c);
+    bool wrote = false;
+    FILE *f = fopen(tmp_path, "wb");
+    if (f) {
+        struct glyph_cache_header hdr = {
+            .magic = GLYPH_CACHE_MAGIC,
+            .version = GLYPH_CACHE_VERSION,
+            .cell_w = (uint32_t)c->cell_w,
+            .cell_h = (uint32_t)c->cell_h,
+            .count = total,
+            .reserved = 0,
+            .length = offset,
+        };
+        wrote = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+                (total == 0 || fwrite(out, sizeof(*out), total, f) == total);
+        for (uint32_t k = 0; wrote && k < total; k++) {
+            size_t n = pixel_bytes(&out[k]);
+            wrote = n == 0 || fwrite(src[k], n, 1, f) == 1;
+        }
+        wrote = (fclose(f) == 0) && wrote;
+        if (!wrote || rename(tmp_path, c->path) != 0) { /* rename: atomic publish */
+            unlink(tmp_path);
+            wrote = false;
+        }
+    }
+    free(fresh);
+    free(out);
+    free(src);
+    if (wrote) c->unsaved = false;
+    return wrote;
+}
+
+void glyph_cache_close(glyph_cache *c) {
+    if (!c) return;
+    glyph_cache_save(c);
+    if (c->map) munmap(c->map, c->map_len);
+    free(c->fresh);
+    free(c->blob);
+    free(c->table);
+    free(c);
+}
+
+size_t glyph_cache_count(const glyph_cache *c) {
+    return c ? (size_t)c->count + c->fresh_count : 0;
+}
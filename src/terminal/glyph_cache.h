@@ -0,0 +1,74 @@
+/*
+ * glyph_cache.h — rasterized glyphs persisted across runs (private to the
+ * terminal module).
+ *
+ * One file per font set and cell size under $XDG_CACHE_HOME/neowall/glyphs
+ * (~/.cache when unset), named by a 64-bit key the atlas derives from the
+ * fonts it loaded and the supersampled cell size. The file is mmapped on open
+ * and its sorted index binary-searched on lookup, so a warm start costs a
+ * memcpy per glyph instead of an stb_truetype raster or a PNG decode, and
+ * only the glyphs actually drawn are ever paged in.
+ *
+ * Glyphs rasterized during the run are collected in memory and merged into a
+ * new file on save (written beside it and renamed over it). A file that fails
+ * validation is removed and the cache starts empty.
+ */
+#ifndef NEOWALL_TERMINAL_GLYPH_CACHE_H
+#define NEOWALL_TERMINAL_GLYPH_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct glyph_cache glyph_cache;
+
+/* What the atlas needs to place a glyph without rasterizing it. Pixels are
+ * w*h bytes of coverage (of signed distance when `sdf`), or w*h*4 of
+ * straight-alpha RGBA when `color`. An entry with !valid records a key no
+ * face could draw. */
+typedef struct {
+    uint32_t key;          /* codepoint | style bits */
+    uint16_t w, h;
+    int16_t  off_x, off_y;
+    bool     valid;
+    bool     color;
+    bool     sdf;
+} glyph_cache_entry;
+
+/* FNV-1a 64 over `len` bytes, continuing from `h` (start from
+ * GLYPH_CACHE_HASH_INIT). */
+#define GLYPH_CACHE_HASH_INIT 0xcbf29ce484222325ull
+uint64_t glyph_cache_hash(const void *data, size_t len, uint64_t h);
+
+/* Fold a font file's identity (path, size, mtime, inode) into `h`; cheaper
+ * than hashing a multi-megabyte CJK or emoji font and changes whenever the
+ * file is replaced. An unreadable path folds in the path alone. */
+uint64_t glyph_cache_hash_file(const char *path, uint64_t h);
+
+/* Open (and map) the cache file for `key`. A missing or invalid file yields
+ * an empty cache; NULL only if there is no cache directory or no memory. */
+glyph_cache *glyph_cache_open(uint64_t key, int cell_w, int cell_h);
+
+/* Save the glyphs added since open, if any, then unmap and free. */
+void         glyph_cache_close(glyph_cache *c);
+
+/* Look up `key`. On a hit fills *e and points *pixels at its packed rows
+ * (NULL for a glyph without ink); valid until close. */
+bool         glyph_cache_find(const glyph_cache *c, uint32_t key,
+                              glyph_cache_entry *e, const uint8_t **pixels);
+
+/* Record a freshly rasterized glyph; its pixels (rows `stride` bytes apart)
+ * are copied. Ignored once the cache holds GLYPH_CACHE_MAX_BYTES of pixels
+ * or when the key is already present. */
+#define GLYPH_CACHE_MAX_BYTES (32u << 20)
+void         glyph_cache_add(glyph_cache *c, const glyph_cache_entry *e,
+                             const uint8_t *pixels, size_t stride);
+
+/* Write the mapped and added glyphs to the file now. False on I/O failure;
+ * true (and no write) when nothing was added. */
+bool         glyph_cache_save(glyph_cache *c);
+
+/* Glyphs known to the cache: mapped plus added. */
+size_t       glyph_cache_count(const glyph_cache *c);
+
+#endif /* NEOWALL_TERMINAL_GLYPH_CACHE_H */
@@ -17,6 +17,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <poll.h>
 #include <pthread.h>
 #include <pty.h>
@@ -31,11 +32,24 @@
 #include <sys/ioctl.h>
 #include <sys/wait.h>
 #include <termios.h>
+#include <time.h>
 #include <unistd.h>
 
-/* term_screen is defined in screen.c; we only use its public API here, plus one
- * accessor to build the snapshot. To copy the grid we read rows via
- * term_screen_row(). */
+/* Synchronized output (DECSET 2026): a repaint is kept off screen for at most
+ * this long, so an app that never ends one cannot freeze the wallpaper. */
+#define SYNC_TIMEOUT_SEC   0.25
+/* Flood: when more than FLOOD_BYTES arrive between snapshots for FLOOD_FRAMES
+ * snapshots in a row, the child is writing far faster than anyone can read
+ * (cat of a big file) and snapshots are taken at most every
+ * FLOOD_INTERVAL_SEC. Every snapshot of a flood is a full-grid scroll, so this
+ * cuts copies, resolves and uploads by the same factor. */
+#define FLOOD_BYTES        (64 * 1024)
+#define FLOOD_FRAMES       2
+#define FLOOD_INTERVAL_SEC (1.0 / 20.0)
+
+/* term_screen is defined in screen.c; we only use its public API here. To
+ * copy the grid we take the screen's dirty-row set and read just those rows
+ * via term_screen_row(). */
 
 struct terminal {
     term_screen *screen;
@@ -54,11 +68,27 @@ struct terminal {
     /* snapshot buffer handed to the GL thread (double-buffer: build under lock,
      * expose a stable pointer). */
     term_cell  *snap_cells;
+    uint64_t    snap_dirty[TERM_SCREEN_DIRTY_WORDS]; /* rows copied by the last snapshot */
+    int         snap_base;  /* ring slot of grid row 0 in snap_cells */
     term_frame  frame;
     uint64_t    epoch;
     atomic_ullong dirty_epoch;  /* bumped by reader when grid changes */
+
+    /* Snapshot pacing (GL thread only, apart from fed_bytes). */
+    atomic_ullong fed_bytes;    /* bytes the reader has fed the screen */
+    uint64_t    snap_fed;       /* fed_bytes at the last snapshot taken */
+    double      snap_secs;      /* when it was taken */
+    int         flood_frames;   /* snapshots in a row that took > FLOOD_BYTES */
+    double      sync_since;     /* first snapshot held for a repaint (0 = none) */
+    uint32_t    sync_expired;   /* repaint no longer waited for (timed out) */
 };
 
+static double mono_secs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
 /* ------------------------------------------------------------------------ */
 
 static void set_nonblock(int fd) {
@@ -118,6 +148,7 @@ static void *reader_main(void *arg) {
                  * waiting for a cursor-position / device-attributes reply. */
                 rlen = term_screen_take_reply(t->screen, reply, sizeof(reply));
                 pthread_mutex_unlock(&t->lock);
+                atomic_fetch_add(&t->fed_bytes, (unsigned long long)n);
                 if (rlen > 0) (void)write_reply(t, reply, rlen);
                 atomic_fetch_add(&t->dirty_epoch, 1);
             } else if (n == 0) {
@@ -158,6 +189,10 @@ nw_result term_spawn(const term_spawn_opts *opts, terminal **out) {
 
     t->screen = term_screen_create(cols, rows);
     if (!t->screen) { free(t); return nw_err(NW_ERR_OOM, "term_spawn: screen"); }
+    if (!term_screen_set_scrollback(t->screen, opts->scrollback)) {
+        term_screen_destroy(t->screen); free(t);
+        return nw_err(NW_ERR_OOM, "term_spawn: scrollback");
+    }
 
     t->snap_cells = calloc((size_t)cols * rows, sizeof(term_cell));
     if (!t->snap_cells) { term_screen_destroy(t->screen); free(t); return nw_err(NW_ERR_OOM, "snap"); }
@@ -325,6 +360,7 @@ nw_result term_resize(terminal *t, int cols, int rows) {
     }
     free(t->snap_cells);
     t->snap_cells = ns;
+    t->snap_base = 0;
     t->cols = term_screen_cols(t->screen);
     t->rows = term_screen_rows(t->screen);
     cols = t->cols;
@@ -341,11 +377,24 @@ nw_result term_resize(terminal *t, int cols, int rows) {
 /* Input: host → child                                                      */
 /* ------------------------------------------------------------------------ */
 
+int term_scroll_view(terminal *t, int delta) {
+    if (!t) return 0;
+    pthread_mutex_lock(&t->lock);
+    int before = term_screen_view_offset(t->screen);
+    int after = term_screen_scroll_view(t->screen, delta);
+    pthread_mutex_unlock(&t->lock);
+    if (after != before) atomic_fetch_add(&t->dirty_epoch, 1);
+    return after;
+}
+
 nw_result term_write(terminal *t, const void *bytes, size_t len) {
     if (!t || t->master_fd < 0) return nw_err(NW_ERR_INVALID_ARG, "term_write: bad terminal");
     if (!bytes || len == 0) return nw_ok();
     if (atomic_load(&t->child_exited)) return nw_err(NW_ERR_STATE, "term_write: child gone");
 
+    /* Typing while scrolled back returns to the live screen, as in xterm. */
+    term_scroll_view(t, INT_MIN / 2);
+
     const uint8_t *p = bytes;
     size_t off = 0;
     /* The master fd is non-blocking; retry short/EAGAIN writes briefly. TUIs
@@ -377,6 +426,11 @@ bool term_mouse(terminal *t, int cell_x, int cell_y, int button, bool pressed, b
     int cols = t->cols, rows = t->rows;
     pthread_mutex_unlock(&t->lock);
 
+    /* The wheel scrolls the history when the app doesn't want the mouse. */
+    if (proto == 0 && pressed && (button == 64 || button == 65)) {
+        int before = term_scroll_view(t, 0);
+        return term_scroll_view(t, button == 64 ? 3 : -3) != before;
+    }
     if (proto == 0) return false;               /* app doesn't want mouse */
     if (motion && proto < 1002) return false;   /* click-only: ignore motion */
 
@@ -422,29 +476,79 @@ bool term_child_exited(const terminal *t, int *exit_status_out) {
     return ex;
 }
 
+/* Keep showing the previous frame instead of snapshotting: while the app is
+ * inside a synchronized repaint (until it ends or times out), and between the
+ * paced snapshots of a flood. Needs a previous frame of the current size.
+ * Called under the lock. */
+static bool hold_frame(terminal *t, int cols, int rows, double now) {
+    if (t->frame.cells != t->snap_cells || t->frame.cols != cols || t->frame.rows != rows)
+        return false;
+    /* The timeout runs from the first held snapshot, not from the start of
+     * the current repaint: an app that is mid-repaint every time we look
+     * still gets a frame out every SYNC_TIMEOUT_SEC. A repaint that outlived
+     * it is shown as it goes. */
+    uint32_t begun;
+    if (term_screen_sync_pending(t->screen, &begun) && begun != t->sync_expired) {
+        if (t->sync_since == 0.0) t->sync_since = now;
+        if (now - t->sync_since < SYNC_TIMEOUT_SEC) return true;
+        t->sync_expired = begun;
+    }
+    return t->flood_frames >= FLOOD_FRAMES && now - t->snap_secs < FLOOD_INTERVAL_SEC;
+}
+
 const term_frame *term_snapshot(terminal *t) {
     if (!t) return NULL;
     uint64_t de = atomic_load(&t->dirty_epoch);
-
+    uint64_t fed = atomic_load(&t->fed_bytes);
+    double now = mono_secs();
+
+    /* snap_cells persists across snapshots, so rows the child did not touch
+     * already hold their current contents: copy only the dirty ones. On a
+     * 400x100 grid where htop redraws its clock, that is one row, not 100.
+     * Like the screen, the buffer is a ring of rows, so when a log scrolls
+     * the whole grid only the origin moves and the new lines are copied. */
     pthread_mutex_lock(&t->lock);
     int cols = term_screen_cols(t->screen);
     int rows = term_screen_rows(t->screen);
+    if (hold_frame(t, cols, rows, now)) {
+        /* Same cells, nothing dirty, and the epoch already consumed, so the
+         * caller uploads nothing but keeps polling until the frame moves. */
+        pthread_mutex_unlock(&t->lock);
+        memset(t->snap_dirty, 0, sizeof(t->snap_dirty));
+        t->frame.scrolled = 0;
+        return &t->frame;
+    }
+    uint64_t took = fed - t->snap_fed;
+    t->snap_fed = fed;
+    t->snap_secs = now;
+    t->sync_since = 0.0;
+    t->flood_frames = took > FLOOD_BYTES ? t->flood_frames + 1 : 0;
+    int scrolled = 0;
+    term_screen_take_dirty(t->screen, t->snap_dirty, &scrolled);
+    t->snap_base = (int)(((long)t->snap_base + scrolled % rows + rows) % rows);
     for (int y = 0; y < rows; y++) {
-        const term_cell *row = term_screen_row(t->screen, y);
-        if (row) memcpy(&t->snap_cells[(size_t)y * cols], row, (size_t)cols * sizeof(term_cell));
+        if (!((t->snap_dirty[y >> 6] >> (y & 63)) & 1)) continue;
+        const term_cell *row = term_screen_view_row(t->screen, y);
+        int slot = (t->snap_base + y) % rows;
+        if (row) memcpy(&t->snap_cells[(size_t)slot * cols], row, (size_t)cols * sizeof(term_cell));
     }
     int cx, cy;
     term_screen_cursor(t->screen, &cx, &cy);
     bool cvis = term_screen_cursor_visible(t->screen);
+    cy += term_screen_view_offset(t->screen);   /* scrolled back: the cursor moves down, or off */
+    if (cy >= rows) { cy = rows - 1; cvis = false; }
     pthread_mutex_unlock(&t->lock);
 
     t->frame.cols = cols;
     t->frame.rows = rows;
     t->frame.cells = t->snap_cells;
+    t->frame.row_base = t->snap_base;
+    t->frame.scrolled = scrolled;
     t->frame.cursor_x = cx;
     t->frame.cursor_y = cy;
     t->frame.cursor_visible = cvis;
     t->frame.epoch = de;
+    t->frame.dirty_rows = t->snap_dirty;
     return &t->frame;
 }
 
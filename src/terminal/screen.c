@@ -21,6 +21,7 @@
  * indexed colours, which keeps OSC-4 palette changes and themes working later.
  */
 #include "neowall/terminal/terminal.h"
+#include "scrollback.h"
 #include "vtparse.h"
 
 #include <stdlib.h>
@@ -34,6 +35,10 @@
 #define TERM_MAX_COLS TERM_SCREEN_MAX_COLS
 #define TERM_MAX_ROWS TERM_SCREEN_MAX_ROWS
 #define TAB_WIDTH_DEFAULT 8
+/* Memory budget per line of requested scrollback. An ASCII log line encodes
+ * to its text plus a few bytes; heavily coloured lines cost more and simply
+ * shorten the history instead of growing memory. */
+#define HISTORY_BYTES_PER_LINE 128
 
 typedef struct {
     int        x, y;
@@ -43,16 +48,47 @@ typedef struct {
     bool       autowrap;      /* DECAWM */
 } cursor_state;
 
+/* One screen's cells. Rows are reached through `line`, a ring of row pointers:
+ * grid row y lives at line[(base + y) % rows]. Scrolling the whole screen only
+ * moves `base` and blanks the rows that come in; scrolling a DECSTBM region
+ * rotates that region's pointers. No cell is copied either way. */
+typedef struct {
+    term_cell  *store;   /* rows*cols cells, in whatever order the ring left them */
+    term_cell **line;
+    int         base;
+} term_grid;
+
 struct term_screen {
     int cols, rows;
 
-    /* Two grids: the primary and the alternate screen. `cells` points at the
-     * active one. Each is rows*cols term_cell, row-major. */
-    term_cell *primary;
-    term_cell *alternate;
-    term_cell *cells;
+    /* Two grids: the primary and the alternate screen. `grid` points at the
+     * active one. */
+    term_grid  primary;
+    term_grid  alternate;
+    term_grid *grid;
     bool       on_alt;
 
+    /* Rows whose cells changed since the last term_screen_take_dirty(), one
+     * bit per row of the ACTIVE grid. Every cell write goes through cell_at(),
+     * row_fill_blank() or a scroll, and each of those sets its row's bit, so
+     * the snapshot copies (and the renderer re-resolves) only these rows. A
+     * grid switch or resize marks every row. */
+    uint64_t   dirty[TERM_SCREEN_DIRTY_WORDS];
+    /* Net lines the whole active grid scrolled up (negative: down) over the
+     * same interval. The bits above are indexed after the scroll, so a
+     * consumer rotates what it holds by this much and copies only them. */
+    int        scrolled;
+
+    /* History: rows that scrolled off the top of the primary screen, kept
+     * compressed (NULL = no scrollback). While `view` > 0 the display is
+     * moved that many rows back into it; the rows shown from history are
+     * decoded into view_cells (display row y at y*cols) only then. New
+     * output keeps the view on the same lines. */
+    term_scrollback *history;
+    int        view;
+    term_cell *view_cells;
+    bool       view_stale;
+
     cursor_state cur;
     cursor_state saved_primary;   /* DECSC target while on primary */
     cursor_state saved_alt;       /* DECSC target while on alt */
@@ -72,6 +108,12 @@ struct term_screen {
     uint16_t mouse_proto;   /* 0=off, 1000=click, 1002=drag, 1003=any-motion */
     bool    mouse_sgr;     /* 1006: SGR extended coordinates (\e[<b;x;yM/m) */
 
+    /* Synchronized output (DECSET 2026): set while the app is repainting, so
+     * the snapshot can keep showing the last finished screen. sync_begun
+     * counts the repaints started, to tell one long update from many. */
+    bool     sync_update;
+    uint32_t sync_begun;
+
     bool *tabstops;      /* cols booleans */
 
     /* Charset selection (VT100 national/DEC special graphics). g[0]/g[1] hold
@@ -112,8 +154,49 @@ static term_cell blank_cell(const term_screen *s) {
     return c;
 }
 
+static void mark_dirty(term_screen *s, int y) {
+    s->dirty[y >> 6] |= 1ull << (y & 63);
+}
+
+static void mark_dirty_range(term_screen *s, int y0, int y1) {
+    for (int y = y0; y <= y1; y++) mark_dirty(s, y);
+}
+
+static void mark_all_dirty(term_screen *s) {
+    mark_dirty_range(s, 0, s->rows - 1);
+}
+
+/* The whole grid moved up by n rows (down if negative): row y's bit now
+ * belongs to row y - n, and bits shifted past either edge are dropped. */
+static void shift_dirty(term_screen *s, int n) {
+    uint64_t out[TERM_SCREEN_DIRTY_WORDS] = {0};
+    int nw = (s->rows + 63) >> 6;               /* words holding a row's bit */
+    int m = n < 0 ? -n : n, q = m >> 6, r = m & 63;
+    for (int i = 0; i < nw; i++) {
+        int a = n > 0 ? i + q : i - q;          /* word feeding bits 0..63-r (or r..63) */
+        int b = n > 0 ? a + 1 : a - 1;          /* word feeding the rest */
+        uint64_t wa = a >= 0 && a < nw ? s->dirty[a] : 0;
+        uint64_t wb = b >= 0 && b < nw ? s->dirty[b] : 0;
+        if (n > 0) out[i] = r ? (wa >> r) | (wb << (64 - r)) : wa;
+        else       out[i] = r ? (wa << r) | (wb >> (64 - r)) : wa;
+    }
+    if (s->rows & 63) out[nw - 1] &= (1ull << (s->rows & 63)) - 1;
+    memcpy(s->dirty, out, sizeof(out));
+}
+
+static term_cell **grid_slot(const term_grid *g, int rows, int y) {
+    int i = g->base + y;
+    return &g->line[i >= rows ? i - rows : i];
+}
+
+static term_cell *row_at(const term_screen *s, int y) {
+    return *grid_slot(s->grid, s->rows, y);
+}
+
+/* A writable cell: marks its row dirty, so callers need no bookkeeping. */
 static term_cell *cell_at(term_screen *s, int x, int y) {
-    return &s->cells[(size_t)y * s->cols + x];
+    mark_dirty(s, y);
+    return &row_at(s, y)[x];
 }
 
 static void clear_wide_pair_at(term_screen *s, int x, int y) {
@@ -135,9 +218,11 @@ static void row_fill_blank(term_screen *s, int y, int x0, int x1) {
     if (x0 >= 0 && x0 < s->cols) clear_wide_pair_at(s, x0, y);
     if (x1 >= 0 && x1 < s->cols) clear_wide_pair_at(s, x1, y);
     term_cell b = blank_cell(s);
+    mark_dirty(s, y);
+    term_cell *row = row_at(s, y);
     for (int x = x0; x <= x1 && x < s->cols; x++) {
         if (x < 0) continue;
-        s->cells[(size_t)y * s->cols + x] = b;
+        row[x] = b;
     }
 }
 
@@ -145,27 +230,60 @@ static void clear_all(term_screen *s) {
     for (int y = 0; y < s->rows; y++) row_fill_blank(s, y, 0, s->cols - 1);
 }
 
+/* Move rows [top,bottom] up by n (down if negative), wrapping within the
+ * region. Spanning the whole grid this is just the ring origin; otherwise the
+ * region's row pointers are rotated. Either way no cell moves, and the rows
+ * that wrapped around still hold old content for the caller to blank. */
+static void rotate_rows(term_screen *s, int top, int bottom, int n) {
+    term_grid *g = s->grid;
+    int h = bottom - top + 1;
+    n %= h;
+    if (n < 0) n += h;
+    if (n == 0) return;
+    if (h == s->rows) {
+        g->base = (g->base + n) % s->rows;
+        return;
+    }
+    term_cell *tmp[TERM_MAX_ROWS];
+    for (int i = 0; i < h; i++) tmp[i] = row_at(s, top + (i + n) % h);
+    for (int i = 0; i < h; i++) *grid_slot(g, s->rows, top + i) = tmp[i];
+}
+
 /* Scroll the region [top,bottom] up by n lines, filling from the bottom with
- * blanks. Used by LF at the region bottom and by SU. */
+ * blanks. Used by LF at the region bottom, SU and DL. A full-screen scroll
+ * keeps the dirty bits of the rows that stay (shifted with them) and reports
+ * the distance instead of dirtying the whole grid. */
 static void scroll_up(term_screen *s, int top, int bottom, int n) {
     if (n <= 0) return;
     if (n > bottom - top + 1) n = bottom - top + 1;
-    for (int y = top; y <= bottom - n; y++) {
-        memcpy(&s->cells[(size_t)y * s->cols],
-               &s->cells[(size_t)(y + n) * s->cols],
-               (size_t)s->cols * sizeof(term_cell));
+    if (top == 0 && s->history && !s->on_alt) {
+        for (int y = 0; y < n; y++) term_scrollback_push(s->history, row_at(s, y), s->cols);
+        if (s->view > 0) {
+            size_t held = term_scrollback_count(s->history);
+            s->view = s->view + n > (int)held ? (int)held : s->view + n;
+            s->view_stale = true;
+        }
     }
+    if (top == 0 && bottom == s->rows - 1 && n < s->rows) {
+        shift_dirty(s, n);
+        s->scrolled += n;
+    } else {
+        mark_dirty_range(s, top, bottom);
+    }
+    rotate_rows(s, top, bottom, n);
     for (int y = bottom - n + 1; y <= bottom; y++) row_fill_blank(s, y, 0, s->cols - 1);
 }
 
 static void scroll_down(term_screen *s, int top, int bottom, int n) {
     if (n <= 0) return;
     if (n > bottom - top + 1) n = bottom - top + 1;
-    for (int y = bottom; y >= top + n; y--) {
-        memcpy(&s->cells[(size_t)y * s->cols],
-               &s->cells[(size_t)(y - n) * s->cols],
-               (size_t)s->cols * sizeof(term_cell));
+    if (top == 0 && bottom == s->rows - 1 && n < s->rows) {
+        shift_dirty(s, -n);
+        s->scrolled -= n;
+    } else {
+        mark_dirty_range(s, top, bottom);
     }
+    rotate_rows(s, top, bottom, -n);
     for (int y = top; y < top + n; y++) row_fill_blank(s, y, 0, s->cols - 1);
 }
 
@@ -260,6 +378,53 @@ static void put_glyph(term_screen *s, uint32_t cp) {
     }
 }
 
+/* Write k single-width cells in the pen at (x, y), k >= 1 and x + k <= cols. */
+static void put_span(term_screen *s, int x, int y, const uint8_t *b, int k) {
+    /* Cells inside the span are overwritten whole; only a wide pair crossing
+     * either edge needs its other half cleared. */
+    clear_wide_pair_at(s, x, y);
+    if (k > 1) clear_wide_pair_at(s, x + k - 1, y);
+    mark_dirty(s, y);
+    term_cell c = {.fg = s->pen_fg, .bg = s->pen_bg, .attr = s->pen_attr};
+    term_cell *row = row_at(s, y) + x;
+    for (int i = 0; i < k; i++) {
+        c.cp = b[i];
+        row[i] = c;
+    }
+}
+
+/* put_glyph() for a run of printable ASCII: every character is one column
+ * wide, so the run is laid down a row at a time with one wrap decision per
+ * row instead of one per character. */
+static void put_ascii_run(term_screen *s, const uint8_t *b, size_t n) {
+    while (n > 0) {
+        if (s->pending_wrap && s->cur.autowrap) {
+            s->cur.x = 0;
+            line_feed(s);
+        }
+        int x = s->cur.x;
+        size_t room = (size_t)(s->cols - x);
+        if (!s->cur.autowrap && n > room) {
+            /* Without autowrap everything past the edge lands on the last
+             * column in turn, so only the final character stays there. */
+            if (room > 1) put_span(s, x, s->cur.y, b, (int)room - 1);
+            put_span(s, s->cols - 1, s->cur.y, b + n - 1, 1);
+            s->cur.x = s->cols - 1;
+            s->pending_wrap = true;
+            return;
+        }
+        int k = (int)(n < room ? n : room);
+        put_span(s, x, s->cur.y, b, k);
+        s->cur.x += k;
+        if (s->cur.x >= s->cols) {
+            s->cur.x = s->cols - 1;
+            s->pending_wrap = true;
+        }
+        b += k;
+        n -= (size_t)k;
+    }
+}
+
 /* ------------------------------------------------------------------------ */
 /* tabs                                                                     */
 /* ------------------------------------------------------------------------ */
@@ -299,6 +464,15 @@ static void cb_print(void *u, uint32_t cp) {
     put_glyph(s, cp);
 }
 
+static void cb_print_run(void *u, const uint8_t *b, size_t n) {
+    term_screen *s = u;
+    if (s->g[s->gl] == '0') {          /* line drawing remaps part of ASCII */
+        for (size_t i = 0; i < n; i++) cb_print(u, b[i]);
+        return;
+    }
+    put_ascii_run(s, b, n);
+}
+
 static void cb_execute(void *u, uint8_t c) {
     term_screen *s = u;
     switch (c) {
@@ -412,6 +586,7 @@ static void apply_sgr(term_screen *s, const int *p, int n) {
 }
 
 static void set_mode(term_screen *s, uint8_t marker, const int *p, int n, bool set);
+static void report_mode(term_screen *s, uint8_t marker, int m);
 
 static void enter_alt(term_screen *s, bool clear);
 static void leave_alt(term_screen *s);
@@ -491,6 +666,9 @@ static void cb_csi(void *u, uint8_t final, const int *p, int n,
             break;
         }
         case 'm': apply_sgr(s, p, n); break;                                               /* SGR */
+        case 'p': /* DECRQM: report whether a mode is set */
+            if (nim == 1 && im[0] == '$') report_mode(s, marker, pget(p,n,0,0));
+            break;
         case 'h': set_mode(s, marker, p, n, true); break;                                  /* SM / DECSET */
         case 'l': set_mode(s, marker, p, n, false); break;                                 /* RM / DECRST */
         case 's': /* save cursor (ANSI.SYS) */ s->saved_primary = s->cur; break;
@@ -551,6 +729,7 @@ static void cb_esc(void *u, uint8_t final, const uint8_t *im, int nim) {
                 s->pen_attr = 0; s->cursor_visible = true;
                 s->g[0] = 'B'; s->g[1] = 'B'; s->gl = 0;
                 s->scroll_top = 0; s->scroll_bottom = s->rows - 1;
+                s->sync_update = false;
                 clear_all(s); cursor_to(s, 0, 0); reset_tabstops(s);
                 break;
             default: break;
@@ -588,6 +767,10 @@ static void set_mode(term_screen *s, uint8_t marker, const int *p, int n, bool s
                 case 1002: s->mouse_proto = set ? 1002 : 0; break; /* button-drag */
                 case 1003: s->mouse_proto = set ? 1003 : 0; break; /* any-motion */
                 case 1006: s->mouse_sgr = set; break;             /* SGR ext coords */
+                case 2026:                                        /* synchronized output */
+                    if (set && !s->sync_update) s->sync_begun++;
+                    s->sync_update = set;
+                    break;
                 default: break; /* bracketed paste, etc. — no-op for a wallpaper */
             }
         } else {
@@ -599,19 +782,46 @@ static void set_mode(term_screen *s, uint8_t marker, const int *p, int n, bool s
     }
 }
 
+/* DECRQM reply, CSI ? Ps ; Pm $ y: Pm 1 = set, 2 = reset, 0 = not
+ * recognised. Apps probe 2026 this way before bracketing their repaints. */
+static void report_mode(term_screen *s, uint8_t marker, int m) {
+    int v = 0;
+    if (marker == '?') {
+        switch (m) {
+            case 6:    v = s->cur.origin_mode; break;
+            case 7:    v = s->cur.autowrap; break;
+            case 25:   v = s->cursor_visible; break;
+            case 47: case 1047: case 1049: v = s->on_alt; break;
+            case 1000: case 1002: case 1003: v = s->mouse_proto == m; break;
+            case 1006: v = s->mouse_sgr; break;
+            case 2026: v = s->sync_update; break;
+            default:   v = -1; break;
+        }
+    } else {
+        v = m == 4 ? 0 : -1;   /* IRM is never on */
+    }
+    char buf[32];
+    int len = snprintf(buf, sizeof(buf), "\x1b[%s%d;%d$y", marker == '?' ? "?" : "", m,
+                       v < 0 ? 0 : v ? 1 : 2);
+    if (len > 0) screen_reply(s, buf, (size_t)len);
+}
+
 static void enter_alt(term_screen *s, bool clear) {
     if (s->on_alt) return;
+    s->view = 0;   /* the alternate screen has no history */
     s->saved_primary = s->cur;
-    s->cells = s->alternate;
+    s->grid = &s->alternate;
     s->on_alt = true;
+    mark_all_dirty(s);
     if (clear) clear_all(s);
     s->pending_wrap = false;
 }
 
 static void leave_alt(term_screen *s) {
     if (!s->on_alt) return;
-    s->cells = s->primary;
+    s->grid = &s->primary;
     s->on_alt = false;
+    mark_all_dirty(s);
     s->pending_wrap = false;
 }
 
@@ -655,12 +865,20 @@ static int char_width(uint32_t cp) {
 /* public API                                                               */
 /* ------------------------------------------------------------------------ */
 
-static void screen_alloc_grids(term_screen *s) {
-    size_t nc = (size_t)s->cols * s->rows;
-    s->primary   = calloc(nc, sizeof(term_cell));
-    s->alternate = calloc(nc, sizeof(term_cell));
-    s->tabstops  = calloc((size_t)s->cols, sizeof(bool));
-    s->cells = s->primary;
+static bool grid_alloc(term_grid *g, int cols, int rows) {
+    g->store = calloc((size_t)cols * rows, sizeof(term_cell));
+    g->line  = malloc((size_t)rows * sizeof(term_cell *));
+    g->base  = 0;
+    if (!g->store || !g->line) return false;
+    for (int y = 0; y < rows; y++) g->line[y] = &g->store[(size_t)y * cols];
+    return true;
+}
+
+static void grid_free(term_grid *g) {
+    free(g->store);
+    free(g->line);
+    g->store = NULL;
+    g->line = NULL;
 }
 
 term_screen *term_screen_create(int cols, int rows) {
@@ -669,8 +887,10 @@ term_screen *term_screen_create(int cols, int rows) {
     term_screen *s = calloc(1, sizeof(*s));
     if (!s) return NULL;
     s->cols = cols; s->rows = rows;
-    screen_alloc_grids(s);
-    if (!s->primary || !s->alternate || !s->tabstops) {
+    s->grid = &s->primary;
+    bool ok = grid_alloc(&s->primary, cols, rows) & grid_alloc(&s->alternate, cols, rows);
+    s->tabstops = calloc((size_t)cols, sizeof(bool));
+    if (!ok || !s->tabstops) {
         term_screen_destroy(s);
         return NULL;
     }
@@ -685,6 +905,7 @@ term_screen *term_screen_create(int cols, int rows) {
 
     vt_callbacks cb = {0};
     cb.print = cb_print;
+    cb.print_run = cb_print_run;
     cb.execute = cb_execute;
     cb.csi = cb_csi;
     cb.esc = cb_esc;
@@ -695,8 +916,10 @@ term_screen *term_screen_create(int cols, int rows) {
 
 void term_screen_destroy(term_screen *s) {
     if (!s) return;
-    free(s->primary);
-    free(s->alternate);
+    grid_free(&s->primary);
+    grid_free(&s->alternate);
+    term_scrollback_destroy(s->history);
+    free(s->view_cells);
     free(s->tabstops);
     free(s);
 }
@@ -710,7 +933,78 @@ int  term_screen_rows(const term_screen *s) { return s->rows; }
 
 const term_cell *term_screen_row(const term_screen *s, int y) {
     if (y < 0 || y >= s->rows) return NULL;
-    return &s->cells[(size_t)y * s->cols];
+    return row_at(s, y);
+}
+
+bool term_screen_take_dirty(term_screen *s, uint64_t rows_out[TERM_SCREEN_DIRTY_WORDS],
+                            int *scrolled) {
+    uint64_t any = 0;
+    for (int i = 0; i < TERM_SCREEN_DIRTY_WORDS; i++) {
+        rows_out[i] = s->dirty[i];
+        any |= s->dirty[i];
+        s->dirty[i] = 0;
+    }
+    /* Scrolled back, the display is not the grid: any change (or a scroll,
+     * which moves the history under the view) repaints every row. */
+    if (s->view > 0 && (any || s->scrolled)) {
+        for (int y = 0; y < s->rows; y++) rows_out[y >> 6] |= 1ull << (y & 63);
+        any = 1;
+        s->scrolled = 0;
+    }
+    if (scrolled) *scrolled = s->scrolled;
+    s->scrolled = 0;
+    return any != 0;
+}
+
+bool term_screen_set_scrollback(term_screen *s, int lines) {
+    if (!s) return false;
+    term_scrollback_destroy(s->history);
+    s->history = NULL;
+    if (s->view) { s->view = 0; mark_all_dirty(s); }
+    if (lines <= 0) return true;
+    s->history = term_scrollback_create((size_t)lines,
+                                        (size_t)lines * HISTORY_BYTES_PER_LINE);
+    return s->history != NULL;
+}
+
+int term_screen_history_lines(const term_screen *s) {
+    return s ? (int)term_scrollback_count(s->history) : 0;
+}
+
+int term_screen_scroll_view(term_screen *s, int delta) {
+    if (!s) return 0;
+    long v = (long)s->view + delta;
+    long held = s->on_alt ? 0 : (long)term_scrollback_count(s->history);
+    if (v > held) v = held;
+    if (v < 0) v = 0;
+    if (v != s->view) {
+        s->view = (int)v;
+        s->view_stale = true;
+        mark_all_dirty(s);
+    }
+    return s->view;
+}
+
+int term_screen_view_offset(const term_screen *s) { return s ? s->view : 0; }
+
+const term_cell *term_screen_view_row(term_screen *s, int y) {
+    if (!s || y < 0 || y >= s->rows) return NULL;
+    if (y >= s->view) return row_at(s, y - s->view);
+    if (!s->view_cells) {
+        s->view_cells = malloc((size_t)s->rows * s->cols * sizeof(term_cell));
+        if (!s->view_cells) return row_at(s, y);
+        s->view_stale = true;
+    }
+    if (s->view_stale) {
+        /* Decode only the history rows on screen: display row r shows the
+         * line (view - 1 - r) back from the newest. */
+        int n = s->view < s->rows ? s->view : s->rows;
+        for (int r = 0; r < n; r++)
+            term_scrollback_line(s->history, (size_t)(s->view - 1 - r),
+                                 &s->view_cells[(size_t)r * s->cols], s->cols);
+        s->view_stale = false;
+    }
+    return &s->view_cells[(size_t)y * s->cols];
 }
 
 void term_screen_cursor(const term_screen *s, int *x, int *y) {
@@ -731,6 +1025,11 @@ void term_screen_mouse_mode(const term_screen *s, int *proto, bool *sgr) {
     if (sgr)   *sgr   = s ? s->mouse_sgr : false;
 }
 
+bool term_screen_sync_pending(const term_screen *s, uint32_t *begun) {
+    if (begun) *begun = s ? s->sync_begun : 0;
+    return s && s->sync_update;
+}
+
 /* Drain any queued reply bytes (query responses) into `out` (up to cap).
  * Returns the number of bytes copied and clears the internal buffer. The PTY
  * layer calls this after each feed and writes the result to the master fd. */
@@ -753,23 +1052,29 @@ bool term_screen_resize(term_screen *s, int cols, int rows) {
     rows = clampi(rows, TERM_MIN_ROWS, TERM_MAX_ROWS);
     if (cols == s->cols && rows == s->rows) return true;
 
-    term_cell *np = calloc((size_t)cols * rows, sizeof(term_cell));
-    term_cell *na = calloc((size_t)cols * rows, sizeof(term_cell));
+    term_grid np, na;
+    bool ok = grid_alloc(&np, cols, rows) & grid_alloc(&na, cols, rows);
     bool *nt = calloc((size_t)cols, sizeof(bool));
-    if (!np || !na || !nt) { free(np); free(na); free(nt); return false; }
+    if (!ok || !nt) { grid_free(&np); grid_free(&na); free(nt); return false; }
 
+    /* The new grids start unrotated, so row y is simply line[y]. */
     int copy_rows = rows < s->rows ? rows : s->rows;
     int copy_cols = cols < s->cols ? cols : s->cols;
     for (int y = 0; y < copy_rows; y++) {
-        memcpy(&np[(size_t)y * cols], &s->primary[(size_t)y * s->cols],   (size_t)copy_cols * sizeof(term_cell));
-        memcpy(&na[(size_t)y * cols], &s->alternate[(size_t)y * s->cols], (size_t)copy_cols * sizeof(term_cell));
+        memcpy(np.line[y], *grid_slot(&s->primary, s->rows, y),   (size_t)copy_cols * sizeof(term_cell));
+        memcpy(na.line[y], *grid_slot(&s->alternate, s->rows, y), (size_t)copy_cols * sizeof(term_cell));
     }
-    bool was_alt = s->on_alt;
-    free(s->primary); free(s->alternate); free(s->tabstops);
+    grid_free(&s->primary); grid_free(&s->alternate); free(s->tabstops);
+    free(s->view_cells);
+    s->view_cells = NULL;
+    s->view = 0;
     s->primary = np; s->alternate = na; s->tabstops = nt;
     s->cols = cols; s->rows = rows;
-    s->cells = was_alt ? s->alternate : s->primary;
+    s->grid = s->on_alt ? &s->alternate : &s->primary;
     s->scroll_top = 0; s->scroll_bottom = rows - 1;
+    memset(s->dirty, 0, sizeof(s->dirty));
+    mark_all_dirty(s);
+    s->scrolled = 0;
     s->cur.x = clampi(s->cur.x, 0, cols - 1);
     s->cur.y = clampi(s->cur.y, 0, rows - 1);
     reset_tabstops(s);
@@ -777,10 +1082,7 @@ bool term_screen_resize(term_screen *s, int cols, int rows) {
      * before it, or retain a head while dropping its tail. Clear the complete
      * pair in either case on both grids. */
     for (int y = 0; y < rows; y++) {
-        term_cell *grids[] = {
-            &s->primary[(size_t)y * cols],
-            &s->alternate[(size_t)y * cols],
-        };
+        term_cell *grids[] = { s->primary.line[y], s->alternate.line[y] };
         for (size_t g = 0; g < sizeof(grids) / sizeof(grids[0]); g++) {
             term_cell *row = grids[g];
             if (row[cols - 1].attr & TERM_ATTR_WIDE_TAIL) {
@@ -801,7 +1103,7 @@ char *term_screen_dump_text(const term_screen *s) {
     if (!out) return NULL;
     size_t o = 0;
     for (int y = 0; y < s->rows; y++) {
-        const term_cell *row = &s->cells[(size_t)y * s->cols];
+        const term_cell *row = row_at(s, y);
         int last = -1;
         for (int x = 0; x < s->cols; x++) if (row[x].cp != 0) last = x;
         for (int x = 0; x <= last; x++) {
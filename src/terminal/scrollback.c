@@ -0,0 +1,262 @@
+/*
+ * scrollback.c — compressed row history. See scrollback.h for the format.
+ *
+ * A row is encoded as
+ *   varint  ncells              stored width, trailing default blanks trimmed
+ *   runs until ncells are covered:
+ *     u8      style header      bits 0-1 fg kind, 2-3 bg kind, 4 attrs present
+ *     ...     fg, bg payload    1 byte (indexed) or 3 (rgb) each, then
+ *     varint  attrs             when bit 4 is set
+ *     varint  run length        cells in this run
+ *     varint  tokens            a codepoint, or REPEAT_BASE + k for k more
+ *                               copies of the previous codepoint
+ * Codepoints are at most U+10FFFF, so tokens from REPEAT_BASE up can never be
+ * mistaken for one; ASCII stays one byte.
+ */
+#include "scrollback.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SB_BLOCK_SIZE (16 * 1024)
+#define REPEAT_BASE   0x110000u
+#define REPEAT_MIN    4            /* shorter repeats are cheaper spelled out */
+/* Worst case per cell: header + two rgb colours + attrs + run length + cp. */
+#define SB_MAX_ROW    (TERM_SCREEN_MAX_COLS * 16 + 8)
+
+typedef struct sb_block {
+    struct sb_block *next;
+    size_t           used;
+    size_t           live;   /* rows stored here that are still held */
+    uint8_t          data[];
+} sb_block;
+
+struct term_scrollback {
+    size_t          max_lines, max_bytes;
+    const uint8_t **line;    /* ring of encoded rows, oldest at `head` */
+    size_t          cap, head, count;
+    sb_block       *first, *last;  /* oldest and newest block */
+    size_t          nblocks;
+};
+
+/* ------------------------------------------------------------------------ */
+
+static size_t put_varint(uint8_t *p, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) { p[n++] = (uint8_t)(v | 0x80); v >>= 7; }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static uint32_t get_varint(const uint8_t **pp) {
+    const uint8_t *p = *pp;
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t b = *p++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+    }
+    *pp = p;
+    return v;
+}
+
+static bool color_eq(const term_color *a, const term_color *b) {
+    if (a->kind != b->kind) return false;
+    if (a->kind == TERM_COLOR_INDEXED) return a->idx == b->idx;
+    if (a->kind == TERM_COLOR_RGB) return a->r == b->r && a->g == b->g && a->b == b->b;
+    return true;
+}
+
+static bool style_eq(const term_cell *a, const term_cell *b) {
+    return a->attr == b->attr && color_eq(&a->fg, &b->fg) && color_eq(&a->bg, &b->bg);
+}
+
+static bool is_default_blank(const term_cell *c) {
+    return c->cp == 0 && c->attr == 0 &&
+           c->fg.kind == TERM_COLOR_DEFAULT && c->bg.kind == TERM_COLOR_DEFAULT;
+}
+
+static unsigned color_code(const term_color *c) {
+    return c->kind == TERM_COLOR_INDEXED ? 1u : c->kind == TERM_COLOR_RGB ? 2u : 0u;
+}
+
+static size_t put_color(uint8_t *p, const term_color *c) {
+    if (c->kind == TERM_COLOR_INDEXED) { p[0] = c->idx; return 1; }
+    if (c->kind == TERM_COLOR_RGB) { p[0] = c->r; p[1] = c->g; p[2] = c->b; return 3; }
+    return 0;
+}
+
+static term_color get_color(const uint8_t **pp, unsigned code) {
+    term_color c = {.kind = TERM_COLOR_DEFAULT};
+    const uint8_t *p = *pp;
+    if (code == 1) { c.kind = TERM_COLOR_INDEXED; c.idx = *p++; }
+    else if (code == 2) { c.kind = TERM_COLOR_RGB; c.r = p[0]; c.g = p[1]; c.b = p[2]; p += 3; }
+    *pp = p;
+    return c;
+}
+
+static size_t encode_row(uint8_t *out, const term_cell *row, int cols) {
+    int n = cols;
+    while (n > 0 && is_default_blank(&row[n - 1])) n--;
+    size_t o = put_varint(out, (uint32_t)n);
+    for (int x = 0; x < n;) {
+        const term_cell *st = &row[x];
+        int len = 1;
+        while (x + len < n && style_eq(&row[x + len], st)) len++;
+
+        out[o++] = (uint8_t)(color_code(&st->fg) | color_code(&st->bg) << 2 |
+                             (st->attr ? 1u << 4 : 0u));
+        o += put_color(out + o, &st->fg);
+        o += put_color(out + o, &st->bg);
+        if (st->attr) o += put_varint(out + o, st->attr);
+        o += put_varint(out + o, (uint32_t)len);
+
+        for (int i = x; i < x + len;) {
+            uint32_t cp = row[i].cp;
+            o += put_varint(out + o, cp);
+            int rep = 0;
+            while (i + 1 + rep < x + len && row[i + 1 + rep].cp == cp) rep++;
+            if (rep >= REPEAT_MIN) {
+                o += put_varint(out + o, REPEAT_BASE + (uint32_t)rep);
+                i += 1 + rep;
+            } else {
+                i++;
+            }
+        }
+        x += len;
+    }
+    return o;
+}
+
+static void decode_row(const uint8_t *p, term_cell *out, int cols) {
+    const term_cell blank = {.fg = {.kind = TERM_COLOR_DEFAULT}, .bg = {.kind = TERM_COLOR_DEFAULT}};
+    int n = (int)get_varint(&p);
+    int x = 0;
+    while (x < n) {
+        unsigned h = *p++;
+        term_cell st = blank;
+        st.fg = get_color(&p, h & 3u);
+        st.bg = get_color(&p, (h >> 2) & 3u);
+        if (h & (1u << 4)) st.attr = (uint16_t)get_varint(&p);
+        int end = x + (int)get_varint(&p);
+        uint32_t prev = 0;
+        while (x < end) {
+            uint32_t t = get_varint(&p);
+            int copies = 1;
+            if (t >= REPEAT_BASE) copies = (int)(t - REPEAT_BASE);
+            else prev = t;
+            for (int k = 0; k < copies; k++, x++) {
+                if (x >= cols) continue;
+                out[x] = st;
+                out[x].cp = prev;
+            }
+        }
+    }
+    for (x = n < cols ? n : cols; x < cols; x++) out[x] = blank;
+}
+
+/* ------------------------------------------------------------------------ */
+
+term_scrollback *term_scrollback_create(size_t max_lines, size_t max_bytes) {
+    if (max_lines == 0) return NULL;
+    term_scrollback *sb = calloc(1, sizeof(*sb));
+    if (!sb) return NULL;
+    sb->max_lines = max_lines;
+    sb->max_bytes = max_bytes;
+    /* Memory is released a block at a time; less than two would leave a
+     * history of the rows in one partly filled block. */
+    if (max_bytes && max_bytes < 2 * (sizeof(sb_block) + SB_BLOCK_SIZE))
+        sb->max_bytes = 2 * (sizeof(sb_block) + SB_BLOCK_SIZE);
+    return sb;
+}
+
+void term_scrollback_destroy(term_scrollback *sb) {
+    if (!sb) return;
+    for (sb_block *b = sb->first, *next; b; b = next) {
+        next = b->next;
+        free(b);
+    }
+    free(sb->line);
+    free(sb);
+}
+
+size_t term_scrollback_count(const term_scrollback *sb) { return sb ? sb->count : 0; }
+
+size_t term_scrollback_bytes(const term_scrollback *sb) {
+    if (!sb) return 0;
+    return sb->nblocks * (sizeof(sb_block) + SB_BLOCK_SIZE) + sb->cap * sizeof(*sb->line);
+}
+
+/* Drop the oldest row; free its block once nothing in it is held. Rows and
+ * blocks are both in push order, so the oldest row is always in `first`. */
+static void evict_oldest(term_scrollback *sb) {
+    sb_block *b = sb->first;
+    sb->head = (sb->head + 1) % sb->cap;
+    sb->count--;
+    if (--b->live > 0) return;
+    if (b == sb->last) {
+        b->used = 0;              /* keep the one block for the next push */
+        return;
+    }
+    sb->first = b->next;
+    free(b);
+    sb->nblocks--;
+}
+
+/* Make room for one more row in the index, doubling up to max_lines. */
+static bool grow_index(term_scrollback *sb) {
+    if (sb->count < sb->cap) return true;
+    if (sb->cap == sb->max_lines) {
+        evict_oldest(sb);
+        return true;
+    }
+    size_t cap = sb->cap ? sb->cap * 2 : 256;
+    if (cap > sb->max_lines) cap = sb->max_lines;
+    const uint8_t **line = malloc(cap * sizeof(*line));
+    if (!line) return false;
+    for (size_t i = 0; i < sb->count; i++) line[i] = sb->line[(sb->head + i) % sb->cap];
+    free(sb->line);
+    sb->line = line;
+    sb->cap = cap;
+    sb->head = 0;
+    return true;
+}
+
+bool term_scrollback_push(term_scrollback *sb, const term_cell *row, int cols) {
+    if (!sb || !row || cols <= 0) return false;
+    if (cols > TERM_SCREEN_MAX_COLS) cols = TERM_SCREEN_MAX_COLS;
+    uint8_t buf[SB_MAX_ROW];
+    size_t len = encode_row(buf, row, cols);
+
+    if (!grow_index(sb)) return false;
+    sb_block *b = sb->last;
+    if (!b || b->used + len > SB_BLOCK_SIZE) {
+        b = malloc(sizeof(sb_block) + SB_BLOCK_SIZE);
+        if (!b) return false;
+        b->next = NULL;
+        b->used = 0;
+        b->live = 0;
+        if (sb->last) sb->last->next = b;
+        else          sb->first = b;
+        sb->last = b;
+        sb->nblocks++;
+    }
+    memcpy(b->data + b->used, buf, len);
+    sb->line[(sb->head + sb->count) % sb->cap] = b->data + b->used;
+    b->used += len;
+    b->live++;
+    sb->count++;
+
+    /* Over the byte budget: drop old rows until their blocks go, but never
+     * the row just added. */
+    while (sb->max_bytes && sb->count > 1 && term_scrollback_bytes(sb) > sb->max_bytes)
+        evict_oldest(sb);
+    return true;
+}
+
+bool term_scrollback_line(const term_scrollback *sb, size_t age, term_cell *out, int cols) {
+    if (!sb || age >= sb->count || !out || cols <= 0) return false;
+    size_t i = (sb->head + sb->count - 1 - age) % sb->cap;
+    decode_row(sb->line[i], out, cols);
+    return true;
+}
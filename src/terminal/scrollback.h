@@ -0,0 +1,47 @@
+/*
+ * scrollback.h — compressed history of rows that scrolled off the screen
+ * (private to the terminal module).
+ *
+ * A retired row is stored as runs of cells sharing one style (fg, bg, attrs),
+ * each run a style header, a length and the codepoints as varints, with a
+ * repeat token for runs of the same character and trailing blanks dropped. A
+ * typical log line (ASCII, one or two styles) costs its text plus a handful of
+ * bytes instead of 16 bytes per cell, so 100k lines of history fit in a few
+ * MB. Rows are decoded only when the view is scrolled back over them.
+ *
+ * Encoded rows are packed into 16 KiB blocks appended in order; the oldest
+ * rows are dropped (and their blocks freed) once either the line or the byte
+ * budget is exceeded.
+ */
+#ifndef NEOWALL_TERMINAL_SCROLLBACK_H
+#define NEOWALL_TERMINAL_SCROLLBACK_H
+
+#include "neowall/terminal/terminal.h"
+
+#include <stddef.h>
+
+typedef struct term_scrollback term_scrollback;
+
+/* Keep at most max_lines rows in at most max_bytes of memory (0 = no byte
+ * budget; a budget below two blocks is raised to that). NULL on allocation
+ * failure or max_lines == 0. */
+term_scrollback *term_scrollback_create(size_t max_lines, size_t max_bytes);
+void             term_scrollback_destroy(term_scrollback *sb);
+
+/* Append one row of `cols` cells as the newest line, evicting the oldest as
+ * needed. False only on allocation failure (the row is then dropped). */
+bool             term_scrollback_push(term_scrollback *sb, const term_cell *row, int cols);
+
+/* Rows currently held. */
+size_t           term_scrollback_count(const term_scrollback *sb);
+
+/* Decode the row `age` lines back (0 = the newest) into `out`, `cols` wide;
+ * cells past the stored width are default blanks, cells past `cols` are cut.
+ * False if age >= count. */
+bool             term_scrollback_line(const term_scrollback *sb, size_t age,
+                                      term_cell *out, int cols);
+
+/* Bytes held: the blocks plus the line index. */
+size_t           term_scrollback_bytes(const term_scrollback *sb);
+
+#endif /* NEOWALL_TERMINAL_SCROLLBACK_H */
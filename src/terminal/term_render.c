@@ -2,11 +2,18 @@
  * term_render.c — resolve a live terminal's cell grid into GPU-ready buffers.
  *
  * Owns a `terminal` and a `glyph_atlas`. Each update():
- *   1. term_snapshot() copies a frame-coherent grid (mutex-guarded internally).
- *   2. skip if the terminal's epoch is unchanged (nothing drew) AND the atlas
- *      didn't change — the shader keeps the previous texture.
- *   3. for each cell: resolve the codepoint's atlas slot (rasterizing on first
- *      touch), resolve fg/bg through the 256-colour palette, pack four uint32.
+ *   1. term_snapshot() copies the rows the child touched since the last frame
+ *      (mutex-guarded internally) and reports which they were.
+ *   2. skip if no row is dirty — the shader keeps the previous texture.
+ *   3. for each cell of a dirty row: resolve the codepoint's atlas slot, resolve
+ *      fg/bg through the 256-colour palette, pack four uint32. Rows the screen
+ *      did not mark keep last frame's records untouched.
+ *
+ * Glyphs are rasterized off this thread: a codepoint seen for the first time
+ * is queued to the atlas's worker pool and its cell shows only its background
+ * (the placeholder) until a later update places the finished glyph and
+ * re-resolves the rows that were waiting for it, so a screen full of new CJK
+ * or emoji costs frames a lookup per cell rather than a raster per glyph.
  *
  * GL-free by design: produces host buffers the shader engine uploads.
  */
@@ -19,6 +26,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <time.h>
+#include <unistd.h>
 
 /* ---- default xterm 256-colour palette (index -> RGB) ------------------- */
 
@@ -51,6 +59,11 @@ static void palette_rgb(uint8_t idx, uint8_t *r, uint8_t *g, uint8_t *b) {
 static const uint8_t kDefaultFg[3] = {200, 200, 200};
 static const uint8_t kDefaultBg[3] = {  0,   0,   0};
 
+/* Atlas cell height in SDF mode, whatever the on-screen cell: enough field
+ * resolution for thin strokes and small counters, and well under the 4x
+ * supersampled cell of any font size above 12 px. */
+#define SDF_CELL_H 48
+
 static void resolve_color(const term_color *c, const uint8_t def[3],
                           uint8_t *r, uint8_t *g, uint8_t *b) {
     switch (c->kind) {
@@ -68,13 +81,16 @@ struct term_render {
     glyph_atlas *atlas;
     int          cols, rows;
     int          cell_w, cell_h;
-    int          ss;          /* atlas supersample factor (glyph px = cell*ss) */
-    uint32_t    *cells;       /* cols*rows*4 uint32 */
+    int          glyph_w, glyph_h; /* atlas cell: 4x supersampled, or the SDF reference */
+    uint32_t    *cells;       /* cols*rows*4 uint32, a ring of rows like the snapshot */
     uint32_t    *prev_cells;  /* previous frame's packed cells, for row diffing */
     uint32_t    *change_ms;   /* cols*rows: ms-since-start each cell last changed */
+    int          row_base;    /* buffer row holding grid row 0 */
     double       start_secs;  /* mono baseline so change_ms fits in 32 bits */
     int          dirty_y0;    /* [dirty_y0, dirty_y1) rows changed this update */
     int          dirty_y1;    /* dirty_y1<=dirty_y0 means nothing changed */
+    uint64_t     row_dirty[TERM_SCREEN_DIRTY_WORDS]; /* buffer rows that changed */
+    uint64_t     row_pending[TERM_SCREEN_DIRTY_WORDS]; /* buffer rows waiting on a glyph */
     uint64_t     last_epoch;
     double       last_change_secs; /* mono time the grid last actually changed */
     int          last_cursor_x, last_cursor_y; /* cursor pos at last change */
@@ -88,6 +104,7 @@ struct term_render {
     char        *cmd;
     char        *cwd;
     char        *term_env;
+    int          scrollback;  /* history lines for each (re)spawn */
     double       exit_at;     /* monotonic secs when the child was seen exited (0 = alive) */
     int          restart_count;
 
@@ -124,10 +141,17 @@ static bool alloc_cells(term_render *tr) {
      * but the shader's texture is undefined, so the diff must not skip rows. */
     tr->dirty_y0 = 0;
     tr->dirty_y1 = tr->rows;
+    tr->row_base = 0;
+    memset(tr->row_dirty, 0xFF, sizeof(tr->row_dirty));
+    memset(tr->row_pending, 0, sizeof(tr->row_pending));
     tr->have_frame_once = false;
     return true;
 }
 
+static bool row_bit(const uint64_t *bits, int y) {
+    return (bits[y >> 6] >> (y & 63)) & 1;
+}
+
 term_render *term_render_create(const term_render_opts *opts, nw_result *err_out) {
     if (!opts || !opts->cmd) {
         if (err_out) *err_out = nw_err(NW_ERR_INVALID_ARG, "term_render: null opts/cmd");
@@ -156,11 +180,21 @@ term_render *term_render_create(const term_render_opts *opts, nw_result *err_out
      * 4x (vs 3x): on a wide, stretched wallpaper grid each cell covers many
      * screen pixels, so a higher oversample visibly smooths diagonal strokes
      * (/ A curves) and thin box lines. Cost is ~1.8x the coverage-atlas memory
-     * and glyph raster time — cheap and one-time (atlas is cached). */
-    tr->ss = 4;
+     * and glyph raster time — cheap and one-time (atlas is cached).
+     *
+     * SDF mode instead rasterizes distance fields at a fixed reference cell
+     * (same aspect) and lets the shader rebuild the edges at display size, so
+     * the atlas no longer scales with the font size or output scale and every
+     * output shares one disk cache. */
+    if (opts->sdf) {
+        tr->glyph_h = SDF_CELL_H;
+        tr->glyph_w = (tr->cell_w * SDF_CELL_H + tr->cell_h / 2) / tr->cell_h;
+        if (tr->glyph_w < 1) tr->glyph_w = 1;
+    } else {
+        tr->glyph_w = tr->cell_w * 4;
+        tr->glyph_h = tr->cell_h * 4;
+    }
     tr->start_secs = mono_secs();
-    int atlas_cw = tr->cell_w * tr->ss;
-    int atlas_ch = tr->cell_h * tr->ss;
 
     /* Load font: explicit in-memory buffer, else a path, else system search. */
     const uint8_t *font_data = opts->font_data;
@@ -188,13 +222,22 @@ term_render *term_render_create(const term_render_opts *opts, nw_result *err_out
 
     tr->atlas = glyph_atlas_create_ex(font_data, font_len,
                                       opts->font_bold_path, opts->font_italic_path,
-                                      atlas_cw, atlas_ch);
+                                      tr->glyph_w, tr->glyph_h);
     free(file_buf); /* atlas copies what it needs; system-font path owns its own */
     if (!tr->atlas) {
         if (err_out) *err_out = nw_err(NW_ERR_IO, "term_render: no usable font");
         free(tr);
         return NULL;
     }
+    glyph_atlas_set_sdf(tr->atlas, opts->sdf);
+
+    /* Rasterize on spare cores, leaving one for the compositor and the PTY
+     * reader; a single-core machine still gets one worker so a burst of new
+     * glyphs is time-sliced against frames instead of stalling one. If no
+     * thread starts, lookups rasterize in place as before. */
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    int nworkers = ncpu > 2 ? (int)(ncpu - 1) : 1;
+    glyph_atlas_start_workers(tr->atlas, nworkers < 4 ? nworkers : 4);
 
     if (!alloc_cells(tr)) {
         if (err_out) *err_out = nw_err(NW_ERR_OOM, "term_render: cell buffer OOM");
@@ -205,7 +248,7 @@ term_render *term_render_create(const term_render_opts *opts, nw_result *err_out
 
     term_spawn_opts so = {
         .cmd = opts->cmd, .cols = tr->cols, .rows = tr->rows,
-        .scrollback = 0, .term_env = opts->term_env,
+        .scrollback = opts->scrollback, .term_env = opts->term_env,
         .cwd = opts->cwd,
     };
     nw_result r = term_spawn(&so, &tr->term);
@@ -223,6 +266,7 @@ term_render *term_render_create(const term_render_opts *opts, nw_result *err_out
     tr->cmd      = opts->cmd ? strdup(opts->cmd) : NULL;
     tr->cwd      = (opts->cwd && opts->cwd[0]) ? strdup(opts->cwd) : NULL;
     tr->term_env = (opts->term_env && opts->term_env[0]) ? strdup(opts->term_env) : NULL;
+    tr->scrollback = opts->scrollback;
 
     /* default fg/bg: config override (0xRRGGBB) or the built-in. */
     if (opts->default_fg >= 0) {
@@ -267,7 +311,7 @@ static bool term_render_respawn(term_render *tr) {
 
     term_spawn_opts so = {
         .cmd = tr->cmd, .cols = tr->cols, .rows = tr->rows,
-        .scrollback = 0, .term_env = tr->term_env, .cwd = tr->cwd,
+        .scrollback = tr->scrollback, .term_env = tr->term_env, .cwd = tr->cwd,
     };
     nw_result r = term_spawn(&so, &tr->term);
     if (nw_is_err(r)) { tr->term = NULL; return false; }
@@ -278,61 +322,15 @@ static bool term_render_respawn(term_render *tr) {
     return true;
 }
 
-bool term_render_update(term_render *tr) {
-    if (!tr) return false;
-
-    /* Auto-restart: if the child exited, relaunch it after a short backoff so a
-     * transient crash resumes the wallpaper instead of freezing on the last
-     * frame. A command that dies instantly gets an increasing delay (capped)
-     * so we don't spin. */
-    if (tr->term && term_child_exited(tr->term, NULL)) {
-        double now = mono_secs();
-        if (tr->exit_at == 0.0) tr->exit_at = now;
-        double backoff = tr->restart_count < 3 ? 0.5
-                       : tr->restart_count < 8 ? 2.0 : 5.0;
-        if (now - tr->exit_at >= backoff) {
-            term_render_respawn(tr);
-        }
-        return false;   /* nothing new to upload while dead/restarting */
-    }
-
-    const term_frame *f = term_snapshot(tr->term);
-    if (!f) return false;
-
-    tr->cursor_x = f->cursor_x;
-    tr->cursor_y = f->cursor_y;
-    tr->cursor_vis = f->cursor_visible;
-
-    /* Cursor motion is its own animation trigger (physical slide/overshoot in
-     * the shader): remember when the cursor cell last moved so the idle gate
-     * keeps painting through the slide even if no glyph cell changed. */
-    if (f->cursor_x != tr->last_cursor_x || f->cursor_y != tr->last_cursor_y) {
-        tr->last_cursor_x = f->cursor_x;
-        tr->last_cursor_y = f->cursor_y;
-        tr->last_cursor_move_secs = mono_secs();
-    }
-
-    /* Grid resized underneath us (child SIGWINCH echo, etc.) — resync. */
-    if (f->cols != tr->cols || f->rows != tr->rows) {
-        tr->cols = f->cols;
-        tr->rows = f->rows;
-        if (!alloc_cells(tr)) return false;
-        tr->have_frame = false;
-    }
-
-    if (tr->have_frame && f->epoch == tr->last_epoch) {
-        return false; /* nothing changed */
-    }
-    tr->last_epoch = f->epoch;
-    tr->have_frame = true;
-
-    const term_cell *src = f->cells;
-    uint32_t *dst = tr->cells;
-    int n = tr->cols * tr->rows;
-    uint32_t now_ms = (uint32_t)((mono_secs() - tr->start_secs) * 1000.0);
-    for (int i = 0; i < n; i++) {
-        const term_cell *c = &src[i];
-        uint32_t *o = &dst[i * 4];
+/* Resolve one row of snapshot cells into packed cell records. Everything a
+ * record depends on is in its own row (a wide tail reads the head to its
+ * left), so rows resolve independently. True if a cell is waiting on a glyph
+ * the workers have not finished. */
+static bool resolve_row(term_render *tr, const term_cell *src, uint32_t *dst) {
+    bool pending = false;
+    for (int x = 0; x < tr->cols; x++) {
+        const term_cell *c = &src[x];
+        uint32_t *o = &dst[(size_t)x * 4];
 
         /* wide-char right half: draw nothing, inherit bg only. */
         bool tail = (c->attr & TERM_ATTR_WIDE_TAIL) != 0;
@@ -350,6 +348,8 @@ bool term_render_update(term_render *tr) {
 
         bool has_glyph = false;
         bool is_color = false;
+        bool is_sdf = false;
+        uint8_t page = 0;
         uint16_t ax = 0, ay = 0, gw = 0, gh = 0;
         int16_t ox = 0, oy = 0;
         if (!tail && c->cp != 0 && c->cp != ' ' &&
@@ -357,24 +357,28 @@ bool term_render_update(term_render *tr) {
             bool bold   = (c->attr & TERM_ATTR_BOLD) != 0;
             bool italic = (c->attr & TERM_ATTR_ITALIC) != 0;
             const glyph_slot *s = glyph_atlas_get_styled(tr->atlas, c->cp, bold, italic);
+            pending = pending || (s && s->pending);
             if (s && s->valid && s->w > 0 && s->h > 0) {
                 has_glyph = true;
                 is_color = s->color;
+                is_sdf = s->sdf;
+                page = s->page;
                 ax = s->x; ay = s->y; gw = s->w; gh = s->h;
                 ox = s->off_x; oy = s->off_y;
             }
-        } else if (tail && i > 0 && !(c->attr & TERM_ATTR_INVISIBLE)) {
+        } else if (tail && x > 0 && !(c->attr & TERM_ATTR_INVISIBLE)) {
             /* Wide-glyph continuation: draw the RIGHT half of the head cell's
              * glyph here instead of leaving it blank, so CJK/emoji span both
              * of their two cells at natural width. We reference the same atlas
              * slot but shift the draw offset left by one on-screen cell, so
              * this cell samples the glyph's second half. */
-            const term_cell *head = &src[i - 1];
+            const term_cell *head = &src[x - 1];
             if (head->cp != 0 && !(head->attr & TERM_ATTR_INVISIBLE)) {
                 bool bold   = (head->attr & TERM_ATTR_BOLD) != 0;
                 bool italic = (head->attr & TERM_ATTR_ITALIC) != 0;
                 const glyph_slot *s = glyph_atlas_get_styled(tr->atlas, head->cp, bold, italic);
-                int cw_ss = tr->cell_w * tr->ss;
+                pending = pending || (s && s->pending);
+                int cw_ss = tr->glyph_w;
                 /* Color emoji always span two cells (drawn into a 2-cell box),
                  * so the tail half is drawn unconditionally; monochrome glyphs
                  * only overflow into the tail when actually wider than a cell. */
@@ -382,6 +386,8 @@ bool term_render_update(term_render *tr) {
                 if (overflows) {
                     has_glyph = true;
                     is_color = s->color;
+                    is_sdf = s->sdf;
+                    page = s->page;
                     ax = s->x; ay = s->y; gw = s->w; gh = s->h;
                     ox = (int16_t)(s->off_x - cw_ss);
                     oy = s->off_y;
@@ -390,58 +396,156 @@ bool term_render_update(term_render *tr) {
         }
 
         uint8_t attr8 = (uint8_t)(c->attr & 0xFF);
-        uint32_t rflags = TERM_PACK_R(ax, ay, has_glyph);
+        uint32_t rflags = TERM_PACK_R(ax, ay, has_glyph) | TERM_PACK_PAGE(page);
         if (is_color) rflags |= TERM_FLAG_COLOR;
+        if (is_sdf) rflags |= TERM_FLAG_SDF;
         o[0] = rflags;
         o[1] = TERM_PACK_G(gw, gh, ox, oy);
         o[2] = TERM_PACK_COL(fr, fg, fb, 0xFF);
         o[3] = TERM_PACK_COL(br, bg, bb, attr8);
+    }
+    return pending;
+}
 
-        /* Change-driven fade: stamp the wall time this cell's record last
-         * differed from the previous frame's, so the shader can ease the cell
-         * in from its background over a short window (graphs/values glide
-         * instead of snapping). prev_cells still holds last frame here (the
-         * row diff below overwrites it). Skip the very first frame
-         * (prev all-zero) so the whole grid doesn't flash on startup. */
-        if (tr->have_frame_once) {
-            const uint32_t *p = &tr->prev_cells[i * 4];
-            if (o[0] != p[0] || o[1] != p[1] || o[2] != p[2] || o[3] != p[3]) {
-                tr->change_ms[i] = now_ms;
-            }
+bool term_render_update(term_render *tr) {
+    if (!tr) return false;
+
+    /* Auto-restart: if the child exited, relaunch it after a short backoff so a
+     * transient crash resumes the wallpaper instead of freezing on the last
+     * frame. A command that dies instantly gets an increasing delay (capped)
+     * so we don't spin. */
+    if (tr->term && term_child_exited(tr->term, NULL)) {
+        double now = mono_secs();
+        if (tr->exit_at == 0.0) tr->exit_at = now;
+        double backoff = tr->restart_count < 3 ? 0.5
+                       : tr->restart_count < 8 ? 2.0 : 5.0;
+        if (now - tr->exit_at >= backoff) {
+            term_render_respawn(tr);
         }
+        return false;   /* nothing new to upload while dead/restarting */
+    }
+
+    const term_frame *f = term_snapshot(tr->term);
+    if (!f) return false;
+
+    tr->cursor_x = f->cursor_x;
+    tr->cursor_y = f->cursor_y;
+    tr->cursor_vis = f->cursor_visible;
+
+    /* Cursor motion is its own animation trigger (physical slide/overshoot in
+     * the shader): remember when the cursor cell last moved so the idle gate
+     * keeps painting through the slide even if no glyph cell changed. */
+    if (f->cursor_x != tr->last_cursor_x || f->cursor_y != tr->last_cursor_y) {
+        tr->last_cursor_x = f->cursor_x;
+        tr->last_cursor_y = f->cursor_y;
+        tr->last_cursor_move_secs = mono_secs();
     }
-    tr->have_frame_once = true;
 
-    /* Diff against the previous frame ROW BY ROW to find the smallest
-     * contiguous [y0,y1) band that actually changed. The GPU uploader then
-     * pushes only those rows instead of the whole grid — for a terminal where
-     * only a handful of lines move per frame (a scrolling log, a cmatrix
-     * column stepping), this cuts the per-frame PCIe traffic from the full
-     * cols*rows*16 bytes down to just the touched band. memcmp over a row is
-     * cheap and vectorised; the win is the smaller glTexSubImage2D. */
-    {
-        size_t roww = (size_t)tr->cols * 4;   /* uint32s per row */
-        int y0 = tr->rows, y1 = 0;
+    /* Grid resized underneath us (child SIGWINCH echo, etc.) — resync. */
+    if (f->cols != tr->cols || f->rows != tr->rows) {
+        tr->cols = f->cols;
+        tr->rows = f->rows;
+        if (!alloc_cells(tr)) return false;
+        tr->have_frame = false;
+    }
+
+    /* The snapshot's dirty rows are the authority, not the epoch: a frame
+     * that carried rows under an epoch we had already seen would otherwise be
+     * dropped, and those rows are never reported again. A fresh buffer or a
+     * respawned child resolves everything. */
+    bool full = !tr->have_frame;
+    tr->last_epoch = f->epoch;
+    tr->row_base = f->row_base;
+
+    /* Glyphs the workers finished since the last update: rows drawn with a
+     * placeholder are resolved again even if the screen did not touch them.
+     * Placing them may have emptied a page, which calls for the full second
+     * pass below. */
+    uint32_t gen0 = glyph_atlas_generation(tr->atlas);
+    bool ready = false;
+    if (glyph_atlas_collect(tr->atlas) > 0) {
+        for (int w = 0; w < TERM_SCREEN_DIRTY_WORDS; w++) ready = ready || tr->row_pending[w];
+    }
+    bool moved = glyph_atlas_generation(tr->atlas) != gen0;
+    if (!full) {
+        bool any = ready || moved;
+        for (int w = 0; w < TERM_SCREEN_DIRTY_WORDS; w++) any = any || f->dirty_rows[w];
+        if (!any) return false; /* nothing changed */
+    }
+    tr->have_frame = true;
+
+    /* Resolve the dirty rows and diff each against the previous frame's
+     * records, so the GPU uploader pushes only rows that actually look
+     * different — a row rewritten with the same text (htop repaints whole
+     * lines) costs a resolve but no upload. The [y0,y1) band bounds them for
+     * damage tracking.
+     *
+     * The buffers mirror the snapshot's ring of rows: when output scrolls the
+     * whole grid, the rows that stay are neither resolved nor uploaded again
+     * (and keep their change stamps); the shader reads through iTermRowBase.
+     * Only the screen's band is reported whole, since every row moved. */
+    size_t roww = (size_t)tr->cols * 4;   /* uint32s per row */
+    uint32_t now_ms = (uint32_t)((mono_secs() - tr->start_secs) * 1000.0);
+    int y0 = tr->rows, y1 = 0;
+    memset(tr->row_dirty, 0, sizeof(tr->row_dirty));
+
+    /* Glyphs looked up below are pinned for this pass. If the atlas had to
+     * empty a page to fit a new glyph, rows resolved in earlier frames may
+     * point at reused space: a second pass re-resolves every row. Its lookups
+     * share the frame, so nothing the second pass places can be evicted by
+     * it; only moved glyphs differ there, and they do not restart the fade. */
+    glyph_atlas_begin_frame(tr->atlas);
+    uint32_t gen = glyph_atlas_generation(tr->atlas);
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1 && !moved && glyph_atlas_generation(tr->atlas) == gen) break;
         for (int y = 0; y < tr->rows; y++) {
-            const uint32_t *cur = tr->cells + (size_t)y * roww;
-            const uint32_t *prv = tr->prev_cells + (size_t)y * roww;
-            if (memcmp(cur, prv, roww * sizeof(uint32_t)) != 0) {
-                if (y < y0) y0 = y;
-                if (y + 1 > y1) y1 = y + 1;
-                memcpy((void *)prv, cur, roww * sizeof(uint32_t));
+            int slot = (tr->row_base + y) % tr->rows;
+            if (!full && pass == 0 && !row_bit(f->dirty_rows, y) &&
+                !(ready && row_bit(tr->row_pending, slot)))
+                continue;
+            uint32_t *cur = tr->cells + (size_t)slot * roww;
+            uint32_t *prv = tr->prev_cells + (size_t)slot * roww;
+            if (resolve_row(tr, term_frame_row(f, y), cur))
+                tr->row_pending[slot >> 6] |= 1ull << (slot & 63);
+            else
+                tr->row_pending[slot >> 6] &= ~(1ull << (slot & 63));
+
+            /* Change-driven fade: stamp the wall time each cell's record last
+             * differed from the previous frame's, so the shader can ease the
+             * cell in from its background over a short window (graphs/values
+             * glide instead of snapping). Skip the very first frame (prev
+             * all-zero) so the whole grid doesn't flash on startup — but
+             * upload it all, since the texture behind a fresh buffer is
+             * undefined. */
+            bool changed = !tr->have_frame_once;
+            for (int x = 0; x < tr->cols; x++) {
+                const uint32_t *o = cur + (size_t)x * 4, *p = prv + (size_t)x * 4;
+                if (o[0] != p[0] || o[1] != p[1] || o[2] != p[2] || o[3] != p[3]) {
+                    if (tr->have_frame_once && pass == 0)
+                        tr->change_ms[(size_t)slot * tr->cols + x] = now_ms;
+                    changed = true;
+                }
             }
+            if (!changed) continue;
+            memcpy(prv, cur, roww * sizeof(uint32_t));
+            tr->row_dirty[slot >> 6] |= 1ull << (slot & 63);
+            if (y < y0) y0 = y;
+            if (y + 1 > y1) y1 = y + 1;
         }
-        tr->dirty_y0 = y0;
-        tr->dirty_y1 = y1;
-        /* Whole grid identical to last frame — tell the caller to skip the
-         * upload entirely (the shader keeps the current texture). */
-        if (y1 <= y0) return false;
     }
+    if (f->scrolled % tr->rows != 0 && !full) { y0 = 0; y1 = tr->rows; }
+    tr->have_frame_once = true;
+    tr->dirty_y0 = y0;
+    tr->dirty_y1 = y1;
+    /* Every resolved row identical to last frame — tell the caller to skip
+     * the upload entirely (the shader keeps the current texture). */
+    if (y1 <= y0) return false;
     tr->last_change_secs = mono_secs();
     return true;
 }
 
 const uint32_t *term_render_cells(const term_render *tr) { return tr ? tr->cells : NULL; }
+int term_render_row_base(const term_render *tr) { return tr ? tr->row_base : 0; }
 int term_render_cols(const term_render *tr) { return tr ? tr->cols : 0; }
 int term_render_rows(const term_render *tr) { return tr ? tr->rows : 0; }
 
@@ -452,6 +556,11 @@ void term_render_cells_dirty_rows(const term_render *tr, int *y0, int *y1) {
     else    { if (y0) *y0 = 0; if (y1) *y1 = 0; }
 }
 
+bool term_render_cells_row_dirty(const term_render *tr, int y) {
+    if (!tr || y < 0 || y >= tr->rows) return false;
+    return row_bit(tr->row_dirty, y);
+}
+
 const uint32_t *term_render_change_ms(const term_render *tr) {
     return tr ? tr->change_ms : NULL;
 }
@@ -459,37 +568,41 @@ uint32_t term_render_now_ms(const term_render *tr) {
     return tr ? (uint32_t)((mono_secs() - tr->start_secs) * 1000.0) : 0;
 }
 
-const uint8_t *term_render_atlas(const term_render *tr) {
-    return tr ? glyph_atlas_bitmap(tr->atlas) : NULL;
+int term_render_atlas_pages(const term_render *tr) {
+    return tr ? glyph_atlas_pages(tr->atlas) : 0;
+}
+const uint8_t *term_render_atlas_page(const term_render *tr, int page) {
+    return tr ? glyph_atlas_page(tr->atlas, page) : NULL;
 }
 int term_render_atlas_w(const term_render *tr) { return tr ? glyph_atlas_width(tr->atlas) : 0; }
 int term_render_atlas_h(const term_render *tr) { return tr ? glyph_atlas_height(tr->atlas) : 0; }
 /* The glyph-pixel cell size the shader needs: nwTerm maps each cell's 0..1
- * fraction into atlas-pixel space, and the atlas is supersampled, so this is
- * the SS-scaled size. (Pixel->cell hit-testing uses tr->cell_w directly and
- * stays at the on-screen size.) */
-int term_render_cell_w(const term_render *tr) { return tr ? tr->cell_w * tr->ss : 0; }
-int term_render_cell_h(const term_render *tr) { return tr ? tr->cell_h * tr->ss : 0; }
+ * fraction into atlas-pixel space, and the atlas is supersampled (or at the
+ * SDF reference size), so this is the atlas cell. (Pixel->cell hit-testing
+ * uses tr->cell_w directly and stays at the on-screen size.) */
+int term_render_cell_w(const term_render *tr) { return tr ? tr->glyph_w : 0; }
+int term_render_cell_h(const term_render *tr) { return tr ? tr->glyph_h : 0; }
 bool term_render_atlas_dirty(const term_render *tr) {
     return tr ? glyph_atlas_dirty(tr->atlas) : false;
 }
-void term_render_atlas_dirty_rows(const term_render *tr, int *y0, int *y1) {
-    if (tr) glyph_atlas_dirty_rows(tr->atlas, y0, y1);
-    else { if (y0) *y0 = 0; if (y1) *y1 = 0; }
+bool term_render_atlas_page_dirty_rows(const term_render *tr, int page, int *y0, int *y1) {
+    return glyph_atlas_page_dirty_rows(tr ? tr->atlas : NULL, page, y0, y1);
 }
 void term_render_clear_atlas_dirty(term_render *tr) {
     if (tr) glyph_atlas_clear_dirty(tr->atlas);
 }
 
-const uint8_t *term_render_color_atlas(const term_render *tr) {
-    return tr ? glyph_atlas_color_bitmap(tr->atlas) : NULL;
+int term_render_color_atlas_pages(const term_render *tr) {
+    return tr ? glyph_atlas_color_pages(tr->atlas) : 0;
+}
+const uint8_t *term_render_color_atlas_page(const term_render *tr, int page) {
+    return tr ? glyph_atlas_color_page(tr->atlas, page) : NULL;
 }
 bool term_render_color_atlas_dirty(const term_render *tr) {
     return tr ? glyph_atlas_color_dirty(tr->atlas) : false;
 }
-void term_render_color_atlas_dirty_rows(const term_render *tr, int *y0, int *y1) {
-    if (tr) glyph_atlas_color_dirty_rows(tr->atlas, y0, y1);
-    else { if (y0) *y0 = 0; if (y1) *y1 = 0; }
+bool term_render_color_atlas_page_dirty_rows(const term_render *tr, int page, int *y0, int *y1) {
+    return glyph_atlas_color_page_dirty_rows(tr ? tr->atlas : NULL, page, y0, y1);
 }
 void term_render_clear_color_atlas_dirty(term_render *tr) {
     if (tr) glyph_atlas_clear_color_dirty(tr->atlas);
@@ -527,6 +640,11 @@ bool term_render_animating(const term_render *tr, unsigned fx_settle_ms) {
     if (tr->term && term_dirty_epoch(tr->term) != tr->last_epoch)
         return true;
 
+    /* Glyphs still with the workers: keep updating so they are placed, and
+     * their cells redrawn, as soon as they are done. */
+    if (glyph_atlas_pending(tr->atlas) > 0)
+        return true;
+
     double now = mono_secs();
     double window = (double)fx_settle_ms / 1000.0;
     if (window < 0.05) window = 0.05;
@@ -565,6 +683,13 @@ bool term_render_mouse(term_render *tr, int px, int py,
     return term_mouse(tr->term, cx, cy, button, pressed, motion);
 }
 
+bool term_render_scroll_page(term_render *tr, int pages) {
+    if (!tr || !tr->term) return false;
+    int page = tr->rows > 2 ? tr->rows - 1 : 1;   /* keep one line of context */
+    int before = term_scroll_view(tr->term, 0);
+    return term_scroll_view(tr->term, pages * page) != before;
+}
+
 bool term_render_wants_mouse(const term_render *tr) {
     return tr ? term_wants_mouse(tr->term) : false;
 }
@@ -16,7 +16,7 @@
  * engine's per-frame glTexSubImage2D.
  *
  * Cell record layout (one RGBA32UI texel per grid cell, .r/.g/.b/.a = uint32):
- *   r: atlas glyph rect, packed  (x<<20 | y<<8 | ... ) — see TERM_PACK_* below
+ *   r: atlas glyph rect, packed  (x<<20 | y<<8 | page<<2 | flags) — see TERM_PACK_*
  *   g: glyph draw offset + size   (off_x, off_y, w, h) 8 bits each (biased)
  *   b: foreground colour RGBA8    (r<<24 | g<<16 | b<<8 | 0xFF)
  *   a: background colour + attrs   (r<<24 | g<<16 | b<<8 | attr8)
@@ -45,6 +45,9 @@ typedef struct term_render_opts {
     const char    *font_italic_path; /* optional italic face (NULL = synth). */
     const char    *cwd;         /* optional working directory for the child. */
     const char    *term_env;    /* optional TERM value (NULL = xterm-256color). */
+    int            scrollback;  /* history lines kept off the top (0 = none). */
+    bool           sdf;         /* distance-field glyphs at a fixed reference size
+                                   instead of coverage at 4x the cell size. */
     /* optional default fg/bg override (each -1 = use built-in). RGB packed 0xRRGGBB. */
     long           default_fg;
     long           default_bg;
@@ -54,22 +57,32 @@ typedef struct term_render_opts {
 term_render *term_render_create(const term_render_opts *opts, nw_result *err_out);
 void         term_render_destroy(term_render *tr);
 
-/* Pull a fresh snapshot from the terminal and resolve every changed cell into
- * the cell buffer, rasterizing any newly-seen glyph into the atlas. Returns
- * true if the cell buffer changed since the last update (upload needed). */
+/* Pull a fresh snapshot from the terminal and resolve the rows the child
+ * touched into the cell buffer, rasterizing any newly-seen glyph into the
+ * atlas. Returns true if the cell buffer changed since the last update
+ * (upload needed). */
 bool term_render_update(term_render *tr);
 
-/* Cell buffer: cols*rows RGBA32UI texels, row-major (row 0 = top line).
- * Valid until the next update. Width/height in cells via the cols/rows getters. */
+/* Cell buffer: cols*rows RGBA32UI texels, row-major. Valid until the next
+ * update. Width/height in cells via the cols/rows getters. The rows form a
+ * ring so that scrolling output does not rewrite the buffer: grid row y (0 =
+ * top line) is buffer row (row_base + y) % rows. The change timestamps below
+ * use the same layout. */
 const uint32_t *term_render_cells(const term_render *tr); /* 4 uint32 per cell */
 int             term_render_cols(const term_render *tr);
 int             term_render_rows(const term_render *tr);
+int             term_render_row_base(const term_render *tr);
 
-/* Rows [y0,y1) of the cell buffer that changed in the last update() that
- * returned true. The uploader pushes only this band (glTexSubImage2D sub-rect)
- * instead of the whole grid. y1<=y0 means no rows changed. */
+/* Screen rows [y0,y1) that look different after the last update() that
+ * returned true, for damage tracking. A scroll of the whole grid reports all
+ * rows. y1<=y0 means no rows changed. */
 void            term_render_cells_dirty_rows(const term_render *tr, int *y0, int *y1);
 
+/* Whether BUFFER row y changed in that update. The uploader pushes each run
+ * of dirty buffer rows (glTexSubImage2D sub-rects) instead of the whole grid;
+ * after a scroll that is just the rows that came in. */
+bool            term_render_cells_row_dirty(const term_render *tr, int y);
+
 /* Per-cell "last changed" timestamps for the change-driven fade: one uint32 per
  * cell (cols*rows, row-major), each the ms-since-start when that cell's record
  * last differed from the prior frame. Upload as an R32UI texture; the shader
@@ -78,22 +91,29 @@ void            term_render_cells_dirty_rows(const term_render *tr, int *y0, int
 const uint32_t *term_render_change_ms(const term_render *tr);
 uint32_t        term_render_now_ms(const term_render *tr);
 
-/* Atlas coverage bitmap (GL_R8), and whether it grew since last clear. */
-const uint8_t *term_render_atlas(const term_render *tr);
+/* Atlas coverage pages (layers of a GL_R8 texture array, atlas_w x atlas_h
+ * each). The page count only grows; when it does, the array must be
+ * reallocated and every page pushed. Otherwise page_dirty_rows gives the rows
+ * of one page to re-push (false if the page is clean). */
+int            term_render_atlas_pages(const term_render *tr);
+const uint8_t *term_render_atlas_page(const term_render *tr, int page);
 int            term_render_atlas_w(const term_render *tr);
 int            term_render_atlas_h(const term_render *tr);
 int            term_render_cell_w(const term_render *tr);
 int            term_render_cell_h(const term_render *tr);
 bool           term_render_atlas_dirty(const term_render *tr);
-void           term_render_atlas_dirty_rows(const term_render *tr, int *y0, int *y1);
+bool           term_render_atlas_page_dirty_rows(const term_render *tr, int page,
+                                                 int *y0, int *y1);
 void           term_render_clear_atlas_dirty(term_render *tr);
 
-/* Color-emoji atlas (GL_RGBA8, same dimensions as the coverage atlas). NULL if
- * no color-emoji font is present, in which case the shader's color branch is
- * never taken (no cell ever sets TERM_FLAG_COLOR). */
-const uint8_t *term_render_color_atlas(const term_render *tr);
+/* Color-emoji pages (GL_RGBA8 texture array, same page size). None until the
+ * first colour glyph, and never without a color-emoji font — in which case the
+ * shader's color branch is never taken (no cell sets TERM_FLAG_COLOR). */
+int            term_render_color_atlas_pages(const term_render *tr);
+const uint8_t *term_render_color_atlas_page(const term_render *tr, int page);
 bool           term_render_color_atlas_dirty(const term_render *tr);
-void           term_render_color_atlas_dirty_rows(const term_render *tr, int *y0, int *y1);
+bool           term_render_color_atlas_page_dirty_rows(const term_render *tr, int page,
+                                                       int *y0, int *y1);
 void           term_render_clear_color_atlas_dirty(term_render *tr);
 
 /* Cursor (in cell coords) for the shader to draw a block/underline. */
@@ -125,15 +145,23 @@ bool           term_render_mouse(term_render *tr, int px, int py,
 /* True if the child enabled any mouse reporting mode. */
 bool           term_render_wants_mouse(const term_render *tr);
 
+/* Scroll the view `pages` screens back into history (negative: forward), a
+ * page being one line short of the grid. True if the view moved. */
+bool           term_render_scroll_page(term_render *tr, int pages);
+
 /* Write raw key bytes to the child (already encoded by the caller). */
 bool           term_render_write(term_render *tr, const void *bytes, size_t len);
 
 /* --- cell-record packing helpers (shared with the GLSL decode) --- */
-/* r channel: atlas x (12 bits) | atlas y (12 bits) | flags(8): bit0 = has-glyph,
- * bit1 = color glyph (sample the RGBA color atlas, don't tint coverage). */
+/* r channel: atlas x (12 bits) | atlas y (12 bits) | low 8: bit0 = has-glyph,
+ * bit1 = color glyph (sample the RGBA color atlas, don't tint coverage),
+ * bits 2-6 = atlas page (texture array layer), bit7 = the texels are a
+ * distance field (GLYPH_ATLAS_SDF_SPREAD), not coverage. */
 #define TERM_PACK_R(ax, ay, has) \
     (((uint32_t)((ax) & 0xFFFu) << 20) | ((uint32_t)((ay) & 0xFFFu) << 8) | ((has) ? 1u : 0u))
 #define TERM_FLAG_COLOR 2u
+#define TERM_FLAG_SDF   128u
+#define TERM_PACK_PAGE(p) ((uint32_t)((p) & 0x1Fu) << 2)
 /* g channel: w (8) | h (8) | off_x+128 (8) | off_y+128 (8) */
 #define TERM_PACK_G(w, h, ox, oy) \
     (((uint32_t)((w) & 0xFFu) << 24) | ((uint32_t)((h) & 0xFFu) << 16) | \
@@ -26,6 +26,12 @@
 
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 /* The UTF-8 decoder lives in the parser struct (p->utf8) and is only consulted
  * in ground state; escape sequences are pure ASCII/C0/C1 bytes. */
 
@@ -192,9 +198,46 @@ void vtparse_reset(vtparser *p) {
 
 static void feed_byte(vtparser *p, uint8_t b);
 
+/* Length of the run of printable ASCII (0x20..0x7E) at the start of s, 16
+ * bytes per step where the target has vectors. As signed bytes that range is
+ * exactly (0x1F, 0x7F): C0 controls fall below it, DEL is its upper bound and
+ * every byte >= 0x80 (UTF-8, C1) is negative. */
+static size_t ascii_run(const uint8_t *s, size_t len) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i lo = _mm_set1_epi8(0x1F), hi = _mm_set1_epi8(0x7F);
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i ok = _mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmplt_epi8(v, hi));
+        unsigned mask = (unsigned)_mm_movemask_epi8(ok);
+        if (mask != 0xFFFFu) return i + (size_t)__builtin_ctz(~mask);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const int8x16_t lo = vdupq_n_s8(0x1F), hi = vdupq_n_s8(0x7F);
+    for (; i + 16 <= len; i += 16) {
+        int8x16_t v = vld1q_s8((const int8_t *)(s + i));
+        uint8x16_t ok = vandq_u8(vcgtq_s8(v, lo), vcltq_s8(v, hi));
+        if (vminvq_u8(ok) != 0xFF) break;   /* the scalar tail finds the byte */
+    }
+#endif
+    while (i < len && s[i] >= 0x20 && s[i] < 0x7F) i++;
+    return i;
+}
+
 void vtparse_feed(vtparser *p, const uint8_t *bytes, size_t len) {
-    for (size_t i = 0; i < len; i++) {
-        feed_byte(p, bytes[i]);
+    size_t i = 0;
+    while (i < len) {
+        /* Mid-UTF-8 an ASCII byte is an error the decoder has to see, so
+         * runs are only taken between codepoints. */
+        uint8_t b = bytes[i];
+        if (b >= 0x20 && b < 0x7F && p->state == VT_GROUND && p->utf8.need == 0 &&
+            p->cb.print_run) {
+            size_t n = 1 + ascii_run(bytes + i + 1, len - i - 1);
+            p->cb.print_run(p->user, bytes + i, n);
+            i += n;
+            continue;
+        }
+        feed_byte(p, bytes[i++]);
     }
 }
 
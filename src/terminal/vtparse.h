@@ -15,7 +15,10 @@
  *
  * The parser is fed one byte at a time (bytes, not codepoints — escape
  * sequences are pure ASCII/C0/C1; UTF-8 only appears in the "print" ground
- * state and is decoded there). It is fully resumable across feeds.
+ * state and is decoded there). It is fully resumable across feeds. The one
+ * exception is bulk text: in ground state a run of printable ASCII is found
+ * with a vector scan and handed over whole (print_run), since it can contain
+ * no control and needs no decoding.
  */
 #ifndef NEOWALL_TERMINAL_VTPARSE_H
 #define NEOWALL_TERMINAL_VTPARSE_H
@@ -58,6 +61,11 @@ typedef struct vt_callbacks {
     /* A printable Unicode codepoint reached the ground state. */
     void (*print)(void *u, uint32_t cp);
 
+    /* A run of `n` >= 1 printable ASCII bytes (0x20..0x7E) in the ground
+     * state, equivalent to print() for each byte in order. Optional: when
+     * NULL every byte goes through print(). */
+    void (*print_run)(void *u, const uint8_t *s, size_t n);
+
     /* A C0/C1 execute control (BEL, BS, HT, LF, CR, ...). `ctrl` is the byte. */
     void (*execute)(void *u, uint8_t ctrl);
 
@@ -30,9 +30,12 @@ static const char *fade_fragment_shader_source =
     "in vec2 v_texcoord;\n"
     "out vec4 fragColor;\n"
     "uniform sampler2D texture0;\n"
+    "uniform vec4 image_rect0;\n"
+    "uniform float image_tile0;\n"
     "uniform float alpha;\n"
+    TRANSITION_PLACE_IMAGE_GLSL
     "void main() {\n"
-    "    vec4 color = texture(texture0, v_texcoord);\n"
+    "    vec4 color = place_image(texture0, image_rect0, image_tile0, v_texcoord);\n"
     "    fragColor = vec4(color.rgb, color.a * alpha);\n"
     "}\n";
 
@@ -67,13 +70,15 @@ bool transition_fade_render(struct output_state *output, float progress) {
     }
 
     /* Draw old image at full opacity */
-    if (!transition_draw_textured_quad(&ctx, output->next_texture, 1.0f, NULL)) {
+    if (!transition_draw_textured_quad(&ctx, output->next_texture, &ctx.old_layout, 1.0f,
+                                       NULL)) {
         transition_end(&ctx);
         return false;
     }
 
     /* Draw new image with alpha based on progress (crossfade effect) */
-    if (!transition_draw_textured_quad(&ctx, output->texture, progress, NULL)) {
+    if (!transition_draw_textured_quad(&ctx, output->texture, &ctx.new_layout, progress,
+                                       NULL)) {
         transition_end(&ctx);
         return false;
     }
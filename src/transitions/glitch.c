@@ -39,6 +39,7 @@ static const char *glitch_fragment_shader_source =
     "    return fract(sin(dot(co.xy, vec2(12.9898, 78.233))) * 43758.5453);\n"
     "}\n"
     "\n"
+    TRANSITION_PLACE_IMAGE_PAIR_GLSL
     "void main() {\n"
     "    vec2 uv = v_texcoord;\n"
     "    float glitch_strength = progress * (1.0 - progress) * 4.0;\n"
@@ -51,13 +52,13 @@ static const char *glitch_fragment_shader_source =
     "    \n"
     "    // RGB channel separation\n"
     "    float separation = glitch_strength * 0.02;\n"
-    "    vec4 old_img = texture(texture0, uv);\n"
-    "    vec4 new_img = texture(texture1, uv);\n"
+    "    vec4 old_img = sample_old(uv);\n"
+    "    vec4 new_img = sample_new(uv);\n"
     "    \n"
     "    // Chromatic aberration on new image\n"
-    "    float r = texture(texture1, uv + vec2(separation, 0.0)).r;\n"
-    "    float g = texture(texture1, uv).g;\n"
-    "    float b = texture(texture1, uv - vec2(separation, 0.0)).b;\n"
+    "    float r = sample_new(uv + vec2(separation, 0.0)).r;\n"
+    "    float g = sample_new(uv).g;\n"
+    "    float b = sample_new(uv - vec2(separation, 0.0)).b;\n"
     "    new_img = vec4(r, g, b, new_img.a);\n"
     "    \n"
     "    // Scan lines\n"
@@ -70,7 +71,7 @@ static const char *glitch_fragment_shader_source =
     "    vec2 block_uv = vec2(uv.x + block_shift, uv.y);\n"
     "    \n"
     "    if (block_glitch > 0.5) {\n"
-    "        new_img = texture(texture1, block_uv);\n"
+    "        new_img = sample_new(block_uv);\n"
     "    }\n"
     "    \n"
     "    // Mix old and new based on progress\n"
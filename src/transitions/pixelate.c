@@ -34,6 +34,7 @@ static const char *pixelate_fragment_shader_source =
     "uniform float progress;\n"
     "uniform vec2 resolution;\n"
     "\n"
+    TRANSITION_PLACE_IMAGE_PAIR_GLSL
     "void main() {\n"
     "    vec2 uv = v_texcoord;\n"
     "    \n"
@@ -55,15 +56,15 @@ static const char *pixelate_fragment_shader_source =
     "    vec2 sample_uv = mix(uv, block_center, intensity);\n"
     "    \n"
     "    // Sample textures\n"
-    "    vec4 old_color = texture(texture0, sample_uv);\n"
-    "    vec4 new_color = texture(texture1, sample_uv);\n"
+    "    vec4 old_color = sample_old(sample_uv);\n"
+    "    vec4 new_color = sample_new(sample_uv);\n"
     "    \n"
     "    // Chromatic aberration\n"
     "    float aberration = intensity * pixel_size.x * 1.5;\n"
-    "    old_color.r = texture(texture0, sample_uv + vec2(aberration, 0.0)).r;\n"
-    "    old_color.b = texture(texture0, sample_uv - vec2(aberration, 0.0)).b;\n"
-    "    new_color.r = texture(texture1, sample_uv + vec2(aberration, 0.0)).r;\n"
-    "    new_color.b = texture(texture1, sample_uv - vec2(aberration, 0.0)).b;\n"
+    "    old_color.r = sample_old(sample_uv + vec2(aberration, 0.0)).r;\n"
+    "    old_color.b = sample_old(sample_uv - vec2(aberration, 0.0)).b;\n"
+    "    new_color.r = sample_new(sample_uv + vec2(aberration, 0.0)).r;\n"
+    "    new_color.b = sample_new(sample_uv - vec2(aberration, 0.0)).b;\n"
     "    \n"
     "    // Mix images\n"
     "    vec4 color = mix(old_color, new_color, eased);\n"
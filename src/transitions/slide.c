@@ -29,9 +29,12 @@ static const char *slide_fragment_shader_source =
     "in vec2 v_texcoord;\n"
     "out vec4 fragColor;\n"
     "uniform sampler2D texture0;\n"
+    "uniform vec4 image_rect0;\n"
+    "uniform float image_tile0;\n"
     "uniform float alpha;\n"
+    TRANSITION_PLACE_IMAGE_GLSL
     "void main() {\n"
-    "    vec4 color = texture(texture0, v_texcoord);\n"
+    "    vec4 color = place_image(texture0, image_rect0, image_tile0, v_texcoord);\n"
     "    fragColor = vec4(color.rgb, color.a * alpha);\n"
     "}\n";
 
@@ -70,7 +73,8 @@ static bool render_slide_transition(struct output_state *output, float progress,
     }
 
     /* Draw old image */
-    if (!transition_draw_textured_quad(&ctx, output->next_texture, 1.0f, old_vertices)) {
+    if (!transition_draw_textured_quad(&ctx, output->next_texture, &ctx.old_layout, 1.0f,
+                                       old_vertices)) {
         transition_end(&ctx);
         return false;
     }
@@ -86,7 +90,8 @@ static bool render_slide_transition(struct output_state *output, float progress,
     }
 
     /* Draw new image */
-    if (!transition_draw_textured_quad(&ctx, output->texture, 1.0f, new_vertices)) {
+    if (!transition_draw_textured_quad(&ctx, output->texture, &ctx.new_layout, 1.0f,
+                                       new_vertices)) {
         transition_end(&ctx);
         return false;
     }
@@ -10,11 +10,13 @@
  */
 
 #include <stddef.h>
+#include <stdio.h>
 #include <string.h>
 #include <GL/gl.h>
 #include "neowall/neowall.h"
 #include "neowall/constants.h"
 #include "neowall/transitions.h"
+#include "neowall/render/render.h"
 
 /**
  * Transition Registry
@@ -94,8 +96,34 @@ static void setup_fullscreen_quad(float vertices[16]) {
 static void bind_texture(GLuint texture, GLenum texture_unit) {
     glActiveTexture(texture_unit);
     glBindTexture(GL_TEXTURE_2D, texture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+/* ============================================================================
+ * Image Placement
+ * ============================================================================ */
+
+void transition_apply_image_layout(GLuint program, int unit, const struct image_layout *layout) {
+    struct image_layout full = {0.0f, 0.0f, 1.0f, 1.0f, false};
+    if (!layout) {
+        layout = &full;
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "image_rect%d", unit);
+    GLint rect_loc = glGetUniformLocation(program, name);
+    if (rect_loc >= 0) {
+        glUniform4f(rect_loc, layout->x, layout->y, layout->w, layout->h);
+    }
+    snprintf(name, sizeof(name), "image_tile%d", unit);
+    GLint tile_loc = glGetUniformLocation(program, name);
+    if (tile_loc >= 0) {
+        glUniform1f(tile_loc, layout->tile ? 1.0f : 0.0f);
+    }
+
+    /* Applies to the texture bound on the active unit; callers bind first. */
+    GLint wrap = layout->tile ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
 }
 
 /* ============================================================================
@@ -134,6 +162,12 @@ bool transition_begin(transition_context_t *ctx, struct output_state *output, GL
 
     setup_fullscreen_quad(ctx->vertices);
 
+    /* Each image keeps its own placement through the transition, so a FIT
+     * wallpaper can cross-fade into a TILE one without either being baked
+     * out to display size. */
+    render_image_layout(output, output->next_image, &ctx->old_layout);
+    render_image_layout(output, output->current_image, &ctx->new_layout);
+
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     output->gl_state.blend_enabled = true;
@@ -143,6 +177,7 @@ bool transition_begin(transition_context_t *ctx, struct output_state *output, GL
 }
 
 bool transition_draw_textured_quad(transition_context_t *ctx, GLuint texture,
+                                    const struct image_layout *layout,
                                     float alpha, const float *custom_vertices) {
     if (!ctx || !ctx->output || ctx->error_occurred) {
         return false;
@@ -170,6 +205,7 @@ bool transition_draw_textured_quad(transition_context_t *ctx, GLuint texture,
         if (tex_uniform >= 0) {
             glUniform1i(tex_uniform, 0);
         }
+        transition_apply_image_layout(ctx->program, 0, layout);
     }
 
     GLint alpha_uniform = glGetUniformLocation(ctx->program, "alpha");
@@ -210,14 +246,16 @@ bool transition_draw_blended_textures(transition_context_t *ctx,
         glEnableVertexAttribArray(ctx->tex_attrib);
     }
 
-    /* Bind textures */
+    /* Bind textures: texture0 is the outgoing image, texture1 the incoming */
     bind_texture(texture0, GL_TEXTURE0);
     GLint tex0_loc = glGetUniformLocation(ctx->program, "texture0");
     if (tex0_loc >= 0) glUniform1i(tex0_loc, 0);
+    transition_apply_image_layout(ctx->program, 0, &ctx->old_layout);
 
     bind_texture(texture1, GL_TEXTURE1);
     GLint tex1_loc = glGetUniformLocation(ctx->program, "texture1");
     if (tex1_loc >= 0) glUniform1i(tex1_loc, 1);
+    transition_apply_image_layout(ctx->program, 1, &ctx->new_layout);
 
     /* Set uniforms */
     GLint prog_loc = glGetUniformLocation(ctx->program, "progress");
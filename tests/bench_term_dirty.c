@@ -0,0 +1,200 @@
+/*
+ * bench_term_dirty.c — what per-row dirty tracking saves on the snapshot path.
+ *
+ * Replays PTY output through a headless term_screen and, after every read-
+ * sized chunk (the reader thread feeds up to 8 KiB at a time and the GL thread
+ * may snapshot between any two), does the per-frame work two ways:
+ *   full  — copy every row and pack every cell's colours, as term_snapshot()
+ *           and term_render_update() did before rows were tracked;
+ *   dirty — copy and pack only the rows term_screen_take_dirty() reports,
+ *           rotating the kept rows like term_snapshot() when the whole grid
+ *           scrolled.
+ * Packing stands in for term_render's resolve (palette + attrs, no glyph
+ * lookups, which need a font), so the dirty column is a lower bound on the
+ * real saving.
+ *
+ * Input is a recording of raw PTY output, e.g. from
+ *     script -q -c htop /tmp/htop.raw      (quit after a few seconds)
+ * given as the first argument, played at the size given by the optional
+ * second and third (default 400x100). Without arguments a built-in trace is
+ * used: an htop-shaped phase (one full paint, then frames that redraw the
+ * clock, two meters and a process line) followed by a `tail -f` phase that
+ * scrolls a few log lines per frame.
+ *
+ * Run with `meson test --benchmark term_dirty_rows -v`.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "neowall/terminal/terminal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHUNK 8192 /* matches the reader thread's read() size */
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    uint8_t *data;
+    size_t   len, cap;
+    size_t  *frame_end;  /* chunk boundaries */
+    size_t   nframes, frame_cap;
+} trace;
+
+static void append(trace *t, const char *s, size_t n) {
+    if (t->len + n > t->cap) {
+        t->cap = (t->len + n) * 2;
+        t->data = realloc(t->data, t->cap);
+        if (!t->data) { perror("realloc"); exit(1); }
+    }
+    memcpy(t->data + t->len, s, n);
+    t->len += n;
+}
+
+static void end_frame(trace *t) {
+    if (t->nframes == t->frame_cap) {
+        t->frame_cap = t->frame_cap ? t->frame_cap * 2 : 256;
+        t->frame_end = realloc(t->frame_end, t->frame_cap * sizeof(size_t));
+        if (!t->frame_end) { perror("realloc"); exit(1); }
+    }
+    t->frame_end[t->nframes++] = t->len;
+}
+
+static void appendf(trace *t, const char *fmt, int a, int b) {
+    char buf[64];
+    int n = snprintf(buf, sizeof(buf), fmt, a, b);
+    append(t, buf, (size_t)n);
+}
+
+/* A top-like screen: header meters, a clock, a coloured process table. */
+static void build_synthetic(trace *t, int cols, int rows) {
+    append(t, "\x1b[?1049h\x1b[H\x1b[2J", 15);
+    for (int y = 0; y < rows; y++) {
+        appendf(t, "\x1b[%d;1H\x1b[38;5;%dm", y + 1, 16 + y % 200);
+        for (int x = 0; x < cols; x++) append(t, &"abcdefghij0123456789 "[(x + y) % 21], 1);
+        if (t->len - (t->nframes ? t->frame_end[t->nframes - 1] : 0) > CHUNK) end_frame(t);
+    }
+    end_frame(t);
+    for (int f = 0; f < 2000; f++) {
+        appendf(t, "\x1b[1;%dH\x1b[1;37m%02d", cols - 8, f % 60);
+        appendf(t, "\x1b[2;1H\x1b[32m[%*d|||]", 1 + f % 40, f % 10);
+        appendf(t, "\x1b[3;1H\x1b[31m[%*d||]", 1 + (f * 7) % 40, f % 10);
+        appendf(t, "\x1b[%d;1H\x1b[0m%6d root  20   0  S  ", 6 + f % (rows - 6), f);
+        appendf(t, "\x1b[%d;%dH", rows, 1);
+        end_frame(t);
+    }
+    append(t, "\x1b[?1049l\x1b[0m", 11);
+    appendf(t, "\x1b[%d;%dH", rows, 1);
+    for (int f = 0; f < 2000; f++) {
+        for (int l = 0; l < 3; l++) {
+            appendf(t, "\r\n\x1b[2m%06d \x1b[0m%d INFO request served in ", f * 3 + l, f);
+            appendf(t, "%d.%dms", f % 97, l);
+        }
+        end_frame(t);
+    }
+}
+
+static void load_recording(trace *t, const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) { perror(path); exit(1); }
+    char buf[CHUNK];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        append(t, buf, n);
+        end_frame(t);
+    }
+    fclose(fp);
+}
+
+/* Colour pack of one cell, roughly what term_render's resolve costs minus the
+ * glyph lookup. */
+static uint32_t pack(const term_cell *c) {
+    uint32_t fg = c->fg.kind == TERM_COLOR_RGB ? ((uint32_t)c->fg.r << 16 | c->fg.g << 8 | c->fg.b)
+                                               : c->fg.idx * 0x010101u;
+    uint32_t bg = c->bg.kind == TERM_COLOR_RGB ? ((uint32_t)c->bg.r << 16 | c->bg.g << 8 | c->bg.b)
+                                               : c->bg.idx * 0x010101u;
+    return (fg ^ (bg << 8) ^ c->cp) + c->attr;
+}
+
+static double run(const trace *t, int cols, int rows, bool dirty_only, double *rows_per_frame,
+                  uint64_t *checksum) {
+    term_screen *s = term_screen_create(cols, rows);
+    term_cell *snap = calloc((size_t)cols * rows, sizeof(term_cell));
+    uint32_t *packed = calloc((size_t)cols * rows, sizeof(uint32_t));
+    if (!s || !snap || !packed) { perror("alloc"); exit(1); }
+
+    size_t copied = 0, start = 0;
+    uint64_t sum = 0;
+    int base = 0;   /* ring slot of row 0 in snap/packed (dirty path only) */
+    double t0 = now_sec(), in_feed = 0.0;
+    for (size_t f = 0; f < t->nframes; f++) {
+        double f0 = now_sec();
+        term_screen_feed(s, t->data + start, t->frame_end[f] - start);
+        in_feed += now_sec() - f0;
+        start = t->frame_end[f];
+
+        uint64_t d[TERM_SCREEN_DIRTY_WORDS];
+        int scrolled = 0;
+        term_screen_take_dirty(s, d, &scrolled);
+        if (dirty_only) base = ((base + scrolled) % rows + rows) % rows;
+        for (int y = 0; y < rows; y++) {
+            if (dirty_only && !((d[y >> 6] >> (y & 63)) & 1)) continue;
+            size_t slot = (size_t)((base + y) % rows) * cols;
+            term_cell *dst = &snap[slot];
+            memcpy(dst, term_screen_row(s, y), (size_t)cols * sizeof(term_cell));
+            for (int x = 0; x < cols; x++) packed[slot + x] = pack(&dst[x]);
+            copied++;
+        }
+    }
+    double elapsed = now_sec() - t0 - in_feed;
+    for (int y = 0; y < rows; y++) {
+        const uint32_t *row = &packed[(size_t)((base + y) % rows) * cols];
+        for (int x = 0; x < cols; x++) sum = sum * 31 + row[x];
+    }
+
+    *rows_per_frame = (double)copied / (double)t->nframes;
+    *checksum = sum;
+    free(packed);
+    free(snap);
+    term_screen_destroy(s);
+    return elapsed / (double)t->nframes;
+}
+
+int main(int argc, char **argv) {
+    int cols = argc > 2 ? atoi(argv[2]) : 400;
+    int rows = argc > 3 ? atoi(argv[3]) : 100;
+    if (cols > TERM_SCREEN_MAX_COLS) cols = TERM_SCREEN_MAX_COLS;
+    if (rows > TERM_SCREEN_MAX_ROWS) rows = TERM_SCREEN_MAX_ROWS;
+    if (cols < 10 || rows < 10) { fprintf(stderr, "grid too small\n"); return 1; }
+
+    trace t = {0};
+    if (argc > 1) load_recording(&t, argv[1]);
+    else          build_synthetic(&t, cols, rows);
+    if (t.nframes == 0) { fprintf(stderr, "empty trace\n"); return 1; }
+
+    double full_rows, dirty_rows;
+    uint64_t full_sum, dirty_sum;
+    double full = run(&t, cols, rows, false, &full_rows, &full_sum);
+    double dirty = run(&t, cols, rows, true, &dirty_rows, &dirty_sum);
+
+    printf("term_dirty: %s, %dx%d, %zu frames, %zu bytes\n",
+           argc > 1 ? argv[1] : "synthetic htop + tail -f trace", cols, rows, t.nframes, t.len);
+    printf("  full : %8.2f us/frame  %6.1f rows copied+packed/frame\n", full * 1e6, full_rows);
+    printf("  dirty: %8.2f us/frame  %6.1f rows copied+packed/frame  (%.1fx)\n",
+           dirty * 1e6, dirty_rows, dirty > 0.0 ? full / dirty : 0.0);
+
+    free(t.data);
+    free(t.frame_end);
+    /* Both paths must end with the same grid, or rows were missed. */
+    if (full_sum != dirty_sum) {
+        fprintf(stderr, "term_dirty: dirty-row snapshot diverged from the full copy\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,280 @@
+/*
+ * bench_term_throughput.c — how fast the terminal wallpaper eats PTY output.
+ *
+ * Every stream is measured twice:
+ *   screen — vtparse + term_screen alone, fed in the reader thread's 8 KiB
+ *            chunks with the dirty set taken after each, in MB/s. This is the
+ *            parser/model ceiling and is deterministic.
+ *   pty    — the whole CPU path: `cat` writes the stream into a real PTY, the
+ *            reader thread parses it, and this thread calls
+ *            term_render_update() at 60 Hz the way the GL thread does, minus
+ *            the texture upload. Reports MB/s until the child exits, frames
+ *            that had something to upload, and the mean and worst time spent
+ *            in term_render_update() per frame (snapshot + resolve + diff).
+ *
+ * Built-in streams: bulk ASCII (a `find /` listing), heavy SGR colour (a
+ * 256-colour or truecolour change every word), UTF-8 CJK, emoji, an htop-like
+ * cursor-addressed redraw (plain and in synchronized-output brackets) and a
+ * vim-like scroll-region redraw. Recordings of
+ * real programs, e.g. from
+ *     script -q -c 'htop' /tmp/htop.raw      (quit after a few seconds)
+ * can be given as arguments and are measured the same way.
+ *
+ * The pty column needs a monospace font; without one only the screen column
+ * is printed. Run with `meson test --benchmark term_throughput -v`.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "neowall/terminal/terminal.h"
+#include "term_render.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CHUNK       8192           /* the reader thread's read() size */
+#define COLS        200
+#define ROWS        60
+#define STREAM_SIZE (4u << 20)
+#define FRAME_SEC   (1.0 / 60.0)
+#define TIMEOUT_SEC 60.0
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void sleep_sec(double s) {
+    if (s <= 0.0) return;
+    struct timespec ts = {.tv_sec = (time_t)s, .tv_nsec = (long)((s - (double)(time_t)s) * 1e9)};
+    nanosleep(&ts, NULL);
+}
+
+typedef struct {
+    char  *data;
+    size_t len, cap;
+} buf;
+
+static void append(buf *b, const char *s, size_t n) {
+    if (b->len + n > b->cap) {
+        b->cap = (b->len + n) * 2;
+        b->data = realloc(b->data, b->cap);
+        if (!b->data) { perror("realloc"); exit(1); }
+    }
+    memcpy(b->data + b->len, s, n);
+    b->len += n;
+}
+
+static void appendf(buf *b, const char *fmt, unsigned a, unsigned c) {
+    char tmp[256];
+    int n = snprintf(tmp, sizeof(tmp), fmt, a, c);
+    append(b, tmp, (size_t)n);
+}
+
+static void gen_ascii(buf *b) {
+    for (unsigned i = 0; b->len < STREAM_SIZE; i++)
+        appendf(b, "/usr/share/doc/package-%u/examples/file%u.txt\n", i % 900, i);
+}
+
+static void gen_sgr(buf *b) {
+    static const char *words[] = {"error", "warning", "note", "built", "linking", "target"};
+    for (unsigned i = 0; b->len < STREAM_SIZE; i++) {
+        for (unsigned w = 0; w < 12; w++) {
+            unsigned k = i * 12 + w;
+            if (k % 3) appendf(b, "\x1b[38;5;%u;48;5;%um", 16 + k % 216, 232 + k % 24);
+            else       appendf(b, "\x1b[1;38;2;%u;%u;200m", k % 256, (k * 7) % 256);
+            append(b, words[k % 6], strlen(words[k % 6]));
+            append(b, "\x1b[0m ", 5);
+        }
+        append(b, "\n", 1);
+    }
+}
+
+static void gen_cjk(buf *b) {
+    /* 终端渲染测试 / 中文日志行 and a Hangul word: all two cells wide */
+    static const char line[] =
+        "\xe7\xbb\x88\xe7\xab\xaf\xe6\xb8\xb2\xe6\x9f\x93\xe6\xb5\x8b\xe8\xaf\x95 "
+        "\xe4\xb8\xad\xe6\x96\x87\xe6\x97\xa5\xe5\xbf\x97\xe8\xa1\x8c "
+        "\xed\x95\x9c\xea\xb5\xad\xec\x96\xb4 ";
+    for (unsigned i = 0; b->len < STREAM_SIZE; i++) {
+        for (int r = 0; r < 4; r++) append(b, line, sizeof(line) - 1);
+        appendf(b, "%u %u\n", i, i * 3);
+    }
+}
+
+static void gen_emoji(buf *b) {
+    static const char *emoji[] = {"\xf0\x9f\x98\x80", "\xf0\x9f\x9a\x80", "\xf0\x9f\x94\xa5",
+                                  "\xf0\x9f\x8e\x89", "\xe2\x9c\x85", "\xf0\x9f\x90\x9b"};
+    for (unsigned i = 0; b->len < STREAM_SIZE; i++) {
+        appendf(b, "[%u] deploy %u ", i, i % 17);
+        for (unsigned e = 0; e < 10; e++) append(b, emoji[(i + e) % 6], strlen(emoji[(i + e) % 6]));
+        append(b, "\n", 1);
+    }
+}
+
+/* htop: a full paint, then frames that redraw the clock, the meters and a few
+ * process lines by absolute position; with `sync` each frame is bracketed in
+ * synchronized output (DECSET 2026) the way tmux and recent TUIs send it. */
+static void tui_frames(buf *b, bool sync) {
+    append(b, "\x1b[?1049h\x1b[H\x1b[2J", 15);
+    for (unsigned f = 0; b->len < STREAM_SIZE; f++) {
+        if (sync) append(b, "\x1b[?2026h", 8);
+        appendf(b, "\x1b[1;%uH\x1b[1;37m%02u", COLS - 8, f % 60);
+        for (unsigned m = 0; m < 4; m++) {
+            appendf(b, "\x1b[%u;1H\x1b[0m%3u[\x1b[32m", m + 2, m);
+            for (unsigned k = 0; k < 1 + (f * (m + 3)) % 60; k++) append(b, "|", 1);
+            append(b, "\x1b[0m]", 5);
+        }
+        for (unsigned p = 0; p < 6; p++) {
+            unsigned y = 8 + (f * 7 + p * 11) % (ROWS - 9);
+            appendf(b, "\x1b[%u;1H\x1b[%um", y, p % 2 ? 7 : 0);
+            appendf(b, "%7u root      20   0  %6uK  S  ", f * 31 + p, (f * 13 + p) % 999999);
+            appendf(b, "%2u.%u  /usr/bin/some-daemon --flag\x1b[K", f % 100, p);
+        }
+        if (sync) append(b, "\x1b[?2026l", 8);
+    }
+    append(b, "\x1b[?1049l", 8);
+}
+
+static void gen_htop(buf *b)      { tui_frames(b, false); }
+static void gen_htop_sync(buf *b) { tui_frames(b, true); }
+
+/* vim: scroll a region with the cursor at its bottom, repaint the new line
+ * with syntax colours, redraw the status line and put the cursor back. */
+static void gen_vim(buf *b) {
+    appendf(b, "\x1b[?1049h\x1b[H\x1b[2J\x1b[1;%ur", ROWS - 2, 0);
+    for (unsigned f = 0; b->len < STREAM_SIZE; f++) {
+        appendf(b, "\x1b[%u;1H\n", ROWS - 2, 0);
+        appendf(b, "\x1b[33m%5u \x1b[0m\x1b[35mstatic\x1b[0m \x1b[32mint\x1b[0m fn_%u(", f, f);
+        append(b, "\x1b[32mvoid\x1b[0m) { \x1b[35mreturn\x1b[0m ", 36);
+        appendf(b, "\x1b[31m%u\x1b[0m; }\x1b[K", f * 7, 0);
+        appendf(b, "\x1b[%u;1H\x1b[7m src/terminal/screen.c  line %u", ROWS - 1, f);
+        appendf(b, "\x1b[K\x1b[0m\x1b[%u;%uH", ROWS - 2, 10 + f % 40);
+    }
+    append(b, "\x1b[r\x1b[?1049l", 11);
+}
+
+static double screen_mbps(const buf *b) {
+    term_screen *s = term_screen_create(COLS, ROWS);
+    if (!s) { perror("term_screen_create"); exit(1); }
+    uint64_t dirty[TERM_SCREEN_DIRTY_WORDS];
+    int scrolled;
+    double t0 = now_sec();
+    for (size_t o = 0; o < b->len; o += CHUNK) {
+        term_screen_feed(s, (const uint8_t *)b->data + o, b->len - o < CHUNK ? b->len - o : CHUNK);
+        term_screen_take_dirty(s, dirty, &scrolled);
+    }
+    double dt = now_sec() - t0;
+    term_screen_destroy(s);
+    return (double)b->len / 1e6 / dt;
+}
+
+typedef struct {
+    double   mbps;
+    unsigned frames, uploads;
+    double   mean_us, max_us;
+    bool     timed_out;
+} pty_result;
+
+/* Play the stream through `cat` in a PTY and drive term_render at 60 Hz
+ * until the child exits. False if term_render could not start. */
+static bool pty_run(const buf *b, pty_result *res) {
+    const char *dir = getenv("TMPDIR");
+    char path[512];
+    snprintf(path, sizeof(path), "%s/nw-bench-XXXXXX", dir && *dir ? dir : "/tmp");
+    int fd = mkstemp(path);
+    if (fd < 0) { perror("mkstemp"); exit(1); }
+    if (write(fd, b->data, b->len) != (ssize_t)b->len) { perror("write"); exit(1); }
+    close(fd);
+
+    char cmd[600];
+    snprintf(cmd, sizeof(cmd), "exec cat '%s'", path);
+    term_render_opts o = {.cmd = cmd, .cols = COLS, .rows = ROWS, .cell_w = 9, .cell_h = 18,
+                          .default_fg = -1, .default_bg = -1};
+    term_render *tr = term_render_create(&o, NULL);
+    if (!tr) {
+        unlink(path);
+        return false;
+    }
+
+    memset(res, 0, sizeof(*res));
+    double t0 = now_sec(), next = t0, spent = 0.0, end;
+    for (;;) {
+        double f0 = now_sec();
+        bool up = term_render_update(tr);
+        double dt = now_sec() - f0;
+        res->frames++;
+        res->uploads += up;
+        spent += dt;
+        if (dt > res->max_us) res->max_us = dt;
+
+        /* Sleep to the next frame, noticing the exit within a millisecond. */
+        next += FRAME_SEC;
+        while ((end = now_sec()) < next && !term_render_child_exited(tr)) sleep_sec(0.001);
+        if (term_render_child_exited(tr)) break;
+        if (end - t0 > TIMEOUT_SEC) { res->timed_out = true; break; }
+    }
+    res->mbps = (double)b->len / 1e6 / (end - t0);
+    res->mean_us = spent / res->frames * 1e6;
+    res->max_us *= 1e6;
+    term_render_destroy(tr);
+    unlink(path);
+    return true;
+}
+
+static void load(buf *b, const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) { perror(path); exit(1); }
+    char tmp[CHUNK];
+    size_t n;
+    while ((n = fread(tmp, 1, sizeof(tmp), fp)) > 0) append(b, tmp, n);
+    fclose(fp);
+}
+
+static void measure(const char *name, const buf *b, bool *have_render) {
+    double scr = screen_mbps(b);
+    printf("  %-20s %6.1f MB %8.1f MB/s", name, (double)b->len / 1e6, scr);
+    pty_result r;
+    if (*have_render && pty_run(b, &r)) {
+        printf(" %8.1f MB/s %6u/%-6u %8.1f %8.1f%s\n", r.mbps, r.uploads, r.frames, r.mean_us,
+               r.max_us, r.timed_out ? "  (timed out)" : "");
+    } else {
+        *have_render = false;
+        printf("\n");
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    static const struct {
+        const char *name;
+        void (*gen)(buf *);
+    } streams[] = {
+        {"bulk ASCII", gen_ascii}, {"SGR colour", gen_sgr}, {"UTF-8 CJK", gen_cjk},
+        {"emoji", gen_emoji},      {"htop redraw", gen_htop}, {"htop, 2026 sync", gen_htop_sync},
+        {"vim scroll region", gen_vim},
+    };
+    bool have_render = true;
+    printf("term_throughput: %dx%d, %d KiB reads, term_render_update at 60 Hz\n", COLS, ROWS,
+           CHUNK / 1024);
+    printf("  %-20s %9s %13s %13s %14s %8s %8s\n", "stream", "size", "screen", "pty",
+           "uploads/frames", "mean us", "max us");
+    for (size_t i = 0; i < sizeof(streams) / sizeof(streams[0]); i++) {
+        buf b = {0};
+        streams[i].gen(&b);
+        measure(streams[i].name, &b, &have_render);
+        free(b.data);
+    }
+    for (int i = 1; i < argc; i++) {
+        buf b = {0};
+        load(&b, argv[i]);
+        const char *base = strrchr(argv[i], '/');
+        measure(base ? base + 1 : argv[i], &b, &have_render);
+        free(b.data);
+    }
+    if (!have_render) printf("  (no monospace font: pty column skipped)\n");
+    return 0;
+}
@@ -0,0 +1,169 @@
+/*
+ * bench_vtparse.c — the printable-ASCII fast path against the per-byte path.
+ *
+ * Two measurements per input stream:
+ *   parser — vtparse_feed() into a minimal cell writer, once with only the
+ *            per-codepoint print callback (width check, wrap check and one
+ *            cell store per character, like put_glyph) and once with
+ *            print_run as well (one wrap decision per row, like
+ *            put_ascii_run). Both must leave the same cells.
+ *   screen — term_screen_feed() end to end, which always takes the fast path;
+ *            compare it across commits.
+ *
+ * Streams: `find /`-style paths, `yes` (two-byte lines), a coloured build log
+ * (an SGR sequence every few words) and CJK text, which never takes the fast
+ * path and shows what the scan costs when it finds nothing.
+ *
+ * Run with `meson test --benchmark vtparse_ascii -v`.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "neowall/terminal/terminal.h"
+#include "vtparse.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHUNK    8192   /* the reader thread's read() size */
+#define COLS     200
+#define ROWS     50
+#define MIN_SIZE (16u << 20)
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    char  *data;
+    size_t len, cap;
+} buf;
+
+static void append(buf *b, const char *s) {
+    size_t n = strlen(s);
+    if (b->len + n > b->cap) {
+        b->cap = (b->len + n) * 2;
+        b->data = realloc(b->data, b->cap);
+        if (!b->data) { perror("realloc"); exit(1); }
+    }
+    memcpy(b->data + b->len, s, n);
+    b->len += n;
+}
+
+static void build(buf *b, int kind) {
+    char line[256];
+    for (unsigned i = 0; b->len < MIN_SIZE; i++) {
+        switch (kind) {
+        case 0:
+            snprintf(line, sizeof(line), "/usr/share/doc/package-%u/examples/module_%u/file%u.txt\n",
+                     i % 900, i % 37, i);
+            break;
+        case 1:
+            snprintf(line, sizeof(line), "y\n");
+            break;
+        case 2:
+            snprintf(line, sizeof(line),
+                     "\x1b[1;32m[%3u%%]\x1b[0m Building C object src/\x1b[36mterminal\x1b[0m/"
+                     "screen.c.o \x1b[33mwarning:\x1b[0m line %u\r\n", i % 100, i);
+            break;
+        default:
+            snprintf(line, sizeof(line),
+                     "\xe7\xbb\x88\xe7\xab\xaf\xe6\xb8\xb2\xe6\x9f\x93\xe6\xb5\x8b\xe8\xaf\x95 %u "
+                     "\xe4\xb8\xad\xe6\x96\x87\xe6\x97\xa5\xe5\xbf\x97\xe8\xa1\x8c\r\n", i);
+            break;
+        }
+        append(b, line);
+    }
+}
+
+/* A stand-in for the screen's print path: one row of cells and a cursor. */
+typedef struct {
+    term_cell row[COLS];
+    int       x;
+    bool      pending_wrap;
+    uint64_t  lines;
+} sink;
+
+static void sink_print(void *u, uint32_t cp) {
+    sink *k = u;
+    int w = cp >= 0x1100 ? 2 : 1;     /* a width lookup per character */
+    if (k->pending_wrap) { k->x = 0; k->lines++; k->pending_wrap = false; }
+    if (w == 2 && k->x == COLS - 1) { k->x = 0; k->lines++; }
+    k->row[k->x] = (term_cell){.cp = cp};
+    k->x += w;
+    if (k->x >= COLS) { k->x = COLS - 1; k->pending_wrap = true; }
+}
+
+static void sink_run(void *u, const uint8_t *s, size_t n) {
+    sink *k = u;
+    while (n > 0) {
+        if (k->pending_wrap) { k->x = 0; k->lines++; k->pending_wrap = false; }
+        size_t room = (size_t)(COLS - k->x), m = n < room ? n : room;
+        for (size_t i = 0; i < m; i++) k->row[k->x + i] = (term_cell){.cp = s[i]};
+        k->x += (int)m;
+        if (k->x >= COLS) { k->x = COLS - 1; k->pending_wrap = true; }
+        s += m;
+        n -= m;
+    }
+}
+
+static void sink_execute(void *u, uint8_t c) {
+    sink *k = u;
+    if (c == '\n') k->lines++;
+    if (c == '\r' || c == '\n') { k->x = 0; k->pending_wrap = false; }
+}
+
+static double parse(const buf *b, bool runs, uint64_t *check) {
+    static sink k;
+    memset(&k, 0, sizeof(k));
+    vt_callbacks cb = {.print = sink_print, .execute = sink_execute};
+    if (runs) cb.print_run = sink_run;
+    vtparser p;
+    vtparse_init(&p, &cb, &k);
+    double t0 = now_sec();
+    for (size_t o = 0; o < b->len; o += CHUNK)
+        vtparse_feed(&p, (const uint8_t *)b->data + o, b->len - o < CHUNK ? b->len - o : CHUNK);
+    double dt = now_sec() - t0;
+    uint64_t sum = k.lines * 131 + (uint64_t)k.x;
+    for (int x = 0; x < COLS; x++) sum = sum * 31 + k.row[x].cp;
+    *check = sum;
+    return dt;
+}
+
+static double screen(const buf *b) {
+    term_screen *s = term_screen_create(COLS, ROWS);
+    if (!s) { perror("term_screen_create"); exit(1); }
+    double t0 = now_sec();
+    for (size_t o = 0; o < b->len; o += CHUNK)
+        term_screen_feed(s, (const uint8_t *)b->data + o, b->len - o < CHUNK ? b->len - o : CHUNK);
+    double dt = now_sec() - t0;
+    term_screen_destroy(s);
+    return dt;
+}
+
+int main(void) {
+    static const char *names[] = {"find /", "yes", "build log (SGR)", "CJK"};
+    int rc = 0;
+    printf("vtparse_ascii: %dx%d, %u KiB feeds\n", COLS, ROWS, CHUNK / 1024);
+    printf("  %-16s %10s %10s %8s %12s\n", "stream", "per-byte", "runs", "", "term_screen");
+    for (int kind = 0; kind < 4; kind++) {
+        buf b = {0};
+        build(&b, kind);
+        double mb = (double)b.len / 1e6;
+        uint64_t c0, c1;
+        double slow = parse(&b, false, &c0);
+        double fast = parse(&b, true, &c1);
+        double scr = screen(&b);
+        printf("  %-16s %7.0f MB/s %7.0f MB/s %6.1fx %9.0f MB/s\n", names[kind], mb / slow,
+               mb / fast, fast > 0.0 ? slow / fast : 0.0, mb / scr);
+        if (c0 != c1) {
+            fprintf(stderr, "vtparse_ascii: %s: print_run left different cells\n", names[kind]);
+            rc = 1;
+        }
+        free(b.data);
+    }
+    return rc;
+}
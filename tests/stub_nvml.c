@@ -0,0 +1,116 @@
+/* A stand-in for libnvidia-ml used by tests/test_reactive_nvml.c: the NVML
+ * entry points reactive_nvml.c loads, answering from values the test sets
+ * through nvml_stub_set / nvml_stub_fail. Built as a shared library so the
+ * real dlopen/dlsym path is exercised. */
+
+#include <stdbool.h>
+#include <string.h>
+
+typedef int nvmlReturn_t;
+typedef struct nvmlDevice_st *nvmlDevice_t;
+typedef struct {
+    unsigned int gpu, memory;
+} nvmlUtilization_t;
+typedef struct {
+    unsigned long long total, free, used;
+} nvmlMemory_t;
+
+#define NVML_SUCCESS 0
+#define NVML_ERROR_UNINITIALIZED 1
+#define NVML_ERROR_INVALID_ARGUMENT 2
+#define NVML_ERROR_NOT_SUPPORTED 3
+#define NVML_ERROR_DRIVER_NOT_LOADED 9
+#define NVML_ERROR_GPU_IS_LOST 15
+
+static struct {
+    unsigned util;
+    unsigned long long used, total;
+    unsigned temp;
+    unsigned power_mw, limit_mw; /* limit 0 = power not supported */
+    bool fail_init, lost;
+    int inits, calls;
+} g = {0, 0, 1, 0, 0, 0, false, false, 0, 0};
+
+static struct nvmlDevice_st {
+    int unused;
+} g_dev;
+
+void nvml_stub_set(unsigned util, unsigned long long used, unsigned long long total,
+                   unsigned temp, unsigned power_mw, unsigned limit_mw) {
+    g.util = util;
+    g.used = used;
+    g.total = total;
+    g.temp = temp;
+    g.power_mw = power_mw;
+    g.limit_mw = limit_mw;
+}
+
+/* fail_init: the driver is not loaded; lost: the GPU fell off the bus */
+void nvml_stub_fail(bool fail_init, bool lost) {
+    g.fail_init = fail_init;
+    g.lost = lost;
+}
+
+/* NVML sessions currently open, and device queries made so far */
+int nvml_stub_inits(void) { return g.inits; }
+int nvml_stub_calls(void) { return g.calls; }
+
+nvmlReturn_t nvmlInit_v2(void) {
+    if (g.fail_init) return NVML_ERROR_DRIVER_NOT_LOADED;
+    g.inits++;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlShutdown(void) {
+    if (g.inits == 0) return NVML_ERROR_UNINITIALIZED;
+    g.inits--;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetHandleByIndex_v2(unsigned int index, nvmlDevice_t *dev) {
+    if (g.inits == 0) return NVML_ERROR_UNINITIALIZED;
+    if (index != 0) return NVML_ERROR_INVALID_ARGUMENT;
+    *dev = &g_dev;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetUtilizationRates(nvmlDevice_t dev, nvmlUtilization_t *u) {
+    g.calls++;
+    if (dev != &g_dev) return NVML_ERROR_INVALID_ARGUMENT;
+    if (g.lost) return NVML_ERROR_GPU_IS_LOST;
+    u->gpu = g.util;
+    u->memory = 0;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetMemoryInfo(nvmlDevice_t dev, nvmlMemory_t *m) {
+    g.calls++;
+    if (dev != &g_dev) return NVML_ERROR_INVALID_ARGUMENT;
+    m->total = g.total;
+    m->used = g.used;
+    m->free = g.total - g.used;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetTemperature(nvmlDevice_t dev, int sensor, unsigned int *t) {
+    g.calls++;
+    if (dev != &g_dev || sensor != 0) return NVML_ERROR_INVALID_ARGUMENT;
+    *t = g.temp;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetPowerUsage(nvmlDevice_t dev, unsigned int *mw) {
+    g.calls++;
+    if (dev != &g_dev) return NVML_ERROR_INVALID_ARGUMENT;
+    if (g.limit_mw == 0) return NVML_ERROR_NOT_SUPPORTED;
+    *mw = g.power_mw;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t nvmlDeviceGetEnforcedPowerLimit(nvmlDevice_t dev, unsigned int *mw) {
+    g.calls++;
+    if (dev != &g_dev) return NVML_ERROR_INVALID_ARGUMENT;
+    if (g.limit_mw == 0) return NVML_ERROR_NOT_SUPPORTED;
+    *mw = g.limit_mw;
+    return NVML_SUCCESS;
+}
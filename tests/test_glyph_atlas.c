@@ -7,17 +7,42 @@
  * If no system font is found the test SKIPs (exit 77), so CI on a font-less
  * container doesn't spuriously fail. No GPU needed: this is the CPU-side
  * rasterizer only.
+ *
+ * The paging tests shrink the atlas to one or two pages of large synthesized
+ * glyphs, fill it, and check that the least recently used page is the one
+ * emptied, that glyphs in use this frame are never moved, that a glyph which
+ * found no room is retried rather than cached blank, and that evicted glyphs
+ * come back with the same pixels.
+ *
+ * The warm-start test destroys an atlas and builds another at the same size:
+ * every glyph must come back from the on-disk cache with the same metrics and
+ * pixels, without being rasterized. All atlases here write their cache under
+ * a temporary XDG_CACHE_HOME.
+ *
+ * The worker test rasterizes on a thread pool: lookups come back pending,
+ * collect places the finished glyphs, and each matches the glyph a
+ * synchronous atlas rasterizes itself. Destroying an atlas with work still
+ * queued must neither leak nor race (run it under the sanitizers).
+ *
+ * The SDF test compares distance-field glyphs with the coverage raster of
+ * the same glyph: same ink once thresholded at the outline, framed by the
+ * spread of padding, and cached apart from the coverage glyphs on disk.
  */
+#define _DEFAULT_SOURCE /* mkdtemp */
 #include "glyph_atlas.h"
 
+#include <dirent.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
 
 static int g_fails = 0;
 
 static long ink_of(glyph_atlas *a, uint32_t cp) {
     const glyph_slot *s = glyph_atlas_get(a, cp);
     if (!s->valid) return -1;
-    const uint8_t *bm = glyph_atlas_bitmap(a);
+    const uint8_t *bm = glyph_atlas_page(a, s->page);
     int W = glyph_atlas_width(a);
     long sum = 0;
     for (int y = 0; y < s->h; y++)
@@ -34,10 +59,281 @@ static void expect_ink(glyph_atlas *a, uint32_t cp, const char *name) {
     }
 }
 
+#define CHECK(cond, what)                                   \
+    do {                                                    \
+        if (!(cond)) { printf("  FAIL: %s\n", what); g_fails++; } \
+    } while (0)
+
+/* FNV-1a over a glyph's pixels, to compare a re-rasterized glyph with the
+ * original wherever it now sits. */
+static uint32_t pixels_of(const glyph_atlas *a, const glyph_slot *s) {
+    const uint8_t *bm = glyph_atlas_page(a, s->page);
+    int W = glyph_atlas_width(a);
+    uint32_t h = 2166136261u;
+    for (int y = 0; y < s->h; y++)
+        for (int x = 0; x < s->w; x++)
+            h = (h ^ bm[(size_t)(s->y + y) * W + (s->x + x)]) * 16777619u;
+    return h;
+}
+
+/* As pixels_of, for a glyph on a colour page. */
+static uint32_t color_pixels_of(const glyph_atlas *a, const glyph_slot *s) {
+    const uint8_t *bm = glyph_atlas_color_page(a, s->page);
+    int W = glyph_atlas_width(a);
+    uint32_t h = 2166136261u;
+    for (int y = 0; y < s->h; y++)
+        for (int x = 0; x < s->w * 4; x++)
+            h = (h ^ bm[((size_t)(s->y + y) * W + s->x) * 4 + x]) * 16777619u;
+    return h;
+}
+
+/* 100x200 synthesized cells pack 10 to a shelf, 5 shelves to a page. */
+#define PER_PAGE 50
+
+static void test_lru_pages(void) {
+    glyph_atlas *a = glyph_atlas_create(NULL, 0, 100, 200);
+    if (!a) return;
+    glyph_atlas_set_max_pages(a, 2);
+    uint32_t braille = 0x2800;
+
+    glyph_atlas_begin_frame(a);                       /* frame 1 fills page 0 */
+    for (int i = 0; i < PER_PAGE; i++) glyph_atlas_get(a, braille + i);
+    glyph_atlas_begin_frame(a);                       /* frame 2 fills page 1 */
+    uint32_t ref = pixels_of(a, glyph_atlas_get(a, braille + PER_PAGE));
+    for (int i = PER_PAGE; i < 2 * PER_PAGE; i++) glyph_atlas_get(a, braille + i);
+    CHECK(glyph_atlas_pages(a) == 2, "two pages allocated");
+    CHECK(glyph_atlas_get(a, braille)->page == 0, "first glyph on page 0");
+    CHECK(glyph_atlas_get(a, braille + PER_PAGE)->page == 1, "page 0 full, next on page 1");
+    uint32_t gen = glyph_atlas_generation(a);
+
+    glyph_atlas_begin_frame(a);                       /* frame 3 touches page 0 */
+    glyph_slot keep = *glyph_atlas_get(a, braille);
+    glyph_atlas_begin_frame(a);                       /* frame 4 needs room */
+    const glyph_slot *s = glyph_atlas_get(a, braille + 2 * PER_PAGE);
+    CHECK(s->valid && s->page == 1, "full atlas empties the colder page");
+    CHECK(glyph_atlas_generation(a) == gen + 1, "eviction bumps the generation");
+    CHECK(glyph_atlas_pages(a) == 2, "page limit holds");
+    s = glyph_atlas_get(a, braille);
+    CHECK(s->page == keep.page && s->x == keep.x && s->y == keep.y,
+          "recently used glyph keeps its place");
+
+    s = glyph_atlas_get(a, braille + PER_PAGE);       /* evicted: rasterized again */
+    CHECK(s->valid && s->page == 1, "evicted glyph comes back");
+    CHECK(pixels_of(a, s) == ref, "re-rasterized glyph has the same pixels");
+    CHECK(glyph_atlas_generation(a) == gen + 1, "room left: no second eviction");
+    glyph_atlas_destroy(a);
+}
+
+static void test_exhaustion(void) {
+    glyph_atlas *a = glyph_atlas_create(NULL, 0, 100, 200);
+    if (!a) return;
+    glyph_atlas_set_max_pages(a, 1);
+    uint32_t braille = 0x2800;
+
+    /* One frame asking for more than fits: what fits is placed, the rest is
+     * blank, and nothing placed this frame is moved to make room. */
+    glyph_atlas_begin_frame(a);
+    glyph_slot first = *glyph_atlas_get(a, braille);
+    int placed = 1;
+    for (int i = 1; i < PER_PAGE + 10; i++) placed += glyph_atlas_get(a, braille + i)->valid;
+    CHECK(placed == PER_PAGE, "one page holds exactly its glyphs");
+    CHECK(glyph_atlas_generation(a) == 0, "no eviction within a frame");
+    const glyph_slot *s = glyph_atlas_get(a, braille);
+    CHECK(s->x == first.x && s->y == first.y, "in-use glyph not moved");
+    CHECK(!glyph_atlas_get(a, braille + PER_PAGE)->valid, "overflow glyph drawn blank");
+
+    /* Next frame the overflow glyph is retried, not stuck blank. */
+    glyph_atlas_begin_frame(a);
+    s = glyph_atlas_get(a, braille + PER_PAGE);
+    CHECK(s->valid, "overflow glyph retried in the next frame");
+    CHECK(glyph_atlas_generation(a) == 1, "retry emptied the page");
+    CHECK(glyph_atlas_dirty(a), "emptied page is marked for upload");
+    int y0 = -1, y1 = -1;
+    CHECK(glyph_atlas_page_dirty_rows(a, 0, &y0, &y1) && y0 == 0 &&
+          y1 == glyph_atlas_height(a), "emptied page re-uploads whole");
+
+    /* Cycle far more glyphs through the page than it holds: every lookup
+     * in a fresh frame succeeds and comes back with correct pixels. */
+    uint32_t ref = 0;
+    for (int i = 0; i < 256; i++) {
+        glyph_atlas_begin_frame(a);
+        s = glyph_atlas_get(a, braille + (uint32_t)i);
+        if (!s->valid) { CHECK(0, "glyph placed after eviction"); break; }
+        if (i == 7) ref = pixels_of(a, s);
+    }
+    glyph_atlas_begin_frame(a);
+    s = glyph_atlas_get(a, braille + 7);
+    CHECK(s->valid && pixels_of(a, s) == ref, "cycled glyph re-rasterizes identically");
+    CHECK(glyph_atlas_pages(a) == 1, "page limit holds while cycling");
+    glyph_atlas_destroy(a);
+}
+
+static void test_warm_start(void) {
+    /* letters, a bold variant, synth, whitespace, CJK, emoji, unassigned */
+    static const uint32_t cps[] = {'A', 'g', '0', 0x2502, ' ', 0x4E2D, 0x1F600, 0x10FFFD};
+    enum { N = sizeof(cps) / sizeof(cps[0]) };
+    glyph_slot first[N + 1];
+    uint32_t ink[N + 1];
+
+    glyph_atlas *a = glyph_atlas_create(NULL, 0, 12, 24);
+    if (!a) return;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i <= N; i++) {
+            const glyph_slot *s = i < N ? glyph_atlas_get(a, cps[i])
+                                        : glyph_atlas_get_styled(a, 'A', true, false);
+            uint32_t h = !s->valid ? 0 : s->color ? color_pixels_of(a, s) : pixels_of(a, s);
+            if (pass == 0) {
+                first[i] = *s;
+                ink[i] = h;
+                continue;
+            }
+            CHECK(s->valid == first[i].valid && s->color == first[i].color &&
+                  s->w == first[i].w && s->h == first[i].h &&
+                  s->off_x == first[i].off_x && s->off_y == first[i].off_y,
+                  "warm glyph has the cold glyph's metrics");
+            CHECK(h == ink[i], "warm glyph has the cold glyph's pixels");
+        }
+        CHECK(glyph_atlas_disk_hits(a) == (pass ? N + 1u : 0u),
+              pass ? "every glyph came from the disk cache" : "cold atlas rasterized everything");
+        glyph_atlas_destroy(a);
+        a = glyph_atlas_create(NULL, 0, 12, 24);
+        if (!a) return;
+    }
+    glyph_atlas_destroy(a);
+}
+
+static void test_workers(void) {
+    static const uint32_t cps[] = {'A', 'g', 0x2502, ' ', 0x4E2D, 0x1F600, 0x10FFFD, 0x2800};
+    enum { N = sizeof(cps) / sizeof(cps[0]) };
+    glyph_atlas *a = glyph_atlas_create(NULL, 0, 14, 28);
+    glyph_atlas *ref = glyph_atlas_create(NULL, 0, 14, 28);
+    if (!a || !ref) { glyph_atlas_destroy(a); glyph_atlas_destroy(ref); return; }
+    CHECK(glyph_atlas_start_workers(a, 2) == 2, "two workers started");
+    CHECK(glyph_atlas_start_workers(a, 2) == 0, "workers start once");
+
+    glyph_atlas_begin_frame(a);
+    int pending = 0;
+    for (int i = 0; i < N; i++) {
+        const glyph_slot *s = glyph_atlas_get(a, cps[i]);
+        pending += s->pending && !s->valid;
+    }
+    glyph_atlas_get(a, 'A');                          /* queued once only */
+    CHECK(pending == N, "unseen glyphs come back pending");
+    CHECK(glyph_atlas_pending(a) == N, "each glyph queued once");
+
+    int placed = 0;
+    for (int tries = 0; glyph_atlas_pending(a) > 0 && tries < 5000; tries++) {
+        glyph_atlas_begin_frame(a);
+        placed += glyph_atlas_collect(a);
+        nanosleep(&(struct timespec){.tv_nsec = 1000000}, NULL);
+    }
+    CHECK(placed == N && glyph_atlas_pending(a) == 0, "workers finished every glyph");
+
+    for (int i = 0; i < N; i++) {
+        glyph_slot s = *glyph_atlas_get(a, cps[i]);
+        const glyph_slot *r = glyph_atlas_get(ref, cps[i]);
+        CHECK(!s.pending, "placed glyph no longer pending");
+        CHECK(s.valid == r->valid && s.color == r->color && s.w == r->w && s.h == r->h &&
+              s.off_x == r->off_x && s.off_y == r->off_y,
+              "worker glyph has the synchronous glyph's metrics");
+        if (s.valid && s.w && s.h)
+            CHECK((s.color ? color_pixels_of(a, &s) : pixels_of(a, &s)) ==
+                  (r->color ? color_pixels_of(ref, r) : pixels_of(ref, r)),
+                  "worker glyph has the synchronous glyph's pixels");
+    }
+    glyph_atlas_destroy(ref);
+    glyph_atlas_destroy(a);
+
+    /* Torn down mid-burst. */
+    a = glyph_atlas_create(NULL, 0, 16, 32);
+    if (!a) return;
+    glyph_atlas_start_workers(a, 3);
+    for (uint32_t cp = 0x4E00; cp < 0x4E00 + 300; cp++) glyph_atlas_get(a, cp);
+    glyph_atlas_destroy(a);
+}
+
+static void test_sdf(void) {
+    enum { PAD = GLYPH_ATLAS_SDF_SPREAD };
+    static const uint32_t cps[] = {'A', 'g', '@', 0x4E2D};
+    glyph_atlas *cov = glyph_atlas_create(NULL, 0, 24, 48);
+    glyph_atlas *sdf = glyph_atlas_create(NULL, 0, 24, 48);
+    if (!cov || !sdf) { glyph_atlas_destroy(cov); glyph_atlas_destroy(sdf); return; }
+    glyph_atlas_set_sdf(sdf, true);
+    int W = glyph_atlas_width(cov);
+    uint32_t cov_a = 0;
+    for (size_t i = 0; i < sizeof(cps) / sizeof(cps[0]); i++) {
+        glyph_slot c = *glyph_atlas_get(cov, cps[i]);
+        const glyph_slot *d = glyph_atlas_get(sdf, cps[i]);
+        if (cps[i] == 'A') cov_a = pixels_of(cov, &c);
+        if (!c.valid) continue;   /* no CJK font installed */
+        CHECK(d->valid && d->sdf && !c.sdf, "outline glyph is a distance field in SDF mode");
+        CHECK(d->w == c.w + 2 * PAD && d->h == c.h + 2 * PAD &&
+              d->off_x == c.off_x - PAD && d->off_y == c.off_y - PAD,
+              "distance field is the coverage box padded by the spread");
+        if (d->w != c.w + 2 * PAD || d->h != c.h + 2 * PAD) continue;
+
+        const uint8_t *cb = glyph_atlas_page(cov, c.page), *db = glyph_atlas_page(sdf, d->page);
+        long inked = 0, differ = 0, rim = 0;
+        for (int y = 0; y < d->h; y++)
+            for (int x = 0; x < d->w; x++) {
+                int f = db[(size_t)(d->y + y) * W + d->x + x];
+                if (x == 0 || y == 0 || x == d->w - 1 || y == d->h - 1) {
+                    rim += f >= 64;
+                    continue;
+                }
+                int cx = x - PAD, cy = y - PAD;
+                bool in = cx >= 0 && cy >= 0 && cx < c.w && cy < c.h &&
+                          cb[(size_t)(c.y + cy) * W + c.x + cx] >= 128;
+                inked += in;
+                differ += in != (f >= 128);
+            }
+        CHECK(inked > 0 && differ * 10 < inked, "thresholded field matches the coverage ink");
+        CHECK(rim == 0, "padding fades to far-outside at the glyph border");
+    }
+    const glyph_slot *box = glyph_atlas_get(sdf, 0x2502);
+    CHECK(box->valid && !box->sdf, "synthesized glyphs stay coverage in SDF mode");
+    glyph_atlas_destroy(cov);
+    glyph_atlas_destroy(sdf);
+
+    /* Each mode reads back only its own glyphs. */
+    cov = glyph_atlas_create(NULL, 0, 24, 48);
+    sdf = glyph_atlas_create(NULL, 0, 24, 48);
+    if (!cov || !sdf) { glyph_atlas_destroy(cov); glyph_atlas_destroy(sdf); return; }
+    glyph_atlas_set_sdf(sdf, true);
+    const glyph_slot *c = glyph_atlas_get(cov, 'A');
+    CHECK(!c->sdf && pixels_of(cov, c) == cov_a, "coverage atlas reads coverage glyphs back");
+    CHECK(glyph_atlas_get(sdf, 'A')->sdf, "SDF atlas reads distance fields back");
+    CHECK(glyph_atlas_disk_hits(cov) == 1 && glyph_atlas_disk_hits(sdf) == 1,
+          "both modes warm-start from their own cache");
+    glyph_atlas_destroy(cov);
+    glyph_atlas_destroy(sdf);
+}
+
+static void remove_cache(const char *dir) {
+    char sub[512], path[1024];
+    snprintf(sub, sizeof(sub), "%s/neowall/glyphs", dir);
+    DIR *d = opendir(sub);
+    for (struct dirent *e; d && (e = readdir(d));) {
+        if (e->d_name[0] == '.') continue;
+        snprintf(path, sizeof(path), "%s/%s", sub, e->d_name);
+        unlink(path);
+    }
+    if (d) closedir(d);
+    rmdir(sub);
+    snprintf(sub, sizeof(sub), "%s/neowall", dir);
+    rmdir(sub);
+    rmdir(dir);
+}
+
 int main(void) {
+    char cache[] = "/tmp/neowall-glyph-atlas-XXXXXX";
+    if (!mkdtemp(cache)) { perror("mkdtemp"); return 1; }
+    setenv("XDG_CACHE_HOME", cache, 1);
+
     glyph_atlas *a = glyph_atlas_create(NULL, 0, 10, 20);
     if (!a) {
         printf("glyph_atlas: no system monospace font found — SKIP\n");
+        remove_cache(cache);
         return 77;   /* meson treats 77 as skip */
     }
 
@@ -66,6 +362,13 @@ int main(void) {
     if (a1->x != a2->x || a1->y != a2->y) { printf("  FAIL: 'A' not cached stably\n"); g_fails++; }
 
     glyph_atlas_destroy(a);
+
+    test_lru_pages();
+    test_exhaustion();
+    test_warm_start();
+    test_workers();
+    test_sdf();
+    remove_cache(cache);
     printf("glyph_atlas: %s\n", g_fails ? "FAILURES" : "all checks passed");
     return g_fails ? 1 : 0;
 }
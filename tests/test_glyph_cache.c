@@ -0,0 +1,172 @@
+/* Unit tests for the on-disk glyph cache (src/terminal/glyph_cache.c).
+ *
+ *   1. Coverage, colour, whitespace and blank entries come back exactly,
+ *      both before a save and from the mapped file after reopening.
+ *   2. Glyphs added to a reopened cache are merged with the mapped ones,
+ *      distance-field glyphs keeping their flag.
+ *   3. A file for another cell size, a truncated file and one with a bad
+ *      magic are dropped and the cache starts empty.
+ *
+ * Runs against a temporary XDG_CACHE_HOME so nothing touches the real one.
+ */
+#define _DEFAULT_SOURCE /* mkdtemp */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../src/terminal/glyph_cache.h"
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        checks++;                                                              \
+        if (!(cond)) {                                                         \
+            failures++;                                                        \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+        }                                                                      \
+    } while (0)
+
+#define KEY  0x0123456789abcdefull
+#define CW   40
+#define CH   80
+
+static char g_file[600];
+
+/* A glyph's pixels inside a wider buffer, as the atlas hands them over. */
+static uint8_t g_page[64 * 64 * 4];
+#define STRIDE (64 * 4)
+
+static void fill(int w, int h, int bpp, uint8_t seed) {
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w * bpp; x++)
+            g_page[(size_t)y * STRIDE + x] = (uint8_t)(seed + x * 7 + y * 13);
+}
+
+static bool same_pixels(const uint8_t *px, int w, int h, int bpp, uint8_t seed) {
+    fill(w, h, bpp, seed);
+    for (int y = 0; y < h; y++)
+        if (memcmp(px + (size_t)y * w * bpp, g_page + (size_t)y * STRIDE, (size_t)w * bpp))
+            return false;
+    return true;
+}
+
+static void add(glyph_cache *c, glyph_cache_entry e, uint8_t seed) {
+    fill(e.w, e.h, e.color ? 4 : 1, seed);
+    glyph_cache_add(c, &e, e.valid && e.w && e.h ? g_page : NULL, STRIDE);
+}
+
+static const glyph_cache_entry cov   = {.key = 'A', .w = 21, .h = 33, .off_x = 2, .off_y = -3, .valid = true};
+static const glyph_cache_entry color = {.key = 0x1F600, .w = 30, .h = 28, .off_x = 5, .off_y = 6,
+                                        .valid = true, .color = true};
+static const glyph_cache_entry space = {.key = ' ', .valid = true};
+static const glyph_cache_entry none  = {.key = 0xE000u | (1u << 30)};
+
+static void check_all(const glyph_cache *c) {
+    glyph_cache_entry e;
+    const uint8_t *px;
+    CHECK(glyph_cache_find(c, 'A', &e, &px));
+    CHECK(e.w == 21 && e.h == 33 && e.off_x == 2 && e.off_y == -3 && e.valid && !e.color && !e.sdf);
+    CHECK(px && same_pixels(px, 21, 33, 1, 1));
+    CHECK(glyph_cache_find(c, 0x1F600, &e, &px));
+    CHECK(e.w == 30 && e.h == 28 && e.off_x == 5 && e.off_y == 6 && e.valid && e.color);
+    CHECK(px && same_pixels(px, 30, 28, 4, 2));
+    CHECK(glyph_cache_find(c, ' ', &e, &px));
+    CHECK(e.valid && e.w == 0 && px == NULL);
+    CHECK(glyph_cache_find(c, none.key, &e, &px));
+    CHECK(!e.valid && px == NULL);
+    CHECK(!glyph_cache_find(c, 'B', &e, &px));
+}
+
+static void test_round_trip(void) {
+    glyph_cache *c = glyph_cache_open(KEY, CW, CH);
+    CHECK(c != NULL);
+    CHECK(glyph_cache_count(c) == 0);
+    add(c, cov, 1);
+    add(c, color, 2);
+    add(c, space, 0);
+    add(c, none, 0);
+    add(c, cov, 9);                 /* already present: ignored */
+    CHECK(glyph_cache_count(c) == 4);
+    check_all(c);                   /* found before any save */
+    glyph_cache_close(c);
+    CHECK(access(g_file, F_OK) == 0);
+
+    c = glyph_cache_open(KEY, CW, CH);
+    CHECK(glyph_cache_count(c) == 4);
+    check_all(c);                   /* from the mapping */
+    CHECK(glyph_cache_save(c));     /* nothing new */
+    glyph_cache_close(c);
+}
+
+static void test_merge(void) {
+    glyph_cache *c = glyph_cache_open(KEY, CW, CH);
+    glyph_cache_entry lo = {.key = '!', .w = 3, .h = 40, .valid = true, .sdf = true};
+    glyph_cache_entry hi = {.key = 0x10FFFF, .w = 40, .h = 3, .valid = true};
+    add(c, hi, 4);
+    add(c, lo, 3);
+    CHECK(glyph_cache_count(c) == 6);
+    CHECK(glyph_cache_save(c));
+    glyph_cache_close(c);
+
+    c = glyph_cache_open(KEY, CW, CH);
+    CHECK(glyph_cache_count(c) == 6);
+    check_all(c);
+    glyph_cache_entry e;
+    const uint8_t *px;
+    CHECK(glyph_cache_find(c, '!', &e, &px) && e.h == 40 && e.sdf && same_pixels(px, 3, 40, 1, 3));
+    CHECK(glyph_cache_find(c, 0x10FFFF, &e, &px) && e.w == 40 && !e.sdf && same_pixels(px, 40, 3, 1, 4));
+    glyph_cache_close(c);
+}
+
+static void test_invalid(void) {
+    /* another cell size under the same key */
+    glyph_cache *c = glyph_cache_open(KEY, CW + 1, CH);
+    CHECK(c != NULL && glyph_cache_count(c) == 0);
+    CHECK(access(g_file, F_OK) != 0);
+    add(c, cov, 1);
+    glyph_cache_close(c);
+
+    /* truncated */
+    CHECK(truncate(g_file, 40) == 0);
+    c = glyph_cache_open(KEY, CW + 1, CH);
+    CHECK(c != NULL && glyph_cache_count(c) == 0);
+    CHECK(!glyph_cache_find(c, 'A', NULL, NULL));
+    add(c, cov, 1);
+    glyph_cache_close(c);
+
+    /* bad magic */
+    FILE *f = fopen(g_file, "r+b");
+    CHECK(f != NULL);
+    if (f) { fputs("XXXX", f); fclose(f); }
+    c = glyph_cache_open(KEY, CW + 1, CH);
+    CHECK(c != NULL && glyph_cache_count(c) == 0);
+    glyph_cache_close(c);
+    CHECK(access(g_file, F_OK) != 0);   /* nothing added: nothing written */
+}
+
+int main(void) {
+    char dir[] = "/tmp/neowall-glyph-cache-XXXXXX";
+    CHECK(mkdtemp(dir) != NULL);
+    setenv("XDG_CACHE_HOME", dir, 1);
+    snprintf(g_file, sizeof(g_file), "%s/neowall/glyphs/%016llx.glyph", dir,
+             (unsigned long long)KEY);
+
+    CHECK(glyph_cache_hash("a", 1, GLYPH_CACHE_HASH_INIT) !=
+          glyph_cache_hash("b", 1, GLYPH_CACHE_HASH_INIT));
+    test_round_trip();
+    test_merge();
+    test_invalid();
+
+    unlink(g_file);
+    char sub[512];
+    snprintf(sub, sizeof(sub), "%s/neowall/glyphs", dir);
+    rmdir(sub);
+    snprintf(sub, sizeof(sub), "%s/neowall", dir);
+    rmdir(sub);
+    rmdir(dir);
+    printf("glyph_cache: %d/%d checks passed\n", checks - failures, checks);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,231 @@
+/* Unit tests for BC1 compression (bc1.c) and the compressed image cache
+ * (image_cache.c).
+ *
+ * Headless: no GL, no codecs. The encoder is checked through the software
+ * decoder — exact for flat 565-representable colours, PSNR-bounded for
+ * gradients and noise — and the cache is round-tripped through a scratch
+ * XDG_CACHE_HOME so nothing touches the real one.
+ */
+#define _DEFAULT_SOURCE /* mkdtemp */
+#include <fcntl.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "neowall/image/bc1.h"
+#include "neowall/image/image.h"
+#include "neowall/image/image_cache.h"
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        checks++;                                                              \
+        if (!(cond)) {                                                         \
+            failures++;                                                        \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+        }                                                                      \
+    } while (0)
+
+enum pattern { PATTERN_FLAT, PATTERN_GRADIENT, PATTERN_NOISE };
+
+static uint8_t *make_image(uint32_t w, uint32_t h, enum pattern pat) {
+    uint8_t *p = malloc((size_t)w * h * 4);
+    uint32_t seed = 12345;
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < w; x++) {
+            uint8_t *px = p + ((size_t)y * w + x) * 4;
+            switch (pat) {
+            case PATTERN_FLAT:
+                /* 5/6/5-exact: top bits replicated into the low bits */
+                px[0] = 0xFF;
+                px[1] = 0x82;
+                px[2] = 0x00;
+                break;
+            case PATTERN_GRADIENT:
+                px[0] = (uint8_t)(x * 255 / (w > 1 ? w - 1 : 1));
+                px[1] = (uint8_t)(y * 255 / (h > 1 ? h - 1 : 1));
+                px[2] = (uint8_t)((x + y) * 127 / (w + h));
+                break;
+            case PATTERN_NOISE:
+                for (int c = 0; c < 3; c++) {
+                    seed = seed * 1103515245u + 12345u;
+                    px[c] = (uint8_t)(seed >> 16);
+                }
+                break;
+            }
+            px[3] = 255;
+        }
+    }
+    return p;
+}
+
+/* PSNR over RGB; alpha is checked separately. */
+static double psnr(const uint8_t *a, const uint8_t *b, uint32_t w, uint32_t h) {
+    double se = 0.0;
+    size_t n = (size_t)w * h;
+    for (size_t i = 0; i < n; i++) {
+        for (int c = 0; c < 3; c++) {
+            double d = (double)a[i * 4 + c] - (double)b[i * 4 + c];
+            se += d * d;
+        }
+    }
+    double mse = se / (double)(n * 3);
+    return mse == 0.0 ? INFINITY : 10.0 * log10(255.0 * 255.0 / mse);
+}
+
+/* Encode then decode; returns PSNR, or -1 if encoding refused. */
+static double round_trip(uint32_t w, uint32_t h, enum pattern pat) {
+    uint8_t *src = make_image(w, h, pat);
+    uint8_t *blocks = malloc(bc1_size(w, h));
+    uint8_t *out = malloc((size_t)w * h * 4);
+    double result = -1.0;
+    if (bc1_encode_rgba(src, w, h, blocks)) {
+        bc1_decode_rgba(blocks, w, h, out);
+        bool opaque = true;
+        for (size_t i = 0; i < (size_t)w * h; i++) {
+            opaque = opaque && out[i * 4 + 3] == 255;
+        }
+        CHECK(opaque);
+        result = psnr(src, out, w, h);
+    }
+    free(src);
+    free(blocks);
+    free(out);
+    return result;
+}
+
+static void test_sizes(void) {
+    CHECK(bc1_size(4, 4) == 8);
+    CHECK(bc1_size(1, 1) == 8);
+    CHECK(bc1_size(5, 3) == 16);
+    CHECK(bc1_size(3840, 2160) == 3840u * 2160u / 2u);
+    CHECK(bc1_size(0, 16) == 0);
+    CHECK(bc1_size(16, 0) == 0);
+}
+
+static void test_codec(void) {
+    CHECK(isinf(round_trip(8, 8, PATTERN_FLAT)));
+    CHECK(isinf(round_trip(5, 3, PATTERN_FLAT)));
+    CHECK(round_trip(64, 64, PATTERN_GRADIENT) > 36.0);
+    CHECK(round_trip(37, 19, PATTERN_GRADIENT) > 30.0);
+    CHECK(round_trip(1, 1, PATTERN_GRADIENT) > 40.0);
+    CHECK(round_trip(32, 32, PATTERN_NOISE) > 10.0);
+
+    /* A single translucent pixel keeps the whole image out of BC1. */
+    uint8_t *src = make_image(8, 8, PATTERN_GRADIENT);
+    uint8_t blocks[32];
+    src[(3 * 8 + 6) * 4 + 3] = 254;
+    CHECK(!bc1_encode_rgba(src, 8, 8, blocks));
+    free(src);
+}
+
+/* Three-colour mode (color0 <= color1) is never emitted by the encoder but
+ * is legal input; index 3 must decode to transparent black. */
+static void test_decode_three_colour(void) {
+    const uint8_t block[8] = {0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    uint8_t out[4 * 4 * 4];
+    bc1_decode_rgba(block, 4, 4, out);
+    CHECK(out[0] == 0 && out[1] == 0 && out[2] == 0 && out[3] == 0);
+}
+
+static void set_mtime(const char *path, time_t t) {
+    struct timespec times[2] = {{t, 0}, {t, 0}};
+    utimensat(AT_FDCWD, path, times, 0);
+}
+
+static void test_cache(void) {
+    char dir[] = "/tmp/neowall-imgcache-XXXXXX";
+    CHECK(mkdtemp(dir) != NULL);
+    setenv("XDG_CACHE_HOME", dir, 1);
+
+    char src_path[256];
+    snprintf(src_path, sizeof(src_path), "%s/wall.png", dir);
+    FILE *f = fopen(src_path, "wb");
+    CHECK(f != NULL);
+    if (!f) {
+        return;
+    }
+    fputs("not really a png", f);
+    fclose(f);
+    set_mtime(src_path, 1000000);
+
+    uint64_t key = 0, other = 0;
+    CHECK(image_cache_key(src_path, 64, 32, 0, &key));
+    CHECK(!image_cache_key("/nonexistent/neowall/wall.png", 64, 32, 0, &other));
+    CHECK(image_cache_key(src_path, 64, 32, 0, &other) && other == key);
+    CHECK(image_cache_key(src_path, 65, 32, 0, &other) && other != key);
+    CHECK(image_cache_key(src_path, 64, 32, 1, &other) && other != key);
+
+    CHECK(image_cache_load(key) == NULL);
+
+    uint8_t *rgba = make_image(64, 32, PATTERN_GRADIENT);
+    struct image_data img = {0};
+    img.width = 64;
+    img.height = 32;
+    img.channels = 4;
+    img.pixel_format = IMAGE_PIXELS_BC1;
+    img.pixels_size = bc1_size(64, 32);
+    img.pixels = malloc(img.pixels_size);
+    CHECK(bc1_encode_rgba(rgba, 64, 32, img.pixels));
+    free(rgba);
+
+    /* Raw images and size mismatches are refused. */
+    struct image_data raw = img;
+    raw.pixel_format = IMAGE_PIXELS_RAW;
+    CHECK(!image_cache_store(key, &raw));
+    struct image_data short_img = img;
+    short_img.pixels_size -= 8;
+    CHECK(!image_cache_store(key, &short_img));
+
+    CHECK(image_cache_store(key, &img));
+    struct image_data *hit = image_cache_load(key);
+    CHECK(hit != NULL);
+    if (hit) {
+        CHECK(hit->width == 64 && hit->height == 32);
+        CHECK(hit->pixel_format == IMAGE_PIXELS_BC1);
+        CHECK(hit->pixels_size == img.pixels_size);
+        CHECK(memcmp(hit->pixels, img.pixels, img.pixels_size) == 0);
+        free(hit->pixels);
+        free(hit);
+    }
+
+    /* Touching the source changes the key: the old entry is never seen. */
+    set_mtime(src_path, 2000000);
+    CHECK(image_cache_key(src_path, 64, 32, 0, &other) && other != key);
+    CHECK(image_cache_load(other) == NULL);
+
+    /* A truncated entry is a miss, and is removed. */
+    char entry[512];
+    snprintf(entry, sizeof(entry), "%s/neowall/imagebin/%016llx.img", dir,
+             (unsigned long long)key);
+    CHECK(truncate(entry, 40) == 0);
+    CHECK(image_cache_load(key) == NULL);
+    struct stat st;
+    CHECK(stat(entry, &st) != 0);
+
+    free(img.pixels);
+    unlink(src_path);
+    char sub[512];
+    snprintf(sub, sizeof(sub), "%s/neowall/imagebin", dir);
+    rmdir(sub);
+    snprintf(sub, sizeof(sub), "%s/neowall", dir);
+    rmdir(sub);
+    rmdir(dir);
+}
+
+int main(void) {
+    test_sizes();
+    test_codec();
+    test_decode_three_colour();
+    test_cache();
+
+    printf("image_compress: %d/%d checks passed\n", checks - failures, checks);
+    return failures ? 1 : 0;
+}
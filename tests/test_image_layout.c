@@ -0,0 +1,115 @@
+/* Unit tests for wallpaper placement (src/render/image_layout.c).
+ *
+ * Headless: no EGL/GL. Each case checks the rect the image shaders sample
+ * from, in the quad's texcoord space (0..1, top-left origin), against the
+ * pixel geometry the old CPU pad/tile produced: the same floor-centred
+ * margins, the same 1:1 tile size.
+ */
+#include <math.h>
+#include <stdio.h>
+
+#include "neowall/render/image_layout.h"
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        checks++;                                                              \
+        if (!(cond)) {                                                         \
+            failures++;                                                        \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+        }                                                                      \
+    } while (0)
+
+/* Rect in output pixels, back from texcoord space. */
+static int px(float v, int32_t len) {
+    return (int)lroundf(v * (float)len);
+}
+
+static void test_full(void) {
+    struct image_layout l;
+    image_layout_compute(IMAGE_LAYOUT_FULL, 1920, 1080, 1920, 1080, &l);
+    CHECK(l.x == 0.0f && l.y == 0.0f && l.w == 1.0f && l.h == 1.0f && !l.tile);
+
+    /* FULL ignores the texture size: STRETCH and FILL cover the output. */
+    image_layout_compute(IMAGE_LAYOUT_FULL, 10, 700, 1920, 1080, &l);
+    CHECK(l.x == 0.0f && l.y == 0.0f && l.w == 1.0f && l.h == 1.0f && !l.tile);
+}
+
+static void test_fit(void) {
+    struct image_layout l;
+
+    /* Pillarbox: 1440x1080 on 1920x1080, 240 px bars. */
+    image_layout_compute(IMAGE_LAYOUT_FIT, 1440, 1080, 1920, 1080, &l);
+    CHECK(px(l.x, 1920) == 240 && px(l.w, 1920) == 1440);
+    CHECK(px(l.y, 1080) == 0 && px(l.h, 1080) == 1080);
+    CHECK(!l.tile);
+
+    /* Odd margin floors, like the old (ow - sw) / 2 pad. */
+    image_layout_compute(IMAGE_LAYOUT_FIT, 10, 10, 33, 17, &l);
+    CHECK(px(l.x, 33) == 11 && px(l.y, 17) == 3);
+    CHECK(px(l.w, 33) == 10 && px(l.h, 17) == 10);
+
+    /* A texture larger than the output (outlived a resize) is scaled down to
+     * fit rather than spilling over. */
+    image_layout_compute(IMAGE_LAYOUT_FIT, 3840, 1080, 1920, 1080, &l);
+    CHECK(px(l.w, 1920) == 1920 && px(l.h, 1080) == 540);
+    CHECK(px(l.x, 1920) == 0 && px(l.y, 1080) == 270);
+}
+
+static void test_center(void) {
+    struct image_layout l;
+
+    image_layout_compute(IMAGE_LAYOUT_CENTER, 800, 600, 1920, 1080, &l);
+    CHECK(px(l.x, 1920) == 560 && px(l.y, 1080) == 240);
+    CHECK(px(l.w, 1920) == 800 && px(l.h, 1080) == 600);
+    CHECK(!l.tile);
+
+    /* Already cropped to the output: exactly full. */
+    image_layout_compute(IMAGE_LAYOUT_CENTER, 1920, 1080, 1920, 1080, &l);
+    CHECK(l.x == 0.0f && l.y == 0.0f && l.w == 1.0f && l.h == 1.0f);
+
+    /* Larger on one axis only: that axis overflows symmetrically (1:1 is
+     * kept, the shader just never samples outside). */
+    image_layout_compute(IMAGE_LAYOUT_CENTER, 2000, 500, 1000, 1000, &l);
+    CHECK(px(l.x, 1000) == -500 && px(l.w, 1000) == 2000);
+    CHECK(px(l.y, 1000) == 250 && px(l.h, 1000) == 500);
+}
+
+static void test_tile(void) {
+    struct image_layout l;
+
+    image_layout_compute(IMAGE_LAYOUT_TILE, 64, 48, 1920, 1080, &l);
+    CHECK(l.tile);
+    CHECK(l.x == 0.0f && l.y == 0.0f);
+    CHECK(px(l.w, 1920) == 64 && px(l.h, 1080) == 48);
+
+    /* uv -> image uv is (uv - xy) / wh: the right edge is 30 tiles across. */
+    CHECK(fabsf(1.0f / l.w - 30.0f) < 1e-4f);
+}
+
+static void test_degenerate(void) {
+    struct image_layout l = {0.5f, 0.5f, 0.0f, 0.0f, true};
+    image_layout_compute(IMAGE_LAYOUT_FIT, 0, 10, 1920, 1080, &l);
+    CHECK(l.x == 0.0f && l.y == 0.0f && l.w == 1.0f && l.h == 1.0f && !l.tile);
+
+    image_layout_compute(IMAGE_LAYOUT_TILE, 64, 64, 0, 1080, &l);
+    CHECK(l.w == 1.0f && l.h == 1.0f && !l.tile);
+
+    image_layout_compute(IMAGE_LAYOUT_CENTER, 64, 64, 1920, -1, &l);
+    CHECK(l.w == 1.0f && l.h == 1.0f);
+
+    image_layout_compute(IMAGE_LAYOUT_FIT, 64, 64, 1920, 1080, NULL); /* must not crash */
+}
+
+int main(void) {
+    test_full();
+    test_fit();
+    test_center();
+    test_tile();
+    test_degenerate();
+
+    printf("image_layout: %d/%d checks passed\n", checks - failures, checks);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,189 @@
+/* Unit tests for the row-streaming resampler (image_stream.c).
+ *
+ * Headless: no libpng/libjpeg. Every case paints a synthetic RGBA source,
+ * streams it through one row at a time, and compares every output pixel with
+ * a reference built the old way — a whole-buffer bilinear scale followed by a
+ * separate centre-crop copy, as image.c did before streaming. The two
+ * must agree bit for bit: streaming is a memory change, not a visual one.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "neowall/image/image_stream.h"
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        checks++;                                                              \
+        if (!(cond)) {                                                         \
+            failures++;                                                        \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+        }                                                                      \
+    } while (0)
+
+static uint8_t *make_source(uint32_t w, uint32_t h) {
+    uint8_t *p = malloc((size_t)w * h * 4);
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < w; x++) {
+            uint8_t *px = p + ((size_t)y * w + x) * 4;
+            px[0] = (uint8_t)(x * 7 + y * 3);
+            px[1] = (uint8_t)(x * y);
+            px[2] = (uint8_t)(255 - x * 5);
+            px[3] = (uint8_t)(128 + (x ^ y));
+        }
+    }
+    return p;
+}
+
+/* The pre-streaming image_scale_bilinear(), verbatim in effect. */
+static uint8_t *ref_scale(const uint8_t *src, uint32_t w, uint32_t h, uint32_t nw, uint32_t nh) {
+    uint8_t *out = malloc((size_t)nw * nh * 4);
+    if (nw == w && nh == h) {
+        memcpy(out, src, (size_t)w * h * 4);
+        return out;
+    }
+    float x_ratio = (float)(w - 1) / (float)nw;
+    float y_ratio = (float)(h - 1) / (float)nh;
+    for (uint32_t y = 0; y < nh; y++) {
+        for (uint32_t x = 0; x < nw; x++) {
+            float src_x = x * x_ratio;
+            float src_y = y * y_ratio;
+            uint32_t x1 = (uint32_t)src_x;
+            uint32_t y1 = (uint32_t)src_y;
+            uint32_t x2 = (x1 < w - 1) ? x1 + 1 : x1;
+            uint32_t y2 = (y1 < h - 1) ? y1 + 1 : y1;
+            float x_diff = src_x - x1;
+            float y_diff = src_y - y1;
+            for (int c = 0; c < 4; c++) {
+                float tl = src[(y1 * w + x1) * 4 + c];
+                float tr = src[(y1 * w + x2) * 4 + c];
+                float bl = src[(y2 * w + x1) * 4 + c];
+                float br = src[(y2 * w + x2) * 4 + c];
+                float top = tl * (1.0f - x_diff) + tr * x_diff;
+                float bottom = bl * (1.0f - x_diff) + br * x_diff;
+                float value = top * (1.0f - y_diff) + bottom * y_diff;
+                out[((size_t)y * nw + x) * 4 + c] = (uint8_t)(value + 0.5f);
+            }
+        }
+    }
+    return out;
+}
+
+/* Reference placement of a scaled image into the output, per the old
+ * image_center_crop. */
+static void ref_pixel(const uint8_t *scaled, const struct image_stream_plan *p, uint32_t x,
+                      uint32_t y, uint8_t out[4]) {
+    uint32_t sw = p->scaled_width, sh = p->scaled_height;
+    uint32_t ow = p->out_width, oh = p->out_height;
+    uint32_t sx = x, sy = y;
+    switch (p->place) {
+    case IMAGE_PLACE_NONE:
+        break;
+    case IMAGE_PLACE_CROP:
+        sx = x + (sw - ow) / 2;
+        sy = y + (sh - oh) / 2;
+        break;
+    }
+    memcpy(out, scaled + ((size_t)sy * sw + sx) * 4, 4);
+}
+
+static void run_case(uint32_t sw_, uint32_t sh_, uint32_t scw, uint32_t sch, uint32_t ow,
+                     uint32_t oh, enum image_place place) {
+    struct image_stream_plan plan = {
+        .src_width = sw_, .src_height = sh_,
+        .scaled_width = scw, .scaled_height = sch,
+        .out_width = ow, .out_height = oh,
+        .place = place,
+    };
+    uint8_t *src = make_source(sw_, sh_);
+    uint8_t *scaled = ref_scale(src, sw_, sh_, scw, sch);
+
+    struct image_stream *s = image_stream_create(&plan);
+    CHECK(s != NULL);
+    if (!s) {
+        free(src);
+        free(scaled);
+        return;
+    }
+
+    /* Finishing early must refuse: rows are still owed. */
+    uint32_t w = 0, h = 0;
+    CHECK(image_stream_finish(s, &w, &h) == NULL);
+
+    for (uint32_t y = 0; y < sh_; y++) {
+        uint8_t *slot = image_stream_row_slot(s);
+        CHECK(slot != NULL);
+        memcpy(slot, src + (size_t)y * sw_ * 4, (size_t)sw_ * 4);
+        image_stream_commit_row(s);
+    }
+    CHECK(image_stream_row_slot(s) == NULL);
+
+    uint8_t *out = image_stream_finish(s, &w, &h);
+    CHECK(out != NULL);
+    CHECK(w == ow && h == oh);
+
+    int bad = 0;
+    for (uint32_t y = 0; out && y < oh; y++) {
+        for (uint32_t x = 0; x < ow; x++) {
+            uint8_t want[4];
+            ref_pixel(scaled, &plan, x, y, want);
+            if (memcmp(want, out + ((size_t)y * ow + x) * 4, 4) != 0) {
+                bad++;
+            }
+        }
+    }
+    CHECK(bad == 0);
+    if (bad) {
+        fprintf(stderr, "  case %ux%u -> %ux%u -> %ux%u place=%d: %d pixels differ\n", sw_,
+                sh_, scw, sch, ow, oh, (int)place, bad);
+    }
+
+    free(out);
+    image_stream_destroy(s);
+    free(src);
+    free(scaled);
+}
+
+static void test_invalid_plans(void) {
+    struct image_stream_plan zero = {0};
+    CHECK(image_stream_create(&zero) == NULL);
+    CHECK(image_stream_create(NULL) == NULL);
+
+    /* NONE must not change size; CROP may not grow. Padding is the GPU's
+     * job now, so a plan asking for a bigger output is refused either way. */
+    struct image_stream_plan none = {4, 4, 4, 4, 5, 4, IMAGE_PLACE_NONE};
+    CHECK(image_stream_create(&none) == NULL);
+    struct image_stream_plan crop = {4, 4, 8, 8, 9, 8, IMAGE_PLACE_CROP};
+    CHECK(image_stream_create(&crop) == NULL);
+    struct image_stream_plan tall = {4, 4, 8, 8, 8, 9, IMAGE_PLACE_CROP};
+    CHECK(image_stream_create(&tall) == NULL);
+
+    image_stream_destroy(NULL);
+    CHECK(image_stream_row_slot(NULL) == NULL);
+    CHECK(!image_stream_push_row(NULL, NULL));
+}
+
+int main(void) {
+    test_invalid_plans();
+
+    /* Plain resample, down and up, including a 1-row / 1-column source. */
+    run_case(64, 48, 32, 24, 32, 24, IMAGE_PLACE_NONE);
+    run_case(17, 9, 40, 31, 40, 31, IMAGE_PLACE_NONE);
+    run_case(1, 1, 5, 3, 5, 3, IMAGE_PLACE_NONE);
+    run_case(100, 1, 10, 4, 10, 4, IMAGE_PLACE_NONE);
+    run_case(300, 200, 7, 5, 7, 5, IMAGE_PLACE_NONE);
+
+    /* FILL: scale past the display, crop the centre. */
+    run_case(80, 40, 64, 32, 48, 32, IMAGE_PLACE_CROP);
+    run_case(30, 90, 32, 96, 32, 40, IMAGE_PLACE_CROP);
+
+    /* CENTER-style crop with no resample. */
+    run_case(50, 50, 50, 50, 20, 30, IMAGE_PLACE_CROP);
+
+    printf("image_stream: %d/%d checks passed\n", checks - failures, checks);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,225 @@
+/* Tests for the reactive audio STFT (src/shader/reactive_audio.c).
+ *
+ * Everything is driven by synthetic signals; no audio thread or parec.
+ *
+ * Coverage:
+ *   1. The packed real FFT matches the reference complex FFT (reactive_fft.h).
+ *   2. Frames arrive every REACTIVE_STFT_HOP samples once the window is full,
+ *      however the input is chunked.
+ *   3. A low tone lands in bass, a high one in treble, and the spectrum peak
+ *      is at the tone's bin.
+ *   4. A kick-drum train fires one onset per kick, close to it; a steady tone
+ *      fires at most once (its start).
+ *   5. Smoothing constants rescale to the same per-1024-sample decay.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/shader/reactive_audio.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define RATE 44100
+
+void neowall_test_fft(float *re, float *im, int n);
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        checks++;                                                              \
+        if (!(cond)) {                                                         \
+            failures++;                                                        \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+        }                                                                      \
+    } while (0)
+
+/* Feed `n` samples in `chunk`-sized reads, as the audio thread does. Calls
+ * `on_frame` for every frame with the index of the sample that completed it. */
+typedef void (*frame_fn)(const reactive_stft_frame_t *fr, long at, void *ud);
+
+static int feed(struct reactive_stft *st, const float *pcm, long n, int chunk,
+                frame_fn on_frame, void *ud) {
+    static reactive_stft_frame_t fr;
+    int frames = 0;
+    for (long off = 0; off < n; off += chunk) {
+        int len = (int)(n - off < chunk ? n - off : chunk);
+        for (int used = 0; used < len;) {
+            bool ready;
+            used += reactive_stft_push(st, pcm + off + used, len - used, &fr, &ready);
+            if (!ready) continue;
+            frames++;
+            if (on_frame) on_frame(&fr, off + used - 1, ud);
+        }
+    }
+    return frames;
+}
+
+static void test_real_fft(void) {
+    struct reactive_stft *st = reactive_stft_create(RATE);
+    CHECK(st != NULL);
+
+    static float in[REACTIVE_STFT_SIZE], ref_re[REACTIVE_STFT_SIZE], ref_im[REACTIVE_STFT_SIZE];
+    float re[REACTIVE_STFT_BINS + 1], im[REACTIVE_STFT_BINS + 1];
+    srand(42);
+    for (int i = 0; i < REACTIVE_STFT_SIZE; i++) {
+        in[i] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+        ref_re[i] = in[i];
+        ref_im[i] = 0.0f;
+    }
+    neowall_test_fft(ref_re, ref_im, REACTIVE_STFT_SIZE);
+    reactive_stft_real_fft(st, in, re, im);
+
+    float worst = 0.0f;
+    for (int k = 0; k <= REACTIVE_STFT_BINS; k++) {
+        worst = fmaxf(worst, fabsf(re[k] - ref_re[k]));
+        worst = fmaxf(worst, fabsf(im[k] - ref_im[k]));
+    }
+    /* bins are sums of ~1000 unit-scale terms; float error stays ~1e-4 */
+    CHECK(worst < 2e-3f);
+    CHECK(fabsf(im[0]) < 1e-4f && fabsf(im[REACTIVE_STFT_BINS]) < 1e-4f);
+
+    reactive_stft_destroy(st);
+}
+
+static void test_frame_cadence(void) {
+    static float pcm[RATE];
+    for (int i = 0; i < RATE; i++) pcm[i] = 0.1f * sinf(i * 0.05f);
+    int want = (RATE - REACTIVE_STFT_SIZE) / REACTIVE_STFT_HOP + 1;
+
+    const int chunks[] = {1, 256, 1000, RATE};
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        struct reactive_stft *st = reactive_stft_create(RATE);
+        CHECK(feed(st, pcm, RATE, chunks[c], NULL, NULL) == want);
+        reactive_stft_destroy(st);
+    }
+
+    /* a single push stops at the first completed frame */
+    struct reactive_stft *st = reactive_stft_create(RATE);
+    reactive_stft_frame_t *fr = malloc(sizeof(*fr));
+    bool ready;
+    CHECK(reactive_stft_push(st, pcm, 4096, fr, &ready) == REACTIVE_STFT_SIZE && ready);
+    CHECK(reactive_stft_push(st, pcm, 4096, fr, &ready) == REACTIVE_STFT_HOP && ready);
+    CHECK(reactive_stft_push(st, pcm, 10, fr, &ready) == 10 && !ready);
+    free(fr);
+    reactive_stft_destroy(st);
+}
+
+static void last_frame(const reactive_stft_frame_t *fr, long at, void *ud) {
+    (void)at;
+    memcpy(ud, fr, sizeof(*fr));
+}
+
+static void tone(float hz, reactive_stft_frame_t *out) {
+    static float pcm[RATE / 2];
+    for (int i = 0; i < RATE / 2; i++) pcm[i] = 0.5f * sinf(2.0f * (float)M_PI * hz * i / RATE);
+    struct reactive_stft *st = reactive_stft_create(RATE);
+    feed(st, pcm, RATE / 2, 256, last_frame, out);
+    reactive_stft_destroy(st);
+}
+
+static int peak_bin(const reactive_stft_frame_t *fr) {
+    int best = 0;
+    for (int k = 1; k < REACTIVE_STFT_BINS; k++) {
+        if (fr->spectrum[k] > fr->spectrum[best]) best = k;
+    }
+    return best;
+}
+
+static void test_bands(void) {
+    static reactive_stft_frame_t low, high;
+    const float bin_hz = (float)RATE / REACTIVE_STFT_SIZE;
+
+    tone(100.0f, &low);
+    CHECK(abs(peak_bin(&low) - (int)lroundf(100.0f / bin_hz)) <= 1);
+    CHECK(low.bass > 0.2f);
+    CHECK(low.bass > low.mid * 2.0f && low.bass > low.treble * 2.0f);
+
+    tone(8000.0f, &high);
+    CHECK(abs(peak_bin(&high) - (int)lroundf(8000.0f / bin_hz)) <= 1);
+    CHECK(high.treble > high.bass * 2.0f && high.treble > high.mid);
+    CHECK(high.bass < 0.05f);
+
+    /* RMS of a 0.5-amplitude sine; waveform is the window mapped to 0..1 */
+    CHECK(fabsf(low.rms - 0.5f / sqrtf(2.0f)) < 0.01f);
+    bool in_range = true;
+    for (int k = 0; k < REACTIVE_STFT_BINS; k++) {
+        if (low.waveform[k] < 0.2f || low.waveform[k] > 0.8f) in_range = false;
+    }
+    CHECK(in_range);
+}
+
+typedef struct {
+    long at[64];
+    int n;
+} onsets_t;
+
+static void collect_onsets(const reactive_stft_frame_t *fr, long at, void *ud) {
+    onsets_t *o = ud;
+    if (fr->onset && o->n < 64) o->at[o->n++] = at;
+}
+
+static void test_onsets(void) {
+    /* A kick drum (decaying 60 Hz burst, 120 ms) twice a second over 4 s of
+     * faint noise, first at 0.25 s. */
+    const long n = 4L * RATE;
+    const long period = RATE / 2, first = RATE / 4;
+    float *pcm = malloc(sizeof(float) * n);
+    srand(7);
+    for (long i = 0; i < n; i++) pcm[i] = ((float)rand() / RAND_MAX - 0.5f) * 0.002f;
+    int kicks = 0;
+    for (long c = first; c < n; c += period, kicks++) {
+        for (int j = 0; j < RATE * 12 / 100; j++) {
+            float t = (float)j / RATE;
+            pcm[c + j] += 0.8f * expf(-t / 0.04f) * sinf(2.0f * (float)M_PI * 60.0f * t);
+        }
+    }
+
+    struct reactive_stft *st = reactive_stft_create(RATE);
+    onsets_t o = {0};
+    feed(st, pcm, n, 256, collect_onsets, &o);
+    reactive_stft_destroy(st);
+
+    CHECK(o.n == kicks);
+    bool near = true;
+    for (int i = 0; i < o.n && i < kicks; i++) {
+        /* reported within a couple of hops of the attack */
+        long lag = o.at[i] - (first + i * period);
+        if (lag < 0 || lag > 2 * REACTIVE_STFT_HOP) near = false;
+    }
+    CHECK(near);
+
+    /* A steady tone: at most the onset of the tone itself. */
+    for (long i = 0; i < n; i++) pcm[i] = 0.4f * sinf(2.0f * (float)M_PI * 220.0f * i / RATE);
+    st = reactive_stft_create(RATE);
+    onsets_t steady = {0};
+    feed(st, pcm, n, 256, collect_onsets, &steady);
+    reactive_stft_destroy(st);
+    CHECK(steady.n <= 1);
+
+    free(pcm);
+}
+
+static void test_rescale(void) {
+    const float frames_per_1024 = (float)REACTIVE_STFT_SIZE / REACTIVE_STFT_HOP;
+    CHECK(fabsf(powf(reactive_stft_rescale(0.5f), frames_per_1024) - 0.5f) < 1e-4f);
+    CHECK(fabsf(powf(reactive_stft_rescale(0.85f), frames_per_1024) - 0.85f) < 1e-4f);
+    CHECK(reactive_stft_rescale(0.6f) > 0.6f && reactive_stft_rescale(0.6f) < 1.0f);
+}
+
+int main(void) {
+    test_real_fft();
+    test_frame_cadence();
+    test_bands();
+    test_onsets();
+    test_rescale();
+
+    printf("reactive_audio: %d/%d checks passed\n", checks - failures, checks);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+/* Tests for the NVML telemetry backend (src/shader/reactive_nvml.c), run
+ * against tests/stub_nvml.c built as a shared library; its path is the
+ * first argument.
+ *
+ * Coverage:
+ *   1. Readings are normalised: utilisation, VRAM fraction, temperature,
+ *      power draw over the enforced limit.
+ *   2. A GPU without power readings still samples, with power 0.
+ *   3. A lost GPU fails the sample; close shuts NVML down again.
+ *   4. A missing library, a driver that fails to initialise and a device
+ *      index that does not exist all fail to open, without leaking a session.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <dlfcn.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../src/shader/reactive_nvml.h"
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        checks++;                                                              \
+        if (!(cond)) {                                                         \
+            failures++;                                                        \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+        }                                                                      \
+    } while (0)
+
+static void (*stub_set)(unsigned, unsigned long long, unsigned long long, unsigned, unsigned,
+                        unsigned);
+static void (*stub_fail)(bool, bool);
+static int (*stub_inits)(void);
+static int (*stub_calls)(void);
+
+static bool load_stub(const char *path) {
+    /* Kept open for the whole run, so the backend's dlopen gets the same
+     * instance and its state. */
+    void *lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!lib) return false;
+    void *p;
+    if (!(p = dlsym(lib, "nvml_stub_set"))) return false;
+    memcpy(&stub_set, &p, sizeof(p));
+    if (!(p = dlsym(lib, "nvml_stub_fail"))) return false;
+    memcpy(&stub_fail, &p, sizeof(p));
+    if (!(p = dlsym(lib, "nvml_stub_inits"))) return false;
+    memcpy(&stub_inits, &p, sizeof(p));
+    if (!(p = dlsym(lib, "nvml_stub_calls"))) return false;
+    memcpy(&stub_calls, &p, sizeof(p));
+    return true;
+}
+
+static void test_sample(const char *path) {
+    stub_set(37, 3ull << 30, 12ull << 30, 64, 90000, 180000);
+    struct reactive_nvml *nv = reactive_nvml_open(path, 0);
+    CHECK(nv != NULL);
+    CHECK(stub_inits() == 1);
+
+    reactive_nvml_sample_t s;
+    CHECK(reactive_nvml_sample(nv, &s));
+    CHECK(fabsf(s.util - 0.37f) < 1e-6f);
+    CHECK(fabsf(s.vram - 0.25f) < 1e-6f);
+    CHECK(s.temp_c == 64.0f);
+    CHECK(fabsf(s.power - 0.5f) < 1e-6f);
+
+    /* readings follow the device, and clamp */
+    stub_set(100, 12ull << 30, 12ull << 30, 91, 250000, 180000);
+    CHECK(reactive_nvml_sample(nv, &s));
+    CHECK(s.util == 1.0f && s.vram == 1.0f && s.temp_c == 91.0f && s.power == 1.0f);
+
+    /* no power readings (common on laptops): the rest still samples */
+    stub_set(5, 1ull << 30, 4ull << 30, 40, 0, 0);
+    CHECK(reactive_nvml_sample(nv, &s));
+    CHECK(fabsf(s.util - 0.05f) < 1e-6f && s.power == 0.0f && s.temp_c == 40.0f);
+
+    /* the GPU falls off the bus */
+    stub_fail(false, true);
+    CHECK(!reactive_nvml_sample(nv, &s));
+    CHECK(s.util == 0.0f && s.temp_c == 0.0f);
+    stub_fail(false, false);
+
+    /* one sample is a handful of calls, not a process */
+    stub_set(50, 1ull << 30, 4ull << 30, 50, 100000, 200000);
+    int before = stub_calls();
+    reactive_nvml_sample(nv, &s);
+    CHECK(stub_calls() - before == 5);
+
+    reactive_nvml_close(nv);
+    CHECK(stub_inits() == 0);
+}
+
+static void test_open_failures(const char *path) {
+    CHECK(reactive_nvml_open("/nonexistent/libnvidia-ml.so.1", 0) == NULL);
+
+    stub_fail(true, false);
+    CHECK(reactive_nvml_open(path, 0) == NULL);
+    stub_fail(false, false);
+
+    /* no such GPU: NVML was initialised, so it must be shut down again */
+    CHECK(reactive_nvml_open(path, 3) == NULL);
+    CHECK(stub_inits() == 0);
+
+    reactive_nvml_close(NULL);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2 || !load_stub(argv[1])) {
+        fprintf(stderr, "usage: %s /path/to/stub_nvml.so (%s)\n", argv[0], dlerror());
+        return 1;
+    }
+
+    test_sample(argv[1]);
+    test_open_failures(argv[1]);
+
+    printf("reactive_nvml: %d/%d checks passed\n", checks - failures, checks);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+/* Contention stress test for the reactive snapshot seqlock
+ * (src/shader/reactive_seqlock.h). Meant to be run under ThreadSanitizer
+ * (meson configure -Db_sanitize=thread) as well as plainly.
+ *
+ * Mirrors how reactive.c uses it:
+ *   - "hot": a few hundred bytes written by three threads serialised by one
+ *     mutex (sampler, audio, NVIDIA), read lock-free by several readers;
+ *   - "cold": 4 KB with a single unserialised writer (the audio thread).
+ *
+ * Every payload a writer publishes is self-describing: all words carry the
+ * same generation value, plus a checksum. A reader that ever sees a mix of
+ * generations, a bad checksum, or a generation going backwards has observed
+ * a torn or reordered read.
+ */
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../src/shader/reactive_seqlock.h"
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        checks++;                                                              \
+        if (!(cond)) {                                                         \
+            failures++;                                                        \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+        }                                                                      \
+    } while (0)
+
+#define HOT_FLOATS 70     /* ~ sizeof(reactive_snapshot_t) / 4 */
+#define COLD_FLOATS 1025  /* frame + 2 x 512 rows */
+#define HOT_WRITERS 3
+#define READERS 4
+#define WRITES_PER_WRITER 4000
+
+typedef struct {
+    uint32_t gen;
+    uint32_t v[HOT_FLOATS];
+    uint32_t sum;
+    uint8_t tail[3]; /* odd size: exercises the partial last word */
+} hot_t;
+
+typedef struct {
+    uint32_t gen;
+    uint32_t v[COLD_FLOATS];
+    uint32_t sum;
+} cold_t;
+
+static REACTIVE_SEQLOCK(REACTIVE_SEQLOCK_WORDS(sizeof(hot_t))) g_hot;
+static REACTIVE_SEQLOCK(REACTIVE_SEQLOCK_WORDS(sizeof(cold_t))) g_cold;
+static pthread_mutex_t g_writer_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t g_hot_gen; /* protected by g_writer_lock */
+static atomic_bool g_done;
+
+static atomic_int g_bad_hot, g_bad_cold, g_backwards;
+static atomic_long g_reads;
+
+static void fill_hot(hot_t *h, uint32_t gen) {
+    memset(h, 0, sizeof(*h));
+    h->gen = gen;
+    h->sum = 0;
+    for (int i = 0; i < HOT_FLOATS; i++) {
+        h->v[i] = gen * 2654435761u + (uint32_t)i;
+        h->sum ^= h->v[i];
+    }
+    h->tail[0] = h->tail[1] = h->tail[2] = (uint8_t)gen;
+}
+
+static bool hot_ok(const hot_t *h) {
+    uint32_t sum = 0;
+    for (int i = 0; i < HOT_FLOATS; i++) {
+        if (h->v[i] != h->gen * 2654435761u + (uint32_t)i) return false;
+        sum ^= h->v[i];
+    }
+    return sum == h->sum && h->tail[0] == (uint8_t)h->gen && h->tail[2] == (uint8_t)h->gen;
+}
+
+static void fill_cold(cold_t *c, uint32_t gen) {
+    c->gen = gen;
+    c->sum = 0;
+    for (int i = 0; i < COLD_FLOATS; i++) {
+        c->v[i] = gen ^ ((uint32_t)i << 16);
+        c->sum += c->v[i];
+    }
+}
+
+static bool cold_ok(const cold_t *c) {
+    uint32_t sum = 0;
+    for (int i = 0; i < COLD_FLOATS; i++) {
+        if (c->v[i] != (c->gen ^ ((uint32_t)i << 16))) return false;
+        sum += c->v[i];
+    }
+    return sum == c->sum;
+}
+
+static void *hot_writer(void *arg) {
+    (void)arg;
+    hot_t h;
+    for (int i = 0; i < WRITES_PER_WRITER; i++) {
+        pthread_mutex_lock(&g_writer_lock);
+        fill_hot(&h, ++g_hot_gen);
+        reactive_seqlock_write(&g_hot.seq, g_hot.words, &h, sizeof(h));
+        pthread_mutex_unlock(&g_writer_lock);
+    }
+    return NULL;
+}
+
+static void *cold_writer(void *arg) {
+    (void)arg;
+    static cold_t c; /* 4 KB: keep it off the thread stack */
+    for (uint32_t gen = 1; gen <= WRITES_PER_WRITER; gen++) {
+        fill_cold(&c, gen);
+        reactive_seqlock_write(&g_cold.seq, g_cold.words, &c, sizeof(c));
+    }
+    return NULL;
+}
+
+static void *reader(void *arg) {
+    (void)arg;
+    hot_t h;
+    static _Thread_local cold_t c;
+    uint32_t last_hot = 0, last_cold = 0;
+    unsigned last_seq = 0;
+    long n = 0;
+    while (!atomic_load(&g_done)) {
+        unsigned seq = reactive_seqlock_read(&g_hot.seq, g_hot.words, &h, sizeof(h));
+        if (seq & 1u) atomic_fetch_add(&g_bad_hot, 1);
+        if (seq != 0 && !hot_ok(&h)) atomic_fetch_add(&g_bad_hot, 1);
+        if (h.gen < last_hot || seq < last_seq) atomic_fetch_add(&g_backwards, 1);
+        last_hot = h.gen;
+        last_seq = seq;
+
+        seq = reactive_seqlock_read(&g_cold.seq, g_cold.words, &c, sizeof(c));
+        if (seq != 0 && !cold_ok(&c)) atomic_fetch_add(&g_bad_cold, 1);
+        if (c.gen < last_cold) atomic_fetch_add(&g_backwards, 1);
+        last_cold = c.gen;
+        n++;
+    }
+    atomic_fetch_add(&g_reads, n);
+    return NULL;
+}
+
+static void test_single_thread(void) {
+    hot_t in, out;
+    fill_hot(&in, 7);
+    CHECK(reactive_seqlock_read(&g_hot.seq, g_hot.words, &out, sizeof(out)) == 0);
+    reactive_seqlock_write(&g_hot.seq, g_hot.words, &in, sizeof(in));
+    CHECK(reactive_seqlock_read(&g_hot.seq, g_hot.words, &out, sizeof(out)) == 2);
+    CHECK(memcmp(&in, &out, sizeof(in)) == 0);
+    CHECK(REACTIVE_SEQLOCK_WORDS(1) == 1 && REACTIVE_SEQLOCK_WORDS(4) == 1);
+    CHECK(REACTIVE_SEQLOCK_WORDS(5) == 2);
+
+    /* start the stress run from a clean, consistent state */
+    memset(&g_hot, 0, sizeof(g_hot));
+}
+
+static void test_contention(void) {
+    pthread_t w[HOT_WRITERS], cw, r[READERS];
+    for (int i = 0; i < READERS; i++) pthread_create(&r[i], NULL, reader, NULL);
+    for (int i = 0; i < HOT_WRITERS; i++) pthread_create(&w[i], NULL, hot_writer, NULL);
+    pthread_create(&cw, NULL, cold_writer, NULL);
+
+    for (int i = 0; i < HOT_WRITERS; i++) pthread_join(w[i], NULL);
+    pthread_join(cw, NULL);
+    atomic_store(&g_done, true);
+    for (int i = 0; i < READERS; i++) pthread_join(r[i], NULL);
+
+    CHECK(atomic_load(&g_bad_hot) == 0);
+    CHECK(atomic_load(&g_bad_cold) == 0);
+    CHECK(atomic_load(&g_backwards) == 0);
+    CHECK(atomic_load(&g_reads) > 0);
+
+    /* final state is the last publish of each */
+    hot_t h;
+    static cold_t final_cold;
+    cold_t *c = &final_cold;
+    CHECK(reactive_seqlock_read(&g_hot.seq, g_hot.words, &h, sizeof(h)) ==
+          2u * HOT_WRITERS * WRITES_PER_WRITER);
+    CHECK(h.gen == (uint32_t)HOT_WRITERS * WRITES_PER_WRITER && hot_ok(&h));
+    reactive_seqlock_read(&g_cold.seq, g_cold.words, c, sizeof(*c));
+    CHECK(c->gen == WRITES_PER_WRITER && cold_ok(c));
+}
+
+int main(void) {
+    test_single_thread();
+    test_contention();
+
+    printf("reactive_seqlock: %d/%d checks passed\n", checks - failures, checks);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,447 @@
+/* Unit tests for the reactive system sampler (reactive_sys.c).
+ *
+ * Runs the real sampler thread against a fake /proc + /sys tree under a
+ * temporary root, so the values are known and nothing depends on the host:
+ *
+ *   1. Parsed values: CPU deltas (aggregate + per core), RAM/swap, load,
+ *      uptime, battery, hwmon CPU/GPU temps, amdgpu busy, net/disk rates.
+ *   2. Cadence: fast ticks at the configured period, slow refreshes at theirs,
+ *      and the first tick is a slow one.
+ *   3. Missing files leave defaults (desktop battery) and still publish.
+ *   4. reactive_sys_stop() wakes a sleeping sampler promptly.
+ *   5. reactive_sys_merge() copies only the sampler-owned fields.
+ *   6. Hot-plug: the sampler keeps its files open, so a battery or hwmon chip
+ *      that disappears and reappears elsewhere must be rediscovered.
+ *   7. Demand: only the requested signal groups are sampled, and adding a
+ *      group samples it at once instead of at the next deadline.
+ *
+ * The fake files are rewritten in place (not replaced by rename) because
+ * the sampler reads through descriptors it opened once, as it does with the
+ * real procfs/sysfs files whose inodes never change.
+ */
+#define _DEFAULT_SOURCE /* mkdtemp */
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../src/shader/reactive_sys.h"
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        checks++;                                                              \
+        if (!(cond)) {                                                         \
+            failures++;                                                        \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+        }                                                                      \
+    } while (0)
+
+#define NEAR(a, b, eps) (fabs((double)(a) - (double)(b)) <= (eps))
+
+static char g_root[64];
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void sleep_sec(double s) {
+    struct timespec ts = {(time_t)s, (long)((s - (double)(time_t)s) * 1e9)};
+    nanosleep(&ts, NULL);
+}
+
+/* mkdir -p for the directory part of root-relative `rel` */
+static void make_parents(const char *rel) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s%s", g_root, rel);
+    for (char *p = path + strlen(g_root) + 1; *p; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            mkdir(path, 0755);
+            *p = '/';
+        }
+    }
+}
+
+/* Rewrite a fake file in place (same inode). Only called while the sampler
+ * is stopped or from its own publish callback, so it never sees a torn
+ * write. */
+static void put(const char *rel, const char *content) {
+    make_parents(rel);
+    char path[512];
+    snprintf(path, sizeof(path), "%s%s", g_root, rel);
+    FILE *f = fopen(path, "w");
+    if (!f) return;
+    fputs(content, f);
+    fclose(f);
+}
+
+static void del(const char *rel) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s%s", g_root, rel);
+    if (unlink(path) != 0) rmdir(path);
+}
+
+static const char *NET_HDR =
+    "Inter-|   Receive                                                |  Transmit\n"
+    " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets\n";
+
+static void build_tree(void) {
+    put("/proc/stat",
+        "cpu  100 0 100 800 0 0 0 0 0 0\n"
+        "cpu0 50 0 50 400 0 0 0 0 0 0\n"
+        "cpu1 50 0 50 400 0 0 0 0 0 0\n"
+        "intr 12345\n");
+    put("/proc/meminfo",
+        "MemTotal:        8388608 kB\n"
+        "MemFree:          100000 kB\n"
+        "MemAvailable:    2097152 kB\n"
+        "SwapTotal:          1000 kB\n"
+        "SwapFree:            250 kB\n");
+    char net[512];
+    snprintf(net, sizeof(net), "%s"
+             "    lo: 999999 0 0 0 0 0 0 0 999999 0 0 0 0 0 0 0\n"
+             "  eth0: 1000000 0 0 0 0 0 0 0 500000 0 0 0 0 0 0 0\n", NET_HDR);
+    put("/proc/net/dev", net);
+    put("/proc/diskstats",
+        "   8       0 sda 10 0 1000 0 10 0 2000 0 0 0 0\n"
+        "   8       1 sda1 10 0 777 0 10 0 777 0 0 0 0\n");
+    put("/proc/loadavg", "2.00 1.00 0.50 3/200 999\n");
+    put("/proc/uptime", "7200.50 100.00\n");
+    put("/sys/class/power_supply/BAT0/capacity", "57\n");
+    put("/sys/class/power_supply/BAT0/status", "Discharging\n");
+    put("/sys/class/hwmon/hwmon0/name", "k10temp\n");
+    put("/sys/class/hwmon/hwmon0/temp1_input", "55000\n");
+    put("/sys/class/hwmon/hwmon0/temp2_input", "61000\n");
+    put("/sys/class/hwmon/hwmon1/name", "amdgpu\n");
+    put("/sys/class/hwmon/hwmon1/temp1_input", "70000\n");
+    put("/sys/class/drm/card0/device/gpu_busy_percent", "40\n");
+}
+
+/* Second generation of the counters, written from the first publish. */
+static void advance_tree(void) {
+    put("/proc/stat",
+        "cpu  200 0 200 1400 0 0 0 0 0 0\n"
+        "cpu0 100 0 100 700 0 0 0 0 0 0\n"
+        "cpu1 200 0 200 500 0 0 0 0 0 0\n"
+        "intr 12345\n");
+    char net[512];
+    snprintf(net, sizeof(net), "%s"
+             "    lo: 9999999 0 0 0 0 0 0 0 9999999 0 0 0 0 0 0 0\n"
+             "  eth0: 3000000 0 0 0 0 0 0 0 1500000 0 0 0 0 0 0 0\n", NET_HDR);
+    put("/proc/net/dev", net);
+    put("/proc/diskstats",
+        "   8       0 sda 10 0 3000 0 10 0 2000 0 0 0 0\n"
+        "   8       1 sda1 10 0 99999 0 10 0 99999 0 0 0 0\n");
+}
+
+/* ---- publish recorder ---- */
+
+#define MAX_TICKS 256
+
+struct recorder {
+    pthread_mutex_t lock;
+    int ticks;
+    int slow_ticks;
+    double t[MAX_TICKS];
+    bool slow[MAX_TICKS];
+    double dt[MAX_TICKS];
+    reactive_snapshot_t snap[4]; /* first few ticks, for value checks */
+    reactive_snapshot_t last;
+    bool advance;                /* rewrite the counters after tick 0 */
+};
+
+static void record(const reactive_snapshot_t *sys, bool slow, double dt, void *user) {
+    struct recorder *r = user;
+    pthread_mutex_lock(&r->lock);
+    int i = r->ticks;
+    if (i < MAX_TICKS) {
+        r->t[i] = now_sec();
+        r->slow[i] = slow;
+        r->dt[i] = dt;
+    }
+    if (i < 4) r->snap[i] = *sys;
+    r->last = *sys;
+    r->ticks++;
+    if (slow) r->slow_ticks++;
+    pthread_mutex_unlock(&r->lock);
+
+    if (i == 0 && r->advance) advance_tree();
+}
+
+static int wait_ticks(struct recorder *r, int n, double timeout) {
+    double end = now_sec() + timeout;
+    int got;
+    do {
+        pthread_mutex_lock(&r->lock);
+        got = r->ticks;
+        pthread_mutex_unlock(&r->lock);
+        if (got >= n) break;
+        sleep_sec(0.005);
+    } while (now_sec() < end);
+    return got;
+}
+
+static void test_values(void) {
+    build_tree();
+    struct recorder r = {.lock = PTHREAD_MUTEX_INITIALIZER, .advance = true};
+    struct reactive_sys_config cfg = {
+        .root = g_root, .fast_period = 0.05, .slow_period = 10.0,
+        .publish = record, .user = &r,
+    };
+    struct reactive_sys *rs = reactive_sys_start(&cfg);
+    CHECK(rs != NULL);
+    CHECK(wait_ticks(&r, 2, 3.0) >= 2);
+    reactive_sys_stop(rs);
+
+    const reactive_snapshot_t *a = &r.snap[0];
+    const reactive_snapshot_t *b = &r.snap[1];
+
+    /* first tick: no deltas yet, but levels and the slow signals are in */
+    CHECK(r.slow[0] && !r.slow[1]);
+    CHECK(r.dt[0] == 0.0);
+    CHECK(NEAR(a->ram, 0.75, 1e-4));
+    CHECK(NEAR(a->ram_total_gb, 8.0, 1e-4) && NEAR(a->ram_gb, 6.0, 1e-4));
+    CHECK(NEAR(a->swap, 0.75, 1e-4));
+    CHECK(NEAR(a->load_raw, 2.0, 1e-4));
+    CHECK(a->proc_count == 200);
+    CHECK(NEAR(a->uptime_hours, 7200.5 / 3600.0, 1e-4));
+    CHECK(NEAR(a->battery, 0.57, 1e-4) && !a->charging);
+    CHECK(NEAR(a->cpu_temp_c, 61.0, 1e-3));
+    CHECK(NEAR(a->gpu_temp_c, 70.0, 1e-3));
+    CHECK(NEAR(a->gpu, 0.40, 1e-4));
+    CHECK(a->net_down_mbs == 0.0f && a->disk_read == 0.0f);
+
+    /* second tick: deltas over the rewritten counters */
+    CHECK(b->cpu_cores == 2);
+    CHECK(NEAR(b->cpu, 0.25, 1e-4));
+    CHECK(NEAR(b->cpu_per[0], 0.25, 1e-4) && NEAR(b->cpu_per[1], 0.75, 1e-4));
+    CHECK(NEAR(b->cpu_max, 0.75, 1e-4) && NEAR(b->cpu_spread, 0.5, 1e-4));
+    double dt = r.dt[1];
+    CHECK(dt > 0.0);
+    /* eth0 only (lo excluded): +2 MB down, +1 MB up over dt */
+    CHECK(NEAR(b->net_down_mbs, 2.0 / dt, 1e-3 * (2.0 / dt)));
+    CHECK(NEAR(b->net_up_mbs, 1.0 / dt, 1e-3 * (1.0 / dt)));
+    /* sda only (sda1 is a partition): +2000 sectors read, none written */
+    double rbps = 2000.0 * 512.0 / dt;
+    CHECK(NEAR(b->disk_read, log10(1.0 + rbps) / log10(5.0e8), 1e-4));
+    CHECK(b->disk_write == 0.0f);
+    /* slow signals carry over between slow ticks */
+    CHECK(NEAR(b->cpu_temp_c, 61.0, 1e-3));
+}
+
+static void test_cadence(void) {
+    build_tree();
+    struct recorder r = {.lock = PTHREAD_MUTEX_INITIALIZER};
+    struct reactive_sys_config cfg = {
+        .root = g_root, .fast_period = 0.02, .slow_period = 0.1,
+        .publish = record, .user = &r,
+    };
+    double start = now_sec();
+    struct reactive_sys *rs = reactive_sys_start(&cfg);
+    CHECK(rs != NULL);
+    sleep_sec(0.5);
+    reactive_sys_stop(rs);
+    double elapsed = now_sec() - start;
+
+    /* ~25 fast and ~5 slow ticks; wide bounds for loaded machines, tight
+     * enough to catch a per-frame or stalled schedule. */
+    int expect = (int)(elapsed / 0.02);
+    CHECK(r.ticks >= expect / 2 && r.ticks <= expect + 2);
+    CHECK(r.slow_ticks >= 2 && r.slow_ticks <= (int)(elapsed / 0.1) + 2);
+    CHECK(r.slow[0]);
+
+    /* never ahead of the fixed-period schedule (a late tick may be followed
+     * by a shorter gap, but never by a catch-up burst), and slow refreshes
+     * never closer than their period */
+    bool fast_ok = true, slow_ok = true;
+    double last_slow = -1.0;
+    int n = r.ticks < MAX_TICKS ? r.ticks : MAX_TICKS;
+    for (int i = 1; i < n; i++) {
+        if (r.t[i] - r.t[0] < i * 0.02 - 0.005) fast_ok = false;
+    }
+    for (int i = 0; i < n; i++) {
+        if (!r.slow[i]) continue;
+        if (last_slow >= 0.0 && r.t[i] - last_slow < 0.08) slow_ok = false;
+        last_slow = r.t[i];
+    }
+    CHECK(fast_ok);
+    CHECK(slow_ok);
+}
+
+static void test_missing_root(void) {
+    struct recorder r = {.lock = PTHREAD_MUTEX_INITIALIZER};
+    struct reactive_sys_config cfg = {
+        .root = "/nonexistent/neowall-reactive", .fast_period = 0.02,
+        .publish = record, .user = &r,
+    };
+    struct reactive_sys *rs = reactive_sys_start(&cfg);
+    CHECK(rs != NULL);
+    CHECK(wait_ticks(&r, 1, 3.0) >= 1);
+    reactive_sys_stop(rs);
+    CHECK(r.snap[0].battery == 1.0f && r.snap[0].charging);
+    CHECK(r.snap[0].cpu == 0.0f && r.snap[0].cpu_cores == 0);
+    CHECK(r.snap[0].ram_total_gb == 0.0f && r.snap[0].cpu_temp_c == 0.0f);
+}
+
+static void test_prompt_stop(void) {
+    struct recorder r = {.lock = PTHREAD_MUTEX_INITIALIZER};
+    struct reactive_sys_config cfg = {
+        .root = g_root, .fast_period = 30.0, .publish = record, .user = &r,
+    };
+    struct reactive_sys *rs = reactive_sys_start(&cfg);
+    CHECK(wait_ticks(&r, 1, 3.0) == 1);
+    double t0 = now_sec();
+    reactive_sys_stop(rs);
+    CHECK(now_sec() - t0 < 0.5);
+    CHECK(r.ticks == 1);
+    reactive_sys_stop(NULL);
+}
+
+/* Poll the latest published snapshot until `pred` holds or time runs out. */
+static bool wait_for(struct recorder *r, bool (*pred)(const reactive_snapshot_t *), double timeout) {
+    double end = now_sec() + timeout;
+    do {
+        pthread_mutex_lock(&r->lock);
+        bool ok = pred(&r->last);
+        pthread_mutex_unlock(&r->lock);
+        if (ok) return true;
+        sleep_sec(0.01);
+    } while (now_sec() < end);
+    return false;
+}
+
+static bool on_bat0(const reactive_snapshot_t *s) { return NEAR(s->battery, 0.57, 1e-4); }
+static bool on_bat1(const reactive_snapshot_t *s) {
+    return NEAR(s->battery, 0.33, 1e-4) && s->charging;
+}
+static bool on_ac(const reactive_snapshot_t *s) { return s->battery == 1.0f && s->charging; }
+static bool new_hwmon(const reactive_snapshot_t *s) { return NEAR(s->cpu_temp_c, 48.0, 1e-3); }
+static bool new_gpu(const reactive_snapshot_t *s) { return NEAR(s->gpu_temp_c, 75.0, 1e-3); }
+
+static void test_hotplug(void) {
+    build_tree();
+    struct recorder r = {.lock = PTHREAD_MUTEX_INITIALIZER};
+    struct reactive_sys_config cfg = {
+        .root = g_root, .fast_period = 0.01, .slow_period = 0.03,
+        .publish = record, .user = &r,
+    };
+    struct reactive_sys *rs = reactive_sys_start(&cfg);
+    CHECK(wait_for(&r, on_bat0, 3.0));
+
+    /* BAT0 pulled, BAT1 appears */
+    del("/sys/class/power_supply/BAT0/capacity");
+    del("/sys/class/power_supply/BAT0/status");
+    del("/sys/class/power_supply/BAT0");
+    put("/sys/class/power_supply/BAT1/status", "Charging\n");
+    put("/sys/class/power_supply/BAT1/capacity", "33\n");
+    CHECK(wait_for(&r, on_bat1, 3.0));
+
+    /* ...and goes away too: back to the desktop default */
+    del("/sys/class/power_supply/BAT1/capacity");
+    del("/sys/class/power_supply/BAT1/status");
+    del("/sys/class/power_supply/BAT1");
+    CHECK(wait_for(&r, on_ac, 3.0));
+
+    /* the CPU sensor chip is re-probed under a new hwmon number */
+    del("/sys/class/hwmon/hwmon0/name");
+    del("/sys/class/hwmon/hwmon0/temp1_input");
+    del("/sys/class/hwmon/hwmon0/temp2_input");
+    del("/sys/class/hwmon/hwmon0");
+    put("/sys/class/hwmon/hwmon5/temp1_input", "48000\n");
+    put("/sys/class/hwmon/hwmon5/name", "k10temp\n");
+    CHECK(wait_for(&r, new_hwmon, 3.0));
+
+    /* a GPU sensor value changing in place is seen without reopening */
+    put("/sys/class/hwmon/hwmon1/temp1_input", "75000\n");
+    CHECK(wait_for(&r, new_gpu, 3.0));
+
+    reactive_sys_stop(rs);
+    del("/sys/class/hwmon/hwmon5/name");
+    del("/sys/class/hwmon/hwmon5/temp1_input");
+    del("/sys/class/hwmon/hwmon5");
+}
+
+static void test_signal_mask(void) {
+    build_tree();
+    struct recorder r = {.lock = PTHREAD_MUTEX_INITIALIZER};
+    struct reactive_sys_config cfg = {
+        .root = g_root, .fast_period = 30.0, .signals = REACTIVE_SIG_INPUT,
+        .publish = record, .user = &r,
+    };
+    struct reactive_sys *rs = reactive_sys_start(&cfg);
+    CHECK(wait_ticks(&r, 1, 3.0) == 1);
+    /* nothing sampled: every field still at its default */
+    CHECK(r.snap[0].cpu_cores == 0 && r.snap[0].ram_total_gb == 0.0f);
+    CHECK(r.snap[0].battery == 1.0f && r.snap[0].cpu_temp_c == 0.0f);
+    CHECK(r.snap[0].time_of_day == 0.0f && r.snap[0].proc_count == 0);
+
+    /* adding groups ticks now (the 30 s deadline is far away), as a slow tick */
+    reactive_sys_set_signals(rs, REACTIVE_SIG_CPU | REACTIVE_SIG_CPU_TEMP);
+    CHECK(wait_ticks(&r, 2, 3.0) == 2);
+    CHECK(r.slow[1]);
+    CHECK(r.snap[1].cpu_cores == 2 && NEAR(r.snap[1].cpu_temp_c, 61.0, 1e-3));
+    CHECK(r.snap[1].ram_total_gb == 0.0f && r.snap[1].battery == 1.0f);
+    CHECK(r.snap[1].gpu == 0.0f && r.snap[1].gpu_temp_c == 0.0f);
+
+    /* dropping groups does not wake the sampler */
+    reactive_sys_set_signals(rs, REACTIVE_SIG_CPU);
+    CHECK(wait_ticks(&r, 3, 0.1) == 2);
+    reactive_sys_stop(rs);
+}
+
+static void test_merge(void) {
+    reactive_snapshot_t src, dst;
+    memset(&src, 0, sizeof(src));
+    memset(&dst, 0, sizeof(dst));
+    src.cpu = 0.5f;
+    src.cpu_per[7] = 0.9f;
+    src.battery = 0.3f;
+    src.gpu_temp_c = 80.0f;
+    src.audio_level = 0.7f;
+    src.nv_gpu = 0.7f;
+    src.key_energy = 0.7f;
+    src.pulse = 0.7f;
+    dst.audio_level = 0.1f;
+    dst.nv_gpu = 0.1f;
+    dst.key_energy = 0.1f;
+    dst.pulse = 0.1f;
+    reactive_sys_merge(&dst, &src);
+    CHECK(dst.cpu == 0.5f && dst.cpu_per[7] == 0.9f);
+    CHECK(dst.battery == 0.3f && dst.gpu_temp_c == 80.0f);
+    CHECK(dst.audio_level == 0.1f && dst.nv_gpu == 0.1f);
+    CHECK(dst.key_energy == 0.1f && dst.pulse == 0.1f);
+}
+
+int main(void) {
+    snprintf(g_root, sizeof(g_root), "/tmp/neowall-reactive-XXXXXX");
+    if (!mkdtemp(g_root)) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    test_values();
+    test_cadence();
+    test_missing_root();
+    test_prompt_stop();
+    test_merge();
+    test_hotplug();
+    test_signal_mask();
+
+    char cmd[128];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", g_root);
+    if (system(cmd) != 0) {
+        fprintf(stderr, "warning: could not remove %s\n", g_root);
+    }
+
+    printf("reactive_sys: %d/%d checks passed\n", checks - failures, checks);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,238 @@
+/* Tests for reactive traces (src/shader/reactive_trace.c).
+ *
+ * Coverage:
+ *   1. Snapshots round-trip exactly and are looked up by time: before the
+ *      first, between records, after the last.
+ *   2. Only changed words are stored: a repeated snapshot costs nothing and
+ *      one changed field costs a few bytes.
+ *   3. Audio frames round-trip to 8 bits, snapshots report how many frames
+ *      preceded them, and the smoothed rows depend only on the frame.
+ *   4. A trace cut short mid-record still loads up to the cut; bad magic,
+ *      a foreign snapshot size and a missing file do not.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../src/shader/reactive_trace.h"
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        checks++;                                                              \
+        if (!(cond)) {                                                         \
+            failures++;                                                        \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+        }                                                                      \
+    } while (0)
+
+static char g_dir[] = "/tmp/nw_trace_XXXXXX";
+
+static long file_size(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (long)st.st_size : -1;
+}
+
+static void test_snapshots(void) {
+    char path[64];
+    snprintf(path, sizeof(path), "%s/snap.nwrt", g_dir);
+    struct reactive_trace_writer *w = reactive_trace_writer_open(path);
+    CHECK(w != NULL);
+
+    reactive_snapshot_t a = {0};
+    a.battery = 1.0f;
+    a.charging = true;
+    a.cpu = 0.25f;
+    a.cpu_cores = 4;
+    a.cpu_per[3] = 0.75f;
+    reactive_trace_write_snapshot(w, 0.0, &a);
+
+    reactive_snapshot_t b = a;
+    b.cpu = 0.5f;
+    b.net_down_mbs = 12.5f;
+    reactive_trace_write_snapshot(w, 0.25, &b);
+
+    reactive_snapshot_t c = b;
+    c.thermal = 0.9f;
+    c.charging = false;
+    reactive_trace_write_snapshot(w, 1.5, &c);
+    CHECK(reactive_trace_writer_close(w));
+
+    struct reactive_trace *tr = reactive_trace_load(path);
+    CHECK(tr != NULL);
+    if (!tr) return;
+    CHECK(fabs(reactive_trace_duration(tr) - 1.5) < 1e-9);
+    CHECK(reactive_trace_audio_frames(tr) == 0);
+
+    reactive_snapshot_t got;
+    reactive_trace_snapshot_at(tr, -1.0, &got);
+    CHECK(memcmp(&got, &a, sizeof(a)) == 0);
+    reactive_trace_snapshot_at(tr, 0.2499, &got);
+    CHECK(memcmp(&got, &a, sizeof(a)) == 0);
+    reactive_trace_snapshot_at(tr, 0.25, &got);
+    CHECK(memcmp(&got, &b, sizeof(b)) == 0);
+    reactive_trace_snapshot_at(tr, 1.0, &got);
+    CHECK(got.cpu == 0.5f && got.net_down_mbs == 12.5f && got.cpu_per[3] == 0.75f);
+    reactive_trace_snapshot_at(tr, 100.0, &got);
+    CHECK(memcmp(&got, &c, sizeof(c)) == 0);
+    reactive_trace_free(tr);
+}
+
+static void test_compact(void) {
+    char path[64];
+    snprintf(path, sizeof(path), "%s/compact.nwrt", g_dir);
+    struct reactive_trace_writer *w = reactive_trace_writer_open(path);
+    reactive_snapshot_t s = {0};
+    s.battery = 1.0f;
+    reactive_trace_write_snapshot(w, 0.0, &s);
+    CHECK(reactive_trace_writer_close(w));
+    long one = file_size(path);
+
+    w = reactive_trace_writer_open(path);
+    reactive_trace_write_snapshot(w, 0.0, &s);
+    for (int i = 1; i <= 100; i++) reactive_trace_write_snapshot(w, i * 0.01, &s);
+    CHECK(reactive_trace_writer_close(w));
+    CHECK(file_size(path) == one); /* unchanged snapshots are not written */
+
+    w = reactive_trace_writer_open(path);
+    reactive_trace_write_snapshot(w, 0.0, &s);
+    for (int i = 1; i <= 100; i++) {
+        s.audio_level = i / 100.0f;
+        reactive_trace_write_snapshot(w, i * 0.01, &s);
+    }
+    CHECK(reactive_trace_writer_close(w));
+    /* type + 2-byte delta + bitmap + one word, well under the full struct */
+    long per = (file_size(path) - one) / 100;
+    CHECK(per <= 3 + (long)(sizeof(reactive_snapshot_t) / 32 + 1) + 4);
+
+    struct reactive_trace *tr = reactive_trace_load(path);
+    CHECK(tr != NULL);
+    reactive_snapshot_t got;
+    reactive_trace_snapshot_at(tr, 0.505, &got);
+    CHECK(got.audio_level == 50 / 100.0f && got.battery == 1.0f);
+    reactive_trace_free(tr);
+}
+
+static void test_audio(void) {
+    char path[64];
+    snprintf(path, sizeof(path), "%s/audio.nwrt", g_dir);
+    struct reactive_trace_writer *w = reactive_trace_writer_open(path);
+    static float spec[REACTIVE_AUDIO_BINS], wave[REACTIVE_AUDIO_BINS];
+
+    reactive_snapshot_t s = {0};
+    reactive_trace_write_snapshot(w, 0.0, &s);
+    for (int f = 1; f <= 100; f++) {
+        for (int k = 0; k < REACTIVE_AUDIO_BINS; k++) {
+            spec[k] = (float)((k + f) % 256) / 255.0f;
+            wave[k] = f % 2 ? 1.0f : 0.0f;
+        }
+        double t = f * 0.01;
+        reactive_trace_write_audio(w, t, spec, wave);
+        s.audio_active = true;
+        s.audio_frame = 5000 + (uint32_t)f; /* live numbering is not kept */
+        s.audio_level = f / 100.0f;
+        reactive_trace_write_snapshot(w, t, &s);
+    }
+    CHECK(reactive_trace_writer_close(w));
+
+    struct reactive_trace *tr = reactive_trace_load(path);
+    CHECK(tr != NULL);
+    if (!tr) return;
+    CHECK(reactive_trace_audio_frames(tr) == 100);
+
+    reactive_snapshot_t got;
+    reactive_trace_snapshot_at(tr, 0.0, &got);
+    CHECK(got.audio_frame == 0 && !got.audio_active);
+    reactive_trace_snapshot_at(tr, 0.375, &got);
+    CHECK(got.audio_frame == 37 && got.audio_level == 0.37f);
+
+    float row[REACTIVE_AUDIO_BINS];
+    CHECK(reactive_trace_audio_row(tr, 37, row));
+    CHECK(fabsf(row[10] - (float)(47 % 256) / 255.0f) < 1e-6f);
+    CHECK(!reactive_trace_audio_row(tr, 0, row) && !reactive_trace_audio_row(tr, 101, row));
+
+    /* the smoothed rows are the same however they are reached */
+    static reactive_audio_t a1, a2;
+    reactive_trace_audio(tr, 90, 0.77f, &a1);
+    reactive_trace_audio(tr, 3, 0.77f, &a2);
+    reactive_trace_audio(tr, 90, 0.77f, &a2);
+    CHECK(memcmp(&a1, &a2, sizeof(a1)) == 0);
+    CHECK(a1.frame == 90 && a1.waveform[0] == 0.0f);
+    /* a steady bin converges to its value */
+    float expect = 0.0f;
+    for (int f = 90 - REACTIVE_TRACE_SMOOTH_FRAMES + 1; f <= 90; f++) {
+        expect = expect * 0.77f + (float)((5 + f) % 256) / 255.0f * 0.23f;
+    }
+    CHECK(fabsf(a1.spectrum[5] - expect) < 1e-6f);
+    reactive_trace_audio(tr, 0, 0.77f, &a2);
+    CHECK(a2.frame == 0 && a2.spectrum[5] == 0.0f);
+    reactive_trace_free(tr);
+}
+
+static void test_damaged(void) {
+    char path[64], cut[64];
+    snprintf(path, sizeof(path), "%s/audio.nwrt", g_dir);
+    snprintf(cut, sizeof(cut), "%s/cut.nwrt", g_dir);
+
+    /* cut the audio trace in the middle of a record */
+    long len = file_size(path);
+    FILE *in = fopen(path, "rb");
+    FILE *out = fopen(cut, "wb");
+    for (long i = 0; i < len - 700; i++) fputc(fgetc(in), out);
+    fclose(in);
+    fclose(out);
+    struct reactive_trace *tr = reactive_trace_load(cut);
+    CHECK(tr != NULL);
+    CHECK(tr && reactive_trace_audio_frames(tr) == 99);
+    reactive_trace_free(tr);
+
+    /* foreign layout: patch the snapshot size */
+    FILE *f = fopen(cut, "r+b");
+    fseek(f, 6, SEEK_SET);
+    fputc(0x01, f);
+    fputc(0x01, f);
+    fclose(f);
+    CHECK(reactive_trace_load(cut) == NULL);
+
+    f = fopen(cut, "wb");
+    fputs("RIFF not a trace", f);
+    fclose(f);
+    CHECK(reactive_trace_load(cut) == NULL);
+
+    /* a header with no snapshot */
+    f = fopen(cut, "wb");
+    fclose(f);
+    struct reactive_trace_writer *w = reactive_trace_writer_open(cut);
+    CHECK(reactive_trace_writer_close(w));
+    CHECK(reactive_trace_load(cut) == NULL);
+
+    snprintf(cut, sizeof(cut), "%s/missing.nwrt", g_dir);
+    CHECK(reactive_trace_load(cut) == NULL);
+}
+
+int main(void) {
+    if (!mkdtemp(g_dir)) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    test_snapshots();
+    test_compact();
+    test_audio();
+    test_damaged();
+
+    char cmd[96];
+    snprintf(cmd, sizeof(cmd), "rm -rf %s", g_dir);
+    if (system(cmd) != 0) fprintf(stderr, "warning: could not remove %s\n", g_dir);
+
+    printf("reactive_trace: %d/%d checks passed\n", checks - failures, checks);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,170 @@
+/* Unit tests for the compressed scrollback (src/terminal/scrollback.c).
+ *
+ *   1. Rows survive the round trip exactly: default, indexed, rgb and attr
+ *      styles, wide pairs, blanks inside a row, long repeats, astral code
+ *      points, trailing default blanks, decoding narrower and wider.
+ *   2. Lines come back newest first and the line budget drops the oldest.
+ *   3. 100k ASCII log lines on a 200-column grid fit in a few MB.
+ *   4. The byte budget bounds memory and keeps the newest lines.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "../src/terminal/scrollback.h"
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        checks++;                                                              \
+        if (!(cond)) {                                                         \
+            failures++;                                                        \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+        }                                                                      \
+    } while (0)
+
+#define COLS 200
+
+static const term_color DEF = {.kind = TERM_COLOR_DEFAULT};
+
+static bool color_same(term_color a, term_color b) {
+    if (a.kind != b.kind) return false;
+    if (a.kind == TERM_COLOR_INDEXED) return a.idx == b.idx;
+    if (a.kind == TERM_COLOR_RGB) return a.r == b.r && a.g == b.g && a.b == b.b;
+    return true;
+}
+
+static bool rows_same(const term_cell *a, const term_cell *b, int n) {
+    for (int x = 0; x < n; x++) {
+        if (a[x].cp != b[x].cp || a[x].attr != b[x].attr ||
+            !color_same(a[x].fg, b[x].fg) || !color_same(a[x].bg, b[x].bg))
+            return false;
+    }
+    return true;
+}
+
+static void blank_row(term_cell *row, int n) {
+    for (int x = 0; x < n; x++) row[x] = (term_cell){.fg = DEF, .bg = DEF};
+}
+
+static void put_text(term_cell *row, int x, const char *s, term_color fg, term_color bg,
+                     uint16_t attr) {
+    for (; *s; s++, x++) row[x] = (term_cell){.cp = (uint8_t)*s, .fg = fg, .bg = bg, .attr = attr};
+}
+
+static void test_round_trip(void) {
+    term_scrollback *sb = term_scrollback_create(16, 0);
+    CHECK(sb != NULL);
+    CHECK(term_scrollback_create(0, 0) == NULL);
+
+    term_cell rows[4][COLS], out[COLS + 10];
+    term_color red = {.kind = TERM_COLOR_INDEXED, .idx = 1};
+    term_color rgb = {.kind = TERM_COLOR_RGB, .r = 10, .g = 200, .b = 30};
+
+    blank_row(rows[0], COLS);
+    put_text(rows[0], 0, "2026-10-18 12:00:01 INFO request served", DEF, DEF, 0);
+
+    blank_row(rows[1], COLS);
+    put_text(rows[1], 0, "ERR", red, DEF, TERM_ATTR_BOLD);
+    put_text(rows[1], 5, "rgb on red", rgb, red, TERM_ATTR_UNDERLINE | TERM_ATTR_ITALIC);
+    rows[1][20] = (term_cell){.cp = 0x4E2D, .fg = DEF, .bg = DEF};
+    rows[1][21] = (term_cell){.cp = 0, .fg = DEF, .bg = DEF, .attr = TERM_ATTR_WIDE_TAIL};
+    rows[1][22] = (term_cell){.cp = 0x1F600, .fg = DEF, .bg = DEF};
+    for (int x = 30; x < 90; x++) rows[1][x] = (term_cell){.cp = '=', .fg = DEF, .bg = rgb};
+
+    /* coloured background to the last column: nothing to trim */
+    for (int x = 0; x < COLS; x++) rows[2][x] = (term_cell){.cp = 0, .fg = DEF, .bg = red};
+    blank_row(rows[3], COLS);
+
+    for (int i = 0; i < 4; i++) CHECK(term_scrollback_push(sb, rows[i], COLS));
+    CHECK(term_scrollback_count(sb) == 4);
+    for (int i = 0; i < 4; i++) {
+        CHECK(term_scrollback_line(sb, (size_t)(3 - i), out, COLS));
+        CHECK(rows_same(out, rows[i], COLS));
+    }
+
+    /* Narrower cuts, wider pads with default blanks. */
+    CHECK(term_scrollback_line(sb, 2, out, 25));
+    CHECK(rows_same(out, rows[1], 25));
+    CHECK(term_scrollback_line(sb, 1, out, COLS + 10));
+    CHECK(rows_same(out, rows[2], COLS));
+    CHECK(out[COLS + 9].cp == 0 && out[COLS + 9].bg.kind == TERM_COLOR_DEFAULT);
+    CHECK(!term_scrollback_line(sb, 4, out, COLS));
+    term_scrollback_destroy(sb);
+}
+
+static void test_line_budget(void) {
+    term_scrollback *sb = term_scrollback_create(1000, 0);
+    term_cell row[COLS], out[COLS];
+    char text[32];
+    for (int i = 0; i < 5000; i++) {
+        blank_row(row, COLS);
+        snprintf(text, sizeof(text), "line %d", i);
+        put_text(row, 0, text, DEF, DEF, 0);
+        term_scrollback_push(sb, row, COLS);
+    }
+    CHECK(term_scrollback_count(sb) == 1000);
+    CHECK(term_scrollback_line(sb, 0, out, COLS));
+    CHECK(out[5].cp == '4' && out[8].cp == '9');           /* "line 4999" */
+    CHECK(term_scrollback_line(sb, 999, out, COLS));
+    CHECK(out[5].cp == '4' && out[6].cp == '0' && out[8].cp == '0'); /* "line 4000" */
+    term_scrollback_destroy(sb);
+}
+
+static void test_compact(void) {
+    term_scrollback *sb = term_scrollback_create(100000, 0);
+    term_cell row[COLS], out[COLS];
+    char text[96];
+    term_color dim = {.kind = TERM_COLOR_INDEXED, .idx = 8};
+    int pushed = 0;
+    for (int i = 0; i < 100000; i++) {
+        blank_row(row, COLS);
+        snprintf(text, sizeof(text), "%06d", i);
+        put_text(row, 0, text, dim, DEF, 0);
+        snprintf(text, sizeof(text), "INFO GET /api/v1/items/%d 200 in %d.%dms from 10.0.%d.%d",
+                 i * 7, i % 97, i % 10, i % 256, (i * 13) % 256);
+        put_text(row, 7, text, DEF, DEF, 0);
+        pushed += term_scrollback_push(sb, row, COLS);
+    }
+    CHECK(pushed == 100000);
+    size_t bytes = term_scrollback_bytes(sb);
+    printf("scrollback: 100000 lines in %zu bytes (%.1f per line, %zu as cells)\n",
+           bytes, (double)bytes / 100000.0, (size_t)100000 * COLS * sizeof(term_cell));
+    CHECK(term_scrollback_count(sb) == 100000);
+    CHECK(bytes < 8u * 1024 * 1024);
+    CHECK(term_scrollback_line(sb, 99999, out, COLS));
+    CHECK(out[0].cp == '0' && out[5].cp == '0' && out[0].fg.kind == TERM_COLOR_INDEXED);
+    CHECK(out[7].cp == 'I' && out[7].fg.kind == TERM_COLOR_DEFAULT);
+    term_scrollback_destroy(sb);
+}
+
+static void test_byte_budget(void) {
+    const size_t budget = 256 * 1024;
+    term_scrollback *sb = term_scrollback_create(1000000, budget);
+    term_cell row[COLS], out[COLS];
+    for (int i = 0; i < 50000; i++) {
+        /* every cell a different rgb colour: the worst case per row */
+        for (int x = 0; x < COLS; x++) {
+            row[x] = (term_cell){.cp = 'a' + (x + i) % 26,
+                                 .fg = {.kind = TERM_COLOR_RGB, .r = (uint8_t)x, .g = (uint8_t)i, .b = 7},
+                                 .bg = DEF};
+        }
+        term_scrollback_push(sb, row, COLS);
+        if (term_scrollback_bytes(sb) > budget) break;
+    }
+    CHECK(term_scrollback_bytes(sb) <= budget);   /* never went over */
+    CHECK(term_scrollback_count(sb) > 10 && term_scrollback_count(sb) < 50000);
+    CHECK(term_scrollback_line(sb, 0, out, COLS));
+    CHECK(rows_same(out, row, COLS));
+    term_scrollback_destroy(sb);
+}
+
+int main(void) {
+    test_round_trip();
+    test_line_budget();
+    test_compact();
+    test_byte_budget();
+    printf("scrollback: %d/%d checks passed\n", checks - failures, checks);
+    return failures ? 1 : 0;
+}
@@ -39,6 +39,21 @@ static void expect_line(term_screen *s, int y, const char *want) {
     }
 }
 
+/* Same, for the row as displayed (history while scrolled back). */
+static void expect_view_line(term_screen *s, int y, const char *want) {
+    g_checks++;
+    const term_cell *r = term_screen_view_row(s, y);
+    char buf[512];
+    int o = 0;
+    for (int x = 0; x < term_screen_cols(s) && o < (int)sizeof(buf) - 1; x++)
+        if (r[x].cp) buf[o++] = r[x].cp < 128 ? (char)r[x].cp : '?';
+    buf[o] = 0;
+    if (strcmp(buf, want) != 0) {
+        printf("  FAIL view row %d: got [%s] want [%s]\n", y, buf, want);
+        g_fails++;
+    }
+}
+
 static void expect(bool cond, const char *what) {
     g_checks++;
     if (!cond) { printf("  FAIL: %s\n", what); g_fails++; }
@@ -181,6 +196,38 @@ int main(void) {
         /* Buffer is empty once drained. */
         n = term_screen_take_reply(s, rep, sizeof(rep));
         expect(n == 0, "reply buffer empty after drain");
+
+        /* DECRQM: apps probe synchronized output before using it. */
+        feed(s, "\x1b[?2026$p");
+        n = term_screen_take_reply(s, rep, sizeof(rep));
+        rep[n] = 0;
+        expect(strcmp(rep, "\x1b[?2026;2$y") == 0, "DECRQM 2026 -> supported, reset");
+        feed(s, "\x1b[?25$p\x1b[?9999$p");
+        n = term_screen_take_reply(s, rep, sizeof(rep));
+        rep[n] = 0;
+        expect(strcmp(rep, "\x1b[?25;1$y\x1b[?9999;0$y") == 0, "DECRQM 25 set, unknown 0");
+    }
+    term_screen_destroy(s);
+
+    /* --- synchronized output (DECSET 2026) --- */
+    s = term_screen_create(20, 4);
+    {
+        uint32_t begun = 99;
+        char rep[64];
+        expect(!term_screen_sync_pending(s, &begun) && begun == 0, "no repaint pending at start");
+        feed(s, "\x1b[?2026h\x1b[Hhalf");
+        expect(term_screen_sync_pending(s, &begun) && begun == 1, "2026 h opens a repaint");
+        feed(s, "\x1b[?2026$p");
+        size_t n = term_screen_take_reply(s, rep, sizeof(rep));
+        rep[n] = 0;
+        expect(strcmp(rep, "\x1b[?2026;1$y") == 0, "DECRQM sees it set");
+        feed(s, "\x1b[?2026h drawn");
+        expect(term_screen_sync_pending(s, &begun) && begun == 1, "a repeated h is the same repaint");
+        feed(s, "\x1b[?2026l");
+        expect(!term_screen_sync_pending(s, NULL), "2026 l ends it");
+        expect_line(s, 0, "half drawn");
+        feed(s, "\x1b[?2026h\x1b" "c");
+        expect(!term_screen_sync_pending(s, &begun) && begun == 2, "RIS ends a repaint");
     }
     term_screen_destroy(s);
 
@@ -238,6 +285,222 @@ int main(void) {
     }
     term_screen_destroy(s);
 
+    /* --- per-row dirty tracking: only the rows a sequence touched are
+     * reported, and taking the set clears it. --- */
+    s = term_screen_create(10, 6);
+    {
+        uint64_t d[TERM_SCREEN_DIRTY_WORDS] = {0};
+        expect(term_screen_take_dirty(s, d, NULL) && d[0] == 0x3Full, "new screen: every row dirty");
+        memset(d, 0, sizeof(d));
+        expect(!term_screen_take_dirty(s, d, NULL) && d[0] == 0, "taking the set clears it");
+
+        feed(s, "\x1b[3;1Hclock\x1b[5;2H\x1b[K");  /* print row 2, erase in row 4 */
+        term_screen_take_dirty(s, d, NULL);
+        expect(d[0] == ((1ull << 2) | (1ull << 4)), "print + EL mark their rows only");
+
+        memset(d, 0, sizeof(d));
+        feed(s, "\x1b[1;1H\x1b[3C\x1b[?25l");        /* cursor motion, DECTCEM */
+        expect(!term_screen_take_dirty(s, d, NULL), "cursor-only changes dirty no row");
+
+        feed(s, "\x1b[2;4r\x1b[4;1H\n");             /* LF at region bottom */
+        term_screen_take_dirty(s, d, NULL);
+        expect(d[0] == 0x0Eull, "region scroll marks exactly the region");
+
+        memset(d, 0, sizeof(d));
+        feed(s, "\x1b[?1049h");
+        term_screen_take_dirty(s, d, NULL);
+        expect(d[0] == 0x3Full, "alternate screen switch marks every row");
+    }
+    term_screen_destroy(s);
+
+    s = term_screen_create(4, 200);
+    {
+        uint64_t d[TERM_SCREEN_DIRTY_WORDS] = {0};
+        term_screen_take_dirty(s, d, NULL);
+        memset(d, 0, sizeof(d));
+        feed(s, "\x1b[130;1HX");
+        term_screen_take_dirty(s, d, NULL);
+        expect(d[0] == 0 && d[1] == 0 && d[2] == (1ull << 1), "rows past 64 use later words");
+    }
+    term_screen_destroy(s);
+
+    /* --- row ring: full-screen scrolls move the ring origin, report the
+     * distance and dirty only the rows they expose; region scrolls rotate
+     * row pointers. The visible grid must read the same either way. --- */
+    s = term_screen_create(8, 4);
+    {
+        uint64_t d[TERM_SCREEN_DIRTY_WORDS] = {0};
+        int sc = 0;
+        feed(s, "a\r\nb\r\nc\r\nd");
+        term_screen_take_dirty(s, d, &sc);
+        feed(s, "\x1b[2;1HB\x1b[4;1H\r\ne\r\nf");   /* touch row 1, scroll twice */
+        term_screen_take_dirty(s, d, &sc);
+        expect_line(s, 0, "c");
+        expect_line(s, 1, "d");
+        expect_line(s, 2, "e");
+        expect_line(s, 3, "f");
+        expect(sc == 2, "full-screen LF scrolls are reported");
+        expect(d[0] == 0x0Cull, "only the exposed rows are dirty; row 1's bit scrolled off");
+
+        feed(s, "\x1b[3;1HX\x1b[1;1H\x1bM");            /* row 2, then RI at the top */
+        term_screen_take_dirty(s, d, &sc);
+        expect_line(s, 0, "");
+        expect_line(s, 1, "c");
+        expect_line(s, 3, "X");
+        expect(sc == -1 && d[0] == 0x09ull, "reverse index scrolls down; dirty bits follow");
+
+        feed(s, "\x1b[2;3r\x1b[3;1H\nR\x1b[r");        /* LF at region bottom */
+        term_screen_take_dirty(s, d, &sc);
+        expect_line(s, 0, "");
+        expect_line(s, 1, "d");
+        expect_line(s, 2, "R");
+        expect_line(s, 3, "X");
+        expect(sc == 0 && d[0] == 0x06ull, "region scroll is not a ring move");
+
+        feed(s, "\x1b[4;1H\x1b[9S");                    /* SU past the height */
+        term_screen_take_dirty(s, d, &sc);
+        expect_line(s, 0, "");
+        expect_line(s, 3, "");
+        expect(sc == 0 && d[0] == 0x0Full, "scrolling everything out dirties every row");
+
+        feed(s, "\x1b[H1\r\n2\r\n3\r\n4\r\n5\r\n6");
+        expect(term_screen_resize(s, 10, 5), "resize a rotated grid");
+        expect_line(s, 0, "3");
+        expect_line(s, 3, "6");
+        expect_line(s, 4, "");
+        char *txt = term_screen_dump_text(s);
+        expect(txt && strcmp(txt, "3\n4\n5\n6\n\n") == 0, "dump_text reads rows in screen order");
+        free(txt);
+        term_screen_take_dirty(s, d, &sc);
+        expect(sc == 0 && d[0] == 0x1Full, "resize drops pending scroll and dirties all");
+    }
+    term_screen_destroy(s);
+
+    /* --- scrollback: rows leaving the top of the primary screen are kept,
+     * the view scrolls back over them and stays put under new output. --- */
+    s = term_screen_create(10, 4);
+    {
+        uint64_t d[TERM_SCREEN_DIRTY_WORDS];
+        int sc = 0;
+        expect(term_screen_scroll_view(s, 5) == 0, "no history: the view stays live");
+        expect(term_screen_set_scrollback(s, 100), "enable scrollback");
+        feed(s, "l0\r\nl1\r\nl2\r\nl3\r\nl4\r\nl5\r\nl6\r\nl7\r\nl8\r\nl9");
+        expect(term_screen_history_lines(s) == 6, "six rows scrolled off the top");
+        feed(s, "\x1b[2;4r\x1b[4;1H\nR\x1b[r");           /* region below the top */
+        expect(term_screen_history_lines(s) == 6, "a region scroll not at the top keeps nothing");
+        term_screen_take_dirty(s, d, &sc);
+
+        expect(term_screen_scroll_view(s, 2) == 2, "scroll back two rows");
+        expect_view_line(s, 0, "l4");
+        expect_view_line(s, 1, "l5");
+        expect_view_line(s, 2, "l6");
+        expect_view_line(s, 3, "l8");
+        expect(term_screen_take_dirty(s, d, &sc) && d[0] == 0x0Full && sc == 0,
+               "moving the view repaints every row");
+
+        feed(s, "\x1b[4;1H\r\nl10");
+        expect(term_screen_view_offset(s) == 3, "output keeps the view on the same lines");
+        expect_view_line(s, 0, "l4");
+        expect_view_line(s, 3, "l8");
+        expect_line(s, 3, "l10");
+        term_screen_take_dirty(s, d, &sc);
+        expect(sc == 0 && d[0] == 0x0Full, "scrolled back: a scroll repaints, no ring move");
+
+        expect(term_screen_scroll_view(s, 1000) == 7, "clamped to the oldest line");
+        expect_view_line(s, 0, "l0");
+        expect(term_screen_scroll_view(s, -1000) == 0, "back to live");
+        expect_view_line(s, 0, "l8");
+
+        term_screen_scroll_view(s, 2);
+        feed(s, "\x1b[?1049h");
+        expect(term_screen_view_offset(s) == 0 && term_screen_scroll_view(s, 2) == 0,
+               "the alternate screen has no history");
+        feed(s, "\x1b[?1049l");
+        expect(term_screen_set_scrollback(s, 0) && term_screen_history_lines(s) == 0,
+               "scrollback off drops the history");
+    }
+    term_screen_destroy(s);
+
+    /* --- printable ASCII runs (vtparse print_run -> one span per row) --- */
+    s = term_screen_create(10, 3);
+    {
+        int cx, cy;
+        feed(s, "abcdefghijklmnopqrstuvwxyz");
+        expect_line(s, 0, "abcdefghij");
+        expect_line(s, 1, "klmnopqrst");
+        expect_line(s, 2, "uvwxyz");
+        term_screen_cursor(s, &cx, &cy);
+        expect(cx == 6 && cy == 2, "run leaves the cursor after its last char");
+
+        feed(s, "\x1b[H\x1b[2J0123456789");
+        term_screen_cursor(s, &cx, &cy);
+        expect(cx == 9 && cy == 0, "a run ending at the edge defers the wrap");
+        feed(s, "X");
+        expect_line(s, 1, "X");
+
+        feed(s, "\x1b[?7l\x1b[3;1H0123456789ABC\x1b[?7h");
+        expect_line(s, 2, "012345678C");
+
+        feed(s, "\x1b[H\x1b[2J\xe4\xb8\xad\r" "a");   /* wide pair, tail under the run */
+        {
+            const term_cell *r = term_screen_row(s, 0);
+            expect(r[0].cp == 'a' && r[1].cp == 0 && !(r[1].attr & TERM_ATTR_WIDE_TAIL),
+                   "run over a wide head clears its tail");
+        }
+        feed(s, "\x1b[2;4H\xe4\xb8\xad\r" "wxyz");     /* run ends on a wide head */
+        {
+            const term_cell *r = term_screen_row(s, 1);
+            expect(r[3].cp == 'z' && r[4].cp == 0 && !(r[4].attr & TERM_ATTR_WIDE_TAIL),
+                   "run ending on a wide head clears its tail");
+        }
+
+        feed(s, "\x1b[H\x1b[2J\x1b[31;1mred\x1b[0m");
+        {
+            const term_cell *r = term_screen_row(s, 0);
+            expect(r[2].fg.kind == TERM_COLOR_INDEXED && r[2].fg.idx == 1 &&
+                   (r[2].attr & TERM_ATTR_BOLD), "run cells take the pen");
+        }
+
+        feed(s, "\x1b[2;1H\xe4");                       /* UTF-8 lead split from ... */
+        feed(s, "AB");                                    /* ... an ASCII byte */
+        {
+            const term_cell *r = term_screen_row(s, 1);
+            expect(r[0].cp == 0xFFFD && r[1].cp == 'A' && r[2].cp == 'B',
+                   "ASCII after a cut UTF-8 lead: U+FFFD then the run");
+        }
+
+        feed(s, "\x1b[3;1H\x1b(0lqqk\x1b(B");
+        {
+            const term_cell *r = term_screen_row(s, 2);
+            expect(r[0].cp == 0x250C && r[1].cp == 0x2500 && r[3].cp == 0x2510,
+                   "line drawing still maps inside a run");
+        }
+    }
+    term_screen_destroy(s);
+
+    /* The same stream fed whole and a few bytes at a time ends identical. */
+    {
+        const char *txt = "build: [ 12%] Compiling src/terminal/screen.c\r\n"
+                          "\x1b[33mwarning:\x1b[0m unused variable 'x' \xe2\x94\x80\xe2\x94\x80 "
+                          "note: here\r\n\tindented text that is longer than one row of the grid\r\n";
+        term_screen *a = term_screen_create(23, 5), *b = term_screen_create(23, 5);
+        for (int i = 0; i < 9; i++) feed(a, txt);
+        for (int i = 0; i < 9; i++) {
+            for (size_t o = 0, n = strlen(txt); o < n; o += 5)
+                term_screen_feed(b, (const uint8_t *)txt + o, n - o < 5 ? n - o : 5);
+        }
+        bool same = true;
+        for (int y = 0; y < 5; y++) {
+            const term_cell *ra = term_screen_row(a, y), *rb = term_screen_row(b, y);
+            for (int x = 0; x < 23; x++)
+                if (ra[x].cp != rb[x].cp || ra[x].attr != rb[x].attr || ra[x].fg.kind != rb[x].fg.kind)
+                    same = false;
+        }
+        expect(same, "split feeds lay down the same cells as one feed");
+        term_screen_destroy(a);
+        term_screen_destroy(b);
+    }
+
     printf("terminal_screen: %d checks, %d failures\n", g_checks, g_fails);
     return g_fails ? 1 : 0;
 }
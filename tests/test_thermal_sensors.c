@@ -0,0 +1,278 @@
+/* Unit tests for thermal sensor discovery (src/shader/thermal_sensors.c).
+ *
+ * Each case builds a fake /sys tree under a temporary root with the chips a
+ * real machine of that kind exposes, including the ones that must not be
+ * picked:
+ *
+ *   1. AMD desktop: an NVMe drive as hwmon0 and acpitz as thermal_zone0; the
+ *      k10temp Tctl input wins over the hotter CCD, amdgpu "edge" over
+ *      junction, and a hwmon CPU chip outranks an x86_pkg_temp zone.
+ *   2. Dual-socket Intel with a discrete GPU: both coretemp chips' package
+ *      inputs count, hwmon numbers sort naturally (hwmon2 before hwmon10),
+ *      and amdgpu outranks i915.
+ *   3. A chip without labels contributes its first four inputs only.
+ *   4. ARM board with thermal zones only: per-cluster cpu zones and the gpu
+ *      zone, battery ignored.
+ *   5. Nothing usable: no class is reported ok.
+ *   6. Cached files follow in-place updates; a re-probed chip reads as not ok
+ *      until a rescan finds it under its new number.
+ */
+#define _DEFAULT_SOURCE /* mkdtemp */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../src/shader/thermal_sensors.h"
+
+static int failures = 0;
+static int checks = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        checks++;                                                              \
+        if (!(cond)) {                                                         \
+            failures++;                                                        \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+        }                                                                      \
+    } while (0)
+
+#define NEAR(a, b) (fabs((double)(a) - (double)(b)) <= 1e-3)
+
+static char g_root[64];
+static char g_case[128]; /* root of the current case, under g_root */
+
+static void begin_case(const char *name) {
+    snprintf(g_case, sizeof(g_case), "%s/%s", g_root, name);
+    mkdir(g_case, 0755);
+}
+
+/* mkdir -p for the directory part of case-relative `rel` */
+static void make_parents(const char *rel) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s%s", g_case, rel);
+    for (char *p = path + strlen(g_case) + 1; *p; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            mkdir(path, 0755);
+            *p = '/';
+        }
+    }
+}
+
+/* Write a fake file in place (same inode if it exists). */
+static void put(const char *rel, const char *content) {
+    make_parents(rel);
+    char path[512];
+    snprintf(path, sizeof(path), "%s%s", g_case, rel);
+    FILE *f = fopen(path, "w");
+    if (!f) return;
+    fputs(content, f);
+    fclose(f);
+}
+
+static void del(const char *rel) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s%s", g_case, rel);
+    if (unlink(path) != 0) rmdir(path);
+}
+
+static void test_amd_desktop(void) {
+    begin_case("amd");
+    put("/sys/class/hwmon/hwmon0/name", "nvme\n");
+    put("/sys/class/hwmon/hwmon0/temp1_input", "38850\n");
+    put("/sys/class/hwmon/hwmon1/name", "k10temp\n");
+    put("/sys/class/hwmon/hwmon1/temp1_label", "Tctl\n");
+    put("/sys/class/hwmon/hwmon1/temp1_input", "65250\n");
+    put("/sys/class/hwmon/hwmon1/temp3_label", "Tccd1\n");
+    put("/sys/class/hwmon/hwmon1/temp3_input", "80000\n");
+    put("/sys/class/hwmon/hwmon2/name", "amdgpu\n");
+    put("/sys/class/hwmon/hwmon2/temp1_label", "edge\n");
+    put("/sys/class/hwmon/hwmon2/temp1_input", "55000\n");
+    put("/sys/class/hwmon/hwmon2/temp2_label", "junction\n");
+    put("/sys/class/hwmon/hwmon2/temp2_input", "70000\n");
+    put("/sys/class/thermal/thermal_zone0/type", "acpitz\n");
+    put("/sys/class/thermal/thermal_zone0/temp", "16800\n");
+    put("/sys/class/thermal/thermal_zone1/type", "x86_pkg_temp\n");
+    put("/sys/class/thermal/thermal_zone1/temp", "99000\n");
+
+    struct thermal_sensors *ts = thermal_sensors_open(g_case);
+    CHECK(ts != NULL);
+    thermal_reading_t r;
+    thermal_sensors_read(ts, THERMAL_CPU | THERMAL_GPU, &r);
+    CHECK(r.cpu_ok && NEAR(r.cpu_c, 65.25));
+    CHECK(r.gpu_ok && NEAR(r.gpu_c, 55.0));
+    CHECK(strcmp(thermal_sensors_describe(ts, THERMAL_CPU), "k10temp Tctl (hwmon1)") == 0);
+    CHECK(strcmp(thermal_sensors_describe(ts, THERMAL_GPU), "amdgpu edge (hwmon2)") == 0);
+
+    /* only the requested class is read */
+    thermal_sensors_read(ts, THERMAL_GPU, &r);
+    CHECK(!r.cpu_ok && r.cpu_c == 0.0f);
+    CHECK(r.gpu_ok && NEAR(r.gpu_c, 55.0));
+    thermal_sensors_close(ts);
+}
+
+static void test_dual_socket(void) {
+    begin_case("intel");
+    put("/sys/class/hwmon/hwmon0/name", "acpitz\n");
+    put("/sys/class/hwmon/hwmon0/temp1_input", "27800\n");
+    put("/sys/class/hwmon/hwmon10/name", "coretemp\n");
+    put("/sys/class/hwmon/hwmon10/temp1_label", "Package id 1\n");
+    put("/sys/class/hwmon/hwmon10/temp1_input", "81000\n");
+    put("/sys/class/hwmon/hwmon10/temp2_label", "Core 0\n");
+    put("/sys/class/hwmon/hwmon10/temp2_input", "93000\n");
+    put("/sys/class/hwmon/hwmon2/name", "coretemp\n");
+    put("/sys/class/hwmon/hwmon2/temp1_label", "Package id 0\n");
+    put("/sys/class/hwmon/hwmon2/temp1_input", "72000\n");
+    put("/sys/class/hwmon/hwmon3/name", "i915\n");
+    put("/sys/class/hwmon/hwmon3/temp1_input", "50000\n");
+    put("/sys/class/hwmon/hwmon4/name", "amdgpu\n");
+    put("/sys/class/hwmon/hwmon4/temp1_input", "60000\n");
+    put("/sys/class/hwmon/hwmon5/name", "iwlwifi_1\n");
+    put("/sys/class/hwmon/hwmon5/temp1_input", "45000\n");
+
+    struct thermal_sensors *ts = thermal_sensors_open(g_case);
+    thermal_reading_t r;
+    thermal_sensors_read(ts, THERMAL_CPU | THERMAL_GPU, &r);
+    CHECK(r.cpu_ok && NEAR(r.cpu_c, 81.0));
+    CHECK(r.gpu_ok && NEAR(r.gpu_c, 60.0));
+    CHECK(strcmp(thermal_sensors_describe(ts, THERMAL_CPU),
+                 "coretemp Package id 0 (hwmon2)") == 0);
+    CHECK(strcmp(thermal_sensors_describe(ts, THERMAL_GPU), "amdgpu (hwmon4)") == 0);
+    thermal_sensors_close(ts);
+
+    /* without the discrete card, the integrated one is used */
+    del("/sys/class/hwmon/hwmon4/name");
+    del("/sys/class/hwmon/hwmon4/temp1_input");
+    del("/sys/class/hwmon/hwmon4");
+    ts = thermal_sensors_open(g_case);
+    thermal_sensors_read(ts, THERMAL_GPU, &r);
+    CHECK(r.gpu_ok && NEAR(r.gpu_c, 50.0));
+    thermal_sensors_close(ts);
+}
+
+static void test_unlabelled(void) {
+    begin_case("unlabelled");
+    put("/sys/class/hwmon/hwmon0/name", "cpu_thermal\n");
+    put("/sys/class/hwmon/hwmon0/temp1_input", "41000\n");
+    put("/sys/class/hwmon/hwmon0/temp2_input", "44000\n");
+    put("/sys/class/hwmon/hwmon0/temp4_input", "43000\n");
+    put("/sys/class/hwmon/hwmon0/temp5_input", "42000\n");
+    put("/sys/class/hwmon/hwmon0/temp6_input", "99000\n");
+
+    struct thermal_sensors *ts = thermal_sensors_open(g_case);
+    thermal_reading_t r;
+    thermal_sensors_read(ts, THERMAL_CPU | THERMAL_GPU, &r);
+    CHECK(r.cpu_ok && NEAR(r.cpu_c, 44.0));
+    CHECK(!r.gpu_ok && r.gpu_c == 0.0f);
+    CHECK(strcmp(thermal_sensors_describe(ts, THERMAL_CPU), "cpu_thermal (hwmon0)") == 0);
+    CHECK(strcmp(thermal_sensors_describe(ts, THERMAL_GPU), "") == 0);
+    thermal_sensors_close(ts);
+}
+
+static void test_zones_only(void) {
+    begin_case("arm");
+    put("/sys/class/thermal/thermal_zone0/type", "cpu0-thermal\n");
+    put("/sys/class/thermal/thermal_zone0/temp", "50000\n");
+    put("/sys/class/thermal/thermal_zone1/type", "gpu-thermal\n");
+    put("/sys/class/thermal/thermal_zone1/temp", "45500\n");
+    put("/sys/class/thermal/thermal_zone2/type", "cpu1-thermal\n");
+    put("/sys/class/thermal/thermal_zone2/temp", "53000\n");
+    put("/sys/class/thermal/thermal_zone3/type", "battery\n");
+    put("/sys/class/thermal/thermal_zone3/temp", "90000\n");
+    put("/sys/class/thermal/thermal_zone4/type", "soc-thermal\n");
+    put("/sys/class/thermal/thermal_zone4/temp", "88000\n");
+
+    struct thermal_sensors *ts = thermal_sensors_open(g_case);
+    thermal_reading_t r;
+    thermal_sensors_read(ts, THERMAL_CPU | THERMAL_GPU, &r);
+    CHECK(r.cpu_ok && NEAR(r.cpu_c, 53.0));
+    CHECK(r.gpu_ok && NEAR(r.gpu_c, 45.5));
+    CHECK(strcmp(thermal_sensors_describe(ts, THERMAL_CPU),
+                 "cpu0-thermal (thermal_zone0)") == 0);
+    thermal_sensors_close(ts);
+}
+
+static void test_nothing_usable(void) {
+    begin_case("none");
+    put("/sys/class/hwmon/hwmon0/name", "nvme\n");
+    put("/sys/class/hwmon/hwmon0/temp1_input", "38850\n");
+    put("/sys/class/thermal/thermal_zone0/type", "acpitz\n");
+    put("/sys/class/thermal/thermal_zone0/temp", "27800\n");
+
+    struct thermal_sensors *ts = thermal_sensors_open(g_case);
+    CHECK(ts != NULL);
+    thermal_reading_t r;
+    thermal_sensors_read(ts, THERMAL_CPU | THERMAL_GPU, &r);
+    CHECK(!r.cpu_ok && !r.gpu_ok && r.cpu_c == 0.0f && r.gpu_c == 0.0f);
+    thermal_sensors_close(ts);
+
+    /* a missing root is an empty set, not a failure */
+    begin_case("empty");
+    ts = thermal_sensors_open(g_case);
+    CHECK(ts != NULL);
+    thermal_sensors_read(ts, THERMAL_CPU, &r);
+    CHECK(!r.cpu_ok);
+    thermal_sensors_close(ts);
+
+    thermal_sensors_read(NULL, THERMAL_CPU, &r);
+    CHECK(!r.cpu_ok && !r.gpu_ok);
+    thermal_sensors_close(NULL);
+}
+
+static void test_reprobe(void) {
+    begin_case("reprobe");
+    put("/sys/class/hwmon/hwmon1/name", "k10temp\n");
+    put("/sys/class/hwmon/hwmon1/temp1_input", "61000\n");
+
+    struct thermal_sensors *ts = thermal_sensors_open(g_case);
+    thermal_reading_t r;
+    thermal_sensors_read(ts, THERMAL_CPU, &r);
+    CHECK(r.cpu_ok && NEAR(r.cpu_c, 61.0));
+
+    /* the cached descriptor sees in-place updates */
+    put("/sys/class/hwmon/hwmon1/temp1_input", "67500\n");
+    thermal_sensors_read(ts, THERMAL_CPU, &r);
+    CHECK(r.cpu_ok && NEAR(r.cpu_c, 67.5));
+
+    /* the driver is reloaded and comes back as hwmon7 */
+    del("/sys/class/hwmon/hwmon1/name");
+    del("/sys/class/hwmon/hwmon1/temp1_input");
+    del("/sys/class/hwmon/hwmon1");
+    put("/sys/class/hwmon/hwmon7/name", "k10temp\n");
+    put("/sys/class/hwmon/hwmon7/temp1_input", "48000\n");
+    thermal_sensors_read(ts, THERMAL_CPU, &r);
+    CHECK(!r.cpu_ok && r.cpu_c == 0.0f);
+
+    thermal_sensors_rescan(ts);
+    thermal_sensors_read(ts, THERMAL_CPU, &r);
+    CHECK(r.cpu_ok && NEAR(r.cpu_c, 48.0));
+    CHECK(strcmp(thermal_sensors_describe(ts, THERMAL_CPU), "k10temp (hwmon7)") == 0);
+    thermal_sensors_close(ts);
+}
+
+int main(void) {
+    snprintf(g_root, sizeof(g_root), "/tmp/neowall-thermal-XXXXXX");
+    if (!mkdtemp(g_root)) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    test_amd_desktop();
+    test_dual_socket();
+    test_unlabelled();
+    test_zones_only();
+    test_nothing_usable();
+    test_reprobe();
+
+    char cmd[128];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", g_root);
+    if (system(cmd) != 0) {
+        fprintf(stderr, "warning: could not remove %s\n", g_root);
+    }
+
+    printf("thermal_sensors: %d/%d checks passed\n", checks - failures, checks);
+    return failures ? 1 : 0;
+}